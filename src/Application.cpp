@@ -5,11 +5,40 @@
 #include <imgui/imgui_impl_glfw_gl3.h>
 
 #include <iostream>
+#include <fstream>
 #include <cassert>
+#include <cstring>
 
+#include "FrameAllocator.h"
+#include "GpuHeap.h"
+#include "JobSystem.h"
 #include "Renderer.h"
+#include "RenderTargetPool.h"
+#include "ResourceRegistry.h"
+#include "TextureCache.h"
+#include "VirtualFileSystem.h"
+#include "VirtualTextureSource.h"
+#include "Tests/TestAllocations.h"
 #include "Tests/TestClearColor.h"
+#include "Tests/TestDecodeBenchmark.h"
+#include "Tests/TestDynamicMesh.h"
+#include "Tests/TestFramebuffer.h"
+#include "Tests/TestFrustumCulling.h"
+#include "Tests/TestGpuCulling.h"
+#include "Tests/TestGpuHeap.h"
+#include "Tests/TestJobSystem.h"
+#include "Tests/TestMeshPool.h"
+#include "Tests/TestOverdraw.h"
+#include "Tests/TestParticleBenchmark.h"
+#include "Tests/TestParticles.h"
+#include "Tests/TestPostProcess.h"
+#include "Tests/TestRenderGraph.h"
+#include "Tests/TestSceneGraph.h"
+#include "Tests/TestSdfText.h"
+#include "Tests/TestSpatialIndex.h"
 #include "Tests/TestTexture2D.h"
+#include "Tests/TestTransformBenchmark.h"
+#include "Tests/TestVirtualTexture.h"
 
 static GLFWwindow* InitOpenGL()
 {
@@ -17,7 +46,8 @@ static GLFWwindow* InitOpenGL()
   if (glfwInit() == GLFW_FALSE)
     return nullptr;
 
-  glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+  // Ask for 4.3 for compute shaders and indirect draws, falling back to 3.3 where it isn't available.
+  glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
   glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
   glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
 
@@ -25,6 +55,12 @@ static GLFWwindow* InitOpenGL()
   GLFWwindow* window;
   window = glfwCreateWindow((int)WINDOW_WIDTH, (int)WINDOW_HEIGHT, "Hello World", NULL, NULL);
   if (!window)
+  {
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    window = glfwCreateWindow((int)WINDOW_WIDTH, (int)WINDOW_HEIGHT, "Hello World", NULL, NULL);
+  }
+  if (!window)
   {
     glfwTerminate();
     return nullptr;
@@ -47,8 +83,42 @@ static GLFWwindow* InitOpenGL()
   return window;
 }
 
-int main(void)
+// Packs every file listed in the manifest (one path per line) into a single archive.
+static int BuildAssetPack(const std::string& manifestPath, const std::string& outputPath)
+{
+  std::ifstream manifest(manifestPath);
+  std::vector<std::string> files;
+  std::string line;
+  while (getline(manifest, line))
+  {
+    if (!line.empty() && line[0] != '#')
+      files.push_back(line);
+  }
+
+  if (files.empty() || !AssetPack::Write(outputPath, files))
+  {
+    std::cout << "Error building asset pack from " << manifestPath << std::endl;
+    return 1;
+  }
+
+  std::cout << "Packed " << files.size() << " files into " << outputPath << std::endl;
+  return 0;
+}
+
+int main(int argc, char** argv)
 {
+  // OpenGL --build-pack <manifest> <output>
+  if (argc == 4 && strcmp(argv[1], "--build-pack") == 0)
+    return BuildAssetPack(argv[2], argv[3]);
+
+  // OpenGL --build-vtex <image> <output>
+  if (argc == 4 && strcmp(argv[1], "--build-vtex") == 0)
+    return VirtualTextureFile::Build(argv[2], argv[3]) ? 0 : 1;
+
+  // The first Get makes this the main thread, the one main thread jobs run on.
+  JobSystem::Get();
+  VirtualFileSystem::Get().Mount("resources.pak");
+
   GLFWwindow* window = InitOpenGL();
   assert(window);
 
@@ -67,18 +137,37 @@ int main(void)
 
   testMenu->RegisterTest<test::ClearColor>("Clear Color");
   testMenu->RegisterTest<test::Texture2D>("2D Texture");
+  testMenu->RegisterTest<test::DecodeBenchmark>("Decode Benchmark");
+  testMenu->RegisterTest<test::VirtualTextureMap>("Virtual Texture Map");
+  testMenu->RegisterTest<test::Framebuffers>("Framebuffers");
+  testMenu->RegisterTest<test::RenderGraphs>("Render Graph");
+  testMenu->RegisterTest<test::PostProcess>("Post Processing");
+  testMenu->RegisterTest<test::Overdraw>("Overdraw");
+  testMenu->RegisterTest<test::GpuCullingScene>("GPU Culling");
+  testMenu->RegisterTest<test::MeshPoolScene>("Mesh Pool");
+  testMenu->RegisterTest<test::GpuHeapChurn>("GPU Heap");
+  testMenu->RegisterTest<test::DynamicMesh>("Dynamic Mesh");
+  testMenu->RegisterTest<test::TransformBenchmark>("Transform Benchmark");
+  testMenu->RegisterTest<test::SceneGraphBenchmark>("Scene Graph");
+  testMenu->RegisterTest<test::FrustumCullingBenchmark>("Frustum Culling");
+  testMenu->RegisterTest<test::SpatialIndexScene>("Spatial Index");
+  testMenu->RegisterTest<test::JobSystemBenchmark>("Job System");
+  testMenu->RegisterTest<test::Allocations>("Allocations");
+  testMenu->RegisterTest<test::Particles>("Particles");
+  testMenu->RegisterTest<test::ParticleBenchmark>("Particle Benchmark");
+  testMenu->RegisterTest<test::SdfText>("SDF Text");
 
   // Loop until the user closes the window
   while (!glfwWindowShouldClose(window))
   {
     OpenGLCall(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
-    renderer.Clear();
+    renderer.Clear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
 
     ImGui_ImplGlfwGL3_NewFrame();
 
     if (currentTest) 
     {
-      currentTest->OnUpdate(0.0f);
+      currentTest->OnUpdate(ImGui::GetIO().DeltaTime);
       currentTest->OnRender();
 
       ImGui::Begin("Test");
@@ -88,11 +177,24 @@ int main(void)
         currentTest = testMenu;
       }
       currentTest->OnImGuiRender();
+      if (ImGui::CollapsingHeader("Texture Cache"))
+        TextureCache::Get().OnImGuiRender();
+      if (ImGui::CollapsingHeader("Render Targets"))
+        RenderTargetPool::Get().OnImGuiRender();
+      if (ImGui::CollapsingHeader("Resources"))
+        ResourceRegistry::Get().OnImGuiRender();
+      if (ImGui::CollapsingHeader("Jobs"))
+        JobSystem::Get().OnImGuiRender();
+      if (ImGui::CollapsingHeader("Frame Memory"))
+        FrameAllocator::Get().OnImGuiRender();
       ImGui::End();
     }
 
     ImGui::Render();
     ImGui_ImplGlfwGL3_RenderDrawData(ImGui::GetDrawData());
+    FrameAllocator::Get().EndFrame();
+    RenderTargetPool::Get().EndFrame();
+    ResourceRegistry::Get().EndFrame();
 
     glfwSwapBuffers(window);
     glfwPollEvents();
@@ -101,6 +203,11 @@ int main(void)
   if (testMenu != currentTest)
     delete testMenu;
   delete currentTest;
+  TextureCache::Get().Clear();
+  RenderTargetPool::Get().Clear();
+  ResourceRegistry::Get().Clear();
+  GpuHeap::Get().Clear();
+  JobSystem::Get().Shutdown();
 
   ImGui_ImplGlfwGL3_Shutdown();
   ImGui::DestroyContext();
@@ -0,0 +1,156 @@
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#ifdef OPENGL_USE_LZ4
+#include <lz4.h>
+#endif
+
+#include "AssetPack.h"
+
+AssetPack::AssetPack(const std::string& filepath)
+  : m_File(filepath), m_Entries(nullptr), m_Paths(nullptr), m_EntryCount(0)
+{
+  if (!m_File.IsValid() || m_File.GetSize() < sizeof(PackHeader))
+    return;
+
+  const PackHeader* header = (const PackHeader*)m_File.GetData();
+  size_t tableEnd = sizeof(PackHeader) + (size_t)header->EntryCount * sizeof(PackEntry) + header->StringTableSize;
+  bool valid = header->Magic == PACK_MAGIC && header->Version == PACK_VERSION && tableEnd <= m_File.GetSize();
+
+  // Find and GetData trust the entries from here on, so every path and blob must lie inside the
+  // string table and the file respectively.
+  const PackEntry* entries = (const PackEntry*)(m_File.GetData() + sizeof(PackHeader));
+  for (uint32_t i = 0; valid && i < header->EntryCount; i++)
+  {
+    const PackEntry& entry = entries[i];
+    valid = (uint64_t)entry.PathOffset + entry.PathLength <= header->StringTableSize
+      && entry.Offset >= tableEnd && entry.Offset <= m_File.GetSize() && entry.StoredSize <= m_File.GetSize() - entry.Offset;
+  }
+  if (!valid)
+  {
+    std::cout << "[ERROR] [VFS]: '" << filepath << "' is not a valid asset pack" << std::endl;
+    return;
+  }
+
+  m_EntryCount = header->EntryCount;
+  m_Entries = entries;
+  m_Paths = (const char*)(m_Entries + m_EntryCount);
+}
+
+const PackEntry* AssetPack::Find(const std::string& path) const
+{
+  std::string normalized = NormalizePath(path);
+  uint64_t hash = HashPath(normalized);
+
+  const PackEntry* end = m_Entries + m_EntryCount;
+  const PackEntry* entry = std::lower_bound(m_Entries, end, hash,
+    [](const PackEntry& entry, uint64_t hash) { return entry.PathHash < hash; });
+
+  for (; entry != end && entry->PathHash == hash; ++entry)
+  {
+    if (entry->PathLength == normalized.size() && memcmp(m_Paths + entry->PathOffset, normalized.data(), normalized.size()) == 0)
+      return entry;
+  }
+  return nullptr;
+}
+
+std::string AssetPack::NormalizePath(const std::string& path)
+{
+  std::string normalized = path;
+  std::replace(normalized.begin(), normalized.end(), '\\', '/');
+  if (normalized.compare(0, 2, "./") == 0)
+    normalized.erase(0, 2);
+  return normalized;
+}
+
+uint64_t AssetPack::HashPath(const std::string& normalizedPath)
+{
+  // 64 bit FNV-1a.
+  uint64_t hash = 14695981039346656037ull;
+  for (char c : normalizedPath)
+  {
+    hash ^= (unsigned char)c;
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+bool AssetPack::Write(const std::string& outputPath, const std::vector<std::string>& files)
+{
+  struct Source
+  {
+    std::string Path;
+    std::vector<char> Data;
+    PackEntry Entry;
+  };
+
+  std::vector<Source> sources(files.size());
+  std::string paths;
+  for (size_t i = 0; i < files.size(); i++)
+  {
+    Source& source = sources[i];
+    source.Path = NormalizePath(files[i]);
+
+    MappedFile file(files[i]);
+    if (!file.IsValid())
+    {
+      std::cout << "[ERROR] [VFS]: Can't pack '" << files[i] << "'" << std::endl;
+      return false;
+    }
+
+    source.Entry = PackEntry{};
+    source.Entry.PathHash = HashPath(source.Path);
+    source.Entry.PathOffset = (uint32_t)paths.size();
+    source.Entry.PathLength = (uint32_t)source.Path.size();
+    source.Entry.OriginalSize = file.GetSize();
+    paths += source.Path;
+
+    source.Data.assign(file.GetData(), file.GetData() + file.GetSize());
+#ifdef OPENGL_USE_LZ4
+    std::vector<char> compressed(LZ4_compressBound((int)file.GetSize()));
+    int compressedSize = LZ4_compress_default((const char*)file.GetData(), compressed.data(), (int)file.GetSize(), (int)compressed.size());
+    if (compressedSize > 0 && (size_t)compressedSize < file.GetSize() - file.GetSize() / 8)
+    {
+      compressed.resize(compressedSize);
+      source.Data.swap(compressed);
+      source.Entry.Flags |= PACK_ENTRY_LZ4;
+    }
+#endif
+    source.Entry.StoredSize = source.Data.size();
+  }
+
+  auto alignUp = [](uint64_t value) { return (value + PACK_ALIGNMENT - 1) & ~(PACK_ALIGNMENT - 1); };
+
+  PackHeader header = { PACK_MAGIC, PACK_VERSION, (uint32_t)sources.size(), (uint32_t)paths.size() };
+  uint64_t offset = alignUp(sizeof(PackHeader) + sources.size() * sizeof(PackEntry) + paths.size());
+  for (Source& source : sources)
+  {
+    source.Entry.Offset = offset;
+    offset = alignUp(offset + source.Entry.StoredSize);
+  }
+
+  std::vector<PackEntry> entries;
+  for (const Source& source : sources)
+    entries.push_back(source.Entry);
+  std::stable_sort(entries.begin(), entries.end(),
+    [](const PackEntry& a, const PackEntry& b) { return a.PathHash < b.PathHash; });
+
+  std::ofstream stream(outputPath, std::ios::binary | std::ios::trunc);
+  if (!stream)
+    return false;
+
+  stream.write((const char*)&header, sizeof(header));
+  stream.write((const char*)entries.data(), entries.size() * sizeof(PackEntry));
+  stream.write(paths.data(), paths.size());
+
+  const char padding[PACK_ALIGNMENT] = {};
+  for (const Source& source : sources)
+  {
+    stream.write(padding, source.Entry.Offset - (uint64_t)stream.tellp());
+    stream.write(source.Data.data(), source.Data.size());
+  }
+
+  return (bool)stream;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "MappedFile.h"
+
+// On-disk layout of a pack:
+//   PackHeader | PackEntry[EntryCount] sorted by PathHash | path strings | blobs
+// Every blob starts on a PACK_ALIGNMENT boundary so uncompressed entries can be handed out
+// as pointers straight into the memory-mapped archive.
+constexpr uint32_t PACK_MAGIC = 0x4B50474F; // "OGPK"
+constexpr uint32_t PACK_VERSION = 1;
+constexpr uint64_t PACK_ALIGNMENT = 64;
+constexpr uint32_t PACK_ENTRY_LZ4 = 1 << 0;
+
+struct PackHeader
+{
+  uint32_t Magic;
+  uint32_t Version;
+  uint32_t EntryCount;
+  uint32_t StringTableSize;
+};
+
+struct PackEntry
+{
+  uint64_t PathHash;
+  uint64_t Offset;
+  uint64_t StoredSize;
+  uint64_t OriginalSize;
+  uint32_t PathOffset;
+  uint32_t PathLength;
+  uint32_t Flags;
+  uint32_t Reserved;
+};
+
+class AssetPack
+{
+private:
+  MappedFile m_File;
+  const PackEntry* m_Entries;
+  const char* m_Paths;
+  uint32_t m_EntryCount;
+
+public:
+  AssetPack(const std::string& filepath);
+
+  inline bool IsValid() const { return m_Entries != nullptr; }
+  inline const std::string& GetFilePath() const { return m_File.GetFilePath(); }
+  inline uint32_t GetEntryCount() const { return m_EntryCount; }
+
+  const PackEntry* Find(const std::string& path) const;
+  inline const unsigned char* GetData(const PackEntry& entry) const { return m_File.GetData() + entry.Offset; }
+
+  // Packs the listed files, storing them under the same relative paths. Entries are LZ4
+  // compressed when built with OPENGL_USE_LZ4 and compression saves at least an eighth.
+  static bool Write(const std::string& outputPath, const std::vector<std::string>& files);
+
+  // Normalises separators so "src\\resources\\a.png" and "src/resources/a.png" match.
+  static std::string NormalizePath(const std::string& path);
+  static uint64_t HashPath(const std::string& normalizedPath);
+};
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <algorithm>
+
+#include <glm/glm.hpp>
+
+struct BoundingSphere
+{
+  glm::vec3 Center;
+  float Radius;
+
+  // Encloses the sphere after transform, using the largest axis scale for the radius.
+  inline BoundingSphere Transform(const glm::mat4& transform) const
+  {
+    float scale = std::max(glm::length(glm::vec3(transform[0])), std::max(glm::length(glm::vec3(transform[1])), glm::length(glm::vec3(transform[2]))));
+    return { glm::vec3(transform * glm::vec4(Center, 1.0f)), Radius * scale };
+  }
+};
+
+// Axis aligned bounding box.
+struct BoundingBox
+{
+  glm::vec3 Min, Max;
+
+  inline glm::vec3 GetCenter() const { return (Min + Max) * 0.5f; }
+  inline glm::vec3 GetExtents() const { return (Max - Min) * 0.5f; }
+  inline BoundingSphere GetBoundingSphere() const { return { GetCenter(), glm::length(GetExtents()) }; }
+  // Half the surface area, which is all that matters when comparing boxes.
+  inline float GetHalfArea() const { glm::vec3 size = Max - Min; return size.x * size.y + size.y * size.z + size.z * size.x; }
+
+  inline bool Contains(const glm::vec3& point) const { return glm::all(glm::greaterThanEqual(point, Min)) && glm::all(glm::lessThanEqual(point, Max)); }
+  inline bool Contains(const BoundingBox& box) const { return glm::all(glm::greaterThanEqual(box.Min, Min)) && glm::all(glm::lessThanEqual(box.Max, Max)); }
+  inline bool Overlaps(const BoundingBox& box) const { return glm::all(glm::lessThanEqual(box.Min, Max)) && glm::all(glm::lessThanEqual(Min, box.Max)); }
+  inline BoundingBox Union(const BoundingBox& box) const { return { glm::min(Min, box.Min), glm::max(Max, box.Max) }; }
+
+  // Axis aligned box around the transformed box: the extents are projected onto each world axis
+  // with the absolute rotation and scale, as in Arvo's method.
+  inline BoundingBox Transform(const glm::mat4& transform) const
+  {
+    glm::vec3 center = glm::vec3(transform * glm::vec4(GetCenter(), 1.0f));
+    glm::vec3 extents = GetExtents();
+    glm::vec3 worldExtents = glm::abs(glm::vec3(transform[0])) * extents.x + glm::abs(glm::vec3(transform[1])) * extents.y +
+      glm::abs(glm::vec3(transform[2])) * extents.z;
+    return { center - worldExtents, center + worldExtents };
+  }
+};
+
+// Axis aligned rectangle, for 2D scenes.
+struct BoundingRect
+{
+  glm::vec2 Min, Max;
+
+  inline glm::vec2 GetCenter() const { return (Min + Max) * 0.5f; }
+  inline glm::vec2 GetExtents() const { return (Max - Min) * 0.5f; }
+
+  inline bool Contains(const glm::vec2& point) const { return glm::all(glm::greaterThanEqual(point, Min)) && glm::all(glm::lessThanEqual(point, Max)); }
+  inline bool Overlaps(const BoundingRect& rect) const { return glm::all(glm::lessThanEqual(rect.Min, Max)) && glm::all(glm::lessThanEqual(Min, rect.Max)); }
+  // Flat box on the z = 0 plane.
+  inline BoundingBox ToBox() const { return { glm::vec3(Min, 0.0f), glm::vec3(Max, 0.0f) }; }
+};
@@ -0,0 +1,137 @@
+#include "BufferStorage.h"
+#include "Renderer.h"
+
+BufferStorage::BufferStorage(const void* data, unsigned int size, BufferUsage usage)
+  : m_Allocation(GpuHeap::INVALID_HANDLE), m_Size(size), m_Usage(usage)
+{
+  if (usage == BufferUsage::Static && size > 0 && size <= MAX_HEAP_SIZE)
+    m_Allocation = GpuHeap::Get().Allocate(size);
+
+  if (IsInHeap())
+  {
+    if (data)
+      GpuHeap::Get().Upload(m_Allocation, data, size);
+    return;
+  }
+
+  unsigned int id = 0;
+  OpenGLCall(glGenBuffers(1, &id));
+  m_RendererId.Reset(id);
+  OpenGLCall(glBindBuffer(GL_COPY_WRITE_BUFFER, id));
+  OpenGLCall(glBufferData(GL_COPY_WRITE_BUFFER, size, data, GetGLUsage(usage)));
+}
+
+BufferStorage::~BufferStorage()
+{
+  GpuHeap::Get().Free(m_Allocation);
+}
+
+BufferStorage::BufferStorage(BufferStorage&& other) noexcept
+  : m_RendererId(std::move(other.m_RendererId)), m_Allocation(other.m_Allocation), m_Size(other.m_Size), m_Usage(other.m_Usage)
+{
+  other.m_Allocation = GpuHeap::INVALID_HANDLE;
+  other.m_Size = 0;
+}
+
+BufferStorage& BufferStorage::operator=(BufferStorage&& other) noexcept
+{
+  if (this != &other)
+  {
+    GpuHeap::Get().Free(m_Allocation);
+    m_RendererId = std::move(other.m_RendererId);
+    m_Allocation = other.m_Allocation;
+    m_Size = other.m_Size;
+    m_Usage = other.m_Usage;
+    other.m_Allocation = GpuHeap::INVALID_HANDLE;
+    other.m_Size = 0;
+  }
+  return *this;
+}
+
+unsigned int BufferStorage::GetRendererId() const
+{
+  if (IsInHeap())
+    return GpuHeap::Get().GetBuffer(m_Allocation)->GetRendererId();
+  return m_RendererId.Get();
+}
+
+unsigned int BufferStorage::GetOffset() const
+{
+  return IsInHeap() ? (unsigned int)GpuHeap::Get().GetOffset(m_Allocation) : 0;
+}
+
+void BufferStorage::Bind(unsigned int target) const
+{
+  OpenGLCall(glBindBuffer(target, GetRendererId()));
+}
+
+void BufferStorage::LeaveHeap(bool keepContents)
+{
+  if (!IsInHeap())
+    return;
+
+  unsigned int id = 0;
+  OpenGLCall(glGenBuffers(1, &id));
+  m_RendererId.Reset(id);
+  OpenGLCall(glBindBuffer(GL_COPY_WRITE_BUFFER, id));
+  OpenGLCall(glBufferData(GL_COPY_WRITE_BUFFER, m_Size, nullptr, GetGLUsage(m_Usage)));
+  if (keepContents)
+  {
+    GpuHeap& heap = GpuHeap::Get();
+    OpenGLCall(glBindBuffer(GL_COPY_READ_BUFFER, heap.GetBuffer(m_Allocation)->GetRendererId()));
+    OpenGLCall(glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, heap.GetOffset(m_Allocation), 0, m_Size));
+  }
+
+  GpuHeap::Get().Free(m_Allocation);
+  m_Allocation = GpuHeap::INVALID_HANDLE;
+}
+
+void BufferStorage::SetData(const void* data, unsigned int size)
+{
+  LeaveHeap(false);
+  m_Size = size;
+  OpenGLCall(glBindBuffer(GL_COPY_WRITE_BUFFER, m_RendererId.Get()));
+  OpenGLCall(glBufferData(GL_COPY_WRITE_BUFFER, size, data, GetGLUsage(m_Usage)));
+}
+
+void BufferStorage::SetSubData(unsigned int offset, const void* data, unsigned int size)
+{
+  if (IsInHeap())
+  {
+    GpuHeap::Get().Upload(m_Allocation, data, size, offset);
+    return;
+  }
+
+  OpenGLCall(glBindBuffer(GL_COPY_WRITE_BUFFER, m_RendererId.Get()));
+  OpenGLCall(glBufferSubData(GL_COPY_WRITE_BUFFER, offset, size, data));
+}
+
+void BufferStorage::Orphan()
+{
+  SetData(nullptr, m_Size);
+}
+
+void BufferStorage::Resize(unsigned int size)
+{
+  if (size == m_Size)
+    return;
+
+  LeaveHeap(true);
+  ResizeBufferStorage(m_RendererId.Get(), m_Size, size, m_Usage);
+  m_Size = size;
+}
+
+void* BufferStorage::Map(unsigned int size)
+{
+  LeaveHeap(false);
+  OpenGLCall(glBindBuffer(GL_COPY_WRITE_BUFFER, m_RendererId.Get()));
+  OpenGLCall(void* data = glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
+  return data;
+}
+
+bool BufferStorage::Unmap()
+{
+  OpenGLCall(glBindBuffer(GL_COPY_WRITE_BUFFER, m_RendererId.Get()));
+  OpenGLCall(GLboolean intact = glUnmapBuffer(GL_COPY_WRITE_BUFFER));
+  return intact == GL_TRUE;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "BufferUsage.h"
+#include "GLHandle.h"
+#include "GpuHeap.h"
+
+// The GL storage behind a VertexBuffer or IndexBuffer. Static buffers small enough are
+// sub-allocated from the shared GpuHeap, so thousands of small meshes don't each need a buffer
+// object; bind GetRendererId and add GetOffset to every offset into the buffer. Anything else gets
+// a buffer object of its own, and so does a static buffer the first time its whole storage is
+// replaced (SetData, Orphan, Resize, Map), since a heap block can't be orphaned or grown in place.
+class BufferStorage
+{
+private:
+  BufferHandle m_RendererId; // Unused while the storage is in the heap.
+  GpuHeap::Handle m_Allocation;
+  unsigned int m_Size;
+  BufferUsage m_Usage;
+
+public:
+  // Static buffers up to this size go to the shared heap.
+  static const unsigned int MAX_HEAP_SIZE = 1024 * 1024;
+
+  BufferStorage(const void* data, unsigned int size, BufferUsage usage);
+  ~BufferStorage();
+
+  BufferStorage(BufferStorage&& other) noexcept;
+  BufferStorage& operator=(BufferStorage&& other) noexcept;
+
+  void Bind(unsigned int target) const;
+
+  void SetData(const void* data, unsigned int size);
+  void SetSubData(unsigned int offset, const void* data, unsigned int size);
+  void Orphan();
+  void Resize(unsigned int size);
+  void* Map(unsigned int size);
+  bool Unmap();
+
+  inline bool IsInHeap() const { return m_Allocation != GpuHeap::INVALID_HANDLE; }
+  unsigned int GetRendererId() const;
+  unsigned int GetOffset() const;
+  inline unsigned int GetSize() const { return m_Size; }
+  inline BufferUsage GetUsage() const { return m_Usage; }
+private:
+  // Gives the storage a buffer object of its own, copying the contents out of the heap if asked.
+  void LeaveHeap(bool keepContents);
+};
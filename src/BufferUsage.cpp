@@ -0,0 +1,29 @@
+#include <algorithm>
+
+#include "BufferUsage.h"
+#include "Renderer.h"
+
+void ResizeBufferStorage(unsigned int buffer, unsigned int oldSize, unsigned int newSize, BufferUsage usage)
+{
+  // Round trip through a scratch buffer; the data never leaves the GPU.
+  unsigned int kept = std::min(oldSize, newSize);
+  unsigned int scratch = 0;
+  if (kept)
+  {
+    OpenGLCall(glGenBuffers(1, &scratch));
+    OpenGLCall(glBindBuffer(GL_COPY_WRITE_BUFFER, scratch));
+    OpenGLCall(glBufferData(GL_COPY_WRITE_BUFFER, kept, nullptr, GL_STREAM_COPY));
+    OpenGLCall(glBindBuffer(GL_COPY_READ_BUFFER, buffer));
+    OpenGLCall(glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, kept));
+  }
+
+  OpenGLCall(glBindBuffer(GL_COPY_WRITE_BUFFER, buffer));
+  OpenGLCall(glBufferData(GL_COPY_WRITE_BUFFER, newSize, nullptr, GetGLUsage(usage)));
+
+  if (kept)
+  {
+    OpenGLCall(glBindBuffer(GL_COPY_READ_BUFFER, scratch));
+    OpenGLCall(glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, kept));
+    OpenGLCall(glDeleteBuffers(1, &scratch));
+  }
+}
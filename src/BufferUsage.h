@@ -0,0 +1,25 @@
+#pragma once
+
+#include <GL/glew.h>
+
+// How often a buffer's contents are expected to change, mapped to the GL usage hint.
+enum class BufferUsage
+{
+  Static,  // Written once, drawn many times.
+  Dynamic, // Rewritten now and then, e.g. animated meshes.
+  Stream   // Rewritten every frame.
+};
+
+inline unsigned int GetGLUsage(BufferUsage usage)
+{
+  switch (usage)
+  {
+  case BufferUsage::Dynamic: return GL_DYNAMIC_DRAW;
+  case BufferUsage::Stream:  return GL_STREAM_DRAW;
+  default:                   return GL_STATIC_DRAW;
+  }
+}
+
+// Reallocates a buffer object's storage at newSize, keeping the first min(oldSize, newSize) bytes.
+// The object name doesn't change, so vertex arrays referring to it stay valid.
+void ResizeBufferStorage(unsigned int buffer, unsigned int oldSize, unsigned int newSize, BufferUsage usage);
@@ -0,0 +1,487 @@
+#include <algorithm>
+
+#include "Bvh.h"
+
+constexpr unsigned int Bvh::INVALID_OBJECT;
+constexpr int Bvh::NO_NODE;
+
+// Slab test. entry is where the ray enters the box, clamped to the ray's start. A ray parallel to
+// an axis (zero inverseDirection component, see Raycast) never crosses that axis' slab, so it only
+// hits when its origin lies between the two planes.
+static bool IntersectRay(const BoundingBox& box, const glm::vec3& origin, const glm::vec3& inverseDirection, float maxDistance, float& entry)
+{
+  entry = 0.0f;
+  float exit = maxDistance;
+  for (int axis = 0; axis < 3; axis++)
+  {
+    if (inverseDirection[axis] == 0.0f)
+    {
+      if (origin[axis] < box.Min[axis] || origin[axis] > box.Max[axis])
+        return false;
+      continue;
+    }
+
+    float t0 = (box.Min[axis] - origin[axis]) * inverseDirection[axis];
+    float t1 = (box.Max[axis] - origin[axis]) * inverseDirection[axis];
+    entry = std::max(entry, std::min(t0, t1));
+    exit = std::min(exit, std::max(t0, t1));
+  }
+  return entry <= exit;
+}
+
+Bvh::Bvh(float margin)
+  : m_Root(NO_NODE), m_Margin(margin), m_Stats{}
+{
+}
+
+unsigned int Bvh::Insert(const BoundingBox& bounds)
+{
+  unsigned int object;
+  if (!m_FreeObjects.empty())
+  {
+    object = m_FreeObjects.back();
+    m_FreeObjects.pop_back();
+  }
+  else
+  {
+    object = (unsigned int)m_ObjectBounds.size();
+    m_ObjectBounds.push_back(bounds);
+    m_ObjectLeaves.push_back(NO_NODE);
+  }
+
+  int leaf = AllocateNode();
+  m_Nodes[leaf].Bounds = Grow(bounds);
+  m_Nodes[leaf].Object = object;
+  m_ObjectBounds[object] = bounds;
+  m_ObjectLeaves[object] = leaf;
+  InsertLeaf(leaf);
+  m_Stats.Objects++;
+  return object;
+}
+
+void Bvh::Remove(unsigned int object)
+{
+  if (!IsValid(object))
+    return;
+
+  int leaf = m_ObjectLeaves[object];
+  RemoveLeaf(leaf);
+  FreeNode(leaf);
+  m_ObjectLeaves[object] = NO_NODE;
+  m_FreeObjects.push_back(object);
+  m_Stats.Objects--;
+}
+
+bool Bvh::Move(unsigned int object, const BoundingBox& bounds)
+{
+  if (!IsValid(object))
+    return false;
+
+  m_ObjectBounds[object] = bounds;
+  int leaf = m_ObjectLeaves[object];
+  if (m_Nodes[leaf].Bounds.Contains(bounds))
+    return false;
+
+  RemoveLeaf(leaf);
+  m_Nodes[leaf].Bounds = Grow(bounds);
+  InsertLeaf(leaf);
+  m_Stats.Reinserts++;
+  return true;
+}
+
+void Bvh::SetBounds(unsigned int object, const BoundingBox& bounds)
+{
+  if (!IsValid(object))
+    return;
+
+  m_ObjectBounds[object] = bounds;
+  m_Nodes[m_ObjectLeaves[object]].Bounds = Grow(bounds);
+}
+
+void Bvh::Refit()
+{
+  if (m_Root == NO_NODE)
+    return;
+
+  // Parents come before their children in pre-order, so walking it backwards refits bottom up.
+  std::vector<int> order;
+  order.reserve(m_Nodes.size());
+  std::vector<int> stack(1, m_Root);
+  while (!stack.empty())
+  {
+    int node = stack.back();
+    stack.pop_back();
+    order.push_back(node);
+    if (!m_Nodes[node].IsLeaf())
+    {
+      stack.push_back(m_Nodes[node].Left);
+      stack.push_back(m_Nodes[node].Right);
+    }
+  }
+
+  for (auto it = order.rbegin(); it != order.rend(); ++it)
+  {
+    Node& node = m_Nodes[*it];
+    if (!node.IsLeaf())
+      node.Bounds = m_Nodes[node.Left].Bounds.Union(m_Nodes[node.Right].Bounds);
+  }
+}
+
+void Bvh::Rebuild()
+{
+  m_Nodes.clear();
+  m_FreeNodes.clear();
+
+  std::vector<int> leaves;
+  leaves.reserve(m_Stats.Objects);
+  for (unsigned int object = 0; object < m_ObjectLeaves.size(); object++)
+  {
+    if (m_ObjectLeaves[object] == NO_NODE)
+      continue;
+
+    int leaf = AllocateNode();
+    m_Nodes[leaf].Bounds = Grow(m_ObjectBounds[object]);
+    m_Nodes[leaf].Object = object;
+    m_ObjectLeaves[object] = leaf;
+    leaves.push_back(leaf);
+  }
+
+  m_Root = leaves.empty() ? NO_NODE : Build(leaves, 0, leaves.size());
+  if (m_Root != NO_NODE)
+    m_Nodes[m_Root].Parent = NO_NODE;
+}
+
+void Bvh::Clear()
+{
+  m_Nodes.clear();
+  m_FreeNodes.clear();
+  m_ObjectBounds.clear();
+  m_ObjectLeaves.clear();
+  m_FreeObjects.clear();
+  m_Root = NO_NODE;
+  m_Stats = {};
+}
+
+int Bvh::AllocateNode()
+{
+  int node;
+  if (!m_FreeNodes.empty())
+  {
+    node = m_FreeNodes.back();
+    m_FreeNodes.pop_back();
+  }
+  else
+  {
+    node = (int)m_Nodes.size();
+    m_Nodes.emplace_back();
+  }
+
+  Node& allocated = m_Nodes[node];
+  allocated.Parent = NO_NODE;
+  allocated.Left = NO_NODE;
+  allocated.Right = NO_NODE;
+  allocated.Object = INVALID_OBJECT;
+  allocated.Height = 0;
+  return node;
+}
+
+void Bvh::FreeNode(int node)
+{
+  m_FreeNodes.push_back(node);
+}
+
+void Bvh::InsertLeaf(int leaf)
+{
+  if (m_Root == NO_NODE)
+  {
+    m_Root = leaf;
+    m_Nodes[leaf].Parent = NO_NODE;
+    return;
+  }
+
+  // Walk down towards the cheapest sibling: pairing with a node costs the area of the new parent,
+  // and every ancestor on the way grows by the leaf's box.
+  BoundingBox bounds = m_Nodes[leaf].Bounds;
+  int index = m_Root;
+  while (!m_Nodes[index].IsLeaf())
+  {
+    const Node& node = m_Nodes[index];
+    float area = node.Bounds.GetHalfArea();
+    float combinedArea = node.Bounds.Union(bounds).GetHalfArea();
+    float cost = 2.0f * combinedArea;
+    float inheritance = 2.0f * (combinedArea - area);
+
+    float childCosts[2];
+    int children[2] = { node.Left, node.Right };
+    for (int i = 0; i < 2; i++)
+    {
+      const Node& child = m_Nodes[children[i]];
+      float growth = child.Bounds.Union(bounds).GetHalfArea();
+      if (!child.IsLeaf())
+        growth -= child.Bounds.GetHalfArea();
+      childCosts[i] = growth + inheritance;
+    }
+
+    if (cost < childCosts[0] && cost < childCosts[1])
+      break;
+    index = childCosts[0] < childCosts[1] ? children[0] : children[1];
+  }
+
+  int sibling = index;
+  int oldParent = m_Nodes[sibling].Parent;
+  int parent = AllocateNode();
+  m_Nodes[parent].Parent = oldParent;
+  m_Nodes[parent].Bounds = m_Nodes[sibling].Bounds.Union(bounds);
+  m_Nodes[parent].Left = sibling;
+  m_Nodes[parent].Right = leaf;
+  m_Nodes[parent].Height = m_Nodes[sibling].Height + 1;
+
+  if (oldParent == NO_NODE)
+    m_Root = parent;
+  else if (m_Nodes[oldParent].Left == sibling)
+    m_Nodes[oldParent].Left = parent;
+  else
+    m_Nodes[oldParent].Right = parent;
+
+  m_Nodes[sibling].Parent = parent;
+  m_Nodes[leaf].Parent = parent;
+  RefitAncestors(oldParent);
+}
+
+void Bvh::RemoveLeaf(int leaf)
+{
+  if (leaf == m_Root)
+  {
+    m_Root = NO_NODE;
+    return;
+  }
+
+  // The leaf's parent goes too, and its other child takes the parent's place.
+  int parent = m_Nodes[leaf].Parent;
+  int grandparent = m_Nodes[parent].Parent;
+  int sibling = m_Nodes[parent].Left == leaf ? m_Nodes[parent].Right : m_Nodes[parent].Left;
+  m_Nodes[sibling].Parent = grandparent;
+  FreeNode(parent);
+
+  if (grandparent == NO_NODE)
+  {
+    m_Root = sibling;
+    return;
+  }
+
+  if (m_Nodes[grandparent].Left == parent)
+    m_Nodes[grandparent].Left = sibling;
+  else
+    m_Nodes[grandparent].Right = sibling;
+  RefitAncestors(grandparent);
+}
+
+void Bvh::RefitAncestors(int node)
+{
+  while (node != NO_NODE)
+  {
+    Node& current = m_Nodes[node];
+    const Node& left = m_Nodes[current.Left];
+    const Node& right = m_Nodes[current.Right];
+    current.Bounds = left.Bounds.Union(right.Bounds);
+    current.Height = std::max(left.Height, right.Height) + 1;
+    node = current.Parent;
+  }
+}
+
+int Bvh::Build(std::vector<int>& leaves, size_t begin, size_t end)
+{
+  if (end - begin == 1)
+    return leaves[begin];
+
+  BoundingBox centers = { glm::vec3(m_Nodes[leaves[begin]].Bounds.GetCenter()), glm::vec3(m_Nodes[leaves[begin]].Bounds.GetCenter()) };
+  for (size_t i = begin + 1; i < end; i++)
+  {
+    glm::vec3 center = m_Nodes[leaves[i]].Bounds.GetCenter();
+    centers = centers.Union({ center, center });
+  }
+  glm::vec3 size = centers.Max - centers.Min;
+  int axis = size.x >= size.y && size.x >= size.z ? 0 : (size.y >= size.z ? 1 : 2);
+
+  size_t middle = begin + (end - begin) / 2;
+  std::nth_element(leaves.begin() + begin, leaves.begin() + middle, leaves.begin() + end, [this, axis](int a, int b)
+  {
+    return m_Nodes[a].Bounds.Min[axis] + m_Nodes[a].Bounds.Max[axis] < m_Nodes[b].Bounds.Min[axis] + m_Nodes[b].Bounds.Max[axis];
+  });
+
+  int left = Build(leaves, begin, middle);
+  int right = Build(leaves, middle, end);
+  int node = AllocateNode();
+  m_Nodes[node].Left = left;
+  m_Nodes[node].Right = right;
+  m_Nodes[node].Bounds = m_Nodes[left].Bounds.Union(m_Nodes[right].Bounds);
+  m_Nodes[node].Height = std::max(m_Nodes[left].Height, m_Nodes[right].Height) + 1;
+  m_Nodes[left].Parent = node;
+  m_Nodes[right].Parent = node;
+  return node;
+}
+
+BoundingBox Bvh::Grow(const BoundingBox& bounds) const
+{
+  return { bounds.Min - glm::vec3(m_Margin), bounds.Max + glm::vec3(m_Margin) };
+}
+
+void Bvh::CollectSubtree(int node, std::vector<unsigned int>& results) const
+{
+  std::vector<int> stack(1, node);
+  while (!stack.empty())
+  {
+    const Node& current = m_Nodes[stack.back()];
+    stack.pop_back();
+    m_Stats.NodesVisited++;
+
+    if (current.IsLeaf())
+    {
+      results.push_back(current.Object);
+      continue;
+    }
+    stack.push_back(current.Left);
+    stack.push_back(current.Right);
+  }
+}
+
+void Bvh::Query(const Frustum& frustum, std::vector<unsigned int>& results) const
+{
+  struct Entry
+  {
+    int Node;
+    unsigned int PlaneMask;
+  };
+
+  results.clear();
+  m_Stats.NodesVisited = 0;
+  if (m_Root == NO_NODE)
+    return;
+
+  std::vector<Entry> stack(1, { m_Root, Frustum::ALL_PLANES });
+  while (!stack.empty())
+  {
+    Entry entry = stack.back();
+    stack.pop_back();
+    const Node& node = m_Nodes[entry.Node];
+    m_Stats.NodesVisited++;
+
+    Frustum::Containment containment = frustum.Classify(node.Bounds, entry.PlaneMask);
+    if (containment == Frustum::Containment::Outside)
+      continue;
+
+    if (node.IsLeaf())
+    {
+      // The leaf's box is grown, so check the exact one before accepting it.
+      if (containment == Frustum::Containment::Inside || frustum.Classify(m_ObjectBounds[node.Object], entry.PlaneMask) != Frustum::Containment::Outside)
+        results.push_back(node.Object);
+    }
+    else if (containment == Frustum::Containment::Inside)
+      CollectSubtree(entry.Node, results);
+    else
+    {
+      stack.push_back({ node.Left, entry.PlaneMask });
+      stack.push_back({ node.Right, entry.PlaneMask });
+    }
+  }
+}
+
+void Bvh::Query(const BoundingBox& box, std::vector<unsigned int>& results) const
+{
+  results.clear();
+  m_Stats.NodesVisited = 0;
+  if (m_Root == NO_NODE)
+    return;
+
+  std::vector<int> stack(1, m_Root);
+  while (!stack.empty())
+  {
+    const Node& node = m_Nodes[stack.back()];
+    stack.pop_back();
+    m_Stats.NodesVisited++;
+
+    if (!box.Overlaps(node.Bounds))
+      continue;
+
+    if (node.IsLeaf())
+    {
+      if (box.Overlaps(m_ObjectBounds[node.Object]))
+        results.push_back(node.Object);
+    }
+    else
+    {
+      stack.push_back(node.Left);
+      stack.push_back(node.Right);
+    }
+  }
+}
+
+void Bvh::QueryPoint(const glm::vec3& point, std::vector<unsigned int>& results) const
+{
+  Query(BoundingBox{ point, point }, results);
+}
+
+unsigned int Bvh::Raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, float* distance) const
+{
+  m_Stats.NodesVisited = 0;
+  unsigned int closest = INVALID_OBJECT;
+  if (m_Root == NO_NODE)
+    return closest;
+
+  // Zero marks an axis the ray is parallel to, instead of the infinity 1 / 0 would give, which
+  // turns into NaN when multiplied by a zero distance to a slab.
+  glm::vec3 inverseDirection(0.0f);
+  for (int axis = 0; axis < 3; axis++)
+  {
+    if (direction[axis] != 0.0f)
+      inverseDirection[axis] = 1.0f / direction[axis];
+  }
+  float closestDistance = maxDistance;
+  std::vector<int> stack(1, m_Root);
+  while (!stack.empty())
+  {
+    const Node& node = m_Nodes[stack.back()];
+    stack.pop_back();
+    m_Stats.NodesVisited++;
+
+    float entry;
+    if (!IntersectRay(node.Bounds, origin, inverseDirection, closestDistance, entry))
+      continue;
+
+    if (node.IsLeaf())
+    {
+      if (IntersectRay(m_ObjectBounds[node.Object], origin, inverseDirection, closestDistance, entry))
+      {
+        closest = node.Object;
+        closestDistance = entry;
+      }
+      continue;
+    }
+
+    // Visit the nearer child first so it can shorten the ray for the other.
+    float leftEntry, rightEntry;
+    bool hitLeft = IntersectRay(m_Nodes[node.Left].Bounds, origin, inverseDirection, closestDistance, leftEntry);
+    bool hitRight = IntersectRay(m_Nodes[node.Right].Bounds, origin, inverseDirection, closestDistance, rightEntry);
+    if (hitLeft && hitRight)
+    {
+      bool leftFirst = leftEntry <= rightEntry;
+      stack.push_back(leftFirst ? node.Right : node.Left);
+      stack.push_back(leftFirst ? node.Left : node.Right);
+    }
+    else if (hitLeft)
+      stack.push_back(node.Left);
+    else if (hitRight)
+      stack.push_back(node.Right);
+  }
+
+  if (distance && closest != INVALID_OBJECT)
+    *distance = closestDistance;
+  return closest;
+}
+
+const Bvh::Stats& Bvh::GetStats() const
+{
+  m_Stats.Nodes = (unsigned int)(m_Nodes.size() - m_FreeNodes.size());
+  m_Stats.Height = m_Root == NO_NODE ? 0 : m_Nodes[m_Root].Height;
+  return m_Stats;
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <vector>
+
+#include "Bounds.h"
+#include "Frustum.h"
+
+// Dynamic bounding volume hierarchy of axis aligned boxes, one object per leaf. Leaves hold the
+// object's box grown by a margin, so small moves don't touch the tree. Objects are inserted next
+// to the sibling that grows the tree's surface area least; Rebuild re-splits everything top down
+// for a better tree once a scene is loaded, and Refit updates the boxes of a tree whose objects
+// all moved a little without changing its shape.
+class Bvh
+{
+public:
+  static constexpr unsigned int INVALID_OBJECT = 0xFFFFFFFF;
+
+  struct Stats
+  {
+    unsigned int Objects;
+    unsigned int Nodes;
+    unsigned int Height;
+    unsigned int NodesVisited; // By the last query.
+    unsigned int Reinserts;
+  };
+
+private:
+  static constexpr int NO_NODE = -1;
+
+  struct Node
+  {
+    BoundingBox Bounds;
+    int Parent;
+    int Left, Right; // NO_NODE for leaves.
+    unsigned int Object;
+    unsigned int Height; // Zero for leaves.
+
+    inline bool IsLeaf() const { return Left == NO_NODE; }
+  };
+
+  std::vector<Node> m_Nodes;
+  std::vector<int> m_FreeNodes;
+  std::vector<BoundingBox> m_ObjectBounds; // Exact, the leaves hold them grown by the margin.
+  std::vector<int> m_ObjectLeaves; // NO_NODE while the id is free.
+  std::vector<unsigned int> m_FreeObjects;
+  int m_Root;
+  float m_Margin;
+  mutable Stats m_Stats;
+
+public:
+  Bvh(float margin = 0.1f);
+
+  // Returns the new object's id.
+  unsigned int Insert(const BoundingBox& bounds);
+  void Remove(unsigned int object);
+  // Only reinserts the object when it leaves its grown box. Returns true if it did.
+  bool Move(unsigned int object, const BoundingBox& bounds);
+  // Changes an object's box without fixing its ancestors; call Refit after a batch of these.
+  void SetBounds(unsigned int object, const BoundingBox& bounds);
+  // Recomputes every parent's box from its children, keeping the tree's shape.
+  void Refit();
+  // Rebuilds the tree top down, splitting each node at the median of its longest axis.
+  void Rebuild();
+  void Clear();
+
+  inline const BoundingBox& GetBounds(unsigned int object) const { return m_ObjectBounds[object]; }
+  inline bool IsValid(unsigned int object) const { return object < m_ObjectLeaves.size() && m_ObjectLeaves[object] != NO_NODE; }
+
+  // Each query replaces the contents of results with the ids of the objects found.
+  void Query(const Frustum& frustum, std::vector<unsigned int>& results) const;
+  void Query(const BoundingBox& box, std::vector<unsigned int>& results) const;
+  void QueryPoint(const glm::vec3& point, std::vector<unsigned int>& results) const;
+  // Picking: the object whose box the ray enters first within maxDistance, or INVALID_OBJECT.
+  unsigned int Raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, float* distance = nullptr) const;
+
+  const Stats& GetStats() const;
+private:
+  int AllocateNode();
+  void FreeNode(int node);
+  void InsertLeaf(int leaf);
+  void RemoveLeaf(int leaf);
+  // Fixes the boxes and heights from node up to the root.
+  void RefitAncestors(int node);
+  int Build(std::vector<int>& leaves, size_t begin, size_t end);
+  BoundingBox Grow(const BoundingBox& bounds) const;
+  void CollectSubtree(int node, std::vector<unsigned int>& results) const;
+};
@@ -0,0 +1,132 @@
+#include <iostream>
+
+#include "ComputeShader.h"
+#include "Renderer.h"
+#include "VirtualFileSystem.h"
+
+ComputeShader::ComputeShader(const std::string& filePath)
+  : m_FilePath(filePath), m_LocalSize{ 1, 1, 1 }
+{
+  if (!IsSupported())
+  {
+    std::cout << "[ERROR] [OPENGL]: Compute shaders need OpenGL 4.3, can't load '" << filePath << "'" << std::endl;
+    return;
+  }
+
+  FileView file = VirtualFileSystem::Get().Open(filePath);
+  if (!file.IsValid())
+  {
+    std::cout << "[ERROR] [OPENGL]: Shader file '" << filePath << "' not found!" << std::endl;
+    return;
+  }
+
+  std::string source = file.ToString();
+  const char* src = source.c_str();
+  OpenGLCall(unsigned int shader = glCreateShader(GL_COMPUTE_SHADER));
+  OpenGLCall(glShaderSource(shader, 1, &src, nullptr));
+  OpenGLCall(glCompileShader(shader));
+
+  int result;
+  OpenGLCall(glGetShaderiv(shader, GL_COMPILE_STATUS, &result));
+  if (result == GL_FALSE)
+  {
+    int length;
+    OpenGLCall(glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &length));
+    std::string message(length, '\0');
+    OpenGLCall(glGetShaderInfoLog(shader, length, &length, &message[0]));
+    std::cout << "Failed to compile compute shader '" << filePath << "'!" << std::endl;
+    std::cout << message << std::endl;
+    OpenGLCall(glDeleteShader(shader));
+    return;
+  }
+
+  OpenGLCall(unsigned int program = glCreateProgram());
+  m_RendererId.Reset(program);
+  OpenGLCall(glAttachShader(m_RendererId.Get(), shader));
+  OpenGLCall(glLinkProgram(m_RendererId.Get()));
+  OpenGLCall(glDeleteShader(shader));
+
+  OpenGLCall(glGetProgramiv(m_RendererId.Get(), GL_LINK_STATUS, &result));
+  if (result == GL_FALSE)
+  {
+    std::cout << "Failed to link compute shader '" << filePath << "'!" << std::endl;
+    m_RendererId.Reset();
+    return;
+  }
+
+  OpenGLCall(glGetProgramiv(m_RendererId.Get(), GL_COMPUTE_WORK_GROUP_SIZE, m_LocalSize));
+}
+
+bool ComputeShader::IsSupported()
+{
+  return GLEW_VERSION_4_3 || GLEW_ARB_compute_shader;
+}
+
+void ComputeShader::Bind() const
+{
+  OpenGLCall(glUseProgram(m_RendererId.Get()));
+}
+
+void ComputeShader::Unbind() const
+{
+  OpenGLCall(glUseProgram(0));
+}
+
+void ComputeShader::Dispatch(unsigned int x, unsigned int y, unsigned int z) const
+{
+  DispatchGroups((x + m_LocalSize[0] - 1) / m_LocalSize[0], (y + m_LocalSize[1] - 1) / m_LocalSize[1],
+    (z + m_LocalSize[2] - 1) / m_LocalSize[2]);
+}
+
+void ComputeShader::DispatchGroups(unsigned int groupsX, unsigned int groupsY, unsigned int groupsZ) const
+{
+  if (groupsX == 0 || groupsY == 0 || groupsZ == 0)
+    return;
+
+  Bind();
+  OpenGLCall(glDispatchCompute(groupsX, groupsY, groupsZ));
+}
+
+void ComputeShader::Barrier(unsigned int bits)
+{
+  OpenGLCall(glMemoryBarrier(bits));
+}
+
+void ComputeShader::SetUniform1i(const char* name, int value)
+{
+  OpenGLCall(glUniform1i(GetUniformLocation(name), value));
+}
+
+void ComputeShader::SetUniform1ui(const char* name, unsigned int value)
+{
+  OpenGLCall(glUniform1ui(GetUniformLocation(name), value));
+}
+
+void ComputeShader::SetUniform1f(const char* name, float value)
+{
+  OpenGLCall(glUniform1f(GetUniformLocation(name), value));
+}
+
+void ComputeShader::SetUniform4fv(const char* name, int count, const glm::vec4* values)
+{
+  OpenGLCall(glUniform4fv(GetUniformLocation(name), count, &values[0][0]));
+}
+
+void ComputeShader::SetUniformMat4f(const char* name, const glm::mat4& matrix)
+{
+  OpenGLCall(glUniformMatrix4fv(GetUniformLocation(name), 1, GL_FALSE, &matrix[0][0]));
+}
+
+int ComputeShader::GetUniformLocation(const char* name)
+{
+  const int* cached = m_UniformLocationCache.Find(name);
+  if (cached)
+    return *cached;
+
+  OpenGLCall(int location = glGetUniformLocation(m_RendererId.Get(), name));
+  if (location == -1)
+    std::cout << "[WARNING] [OPENGL]: Uniform '" << name << "' doesn't exist!" << std::endl;
+
+  m_UniformLocationCache.Add(name, location);
+  return location;
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <string>
+
+#include "GLHandle.h"
+#include "UniformLocationCache.h"
+
+// Single compute stage program. Needs OpenGL 4.3 or ARB_compute_shader; check IsSupported first.
+class ComputeShader
+{
+private:
+  std::string m_FilePath;
+  ProgramHandle m_RendererId;
+  int m_LocalSize[3];
+  UniformLocationCache m_UniformLocationCache;
+public:
+  ComputeShader(const std::string& filePath);
+
+  ComputeShader(ComputeShader&&) = default;
+  ComputeShader& operator=(ComputeShader&&) = default;
+
+  void Bind() const;
+  void Unbind() const;
+
+  // Dispatches enough work groups to cover the given number of invocations in each dimension,
+  // using the local size declared in the shader.
+  void Dispatch(unsigned int x, unsigned int y = 1, unsigned int z = 1) const;
+  void DispatchGroups(unsigned int groupsX, unsigned int groupsY = 1, unsigned int groupsZ = 1) const;
+
+  void SetUniform1i(const char* name, int value);
+  void SetUniform1ui(const char* name, unsigned int value);
+  void SetUniform1f(const char* name, float value);
+  void SetUniform4fv(const char* name, int count, const glm::vec4* values);
+  void SetUniformMat4f(const char* name, const glm::mat4& matrix);
+
+  inline bool IsValid() const { return static_cast<bool>(m_RendererId); }
+
+  static bool IsSupported();
+  // Makes writes from earlier dispatches visible to the accesses named by the GL_*_BARRIER_BIT flags.
+  static void Barrier(unsigned int bits);
+private:
+  int GetUniformLocation(const char* name);
+};
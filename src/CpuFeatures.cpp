@@ -0,0 +1,88 @@
+#include "CpuFeatures.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+
+static void QueryCpuid(int leaf, int subleaf, int registers[4])
+{
+#if defined(_MSC_VER)
+  __cpuidex(registers, leaf, subleaf);
+#else
+  unsigned int a, b, c, d;
+  __cpuid_count(leaf, subleaf, a, b, c, d);
+  registers[0] = (int)a;
+  registers[1] = (int)b;
+  registers[2] = (int)c;
+  registers[3] = (int)d;
+#endif
+}
+
+// Whether the OS saves the YMM registers on context switches, without which AVX can't be used.
+static bool IsAvxStateEnabled()
+{
+#if defined(_MSC_VER)
+  unsigned long long xcr0 = _xgetbv(0);
+#else
+  unsigned int low, high;
+  __asm__("xgetbv" : "=a"(low), "=d"(high) : "c"(0));
+  unsigned long long xcr0 = ((unsigned long long)high << 32) | low;
+#endif
+  return (xcr0 & 0x6) == 0x6;
+}
+
+static CpuFeatures Detect()
+{
+  CpuFeatures features = {};
+  int registers[4];
+
+  QueryCpuid(0, 0, registers);
+  int maxLeaf = registers[0];
+
+  QueryCpuid(1, 0, registers);
+  features.Sse41 = (registers[2] & (1 << 19)) != 0;
+  bool osxsave = (registers[2] & (1 << 27)) != 0;
+  features.Avx = (registers[2] & (1 << 28)) != 0 && osxsave && IsAvxStateEnabled();
+  features.Fma = (registers[2] & (1 << 12)) != 0 && features.Avx;
+
+  if (maxLeaf >= 7)
+  {
+    QueryCpuid(7, 0, registers);
+    features.Avx2 = (registers[1] & (1 << 5)) != 0 && features.Avx;
+  }
+  return features;
+}
+
+const CpuFeatures& CpuFeatures::Get()
+{
+  static const CpuFeatures features = Detect();
+  return features;
+}
+
+bool IsSimdKernelSupported(SimdKernel kernel)
+{
+  switch (kernel)
+  {
+    case SimdKernel::Avx2:
+      return CpuFeatures::Get().Avx2 && CpuFeatures::Get().Fma;
+    default:
+      return true;
+  }
+}
+
+SimdKernel GetBestSimdKernel()
+{
+  return IsSimdKernelSupported(SimdKernel::Avx2) ? SimdKernel::Avx2 : SimdKernel::Sse;
+}
+
+const char* GetSimdKernelName(SimdKernel kernel)
+{
+  switch (kernel)
+  {
+    case SimdKernel::Sse: return "SSE";
+    case SimdKernel::Avx2: return "AVX2";
+    default: return "Scalar";
+  }
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+// Marks a function whose body uses AVX2 intrinsics. MSVC compiles those in any function; GCC and
+// Clang need the target enabled per function so the rest of the file stays baseline x64.
+#if defined(__GNUC__)
+#define SIMD_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#else
+#define SIMD_TARGET_AVX2
+#endif
+
+// Instruction set extensions of the CPU we're running on, detected once with cpuid. SSE2 is part
+// of x64 so it's always available; anything newer must be checked before taking a SIMD path.
+struct CpuFeatures
+{
+  bool Sse41;
+  bool Avx;
+  bool Avx2;
+  bool Fma;
+
+  static const CpuFeatures& Get();
+};
+
+// Code paths of the batch kernels: one lane at a time, four with SSE or eight with AVX2.
+enum class SimdKernel
+{
+  Scalar, Sse, Avx2
+};
+
+// AVX2 kernels are also allowed to use FMA, so both are required.
+bool IsSimdKernelSupported(SimdKernel kernel);
+SimdKernel GetBestSimdKernel();
+const char* GetSimdKernelName(SimdKernel kernel);
@@ -0,0 +1,11 @@
+#pragma once
+
+// Layout of one glMultiDrawElementsIndirect command.
+struct DrawElementsIndirectCommand
+{
+  unsigned int Count;
+  unsigned int InstanceCount;
+  unsigned int FirstIndex;
+  int BaseVertex;
+  unsigned int BaseInstance;
+};
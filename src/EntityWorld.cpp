@@ -0,0 +1,330 @@
+#include <algorithm>
+#include <iostream>
+#include <mutex>
+
+#include "EntityWorld.h"
+#include "PoolAllocator.h"
+
+static std::mutex s_ComponentMutex;
+static std::vector<ComponentInfo> s_Components;
+
+ComponentTypeId RegisterComponentType(size_t size, size_t alignment)
+{
+  std::lock_guard<std::mutex> lock(s_ComponentMutex);
+  s_Components.push_back({ size, alignment });
+  return (ComponentTypeId)(s_Components.size() - 1);
+}
+
+ComponentInfo GetComponentInfo(ComponentTypeId type)
+{
+  std::lock_guard<std::mutex> lock(s_ComponentMutex);
+  return s_Components[type];
+}
+
+static PoolAllocator& GetChunkPool()
+{
+  static PoolAllocator pool(Archetype::CHUNK_SIZE, 16);
+  return pool;
+}
+
+static size_t AlignUp(size_t offset, size_t alignment)
+{
+  return (offset + alignment - 1) / alignment * alignment;
+}
+
+Archetype::Archetype(const std::vector<ComponentTypeId>& types)
+  : m_Types(types), m_Capacity(0), m_EntityCount(0)
+{
+  size_t rowSize = sizeof(Entity);
+  std::vector<size_t> alignments;
+  for (ComponentTypeId type : m_Types)
+  {
+    ComponentInfo info = GetComponentInfo(type);
+    m_Sizes.push_back(info.Size);
+    alignments.push_back(info.Alignment);
+    rowSize += info.Size;
+  }
+
+  // Start from the capacity ignoring padding and shrink until the aligned arrays fit.
+  m_Offsets.resize(m_Types.size());
+  for (size_t capacity = CHUNK_SIZE / rowSize; capacity > 0; capacity--)
+  {
+    size_t offset = capacity * sizeof(Entity);
+    for (size_t column = 0; column < m_Types.size(); column++)
+    {
+      offset = AlignUp(offset, alignments[column]);
+      m_Offsets[column] = offset;
+      offset += capacity * m_Sizes[column];
+    }
+
+    if (offset <= CHUNK_SIZE)
+    {
+      m_Capacity = (uint32_t)capacity;
+      break;
+    }
+  }
+
+  if (m_Capacity == 0)
+    std::cout << "[ERROR] [ECS]: Components of " << rowSize << " bytes per entity don't fit in a " << CHUNK_SIZE << " byte chunk" << std::endl;
+}
+
+int Archetype::GetColumn(ComponentTypeId type) const
+{
+  auto it = std::lower_bound(m_Types.begin(), m_Types.end(), type);
+  return it != m_Types.end() && *it == type ? (int)(it - m_Types.begin()) : -1;
+}
+
+Archetype::~Archetype()
+{
+  FreeChunks();
+}
+
+void Archetype::FreeChunks()
+{
+  for (Chunk& chunk : m_Chunks)
+    GetChunkPool().Free(chunk.Data);
+  m_Chunks.clear();
+}
+
+void Archetype::Allocate(Entity entity, uint32_t& chunk, uint32_t& row)
+{
+  if (m_Chunks.empty() || m_Chunks.back().Count == m_Capacity)
+    m_Chunks.push_back({ static_cast<unsigned char*>(GetChunkPool().Allocate()), 0 });
+
+  chunk = (uint32_t)(m_Chunks.size() - 1);
+  row = m_Chunks.back().Count++;
+  GetEntities(chunk)[row] = entity;
+  for (size_t column = 0; column < m_Types.size(); column++)
+    std::memset(GetComponent(chunk, row, (int)column), 0, m_Sizes[column]);
+  m_EntityCount++;
+}
+
+Entity Archetype::Free(uint32_t chunk, uint32_t row)
+{
+  uint32_t lastChunk = (uint32_t)(m_Chunks.size() - 1);
+  uint32_t lastRow = m_Chunks.back().Count - 1;
+  Entity moved;
+  if (chunk != lastChunk || row != lastRow)
+  {
+    moved = GetEntities(lastChunk)[lastRow];
+    GetEntities(chunk)[row] = moved;
+    for (size_t column = 0; column < m_Types.size(); column++)
+      std::memcpy(GetComponent(chunk, row, (int)column), GetComponent(lastChunk, lastRow, (int)column), m_Sizes[column]);
+  }
+
+  if (--m_Chunks.back().Count == 0)
+  {
+    GetChunkPool().Free(m_Chunks.back().Data);
+    m_Chunks.pop_back();
+  }
+  m_EntityCount--;
+  return moved;
+}
+
+EntityWorld::EntityWorld()
+{
+  GetArchetype({});
+}
+
+Entity EntityWorld::CreateEntity()
+{
+  return CreateEntity(m_ArchetypeLookup[std::vector<ComponentTypeId>()]);
+}
+
+Entity EntityWorld::CreateEntity(Archetype* archetype)
+{
+  if (archetype->GetCapacity() == 0)
+    return Entity();
+
+  uint32_t index;
+  if (!m_FreeEntities.empty())
+  {
+    index = m_FreeEntities.back();
+    m_FreeEntities.pop_back();
+  }
+  else
+  {
+    index = (uint32_t)m_Records.size();
+    m_Records.push_back({ nullptr, 0, 0, 0 });
+  }
+
+  EntityRecord& record = m_Records[index];
+  Entity entity(index, record.Generation);
+  record.Storage = archetype;
+  archetype->Allocate(entity, record.Chunk, record.Row);
+  return entity;
+}
+
+void EntityWorld::DestroyEntity(Entity entity)
+{
+  if (!IsAlive(entity))
+    return;
+
+  EntityRecord& record = m_Records[entity.Index];
+  FreeRow(record.Storage, record.Chunk, record.Row);
+  record.Storage = nullptr;
+  record.Generation++;
+  m_FreeEntities.push_back(entity.Index);
+}
+
+bool EntityWorld::IsAlive(Entity entity) const
+{
+  return entity.Index < m_Records.size() && m_Records[entity.Index].Storage &&
+    m_Records[entity.Index].Generation == entity.Generation;
+}
+
+bool EntityWorld::CheckAlive(Entity entity) const
+{
+  if (IsAlive(entity))
+    return true;
+
+  std::cout << "[ERROR] [ECS]: Entity " << entity.Index << " (generation " << entity.Generation << ") is not alive" << std::endl;
+  return false;
+}
+
+void EntityWorld::Clear()
+{
+  // Archetypes and queries stay, only emptied, so the next scene with the same components
+  // doesn't have to find them again.
+  for (EntityRecord& record : m_Records)
+  {
+    if (record.Storage)
+    {
+      record.Storage = nullptr;
+      record.Generation++;
+    }
+  }
+  m_FreeEntities.clear();
+  for (uint32_t index = (uint32_t)m_Records.size(); index > 0; index--)
+    m_FreeEntities.push_back(index - 1);
+
+  for (std::unique_ptr<Archetype>& archetype : m_Archetypes)
+  {
+    archetype->FreeChunks();
+    archetype->m_EntityCount = 0;
+  }
+}
+
+void* EntityWorld::GetComponentData(Entity entity, ComponentTypeId type)
+{
+  if (!IsAlive(entity))
+    return nullptr;
+
+  const EntityRecord& record = m_Records[entity.Index];
+  int column = record.Storage->GetColumn(type);
+  return column >= 0 ? record.Storage->GetComponent(record.Chunk, record.Row, column) : nullptr;
+}
+
+Archetype* EntityWorld::GetArchetype(std::vector<ComponentTypeId> types)
+{
+  std::sort(types.begin(), types.end());
+  types.erase(std::unique(types.begin(), types.end()), types.end());
+
+  auto it = m_ArchetypeLookup.find(types);
+  if (it != m_ArchetypeLookup.end())
+    return it->second;
+
+  m_Archetypes.push_back(std::make_unique<Archetype>(types));
+  Archetype* archetype = m_Archetypes.back().get();
+  m_ArchetypeLookup[types] = archetype;
+  return archetype;
+}
+
+Archetype* EntityWorld::GetArchetypeWith(Archetype* archetype, ComponentTypeId type)
+{
+  Archetype*& edge = archetype->m_AddEdges[type];
+  if (!edge)
+  {
+    std::vector<ComponentTypeId> types = archetype->GetTypes();
+    types.push_back(type);
+    edge = GetArchetype(types);
+  }
+  return edge;
+}
+
+Archetype* EntityWorld::GetArchetypeWithout(Archetype* archetype, ComponentTypeId type)
+{
+  Archetype*& edge = archetype->m_RemoveEdges[type];
+  if (!edge)
+  {
+    std::vector<ComponentTypeId> types = archetype->GetTypes();
+    types.erase(std::remove(types.begin(), types.end(), type), types.end());
+    edge = GetArchetype(types);
+  }
+  return edge;
+}
+
+bool EntityWorld::MoveEntity(Entity entity, Archetype* destination)
+{
+  if (destination->GetCapacity() == 0)
+    return false;
+
+  EntityRecord& record = m_Records[entity.Index];
+  Archetype* source = record.Storage;
+  uint32_t chunk, row;
+  destination->Allocate(entity, chunk, row);
+
+  // Components the destination doesn't have are dropped, ones the source didn't have stay zeroed.
+  const std::vector<ComponentTypeId>& types = destination->GetTypes();
+  for (size_t column = 0; column < types.size(); column++)
+  {
+    int sourceColumn = source->GetColumn(types[column]);
+    if (sourceColumn >= 0)
+      std::memcpy(destination->GetComponent(chunk, row, (int)column), source->GetComponent(record.Chunk, record.Row, sourceColumn), destination->m_Sizes[column]);
+  }
+
+  FreeRow(source, record.Chunk, record.Row);
+  record.Storage = destination;
+  record.Chunk = chunk;
+  record.Row = row;
+  return true;
+}
+
+void EntityWorld::FreeRow(Archetype* archetype, uint32_t chunk, uint32_t row)
+{
+  Entity moved = archetype->Free(chunk, row);
+  if (moved.Index != Entity().Index)
+  {
+    m_Records[moved.Index].Chunk = chunk;
+    m_Records[moved.Index].Row = row;
+  }
+}
+
+const std::vector<Archetype*>& EntityWorld::GetMatchingArchetypes(const ComponentTypeId* types, size_t count)
+{
+  Query* found = nullptr;
+  for (Query& query : m_Queries)
+  {
+    if (query.Types.size() == count && std::equal(types, types + count, query.Types.begin()))
+    {
+      found = &query;
+      break;
+    }
+  }
+  if (!found)
+  {
+    m_Queries.push_back({ std::vector<ComponentTypeId>(types, types + count), {}, 0 });
+    found = &m_Queries.back();
+  }
+
+  // Archetypes are only ever added, so a cached query just checks the new ones.
+  Query& query = *found;
+  for (; query.ArchetypesChecked < m_Archetypes.size(); query.ArchetypesChecked++)
+  {
+    Archetype* archetype = m_Archetypes[query.ArchetypesChecked].get();
+    const std::vector<ComponentTypeId>& archetypeTypes = archetype->GetTypes();
+    if (std::includes(archetypeTypes.begin(), archetypeTypes.end(), types, types + count))
+      query.Matches.push_back(archetype);
+  }
+  return query.Matches;
+}
+
+EntityWorld::Stats EntityWorld::GetStats() const
+{
+  Stats stats = {};
+  stats.Entities = (unsigned int)(m_Records.size() - m_FreeEntities.size());
+  stats.Archetypes = (unsigned int)m_Archetypes.size();
+  for (const std::unique_ptr<Archetype>& archetype : m_Archetypes)
+    stats.Chunks += (unsigned int)archetype->GetChunkCount();
+  return stats;
+}
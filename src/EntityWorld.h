@@ -0,0 +1,281 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "FrameAllocator.h"
+#include "JobSystem.h"
+
+// Reference to an entity in an EntityWorld. The generation goes up when an entity is destroyed, so
+// references to it stop being alive even after its index is reused.
+struct Entity
+{
+  uint32_t Index;
+  uint32_t Generation;
+
+  Entity() : Index(0xFFFFFFFF), Generation(0) {}
+  Entity(uint32_t index, uint32_t generation) : Index(index), Generation(generation) {}
+
+  inline bool operator==(const Entity& other) const { return Index == other.Index && Generation == other.Generation; }
+  inline bool operator!=(const Entity& other) const { return !(*this == other); }
+};
+
+typedef uint32_t ComponentTypeId;
+
+struct ComponentInfo
+{
+  size_t Size;
+  size_t Alignment;
+};
+
+ComponentTypeId RegisterComponentType(size_t size, size_t alignment);
+ComponentInfo GetComponentInfo(ComponentTypeId type);
+
+// Sequential id of a component type, assigned the first time the type is used. Components are
+// plain data: they're moved between chunks with memcpy and never destructed.
+template<typename T>
+ComponentTypeId GetComponentTypeId()
+{
+  static_assert(std::is_trivially_copyable<T>::value, "Components must be trivially copyable");
+  static_assert(alignof(T) <= alignof(std::max_align_t), "Components can't be over-aligned");
+  static const ComponentTypeId id = RegisterComponentType(sizeof(T), alignof(T));
+  return id;
+}
+
+// Every entity with exactly the same set of component types. They're stored in fixed size chunks,
+// each holding an array of entities and one array per component type, so walking a component
+// touches contiguous memory. Removing an entity moves the archetype's last one into its place.
+// Chunks come from a pool shared by every archetype, so emptied chunks are reused rather than
+// going back to the heap. A component set too big for one entity per chunk gets zero capacity, and
+// the world refuses to put entities in it.
+class Archetype
+{
+public:
+  static constexpr size_t CHUNK_SIZE = 16 * 1024;
+
+  struct Chunk
+  {
+    unsigned char* Data;
+    uint32_t Count;
+  };
+
+private:
+  std::vector<ComponentTypeId> m_Types; // Sorted.
+  std::vector<size_t> m_Sizes;
+  std::vector<size_t> m_Offsets; // Of each component array within a chunk.
+  uint32_t m_Capacity;
+  std::vector<Chunk> m_Chunks;
+  size_t m_EntityCount;
+  // Archetypes one component away, filled in as entities move between them.
+  std::map<ComponentTypeId, Archetype*> m_AddEdges, m_RemoveEdges;
+
+  friend class EntityWorld;
+
+public:
+  Archetype(const std::vector<ComponentTypeId>& types);
+  ~Archetype();
+
+  Archetype(const Archetype&) = delete;
+  Archetype& operator=(const Archetype&) = delete;
+
+  // Index of the type's array, or -1 if these entities don't have it.
+  int GetColumn(ComponentTypeId type) const;
+
+  inline const std::vector<ComponentTypeId>& GetTypes() const { return m_Types; }
+  inline uint32_t GetCapacity() const { return m_Capacity; }
+  inline size_t GetEntityCount() const { return m_EntityCount; }
+  inline size_t GetChunkCount() const { return m_Chunks.size(); }
+  inline uint32_t GetCount(size_t chunk) const { return m_Chunks[chunk].Count; }
+  inline Entity* GetEntities(size_t chunk) { return reinterpret_cast<Entity*>(m_Chunks[chunk].Data); }
+  inline void* GetColumnData(size_t chunk, int column) { return m_Chunks[chunk].Data + m_Offsets[column]; }
+  inline void* GetComponent(size_t chunk, uint32_t row, int column) { return m_Chunks[chunk].Data + m_Offsets[column] + row * m_Sizes[column]; }
+private:
+  // Appends a row for entity, with its components zeroed.
+  void Allocate(Entity entity, uint32_t& chunk, uint32_t& row);
+  // Returns the entity moved into the freed row, or an invalid one if the row was the last.
+  Entity Free(uint32_t chunk, uint32_t row);
+  void FreeChunks();
+};
+
+// Entities and their components, grouped by archetype. Queries go through the archetypes that
+// have every requested component and hand out references straight from the chunk arrays.
+class EntityWorld
+{
+public:
+  struct Stats
+  {
+    unsigned int Entities;
+    unsigned int Archetypes;
+    unsigned int Chunks;
+  };
+
+private:
+  struct EntityRecord
+  {
+    Archetype* Storage; // Null while the index is free.
+    uint32_t Chunk, Row;
+    uint32_t Generation;
+  };
+
+  struct Query
+  {
+    std::vector<ComponentTypeId> Types; // Sorted.
+    std::vector<Archetype*> Matches;
+    size_t ArchetypesChecked;
+  };
+
+  std::vector<EntityRecord> m_Records;
+  std::vector<uint32_t> m_FreeEntities;
+  std::vector<std::unique_ptr<Archetype>> m_Archetypes;
+  std::map<std::vector<ComponentTypeId>, Archetype*> m_ArchetypeLookup;
+  std::deque<Query> m_Queries; // Few enough to search linearly; a deque keeps Matches in place.
+
+public:
+  EntityWorld();
+
+  EntityWorld(const EntityWorld&) = delete;
+  EntityWorld& operator=(const EntityWorld&) = delete;
+
+  Entity CreateEntity();
+  template<typename... Components>
+  Entity CreateEntity(const Components&... components)
+  {
+    std::vector<ComponentTypeId> types = { GetComponentTypeId<Components>()... };
+    Entity entity = CreateEntity(GetArchetype(types));
+    if (!IsAlive(entity))
+      return entity;
+    int unused[] = { 0, (std::memcpy(GetComponentData(entity, GetComponentTypeId<Components>()), &components, sizeof(Components)), 0)... };
+    (void)unused;
+    return entity;
+  }
+  void DestroyEntity(Entity entity);
+  bool IsAlive(Entity entity) const;
+  void Clear();
+
+  // Adding a component the entity already has overwrites it. Returns the stored component, or null
+  // if the entity isn't alive or its components would no longer fit in a chunk.
+  template<typename T>
+  T* AddComponent(Entity entity, const T& component)
+  {
+    if (!CheckAlive(entity))
+      return nullptr;
+
+    ComponentTypeId type = GetComponentTypeId<T>();
+    void* data = GetComponentData(entity, type);
+    if (!data)
+    {
+      if (!MoveEntity(entity, GetArchetypeWith(m_Records[entity.Index].Storage, type)))
+        return nullptr;
+      data = GetComponentData(entity, type);
+    }
+    std::memcpy(data, &component, sizeof(T));
+    return static_cast<T*>(data);
+  }
+
+  template<typename T>
+  void RemoveComponent(Entity entity)
+  {
+    ComponentTypeId type = GetComponentTypeId<T>();
+    if (GetComponentData(entity, type))
+      MoveEntity(entity, GetArchetypeWithout(m_Records[entity.Index].Storage, type));
+  }
+
+  // Null if the entity doesn't have the component. Invalidated by any change to the entity's
+  // components or by destroying entities of the same archetype.
+  template<typename T>
+  T* GetComponent(Entity entity) { return static_cast<T*>(GetComponentData(entity, GetComponentTypeId<T>())); }
+  template<typename T>
+  bool HasComponent(Entity entity) { return GetComponentData(entity, GetComponentTypeId<T>()) != nullptr; }
+
+  // Calls function(Entity, Components&...) for every entity with all of Components. The function
+  // mustn't create or destroy entities or change which components they have.
+  template<typename... Components, typename Function>
+  void ForEach(Function function)
+  {
+    for (Archetype* archetype : GetMatchingArchetypes<Components...>())
+    {
+      std::array<int, sizeof...(Components)> columns = { { archetype->GetColumn(GetComponentTypeId<Components>())... } };
+      for (size_t chunk = 0; chunk < archetype->GetChunkCount(); chunk++)
+        ForEachInChunk<Components...>(*archetype, chunk, columns.data(), function, std::index_sequence_for<Components...>());
+    }
+  }
+
+  // As ForEach, with the chunks shared out as jobs. The function may run on several threads at
+  // once, each with different entities.
+  template<typename... Components, typename Function>
+  void ParallelForEach(Function function)
+  {
+    struct Work
+    {
+      Archetype* Owner;
+      size_t Chunk;
+      std::array<int, sizeof...(Components)> Columns;
+    };
+
+    const std::vector<Archetype*>& archetypes = GetMatchingArchetypes<Components...>();
+    size_t chunks = 0;
+    for (Archetype* archetype : archetypes)
+      chunks += archetype->GetChunkCount();
+
+    FrameVector<Work> work;
+    work.reserve(chunks);
+    for (Archetype* archetype : archetypes)
+    {
+      std::array<int, sizeof...(Components)> columns = { { archetype->GetColumn(GetComponentTypeId<Components>())... } };
+      for (size_t chunk = 0; chunk < archetype->GetChunkCount(); chunk++)
+        work.push_back({ archetype, chunk, columns });
+    }
+
+    JobSystem::Get().ParallelFor(work.size(), 1, [&work, &function](size_t begin, size_t end)
+    {
+      for (size_t i = begin; i < end; i++)
+        ForEachInChunk<Components...>(*work[i].Owner, work[i].Chunk, work[i].Columns.data(), function, std::index_sequence_for<Components...>());
+    });
+  }
+
+  Stats GetStats() const;
+private:
+  // Returns an entity that isn't alive if the archetype can't hold any.
+  Entity CreateEntity(Archetype* archetype);
+  // Logs an error for entities that aren't alive.
+  bool CheckAlive(Entity entity) const;
+  void* GetComponentData(Entity entity, ComponentTypeId type);
+  // types needn't be sorted.
+  Archetype* GetArchetype(std::vector<ComponentTypeId> types);
+  Archetype* GetArchetypeWith(Archetype* archetype, ComponentTypeId type);
+  Archetype* GetArchetypeWithout(Archetype* archetype, ComponentTypeId type);
+  // Leaves the entity where it is and returns false if the destination can't hold any entities.
+  bool MoveEntity(Entity entity, Archetype* destination);
+  void FreeRow(Archetype* archetype, uint32_t chunk, uint32_t row);
+  // types must be sorted and unique.
+  const std::vector<Archetype*>& GetMatchingArchetypes(const ComponentTypeId* types, size_t count);
+
+  template<typename... Components>
+  const std::vector<Archetype*>& GetMatchingArchetypes()
+  {
+    std::array<ComponentTypeId, sizeof...(Components)> types = { { GetComponentTypeId<Components>()... } };
+    std::sort(types.begin(), types.end());
+    return GetMatchingArchetypes(types.data(), std::unique(types.begin(), types.end()) - types.begin());
+  }
+
+  template<typename... Components, typename Function, size_t... Indices>
+  static void ForEachInChunk(Archetype& archetype, size_t chunk, const int* columns, Function& function, std::index_sequence<Indices...>)
+  {
+    uint32_t count = archetype.GetCount(chunk);
+    Entity* entities = archetype.GetEntities(chunk);
+    std::tuple<Components*...> arrays(static_cast<Components*>(archetype.GetColumnData(chunk, columns[Indices]))...);
+    (void)arrays;
+    for (uint32_t row = 0; row < count; row++)
+      function(entities[row], std::get<Indices>(arrays)[row]...);
+  }
+};
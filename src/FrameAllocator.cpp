@@ -0,0 +1,109 @@
+#include <algorithm>
+#include <cstdint>
+
+#include <imgui/imgui.h>
+
+#include "FrameAllocator.h"
+
+constexpr unsigned int FrameAllocator::FRAMES;
+
+static size_t AlignUp(size_t value, size_t alignment)
+{
+  return (value + alignment - 1) & ~(alignment - 1);
+}
+
+FrameAllocator::FrameAllocator()
+  : m_Current(0), m_Stats{}
+{
+  for (Arena& arena : m_Arenas)
+  {
+    arena.Capacity = 0;
+    arena.Offset = 0;
+    arena.Allocations = 0;
+    arena.OverflowBytes = 0;
+  }
+  Reserve(1024 * 1024);
+  EndFrame();
+  EndFrame();
+  m_Stats = {};
+  m_Stats.Capacity = m_Arenas[0].Capacity;
+}
+
+FrameAllocator& FrameAllocator::Get()
+{
+  static FrameAllocator instance;
+  return instance;
+}
+
+void* FrameAllocator::Allocate(size_t size, size_t alignment)
+{
+  Arena& arena = m_Arenas[m_Current];
+  arena.Allocations.fetch_add(1, std::memory_order_relaxed);
+
+  uintptr_t base = (uintptr_t)arena.Memory.get();
+  size_t offset = arena.Offset.load(std::memory_order_relaxed);
+  for (;;)
+  {
+    size_t start = (size_t)(AlignUp(base + offset, alignment) - base);
+    size_t end = start + size;
+    if (end > arena.Capacity)
+      return AllocateOverflow(arena, size, alignment);
+    if (arena.Offset.compare_exchange_weak(offset, end, std::memory_order_relaxed))
+      return arena.Memory.get() + start;
+  }
+}
+
+void* FrameAllocator::AllocateOverflow(Arena& arena, size_t size, size_t alignment)
+{
+  std::lock_guard<std::mutex> lock(m_OverflowMutex);
+  arena.Overflow.emplace_back(new unsigned char[size + alignment]);
+  arena.OverflowBytes += size + alignment;
+  uintptr_t address = (uintptr_t)arena.Overflow.back().get();
+  return (void*)AlignUp(address, alignment);
+}
+
+void FrameAllocator::EndFrame()
+{
+  Arena& finished = m_Arenas[m_Current];
+  size_t used = finished.Offset.load() + finished.OverflowBytes;
+  m_Stats.UsedLastFrame = used;
+  m_Stats.HighWater = std::max(m_Stats.HighWater, used);
+  m_Stats.AllocationsLastFrame = finished.Allocations.load();
+  m_Stats.OverflowsLastFrame = (unsigned int)finished.Overflow.size();
+
+  // The arena being reset was last used two frames ago, so nothing still reads from it.
+  m_Current = (m_Current + 1) % FRAMES;
+  Arena& next = m_Arenas[m_Current];
+  size_t capacity = std::max(next.Capacity, m_Stats.Capacity);
+  if (m_Stats.HighWater > capacity)
+  {
+    // Round up so a slowly growing frame doesn't reallocate every time.
+    while (capacity < m_Stats.HighWater)
+      capacity = std::max<size_t>(capacity * 2, 64 * 1024);
+  }
+  if (capacity != next.Capacity)
+  {
+    next.Memory.reset(new unsigned char[capacity]);
+    next.Capacity = capacity;
+    m_Stats.Grows++;
+  }
+  m_Stats.Capacity = capacity;
+
+  next.Overflow.clear();
+  next.OverflowBytes = 0;
+  next.Offset = 0;
+  next.Allocations = 0;
+}
+
+void FrameAllocator::Reserve(size_t capacity)
+{
+  m_Stats.Capacity = std::max(m_Stats.Capacity, capacity);
+}
+
+void FrameAllocator::OnImGuiRender()
+{
+  ImGui::Text("Arena: %.1f KB x %u", m_Stats.Capacity / 1024.0f, FRAMES);
+  ImGui::Text("Used last frame: %.1f KB in %u allocations", m_Stats.UsedLastFrame / 1024.0f, m_Stats.AllocationsLastFrame);
+  ImGui::Text("High water: %.1f KB", m_Stats.HighWater / 1024.0f);
+  ImGui::Text("Heap overflows last frame: %u, grows: %u", m_Stats.OverflowsLastFrame, m_Stats.Grows);
+}
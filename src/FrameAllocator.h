@@ -0,0 +1,99 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Bump allocator for data that only lives for a frame or two. Allocating moves an offset forward;
+// nothing is freed individually. There are two arenas and EndFrame switches between them, so
+// anything allocated stays valid until the end of the next frame, long enough for the GPU to read
+// what was uploaded from it. An allocation that doesn't fit gets its own heap block, and the arena
+// grows to the frame's high-water mark the next time it's reset, so steady state frames never
+// touch the global heap. Allocate is safe from any thread; EndFrame is main thread only.
+class FrameAllocator
+{
+public:
+  static constexpr unsigned int FRAMES = 2;
+
+  struct Stats
+  {
+    size_t Capacity; // Of each arena.
+    size_t UsedLastFrame, HighWater;
+    unsigned int AllocationsLastFrame;
+    unsigned int OverflowsLastFrame; // Allocations that had to go to the heap.
+    unsigned int Grows;
+  };
+
+private:
+  struct Arena
+  {
+    std::unique_ptr<unsigned char[]> Memory;
+    size_t Capacity;
+    std::atomic<size_t> Offset;
+    std::atomic<unsigned int> Allocations;
+    std::vector<std::unique_ptr<unsigned char[]>> Overflow;
+    size_t OverflowBytes;
+  };
+
+  Arena m_Arenas[FRAMES];
+  unsigned int m_Current;
+  std::mutex m_OverflowMutex;
+  Stats m_Stats;
+
+public:
+  static FrameAllocator& Get();
+
+  // Never null. alignment must be a power of two.
+  void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+  template<typename T>
+  T* AllocateArray(size_t count) { return static_cast<T*>(Allocate(count * sizeof(T), alignof(T))); }
+
+  // The object's destructor is never called.
+  template<typename T, typename... Args>
+  T* New(Args&&... args) { return new (Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...); }
+
+  // Releases everything allocated the frame before last. Call once per frame.
+  void EndFrame();
+  // Capacity of each arena, applied the next time it's reset.
+  void Reserve(size_t capacity);
+
+  inline const Stats& GetStats() const { return m_Stats; }
+  void OnImGuiRender();
+private:
+  FrameAllocator();
+  FrameAllocator(const FrameAllocator&) = delete;
+  FrameAllocator& operator=(const FrameAllocator&) = delete;
+
+  void* AllocateOverflow(Arena& arena, size_t size, size_t alignment);
+};
+
+// Lets standard containers allocate from the FrameAllocator. Deallocation does nothing, so
+// reserve up front: every reallocation leaves the old storage behind until the arena is reset.
+template<typename T>
+class FrameStlAllocator
+{
+public:
+  typedef T value_type;
+
+  FrameStlAllocator() {}
+  template<typename U>
+  FrameStlAllocator(const FrameStlAllocator<U>&) {}
+
+  T* allocate(size_t count) { return FrameAllocator::Get().AllocateArray<T>(count); }
+  void deallocate(T*, size_t) {}
+};
+
+template<typename T, typename U>
+inline bool operator==(const FrameStlAllocator<T>&, const FrameStlAllocator<U>&) { return true; }
+template<typename T, typename U>
+inline bool operator!=(const FrameStlAllocator<T>&, const FrameStlAllocator<U>&) { return false; }
+
+template<typename T>
+using FrameVector = std::vector<T, FrameStlAllocator<T>>;
+typedef std::basic_string<char, std::char_traits<char>, FrameStlAllocator<char>> FrameString;
@@ -0,0 +1,99 @@
+#include "Framebuffer.h"
+
+Framebuffer::Framebuffer(const FramebufferSpecification& specification)
+  : m_Specification(specification)
+{
+  Invalidate();
+}
+
+void Framebuffer::Invalidate()
+{
+  m_ColorAttachments.clear();
+  m_DepthAttachment.reset();
+
+  unsigned int id = 0;
+  OpenGLCall(glGenFramebuffers(1, &id));
+  m_RendererId.Reset(id);
+  OpenGLCall(glBindFramebuffer(GL_FRAMEBUFFER, id));
+
+  const FramebufferSpecification& spec = m_Specification;
+  std::vector<GLenum> drawBuffers;
+  for (size_t i = 0; i < spec.ColorFormats.size(); i++)
+  {
+    m_ColorAttachments.emplace_back(new RenderTexture(spec.Width, spec.Height, spec.ColorFormats[i], 1, spec.Samples));
+    const RenderTexture& attachment = *m_ColorAttachments.back();
+    OpenGLCall(glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + (GLenum)i, attachment.GetTarget(), attachment.GetRendererId(), 0));
+    drawBuffers.push_back(GL_COLOR_ATTACHMENT0 + (GLenum)i);
+  }
+
+  if (spec.DepthFormat)
+  {
+    m_DepthAttachment.reset(new RenderTexture(spec.Width, spec.Height, spec.DepthFormat, 1, spec.Samples));
+    GLenum attachmentPoint = Texture::GetFormatForInternalFormat(spec.DepthFormat) == GL_DEPTH_STENCIL ?
+      GL_DEPTH_STENCIL_ATTACHMENT : GL_DEPTH_ATTACHMENT;
+    OpenGLCall(glFramebufferTexture2D(GL_FRAMEBUFFER, attachmentPoint, m_DepthAttachment->GetTarget(), m_DepthAttachment->GetRendererId(), 0));
+  }
+
+  if (drawBuffers.empty())
+  {
+    OpenGLCall(glDrawBuffer(GL_NONE));
+  }
+  else
+  {
+    OpenGLCall(glDrawBuffers((GLsizei)drawBuffers.size(), drawBuffers.data()));
+  }
+
+  OpenGLCall(GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER));
+  if (status != GL_FRAMEBUFFER_COMPLETE)
+    std::cout << "[ERROR] [OPENGL]: Framebuffer incomplete: " << status << std::endl;
+
+  OpenGLCall(glBindFramebuffer(GL_FRAMEBUFFER, 0));
+}
+
+void Framebuffer::Bind() const
+{
+  OpenGLCall(glBindFramebuffer(GL_FRAMEBUFFER, m_RendererId.Get()));
+  OpenGLCall(glViewport(0, 0, m_Specification.Width, m_Specification.Height));
+}
+
+void Framebuffer::Unbind() const
+{
+  OpenGLCall(glBindFramebuffer(GL_FRAMEBUFFER, 0));
+  OpenGLCall(glViewport(0, 0, (GLsizei)WINDOW_WIDTH, (GLsizei)WINDOW_HEIGHT));
+}
+
+void Framebuffer::Resize(int width, int height)
+{
+  if (width == m_Specification.Width && height == m_Specification.Height)
+    return;
+
+  m_Specification.Width = width;
+  m_Specification.Height = height;
+  Invalidate();
+}
+
+void Framebuffer::BlitTo(const Framebuffer* target, unsigned int filter) const
+{
+  int targetWidth = target ? target->m_Specification.Width : (int)WINDOW_WIDTH;
+  int targetHeight = target ? target->m_Specification.Height : (int)WINDOW_HEIGHT;
+
+  GLbitfield mask = GL_COLOR_BUFFER_BIT;
+  if (m_DepthAttachment && target && target->m_DepthAttachment)
+    mask |= GL_DEPTH_BUFFER_BIT;
+
+  OpenGLCall(glBindFramebuffer(GL_READ_FRAMEBUFFER, m_RendererId.Get()));
+  OpenGLCall(glBindFramebuffer(GL_DRAW_FRAMEBUFFER, target ? target->m_RendererId.Get() : 0));
+  OpenGLCall(glReadBuffer(GL_COLOR_ATTACHMENT0));
+  // Depth can only be blitted with nearest filtering.
+  OpenGLCall(glBlitFramebuffer(0, 0, m_Specification.Width, m_Specification.Height, 0, 0, targetWidth, targetHeight,
+    mask, (mask & GL_DEPTH_BUFFER_BIT) ? GL_NEAREST : filter));
+  OpenGLCall(glBindFramebuffer(GL_FRAMEBUFFER, 0));
+}
+
+size_t Framebuffer::GetMemorySize() const
+{
+  size_t size = m_DepthAttachment ? m_DepthAttachment->GetMemorySize() : 0;
+  for (const auto& attachment : m_ColorAttachments)
+    size += attachment->GetMemorySize();
+  return size;
+}
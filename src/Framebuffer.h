@@ -0,0 +1,57 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "GLHandle.h"
+#include "RenderTexture.h"
+
+struct FramebufferSpecification
+{
+  int Width, Height;
+  std::vector<unsigned int> ColorFormats; // One internal format per colour attachment.
+  unsigned int DepthFormat;                 // 0 for no depth attachment.
+  int Samples;                              // 0 for no multisampling.
+
+  bool operator==(const FramebufferSpecification& other) const
+  {
+    return Width == other.Width && Height == other.Height && ColorFormats == other.ColorFormats &&
+      DepthFormat == other.DepthFormat && Samples == other.Samples;
+  }
+};
+
+class Framebuffer
+{
+private:
+  FramebufferHandle m_RendererId;
+  FramebufferSpecification m_Specification;
+  std::vector<std::unique_ptr<RenderTexture>> m_ColorAttachments;
+  std::unique_ptr<RenderTexture> m_DepthAttachment;
+
+public:
+  Framebuffer(const FramebufferSpecification& specification);
+
+  Framebuffer(Framebuffer&&) = default;
+  Framebuffer& operator=(Framebuffer&&) = default;
+
+  // Binds for drawing and sets the viewport to the framebuffer size.
+  void Bind() const;
+  // Binds the default framebuffer again with the window sized viewport.
+  void Unbind() const;
+
+  // Recreates the attachments at the new size; a no-op when the size is unchanged.
+  void Resize(int width, int height);
+
+  // Blits colour attachment 0 (and depth, when both have it) into target, resolving multisampling.
+  // A null target blits to the default framebuffer.
+  void BlitTo(const Framebuffer* target, unsigned int filter = GL_NEAREST) const;
+
+  size_t GetMemorySize() const;
+
+  inline const FramebufferSpecification& GetSpecification() const { return m_Specification; }
+  inline const RenderTexture& GetColorAttachment(size_t index = 0) const { return *m_ColorAttachments[index]; }
+  inline const RenderTexture* GetDepthAttachment() const { return m_DepthAttachment.get(); }
+  inline unsigned int GetRendererId() const { return m_RendererId.Get(); }
+private:
+  void Invalidate();
+};
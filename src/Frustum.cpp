@@ -0,0 +1,62 @@
+#include "Frustum.h"
+
+Frustum::Frustum(const glm::mat4& viewProjection)
+{
+  // Gribb and Hartmann: each plane is the last row of the matrix plus or minus one of the others.
+  glm::vec4 rows[4];
+  for (int i = 0; i < 4; i++)
+    rows[i] = glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+
+  for (int i = 0; i < 3; i++)
+  {
+    m_Planes[i * 2] = rows[3] + rows[i];
+    m_Planes[i * 2 + 1] = rows[3] - rows[i];
+  }
+
+  for (int i = 0; i < 6; i++)
+    m_Planes[i] /= glm::length(glm::vec3(m_Planes[i]));
+}
+
+bool Frustum::Intersects(const BoundingSphere& sphere) const
+{
+  for (int i = 0; i < 6; i++)
+  {
+    if (glm::dot(glm::vec3(m_Planes[i]), sphere.Center) + m_Planes[i].w < -sphere.Radius)
+      return false;
+  }
+  return true;
+}
+
+bool Frustum::Intersects(const BoundingBox& box) const
+{
+  glm::vec3 center = box.GetCenter(), extents = box.GetExtents();
+  for (int i = 0; i < 6; i++)
+  {
+    glm::vec3 normal(m_Planes[i]);
+    // Distance from the centre to the box corner furthest along the plane normal.
+    float radius = glm::dot(glm::abs(normal), extents);
+    if (glm::dot(normal, center) + m_Planes[i].w < -radius)
+      return false;
+  }
+  return true;
+}
+
+Frustum::Containment Frustum::Classify(const BoundingBox& box, unsigned int& planeMask) const
+{
+  glm::vec3 center = box.GetCenter(), extents = box.GetExtents();
+  for (int i = 0; i < 6; i++)
+  {
+    unsigned int bit = 1u << i;
+    if (!(planeMask & bit))
+      continue;
+
+    glm::vec3 normal(m_Planes[i]);
+    float radius = glm::dot(glm::abs(normal), extents);
+    float distance = glm::dot(normal, center) + m_Planes[i].w;
+    if (distance < -radius)
+      return Containment::Outside;
+    if (distance >= radius)
+      planeMask &= ~bit;
+  }
+  return planeMask ? Containment::Intersects : Containment::Inside;
+}
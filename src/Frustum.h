@@ -0,0 +1,33 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include "Bounds.h"
+
+// View frustum as six planes (normal pointing inwards, w the distance) in the order left, right,
+// bottom, top, near, far, extracted from a projection * view matrix.
+class Frustum
+{
+public:
+  static constexpr unsigned int ALL_PLANES = 0x3F;
+
+  enum class Containment
+  {
+    Outside, Intersects, Inside
+  };
+
+private:
+  glm::vec4 m_Planes[6];
+
+public:
+  Frustum(const glm::mat4& viewProjection);
+
+  // Conservative: objects near a frustum corner can pass without being on screen.
+  bool Intersects(const BoundingSphere& sphere) const;
+  bool Intersects(const BoundingBox& box) const;
+  // For hierarchies: only tests the planes whose bits are set in planeMask, and clears the bits
+  // of planes the box is entirely inside, which its children then needn't test again.
+  Containment Classify(const BoundingBox& box, unsigned int& planeMask) const;
+
+  inline const glm::vec4* GetPlanes() const { return m_Planes; }
+};
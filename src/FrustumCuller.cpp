@@ -0,0 +1,254 @@
+#include <immintrin.h>
+
+#include "FrustumCuller.h"
+
+size_t FrustumCuller::AddSphere(const BoundingSphere& sphere)
+{
+  m_SphereX.push_back(sphere.Center.x);
+  m_SphereY.push_back(sphere.Center.y);
+  m_SphereZ.push_back(sphere.Center.z);
+  m_SphereRadius.push_back(sphere.Radius);
+  return m_SphereX.size() - 1;
+}
+
+void FrustumCuller::SetSphere(size_t index, const BoundingSphere& sphere)
+{
+  m_SphereX[index] = sphere.Center.x;
+  m_SphereY[index] = sphere.Center.y;
+  m_SphereZ[index] = sphere.Center.z;
+  m_SphereRadius[index] = sphere.Radius;
+}
+
+size_t FrustumCuller::AddBox(const BoundingBox& box)
+{
+  glm::vec3 center = box.GetCenter(), extents = box.GetExtents();
+  m_BoxCenterX.push_back(center.x);
+  m_BoxCenterY.push_back(center.y);
+  m_BoxCenterZ.push_back(center.z);
+  m_BoxExtentX.push_back(extents.x);
+  m_BoxExtentY.push_back(extents.y);
+  m_BoxExtentZ.push_back(extents.z);
+  return m_BoxCenterX.size() - 1;
+}
+
+void FrustumCuller::SetBox(size_t index, const BoundingBox& box)
+{
+  glm::vec3 center = box.GetCenter(), extents = box.GetExtents();
+  m_BoxCenterX[index] = center.x;
+  m_BoxCenterY[index] = center.y;
+  m_BoxCenterZ[index] = center.z;
+  m_BoxExtentX[index] = extents.x;
+  m_BoxExtentY[index] = extents.y;
+  m_BoxExtentZ[index] = extents.z;
+}
+
+void FrustumCuller::Clear()
+{
+  for (std::vector<float>* component : { &m_SphereX, &m_SphereY, &m_SphereZ, &m_SphereRadius, &m_BoxCenterX,
+    &m_BoxCenterY, &m_BoxCenterZ, &m_BoxExtentX, &m_BoxExtentY, &m_BoxExtentZ })
+  {
+    component->clear();
+  }
+}
+
+void FrustumCuller::CullSpheres(const Frustum& frustum, std::vector<unsigned int>& visible, SimdKernel kernel) const
+{
+  size_t count = GetSphereCount();
+  visible.resize(count);
+  if (!IsSimdKernelSupported(kernel))
+    kernel = SimdKernel::Scalar;
+
+  // The SIMD kernels only take whole groups of lanes, the scalar kernel finishes the rest.
+  size_t done = 0, written = 0;
+  switch (kernel)
+  {
+    case SimdKernel::Sse:
+      done = count & ~(size_t)3;
+      written = CullSpheresSse(frustum, done, visible.data());
+      break;
+    case SimdKernel::Avx2:
+      done = count & ~(size_t)7;
+      written = CullSpheresAvx2(frustum, done, visible.data());
+      break;
+    default:
+      break;
+  }
+  written += CullSpheresScalar(frustum, done, count, visible.data() + written);
+  visible.resize(written);
+}
+
+void FrustumCuller::CullBoxes(const Frustum& frustum, std::vector<unsigned int>& visible, SimdKernel kernel) const
+{
+  size_t count = GetBoxCount();
+  visible.resize(count);
+  if (!IsSimdKernelSupported(kernel))
+    kernel = SimdKernel::Scalar;
+
+  size_t done = 0, written = 0;
+  switch (kernel)
+  {
+    case SimdKernel::Sse:
+      done = count & ~(size_t)3;
+      written = CullBoxesSse(frustum, done, visible.data());
+      break;
+    case SimdKernel::Avx2:
+      done = count & ~(size_t)7;
+      written = CullBoxesAvx2(frustum, done, visible.data());
+      break;
+    default:
+      break;
+  }
+  written += CullBoxesScalar(frustum, done, count, visible.data() + written);
+  visible.resize(written);
+}
+
+size_t FrustumCuller::CullSpheresScalar(const Frustum& frustum, size_t begin, size_t end, unsigned int* visible) const
+{
+  size_t written = 0;
+  for (size_t i = begin; i < end; i++)
+  {
+    BoundingSphere sphere = { glm::vec3(m_SphereX[i], m_SphereY[i], m_SphereZ[i]), m_SphereRadius[i] };
+    if (frustum.Intersects(sphere))
+      visible[written++] = (unsigned int)i;
+  }
+  return written;
+}
+
+size_t FrustumCuller::CullBoxesScalar(const Frustum& frustum, size_t begin, size_t end, unsigned int* visible) const
+{
+  size_t written = 0;
+  for (size_t i = begin; i < end; i++)
+  {
+    glm::vec3 center(m_BoxCenterX[i], m_BoxCenterY[i], m_BoxCenterZ[i]);
+    glm::vec3 extents(m_BoxExtentX[i], m_BoxExtentY[i], m_BoxExtentZ[i]);
+    if (frustum.Intersects(BoundingBox{ center - extents, center + extents }))
+      visible[written++] = (unsigned int)i;
+  }
+  return written;
+}
+
+// Appends the lanes set in mask without branching: every lane's index is written, but the
+// output position only advances past the visible ones.
+static inline size_t Compact(int mask, int lanes, unsigned int first, unsigned int* visible)
+{
+  size_t written = 0;
+  for (int lane = 0; lane < lanes; lane++)
+  {
+    visible[written] = first + lane;
+    written += (mask >> lane) & 1;
+  }
+  return written;
+}
+
+size_t FrustumCuller::CullSpheresSse(const Frustum& frustum, size_t end, unsigned int* visible) const
+{
+  __m128 planes[6][4];
+  for (int p = 0; p < 6; p++)
+  {
+    for (int c = 0; c < 4; c++)
+      planes[p][c] = _mm_set1_ps(frustum.GetPlanes()[p][c]);
+  }
+
+  size_t written = 0;
+  for (size_t i = 0; i < end; i += 4)
+  {
+    __m128 x = _mm_loadu_ps(&m_SphereX[i]), y = _mm_loadu_ps(&m_SphereY[i]), z = _mm_loadu_ps(&m_SphereZ[i]);
+    __m128 negativeRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(&m_SphereRadius[i]));
+
+    __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+    for (int p = 0; p < 6; p++)
+    {
+      __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(planes[p][0], x), _mm_mul_ps(planes[p][1], y)),
+        _mm_add_ps(_mm_mul_ps(planes[p][2], z), planes[p][3]));
+      inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, negativeRadius));
+    }
+    written += Compact(_mm_movemask_ps(inside), 4, (unsigned int)i, visible + written);
+  }
+  return written;
+}
+
+size_t FrustumCuller::CullBoxesSse(const Frustum& frustum, size_t end, unsigned int* visible) const
+{
+  __m128 planes[6][4], absoluteNormals[6][3];
+  for (int p = 0; p < 6; p++)
+  {
+    for (int c = 0; c < 4; c++)
+      planes[p][c] = _mm_set1_ps(frustum.GetPlanes()[p][c]);
+    for (int c = 0; c < 3; c++)
+      absoluteNormals[p][c] = _mm_set1_ps(glm::abs(frustum.GetPlanes()[p][c]));
+  }
+
+  size_t written = 0;
+  for (size_t i = 0; i < end; i += 4)
+  {
+    __m128 x = _mm_loadu_ps(&m_BoxCenterX[i]), y = _mm_loadu_ps(&m_BoxCenterY[i]), z = _mm_loadu_ps(&m_BoxCenterZ[i]);
+    __m128 ex = _mm_loadu_ps(&m_BoxExtentX[i]), ey = _mm_loadu_ps(&m_BoxExtentY[i]), ez = _mm_loadu_ps(&m_BoxExtentZ[i]);
+
+    __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+    for (int p = 0; p < 6; p++)
+    {
+      __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(planes[p][0], x), _mm_mul_ps(planes[p][1], y)),
+        _mm_add_ps(_mm_mul_ps(planes[p][2], z), planes[p][3]));
+      __m128 radius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(absoluteNormals[p][0], ex), _mm_mul_ps(absoluteNormals[p][1], ey)),
+        _mm_mul_ps(absoluteNormals[p][2], ez));
+      inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(distance, radius), _mm_setzero_ps()));
+    }
+    written += Compact(_mm_movemask_ps(inside), 4, (unsigned int)i, visible + written);
+  }
+  return written;
+}
+
+SIMD_TARGET_AVX2 size_t FrustumCuller::CullSpheresAvx2(const Frustum& frustum, size_t end, unsigned int* visible) const
+{
+  __m256 planes[6][4];
+  for (int p = 0; p < 6; p++)
+  {
+    for (int c = 0; c < 4; c++)
+      planes[p][c] = _mm256_set1_ps(frustum.GetPlanes()[p][c]);
+  }
+
+  size_t written = 0;
+  for (size_t i = 0; i < end; i += 8)
+  {
+    __m256 x = _mm256_loadu_ps(&m_SphereX[i]), y = _mm256_loadu_ps(&m_SphereY[i]), z = _mm256_loadu_ps(&m_SphereZ[i]);
+    __m256 negativeRadius = _mm256_sub_ps(_mm256_setzero_ps(), _mm256_loadu_ps(&m_SphereRadius[i]));
+
+    __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+    for (int p = 0; p < 6; p++)
+    {
+      __m256 distance = _mm256_fmadd_ps(planes[p][2], z, _mm256_fmadd_ps(planes[p][1], y, _mm256_fmadd_ps(planes[p][0], x, planes[p][3])));
+      inside = _mm256_and_ps(inside, _mm256_cmp_ps(distance, negativeRadius, _CMP_GE_OQ));
+    }
+    written += Compact(_mm256_movemask_ps(inside), 8, (unsigned int)i, visible + written);
+  }
+  return written;
+}
+
+SIMD_TARGET_AVX2 size_t FrustumCuller::CullBoxesAvx2(const Frustum& frustum, size_t end, unsigned int* visible) const
+{
+  __m256 planes[6][4], absoluteNormals[6][3];
+  for (int p = 0; p < 6; p++)
+  {
+    for (int c = 0; c < 4; c++)
+      planes[p][c] = _mm256_set1_ps(frustum.GetPlanes()[p][c]);
+    for (int c = 0; c < 3; c++)
+      absoluteNormals[p][c] = _mm256_set1_ps(glm::abs(frustum.GetPlanes()[p][c]));
+  }
+
+  size_t written = 0;
+  for (size_t i = 0; i < end; i += 8)
+  {
+    __m256 x = _mm256_loadu_ps(&m_BoxCenterX[i]), y = _mm256_loadu_ps(&m_BoxCenterY[i]), z = _mm256_loadu_ps(&m_BoxCenterZ[i]);
+    __m256 ex = _mm256_loadu_ps(&m_BoxExtentX[i]), ey = _mm256_loadu_ps(&m_BoxExtentY[i]), ez = _mm256_loadu_ps(&m_BoxExtentZ[i]);
+
+    __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+    for (int p = 0; p < 6; p++)
+    {
+      __m256 distance = _mm256_fmadd_ps(planes[p][2], z, _mm256_fmadd_ps(planes[p][1], y, _mm256_fmadd_ps(planes[p][0], x, planes[p][3])));
+      __m256 radius = _mm256_fmadd_ps(absoluteNormals[p][2], ez, _mm256_fmadd_ps(absoluteNormals[p][1], ey, _mm256_mul_ps(absoluteNormals[p][0], ex)));
+      inside = _mm256_and_ps(inside, _mm256_cmp_ps(_mm256_add_ps(distance, radius), _mm256_setzero_ps(), _CMP_GE_OQ));
+    }
+    written += Compact(_mm256_movemask_ps(inside), 8, (unsigned int)i, visible + written);
+  }
+  return written;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <vector>
+
+#include "CpuFeatures.h"
+#include "Frustum.h"
+
+// World space bounding spheres and boxes in structure of arrays form, tested against a frustum
+// four (SSE) or eight (AVX2) at a time. Culling writes the indices of the visible ones, in order,
+// to a compact list. Spheres and boxes are separate sets with their own indices.
+class FrustumCuller
+{
+private:
+  std::vector<float> m_SphereX, m_SphereY, m_SphereZ, m_SphereRadius;
+  std::vector<float> m_BoxCenterX, m_BoxCenterY, m_BoxCenterZ;
+  std::vector<float> m_BoxExtentX, m_BoxExtentY, m_BoxExtentZ;
+
+public:
+  size_t AddSphere(const BoundingSphere& sphere);
+  void SetSphere(size_t index, const BoundingSphere& sphere);
+  inline size_t GetSphereCount() const { return m_SphereX.size(); }
+
+  size_t AddBox(const BoundingBox& box);
+  void SetBox(size_t index, const BoundingBox& box);
+  inline size_t GetBoxCount() const { return m_BoxCenterX.size(); }
+
+  void Clear();
+
+  // Replaces the contents of visible with the indices of the spheres (or boxes) that intersect
+  // the frustum. Falls back to the scalar kernel when the CPU lacks the requested one.
+  void CullSpheres(const Frustum& frustum, std::vector<unsigned int>& visible, SimdKernel kernel = GetBestSimdKernel()) const;
+  void CullBoxes(const Frustum& frustum, std::vector<unsigned int>& visible, SimdKernel kernel = GetBestSimdKernel()) const;
+private:
+  size_t CullSpheresScalar(const Frustum& frustum, size_t begin, size_t end, unsigned int* visible) const;
+  size_t CullSpheresSse(const Frustum& frustum, size_t end, unsigned int* visible) const;
+  size_t CullSpheresAvx2(const Frustum& frustum, size_t end, unsigned int* visible) const;
+  size_t CullBoxesScalar(const Frustum& frustum, size_t begin, size_t end, unsigned int* visible) const;
+  size_t CullBoxesSse(const Frustum& frustum, size_t end, unsigned int* visible) const;
+  size_t CullBoxesAvx2(const Frustum& frustum, size_t end, unsigned int* visible) const;
+};
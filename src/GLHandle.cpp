@@ -0,0 +1,27 @@
+#include "GLHandle.h"
+#include "Renderer.h"
+
+void BufferDeleter::operator()(unsigned int id) const
+{
+  OpenGLCall(glDeleteBuffers(1, &id));
+}
+
+void VertexArrayDeleter::operator()(unsigned int id) const
+{
+  OpenGLCall(glDeleteVertexArrays(1, &id));
+}
+
+void ProgramDeleter::operator()(unsigned int id) const
+{
+  OpenGLCall(glDeleteProgram(id));
+}
+
+void TextureDeleter::operator()(unsigned int id) const
+{
+  OpenGLCall(glDeleteTextures(1, &id));
+}
+
+void FramebufferDeleter::operator()(unsigned int id) const
+{
+  OpenGLCall(glDeleteFramebuffers(1, &id));
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+// Owns one OpenGL object name and deletes it with Deleter when destroyed. Move-only, so classes
+// holding one are move-only too and can live by value in containers without double deletes.
+template<typename Deleter>
+class GLHandle
+{
+private:
+  unsigned int m_Id;
+
+public:
+  GLHandle() : m_Id(0) {}
+  explicit GLHandle(unsigned int id) : m_Id(id) {}
+  ~GLHandle() { Reset(); }
+
+  GLHandle(const GLHandle&) = delete;
+  GLHandle& operator=(const GLHandle&) = delete;
+
+  GLHandle(GLHandle&& other) noexcept : m_Id(other.Release()) {}
+  GLHandle& operator=(GLHandle&& other) noexcept
+  {
+    if (this != &other)
+      Reset(other.Release());
+    return *this;
+  }
+
+  // Deletes the current object, if any, and takes ownership of id.
+  void Reset(unsigned int id = 0)
+  {
+    if (m_Id)
+      Deleter()(m_Id);
+    m_Id = id;
+  }
+
+  // Gives up ownership without deleting.
+  unsigned int Release()
+  {
+    unsigned int id = m_Id;
+    m_Id = 0;
+    return id;
+  }
+
+  inline unsigned int Get() const { return m_Id; }
+  inline explicit operator bool() const { return m_Id != 0; }
+};
+
+struct BufferDeleter { void operator()(unsigned int id) const; };
+struct VertexArrayDeleter { void operator()(unsigned int id) const; };
+struct ProgramDeleter { void operator()(unsigned int id) const; };
+struct TextureDeleter { void operator()(unsigned int id) const; };
+struct FramebufferDeleter { void operator()(unsigned int id) const; };
+
+typedef GLHandle<BufferDeleter> BufferHandle;
+typedef GLHandle<VertexArrayDeleter> VertexArrayHandle;
+typedef GLHandle<ProgramDeleter> ProgramHandle;
+typedef GLHandle<TextureDeleter> TextureHandle;
+typedef GLHandle<FramebufferDeleter> FramebufferHandle;
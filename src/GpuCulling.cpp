@@ -0,0 +1,185 @@
+#include <algorithm>
+#include <cstddef>
+
+#include "Frustum.h"
+#include "GpuCulling.h"
+
+GpuCulling::GpuCulling(const std::vector<MeshRange>& meshes)
+  : m_Meshes(meshes), m_IndexBase(0), m_Frame(0), m_UseGpu(false), m_Stats{}
+{
+  m_VisibleCounts.resize(meshes.size());
+  for (const MeshRange& mesh : meshes)
+    m_Commands.push_back({ mesh.IndexCount, 0, mesh.FirstIndex, mesh.BaseVertex, 0 });
+
+  if (ComputeShader::IsSupported())
+  {
+    m_CullShader = ResourceRegistry::Get().LoadComputeShader("src/resources/FrustumCull.comp");
+    size_t commandsSize = m_Commands.size() * sizeof(DrawElementsIndirectCommand);
+    m_CommandBuffer = std::make_unique<StorageBuffer>(commandsSize, m_Commands.data());
+    m_ReadbackBuffers[0] = std::make_unique<StorageBuffer>(commandsSize, nullptr, GL_STREAM_READ);
+    m_ReadbackBuffers[1] = std::make_unique<StorageBuffer>(commandsSize, nullptr, GL_STREAM_READ);
+    m_UseGpu = IsGpuCullingSupported();
+  }
+  m_Stats.Gpu = m_UseGpu;
+}
+
+GpuCulling::~GpuCulling()
+{
+  ResourceRegistry::Get().Release(m_CullShader);
+}
+
+void GpuCulling::SetGpuCulling(bool enabled)
+{
+  m_UseGpu = enabled && IsGpuCullingSupported();
+  m_Stats.Gpu = m_UseGpu;
+  m_Frame = 0;
+}
+
+void GpuCulling::SetInstances(const std::vector<CullingInstance>& instances)
+{
+  m_Instances = instances;
+  m_Stats.Instances = (unsigned int)instances.size();
+
+  // Each mesh gets a contiguous range of the visible buffer big enough for all its instances,
+  // so culling can append to it without any sorting.
+  for (DrawElementsIndirectCommand& command : m_Commands)
+    command.BaseInstance = 0;
+  for (const CullingInstance& instance : instances)
+  {
+    for (size_t mesh = instance.Mesh + 1; mesh < m_Commands.size(); mesh++)
+      m_Commands[mesh].BaseInstance++;
+  }
+
+  m_VisibleTransforms.resize(instances.size());
+  size_t size = std::max<size_t>(instances.size(), 1) * sizeof(glm::mat4);
+  if (!m_VisibleBuffer || m_VisibleBuffer->GetSize() != size)
+    m_VisibleBuffer = std::make_unique<StorageBuffer>(size, nullptr, GL_DYNAMIC_DRAW);
+
+  if (IsGpuCullingSupported())
+  {
+    m_InstanceBuffer = std::make_unique<StorageBuffer>(std::max<size_t>(instances.size(), 1) * sizeof(CullingInstance),
+      instances.data(), GL_STATIC_DRAW);
+  }
+  m_Frame = 0;
+}
+
+void GpuCulling::Cull(const glm::mat4& viewProjection)
+{
+  Frustum frustum(viewProjection);
+  if (m_UseGpu)
+    CullOnGpu(frustum.GetPlanes());
+  else
+    CullOnCpu(frustum);
+  m_Frame++;
+}
+
+void GpuCulling::CullOnCpu(const Frustum& frustum)
+{
+  std::fill(m_VisibleCounts.begin(), m_VisibleCounts.end(), 0);
+  for (const CullingInstance& instance : m_Instances)
+  {
+    if (frustum.Intersects(::BoundingSphere{ glm::vec3(instance.BoundingSphere), instance.BoundingSphere.w }))
+      m_VisibleTransforms[m_Commands[instance.Mesh].BaseInstance + m_VisibleCounts[instance.Mesh]++] = instance.Transform;
+  }
+
+  m_Stats.Visible = 0;
+  for (size_t mesh = 0; mesh < m_Commands.size(); mesh++)
+  {
+    unsigned int count = m_VisibleCounts[mesh];
+    if (count)
+    {
+      size_t first = m_Commands[mesh].BaseInstance;
+      m_VisibleBuffer->SetSubData(first * sizeof(glm::mat4), count * sizeof(glm::mat4), &m_VisibleTransforms[first]);
+    }
+    m_Stats.Visible += count;
+  }
+}
+
+void GpuCulling::CullOnGpu(const glm::vec4 planes[6])
+{
+  size_t commandsSize = m_Commands.size() * sizeof(DrawElementsIndirectCommand);
+  m_CommandBuffer->SetSubData(0, commandsSize, m_Commands.data());
+
+  ComputeShader& cullShader = *ResourceRegistry::Get().Resolve(m_CullShader);
+  cullShader.Bind();
+  cullShader.SetUniform4fv("u_FrustumPlanes", 6, planes);
+  cullShader.SetUniform1ui("u_InstanceCount", (unsigned int)m_Instances.size());
+  m_InstanceBuffer->BindBase(GL_SHADER_STORAGE_BUFFER, 0);
+  m_CommandBuffer->BindBase(GL_SHADER_STORAGE_BUFFER, 1);
+  m_VisibleBuffer->BindBase(GL_SHADER_STORAGE_BUFFER, 2);
+  cullShader.Dispatch((unsigned int)m_Instances.size());
+
+  // The results are consumed as indirect commands, as instanced attributes and by the read back copy.
+  ComputeShader::Barrier(GL_COMMAND_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+
+  // Read the counts copied last frame rather than waiting on this frame's dispatch.
+  m_CommandBuffer->CopyTo(*m_ReadbackBuffers[m_Frame & 1], 0, 0, commandsSize);
+  if (m_Frame > 0)
+  {
+    std::vector<DrawElementsIndirectCommand> commands(m_Commands.size());
+    m_ReadbackBuffers[(m_Frame + 1) & 1]->GetSubData(0, commandsSize, commands.data());
+    m_Stats.Visible = 0;
+    for (const DrawElementsIndirectCommand& command : commands)
+      m_Stats.Visible += command.InstanceCount;
+  }
+}
+
+void GpuCulling::BindTransforms(const VertexArray& vertexArray, size_t firstInstance) const
+{
+  vertexArray.Bind();
+  m_VisibleBuffer->Bind(GL_ARRAY_BUFFER);
+  for (unsigned int column = 0; column < 4; column++)
+  {
+    size_t offset = firstInstance * sizeof(glm::mat4) + column * sizeof(glm::vec4);
+    OpenGLCall(glEnableVertexAttribArray(2 + column));
+    OpenGLCall(glVertexAttribPointer(2 + column, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (const void*)offset));
+    OpenGLCall(glVertexAttribDivisor(2 + column, 1));
+  }
+}
+
+void GpuCulling::Draw(const VertexArray& vertexArray, const IndexBuffer& indexBuffer, const Shader& shader)
+{
+  if (m_Instances.empty())
+    return;
+
+  shader.Bind();
+  vertexArray.Bind();
+  indexBuffer.Bind();
+
+  // Static index buffers can start part way into a shared GpuHeap buffer, and move out of it
+  // when resized, so the commands' first indices follow wherever the buffer is now.
+  unsigned int indexBase = indexBuffer.GetOffset() / indexBuffer.GetIndexSize();
+  if (indexBase != m_IndexBase)
+  {
+    m_IndexBase = indexBase;
+    for (size_t mesh = 0; mesh < m_Commands.size(); mesh++)
+    {
+      m_Commands[mesh].FirstIndex = m_Meshes[mesh].FirstIndex + indexBase;
+      // This frame's cull already wrote the command buffer, so patch just the first indices.
+      if (m_CommandBuffer)
+        m_CommandBuffer->SetSubData(mesh * sizeof(DrawElementsIndirectCommand) + offsetof(DrawElementsIndirectCommand, FirstIndex),
+          sizeof(unsigned int), &m_Commands[mesh].FirstIndex);
+    }
+  }
+
+  if (m_UseGpu)
+  {
+    BindTransforms(vertexArray, 0);
+    m_CommandBuffer->Bind(GL_DRAW_INDIRECT_BUFFER);
+    OpenGLCall(glMultiDrawElementsIndirect(GL_TRIANGLES, indexBuffer.GetType(), nullptr, (GLsizei)m_Commands.size(), 0));
+    OpenGLCall(glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0));
+    return;
+  }
+
+  // Without base instance support each mesh points the transform attributes at its own range.
+  for (size_t mesh = 0; mesh < m_Meshes.size(); mesh++)
+  {
+    if (m_VisibleCounts[mesh] == 0)
+      continue;
+
+    const MeshRange& range = m_Meshes[mesh];
+    BindTransforms(vertexArray, m_Commands[mesh].BaseInstance);
+    OpenGLCall(glDrawElementsInstancedBaseVertex(GL_TRIANGLES, range.IndexCount, indexBuffer.GetType(),
+      (const void*)((size_t)(range.FirstIndex + indexBase) * indexBuffer.GetIndexSize()), m_VisibleCounts[mesh], range.BaseVertex));
+  }
+}
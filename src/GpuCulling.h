@@ -0,0 +1,83 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "ComputeShader.h"
+#include "DrawElementsIndirectCommand.h"
+#include "ResourceRegistry.h"
+#include "Renderer.h"
+#include "StorageBuffer.h"
+
+// One object to cull, laid out to match the std430 struct in FrustumCull.comp.
+struct CullingInstance
+{
+  glm::mat4 Transform;
+  glm::vec4 BoundingSphere; // World space centre and radius.
+  unsigned int Mesh;        // Index into the meshes given to GpuCulling.
+  unsigned int Padding[3];
+};
+
+// Frustum culls instances of a few meshes sharing one vertex array and draws the survivors.
+// With compute shaders a dispatch tests every bounding sphere and appends visible transforms and
+// instance counts straight into an indirect command buffer, drawn with one
+// glMultiDrawElementsIndirect, so nothing per object touches the CPU. On OpenGL 3.3 the same
+// test runs on the CPU and each mesh is drawn with glDrawElementsInstancedBaseVertex.
+// Visible transforms are fed to the vertex shader as a mat4 at attribute locations 2 to 5.
+class GpuCulling
+{
+public:
+  struct MeshRange
+  {
+    unsigned int IndexCount;
+    unsigned int FirstIndex;
+    int BaseVertex;
+  };
+
+  struct Stats
+  {
+    unsigned int Instances;
+    unsigned int Visible; // A frame behind when culling on the GPU.
+    bool Gpu;
+  };
+
+private:
+  std::vector<MeshRange> m_Meshes;
+  std::vector<CullingInstance> m_Instances;
+  // Per mesh commands with zero instances, reset into the command buffer before every cull.
+  std::vector<DrawElementsIndirectCommand> m_Commands;
+  std::vector<unsigned int> m_VisibleCounts;
+  std::vector<glm::mat4> m_VisibleTransforms;
+  ComputeShaderHandle m_CullShader;
+  std::unique_ptr<StorageBuffer> m_InstanceBuffer, m_CommandBuffer, m_VisibleBuffer;
+  std::unique_ptr<StorageBuffer> m_ReadbackBuffers[2];
+  unsigned int m_IndexBase; // Offset of the index buffer last drawn with, in indices.
+  unsigned int m_Frame;
+  bool m_UseGpu;
+  Stats m_Stats;
+
+public:
+  GpuCulling(const std::vector<MeshRange>& meshes);
+  ~GpuCulling();
+
+  GpuCulling(const GpuCulling&) = delete;
+  GpuCulling& operator=(const GpuCulling&) = delete;
+
+  void SetInstances(const std::vector<CullingInstance>& instances);
+  // Ignored when compute shaders aren't supported.
+  void SetGpuCulling(bool enabled);
+
+  void Cull(const glm::mat4& viewProjection);
+  void Draw(const VertexArray& vertexArray, const IndexBuffer& indexBuffer, const Shader& shader);
+
+  inline bool IsGpuCullingSupported() const
+  {
+    ComputeShader* cullShader = ResourceRegistry::Get().Resolve(m_CullShader);
+    return cullShader && cullShader->IsValid();
+  }
+  inline const Stats& GetStats() const { return m_Stats; }
+private:
+  void CullOnCpu(const Frustum& frustum);
+  void CullOnGpu(const glm::vec4 planes[6]);
+  void BindTransforms(const VertexArray& vertexArray, size_t firstInstance) const;
+};
@@ -0,0 +1,326 @@
+#include <algorithm>
+
+#include <imgui/imgui.h>
+
+#include "GpuHeap.h"
+#include "Renderer.h"
+
+static size_t RoundUpToPowerOfTwo(size_t value)
+{
+  size_t result = 1;
+  while (result < value)
+    result <<= 1;
+  return result;
+}
+
+GpuHeap::GpuHeap(size_t pageSize, size_t minBlockSize, unsigned int usage)
+  : m_PageSize(RoundUpToPowerOfTwo(pageSize)), m_MinBlockSize(RoundUpToPowerOfTwo(minBlockSize)), m_MaxOrder(0),
+    m_Usage(usage), m_Generation(0), m_Stats{}
+{
+  m_MinBlockSize = std::min(m_MinBlockSize, m_PageSize);
+  while (GetBlockSize(m_MaxOrder) < m_PageSize)
+    m_MaxOrder++;
+}
+
+GpuHeap::~GpuHeap()
+{
+}
+
+GpuHeap& GpuHeap::Get()
+{
+  static GpuHeap instance;
+  return instance;
+}
+
+bool GpuHeap::CheckHandle(Handle handle) const
+{
+  if (handle < m_Allocations.size() && m_Allocations[handle].Live)
+    return true;
+
+  std::cout << "[ERROR] [OPENGL]: GpuHeap handle " << handle << " is not a live allocation" << std::endl;
+  return false;
+}
+
+int GpuHeap::AddPage()
+{
+  std::unique_ptr<Page> page = std::make_unique<Page>();
+  page->Buffer = std::make_unique<StorageBuffer>(m_PageSize, nullptr, m_Usage);
+  page->FreeLists.resize(m_MaxOrder + 1);
+  page->FreeLists[m_MaxOrder].insert(0);
+  page->Allocated = 0;
+
+  for (size_t i = 0; i < m_Pages.size(); i++)
+  {
+    if (!m_Pages[i])
+    {
+      m_Pages[i] = std::move(page);
+      return (int)i;
+    }
+  }
+  m_Pages.push_back(std::move(page));
+  return (int)m_Pages.size() - 1;
+}
+
+bool GpuHeap::FindFreeBlock(unsigned int order, int limitPage, size_t limitOffset, int& page, unsigned int& offset, unsigned int& foundOrder) const
+{
+  // Smallest order that fits first, to keep large blocks whole; within an order the lowest
+  // address, which packs allocations towards the start of the heap.
+  for (unsigned int candidate = order; candidate <= m_MaxOrder; candidate++)
+  {
+    for (int i = 0; i < (int)m_Pages.size() && i <= limitPage; i++)
+    {
+      if (!m_Pages[i] || m_Pages[i]->FreeLists[candidate].empty())
+        continue;
+
+      unsigned int lowest = *m_Pages[i]->FreeLists[candidate].begin();
+      if (i == limitPage && lowest >= limitOffset)
+        break;
+
+      page = i;
+      offset = lowest;
+      foundOrder = candidate;
+      return true;
+    }
+  }
+  return false;
+}
+
+unsigned int GpuHeap::TakeBlock(int page, unsigned int offset, unsigned int foundOrder, unsigned int order)
+{
+  Page& target = *m_Pages[page];
+  target.FreeLists[foundOrder].erase(offset);
+
+  // Split down to the wanted order, freeing the upper halves.
+  while (foundOrder > order)
+  {
+    foundOrder--;
+    target.FreeLists[foundOrder].insert(offset + (unsigned int)GetBlockSize(foundOrder));
+  }
+  target.Allocated += GetBlockSize(order);
+  return offset;
+}
+
+void GpuHeap::ReleaseBlock(int page, unsigned int offset, unsigned int order)
+{
+  Page& target = *m_Pages[page];
+  target.Allocated -= GetBlockSize(order);
+
+  // Merge with the buddy for as long as it's free too.
+  while (order < m_MaxOrder)
+  {
+    unsigned int buddy = offset ^ (unsigned int)GetBlockSize(order);
+    auto it = target.FreeLists[order].find(buddy);
+    if (it == target.FreeLists[order].end())
+      break;
+
+    target.FreeLists[order].erase(it);
+    offset = std::min(offset, buddy);
+    order++;
+  }
+  target.FreeLists[order].insert(offset);
+}
+
+GpuHeap::Handle GpuHeap::Allocate(size_t size)
+{
+  if (size == 0 || size > m_PageSize)
+    return INVALID_HANDLE;
+
+  unsigned int order = 0;
+  while (GetBlockSize(order) < size)
+    order++;
+
+  int page = -1;
+  unsigned int offset = 0, foundOrder = 0;
+  if (!FindFreeBlock(order, (int)m_Pages.size(), 0, page, offset, foundOrder))
+  {
+    page = AddPage();
+    offset = 0;
+    foundOrder = m_MaxOrder;
+  }
+  TakeBlock(page, offset, foundOrder, order);
+
+  Handle handle;
+  if (!m_FreeHandles.empty())
+  {
+    handle = m_FreeHandles.back();
+    m_FreeHandles.pop_back();
+  }
+  else
+  {
+    handle = (Handle)m_Allocations.size();
+    m_Allocations.push_back({});
+  }
+  m_Allocations[handle] = { page, offset, order, size, true };
+  return handle;
+}
+
+void GpuHeap::Free(Handle handle)
+{
+  if (handle == INVALID_HANDLE || handle >= m_Allocations.size() || !m_Allocations[handle].Live)
+    return;
+
+  Allocation& allocation = m_Allocations[handle];
+  ReleaseBlock(allocation.Page, allocation.Offset, allocation.Order);
+  allocation.Live = false;
+  m_FreeHandles.push_back(handle);
+}
+
+void GpuHeap::Upload(Handle handle, const void* data, size_t size, size_t offset)
+{
+  if (!CheckHandle(handle))
+    return;
+
+  const Allocation& allocation = m_Allocations[handle];
+  if (offset + size > allocation.Size)
+  {
+    std::cout << "[ERROR] [OPENGL]: GpuHeap upload of " << size << " bytes at " << offset << " overflows a " << allocation.Size << " byte allocation" << std::endl;
+    return;
+  }
+  m_Pages[allocation.Page]->Buffer->SetSubData(allocation.Offset + offset, size, data);
+}
+
+void GpuHeap::Clear()
+{
+  m_Pages.clear();
+  m_Allocations.clear();
+  m_FreeHandles.clear();
+  m_Generation++;
+  m_Stats = {};
+}
+
+const StorageBuffer* GpuHeap::GetBuffer(Handle handle) const
+{
+  if (!CheckHandle(handle))
+    return nullptr;
+  return m_Pages[m_Allocations[handle].Page]->Buffer.get();
+}
+
+size_t GpuHeap::GetOffset(Handle handle) const
+{
+  if (!CheckHandle(handle))
+    return 0;
+  return m_Allocations[handle].Offset;
+}
+
+size_t GpuHeap::GetSize(Handle handle) const
+{
+  if (!CheckHandle(handle))
+    return 0;
+  return m_Allocations[handle].Size;
+}
+
+size_t GpuHeap::Defragment(size_t maxBytes)
+{
+  // Visit allocations from the back of the heap and move each into a lower free block of its size.
+  std::vector<Handle> candidates;
+  for (Handle handle = 0; handle < (Handle)m_Allocations.size(); handle++)
+  {
+    if (m_Allocations[handle].Live)
+      candidates.push_back(handle);
+  }
+  std::sort(candidates.begin(), candidates.end(), [this](Handle a, Handle b)
+  {
+    const Allocation& first = m_Allocations[a];
+    const Allocation& second = m_Allocations[b];
+    return first.Page != second.Page ? first.Page > second.Page : first.Offset > second.Offset;
+  });
+
+  size_t moved = 0;
+  for (Handle handle : candidates)
+  {
+    Allocation& allocation = m_Allocations[handle];
+    size_t blockSize = GetBlockSize(allocation.Order);
+    if (moved + blockSize > maxBytes)
+      break;
+
+    int page;
+    unsigned int offset, foundOrder;
+    if (!FindFreeBlock(allocation.Order, allocation.Page, allocation.Offset, page, offset, foundOrder))
+      continue;
+
+    TakeBlock(page, offset, foundOrder, allocation.Order);
+    m_Pages[allocation.Page]->Buffer->CopyTo(*m_Pages[page]->Buffer, allocation.Offset, offset, allocation.Size);
+    ReleaseBlock(allocation.Page, allocation.Offset, allocation.Order);
+    allocation.Page = page;
+    allocation.Offset = offset;
+    moved += blockSize;
+  }
+
+  // Keep the first page around so a steady trickle of allocations doesn't recreate it.
+  for (size_t i = 1; i < m_Pages.size(); i++)
+  {
+    if (m_Pages[i] && m_Pages[i]->Allocated == 0)
+      m_Pages[i].reset();
+  }
+  while (m_Pages.size() > 1 && !m_Pages.back())
+    m_Pages.pop_back();
+
+  if (moved)
+    m_Generation++;
+  m_Stats.BytesMoved = moved;
+  m_Stats.TotalBytesMoved += moved;
+  return moved;
+}
+
+const GpuHeap::Stats& GpuHeap::GetStats()
+{
+  m_Stats.Capacity = 0;
+  m_Stats.Allocated = 0;
+  m_Stats.Requested = 0;
+  m_Stats.LargestFreeBlock = 0;
+  m_Stats.Pages = 0;
+  m_Stats.Allocations = 0;
+
+  for (const std::unique_ptr<Page>& page : m_Pages)
+  {
+    if (!page)
+      continue;
+
+    m_Stats.Pages++;
+    m_Stats.Capacity += m_PageSize;
+    m_Stats.Allocated += page->Allocated;
+    for (unsigned int order = m_MaxOrder + 1; order-- > 0;)
+    {
+      if (!page->FreeLists[order].empty())
+      {
+        m_Stats.LargestFreeBlock = std::max(m_Stats.LargestFreeBlock, GetBlockSize(order));
+        break;
+      }
+    }
+  }
+
+  for (const Allocation& allocation : m_Allocations)
+  {
+    if (!allocation.Live)
+      continue;
+    m_Stats.Allocations++;
+    m_Stats.Requested += allocation.Size;
+  }
+
+  size_t free = m_Stats.Capacity - m_Stats.Allocated;
+  m_Stats.ExternalFragmentation = free ? 1.0f - (float)m_Stats.LargestFreeBlock / free : 0.0f;
+  m_Stats.InternalFragmentation = m_Stats.Allocated ? 1.0f - (float)m_Stats.Requested / m_Stats.Allocated : 0.0f;
+  return m_Stats;
+}
+
+std::vector<std::pair<size_t, size_t>> GpuHeap::GetAllocatedBlocks(unsigned int page) const
+{
+  std::vector<std::pair<size_t, size_t>> blocks;
+  for (const Allocation& allocation : m_Allocations)
+  {
+    if (allocation.Live && allocation.Page == (int)page)
+      blocks.push_back(std::make_pair((size_t)allocation.Offset, GetBlockSize(allocation.Order)));
+  }
+  return blocks;
+}
+
+void GpuHeap::OnImGuiRender()
+{
+  const Stats& stats = GetStats();
+  const double megabyte = 1024.0 * 1024.0;
+  ImGui::Text("Pages: %u (%.1f MB)  Allocations: %u", stats.Pages, stats.Capacity / megabyte, stats.Allocations);
+  ImGui::Text("Allocated: %.2f MB for %.2f MB requested (%.1f%% rounding)", stats.Allocated / megabyte,
+    stats.Requested / megabyte, stats.InternalFragmentation * 100.0f);
+  ImGui::Text("Largest free block: %.2f MB (%.1f%% fragmented)", stats.LargestFreeBlock / megabyte, stats.ExternalFragmentation * 100.0f);
+  ImGui::Text("Moved: %.1f KB last call, %.2f MB total", stats.BytesMoved / 1024.0, stats.TotalBytesMoved / megabyte);
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <memory>
+#include <set>
+#include <vector>
+
+#include "StorageBuffer.h"
+
+// Sub-allocates ranges of a few large GL buffers ("pages") with a buddy allocator, so many small
+// resources share storage instead of each owning a buffer object. Allocations are referred to by
+// handle because Defragment may move them: it copies blocks towards the start of the heap with
+// glCopyBufferSubData, a few at a time, and releases pages that end up empty. Look up the buffer
+// and offset again whenever GetGeneration changes.
+//
+// Get returns the heap that static VertexBuffers and IndexBuffers share. It is never defragmented,
+// since vertex arrays hold on to the offsets their buffers had when they were added.
+class GpuHeap
+{
+public:
+  typedef unsigned int Handle;
+  static const Handle INVALID_HANDLE = 0xFFFFFFFF;
+
+  struct Stats
+  {
+    size_t Capacity;   // Bytes in all pages.
+    size_t Allocated;  // Bytes in allocated blocks, after rounding up to powers of two.
+    size_t Requested;  // Bytes actually asked for.
+    size_t LargestFreeBlock;
+    unsigned int Pages, Allocations;
+    // 0 when all free space is one block, approaching 1 as it splinters.
+    float ExternalFragmentation;
+    // Share of allocated bytes lost to rounding.
+    float InternalFragmentation;
+    size_t BytesMoved, TotalBytesMoved;
+  };
+
+private:
+  struct Page
+  {
+    std::unique_ptr<StorageBuffer> Buffer;
+    std::vector<std::set<unsigned int>> FreeLists; // Free block offsets per order.
+    size_t Allocated;
+  };
+
+  struct Allocation
+  {
+    int Page;
+    unsigned int Offset;
+    unsigned int Order;
+    size_t Size;
+    bool Live;
+  };
+
+  std::vector<std::unique_ptr<Page>> m_Pages; // Released pages leave a null slot.
+  std::vector<Allocation> m_Allocations;
+  std::vector<Handle> m_FreeHandles;
+  size_t m_PageSize, m_MinBlockSize;
+  unsigned int m_MaxOrder;
+  unsigned int m_Usage;
+  unsigned int m_Generation;
+  Stats m_Stats;
+
+public:
+  // pageSize and minBlockSize are rounded up to powers of two; minBlockSize is also the alignment.
+  GpuHeap(size_t pageSize = 16 * 1024 * 1024, size_t minBlockSize = 256, unsigned int usage = GL_STATIC_DRAW);
+  ~GpuHeap();
+
+  GpuHeap(const GpuHeap&) = delete;
+  GpuHeap& operator=(const GpuHeap&) = delete;
+
+  static GpuHeap& Get();
+
+  // Returns INVALID_HANDLE when size is zero or larger than a page.
+  Handle Allocate(size_t size);
+  void Free(Handle handle);
+  void Upload(Handle handle, const void* data, size_t size, size_t offset = 0);
+  // Frees every allocation and page. Call while the GL context still exists.
+  void Clear();
+
+  // Null, and zero for the offset and size, when the handle isn't a live allocation.
+  const StorageBuffer* GetBuffer(Handle handle) const;
+  size_t GetOffset(Handle handle) const;
+  size_t GetSize(Handle handle) const;
+  // Changes whenever Defragment moves something.
+  inline unsigned int GetGeneration() const { return m_Generation; }
+
+  // Moves up to maxBytes of allocations into free blocks nearer the start of the heap and
+  // releases emptied pages. Returns the bytes moved; call once per frame with a small budget.
+  size_t Defragment(size_t maxBytes);
+
+  const Stats& GetStats();
+  inline size_t GetPageSize() const { return m_PageSize; }
+  inline unsigned int GetPageCount() const { return (unsigned int)m_Pages.size(); }
+  // Allocated blocks in a page as (offset, size) pairs, for visualisation.
+  std::vector<std::pair<size_t, size_t>> GetAllocatedBlocks(unsigned int page) const;
+
+  void OnImGuiRender();
+private:
+  inline size_t GetBlockSize(unsigned int order) const { return m_MinBlockSize << order; }
+  // Prints an error for handles that aren't live allocations.
+  bool CheckHandle(Handle handle) const;
+  // Lowest placed free block of at least the given order that sits before (limitPage, limitOffset).
+  bool FindFreeBlock(unsigned int order, int limitPage, size_t limitOffset, int& page, unsigned int& offset, unsigned int& foundOrder) const;
+  unsigned int TakeBlock(int page, unsigned int offset, unsigned int foundOrder, unsigned int order);
+  void ReleaseBlock(int page, unsigned int offset, unsigned int order);
+  int AddPage();
+};
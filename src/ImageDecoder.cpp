@@ -0,0 +1,204 @@
+#include <cstring>
+
+#include "stb_image/stb_image.h"
+
+#ifdef OPENGL_USE_SPNG
+#include <spng.h>
+#endif
+
+#ifdef OPENGL_USE_TURBOJPEG
+#include <turbojpeg.h>
+#endif
+
+#include "ImageDecoder.h"
+
+// Fallback for every format stb_image understands. stb always decodes into its own allocation,
+// so this backend costs one extra copy into the destination.
+class StbImageDecoder : public ImageDecoder
+{
+public:
+  const char* GetName() const override { return "stb_image"; }
+
+  bool CanDecode(const unsigned char* data, size_t size) const override
+  {
+    int width, height, channels;
+    return stbi_info_from_memory(data, (int)size, &width, &height, &channels) != 0;
+  }
+
+  bool ReadInfo(const unsigned char* data, size_t size, ImageInfo& info) const override
+  {
+    return stbi_info_from_memory(data, (int)size, &info.Width, &info.Height, &info.Channels) != 0;
+  }
+
+  bool Decode(const unsigned char* data, size_t size, unsigned char* destination,
+    size_t destinationSize, int channels, bool flipVertically) const override
+  {
+    int width, height, fileChannels;
+    stbi_set_flip_vertically_on_load_thread(flipVertically ? 1 : 0);
+    unsigned char* pixels = stbi_load_from_memory(data, (int)size, &width, &height, &fileChannels, channels);
+    if (!pixels)
+      return false;
+
+    size_t decodedSize = (size_t)width * height * channels;
+    bool fits = decodedSize <= destinationSize;
+    if (fits)
+      memcpy(destination, pixels, decodedSize);
+
+    stbi_image_free(pixels);
+    return fits;
+  }
+
+  const char* GetFailureReason() const override { return stbi_failure_reason(); }
+};
+
+#ifdef OPENGL_USE_SPNG
+
+static bool IsPng(const unsigned char* data, size_t size)
+{
+  static const unsigned char signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+  return size >= sizeof(signature) && memcmp(data, signature, sizeof(signature)) == 0;
+}
+
+class SpngDecoder : public ImageDecoder
+{
+public:
+  const char* GetName() const override { return "libspng"; }
+
+  bool CanDecode(const unsigned char* data, size_t size) const override { return IsPng(data, size); }
+
+  bool ReadInfo(const unsigned char* data, size_t size, ImageInfo& info) const override
+  {
+    spng_ctx* context = spng_ctx_new(0);
+    spng_set_png_buffer(context, data, size);
+
+    struct spng_ihdr header;
+    bool valid = spng_get_ihdr(context, &header) == 0;
+    if (valid)
+    {
+      struct spng_trns transparency;
+      bool hasAlpha = header.color_type == SPNG_COLOR_TYPE_GRAYSCALE_ALPHA ||
+        header.color_type == SPNG_COLOR_TYPE_TRUECOLOR_ALPHA || spng_get_trns(context, &transparency) == 0;
+
+      info.Width = (int)header.width;
+      info.Height = (int)header.height;
+      info.Channels = hasAlpha ? 4 : 3;
+    }
+
+    spng_ctx_free(context);
+    return valid;
+  }
+
+  bool Decode(const unsigned char* data, size_t size, unsigned char* destination,
+    size_t destinationSize, int channels, bool flipVertically) const override
+  {
+    if (channels != 3 && channels != 4)
+      return false;
+
+    spng_ctx* context = spng_ctx_new(0);
+    spng_set_png_buffer(context, data, size);
+
+    int format = channels == 4 ? SPNG_FMT_RGBA8 : SPNG_FMT_RGB8;
+    struct spng_ihdr header;
+    size_t decodedSize = 0;
+    bool valid = spng_get_ihdr(context, &header) == 0 &&
+      spng_decoded_image_size(context, format, &decodedSize) == 0 && decodedSize <= destinationSize &&
+      spng_decode_image(context, nullptr, 0, format, SPNG_DECODE_TRNS | SPNG_DECODE_PROGRESSIVE) == 0;
+
+    // Decode row by row so flipping costs nothing; each row is written straight to its final place.
+    size_t rowSize = (size_t)header.width * channels;
+    int result = 0;
+    while (valid && result == 0)
+    {
+      struct spng_row_info row;
+      if (spng_get_row_info(context, &row) != 0)
+        break;
+
+      size_t y = flipVertically ? header.height - 1 - row.row_num : row.row_num;
+      result = spng_decode_row(context, destination + y * rowSize, rowSize);
+    }
+
+    spng_ctx_free(context);
+    return valid && result == SPNG_EOI;
+  }
+};
+
+#endif
+
+#ifdef OPENGL_USE_TURBOJPEG
+
+static bool IsJpeg(const unsigned char* data, size_t size)
+{
+  return size >= 3 && data[0] == 0xFF && data[1] == 0xD8 && data[2] == 0xFF;
+}
+
+class TurboJpegDecoder : public ImageDecoder
+{
+public:
+  const char* GetName() const override { return "libjpeg-turbo"; }
+
+  bool CanDecode(const unsigned char* data, size_t size) const override { return IsJpeg(data, size); }
+
+  bool ReadInfo(const unsigned char* data, size_t size, ImageInfo& info) const override
+  {
+    tjhandle handle = tjInitDecompress();
+    int subsampling, colorspace;
+    bool valid = tjDecompressHeader3(handle, data, (unsigned long)size, &info.Width, &info.Height,
+      &subsampling, &colorspace) == 0;
+    info.Channels = colorspace == TJCS_GRAY ? 1 : 3;
+    tjDestroy(handle);
+    return valid;
+  }
+
+  bool Decode(const unsigned char* data, size_t size, unsigned char* destination,
+    size_t destinationSize, int channels, bool flipVertically) const override
+  {
+    int pixelFormat;
+    switch (channels)
+    {
+      case 1: pixelFormat = TJPF_GRAY; break;
+      case 3: pixelFormat = TJPF_RGB; break;
+      case 4: pixelFormat = TJPF_RGBA; break;
+      default: return false;
+    }
+
+    tjhandle handle = tjInitDecompress();
+    int width, height, subsampling, colorspace;
+    bool valid = tjDecompressHeader3(handle, data, (unsigned long)size, &width, &height, &subsampling, &colorspace) == 0 &&
+      (size_t)width * height * channels <= destinationSize &&
+      tjDecompress2(handle, data, (unsigned long)size, destination, width, 0, height, pixelFormat,
+        TJFLAG_FASTDCT | (flipVertically ? TJFLAG_BOTTOMUP : 0)) == 0;
+    tjDestroy(handle);
+    return valid;
+  }
+};
+
+#endif
+
+static std::vector<std::unique_ptr<ImageDecoder>> CreateDecoders()
+{
+  std::vector<std::unique_ptr<ImageDecoder>> decoders;
+#ifdef OPENGL_USE_SPNG
+  decoders.emplace_back(new SpngDecoder());
+#endif
+#ifdef OPENGL_USE_TURBOJPEG
+  decoders.emplace_back(new TurboJpegDecoder());
+#endif
+  decoders.emplace_back(new StbImageDecoder());
+  return decoders;
+}
+
+const std::vector<std::unique_ptr<ImageDecoder>>& ImageDecoder::GetDecoders()
+{
+  static const std::vector<std::unique_ptr<ImageDecoder>> decoders = CreateDecoders();
+  return decoders;
+}
+
+const ImageDecoder* ImageDecoder::Find(const unsigned char* data, size_t size)
+{
+  for (const auto& decoder : GetDecoders())
+  {
+    if (decoder->CanDecode(data, size))
+      return decoder.get();
+  }
+  return nullptr;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+struct ImageInfo
+{
+  int Width;
+  int Height;
+  int Channels;
+};
+
+// Decodes an encoded image held in memory (usually a MappedFile) straight into caller-provided
+// memory, such as a mapped pixel unpack buffer, so pixels are written exactly once on the CPU.
+//
+// Backends are tried in order of preference. libspng and libjpeg-turbo are used when the project is
+// built with OPENGL_USE_SPNG / OPENGL_USE_TURBOJPEG, and stb_image handles everything else.
+class ImageDecoder
+{
+public:
+  virtual ~ImageDecoder() {}
+
+  virtual const char* GetName() const = 0;
+  virtual bool CanDecode(const unsigned char* data, size_t size) const = 0;
+
+  // Reads the image dimensions and the channel count the image is stored with.
+  virtual bool ReadInfo(const unsigned char* data, size_t size, ImageInfo& info) const = 0;
+
+  // Writes tightly packed 8 bit rows with the given channel count into destination, which must hold
+  // at least width * height * channels bytes. Rows are written bottom-up when flipVertically is set,
+  // matching OpenGL's texture origin.
+  virtual bool Decode(const unsigned char* data, size_t size, unsigned char* destination,
+    size_t destinationSize, int channels, bool flipVertically) const = 0;
+
+  virtual const char* GetFailureReason() const { return "unknown error"; }
+
+  // Returns the preferred decoder for the data, or nullptr if the format isn't supported.
+  static const ImageDecoder* Find(const unsigned char* data, size_t size);
+  static const std::vector<std::unique_ptr<ImageDecoder>>& GetDecoders();
+};
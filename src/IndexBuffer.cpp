@@ -1,25 +1,76 @@
+#include <algorithm>
+#include <vector>
+
 #include "IndexBuffer.h"
 #include "Renderer.h"
 
-IndexBuffer::IndexBuffer(const unsigned int* data, unsigned int length)
-  : m_Length(length)
+IndexBuffer::IndexBuffer(const unsigned int* data, unsigned int length, BufferUsage usage)
+  : m_Storage(data, length * sizeof(unsigned int), usage), m_Length(length), m_Type(GL_UNSIGNED_INT)
 {
-  OpenGLCall(glGenBuffers(1, &m_RendererId));
-  OpenGLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererId));
-  OpenGLCall(glBufferData(GL_ELEMENT_ARRAY_BUFFER, length * sizeof (unsigned int), data, GL_STATIC_DRAW));
 }
 
-IndexBuffer::~IndexBuffer()
+IndexBuffer::IndexBuffer(const unsigned short* data, unsigned int length, BufferUsage usage)
+  : m_Storage(data, length * sizeof(unsigned short), usage), m_Length(length), m_Type(GL_UNSIGNED_SHORT)
 {
-  OpenGLCall(glDeleteBuffers(1, &m_RendererId));
+}
+
+std::unique_ptr<IndexBuffer> IndexBuffer::CreateCompact(const unsigned int* data, unsigned int length, BufferUsage usage)
+{
+  if (!data || std::any_of(data, data + length, [](unsigned int index) { return index >= 0xFFFF; }))
+    return std::make_unique<IndexBuffer>(data, length, usage);
+
+  std::vector<unsigned short> narrow(data, data + length);
+  return std::make_unique<IndexBuffer>(narrow.data(), length, usage);
+}
+
+void IndexBuffer::Store(const void* data, unsigned int length, unsigned int type)
+{
+  m_Length = length;
+  m_Type = type;
+  m_Storage.SetData(data, length * GetIndexSize());
 }
 
 void IndexBuffer::Bind() const
 {
-  OpenGLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererId));
+  m_Storage.Bind(GL_ELEMENT_ARRAY_BUFFER);
 }
 
 void IndexBuffer::Unbind() const
 {
   OpenGLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
 }
+
+void IndexBuffer::SetData(const unsigned int* data, unsigned int length)
+{
+  Store(data, length, GL_UNSIGNED_INT);
+}
+
+void IndexBuffer::SetData(const unsigned short* data, unsigned int length)
+{
+  Store(data, length, GL_UNSIGNED_SHORT);
+}
+
+void IndexBuffer::SetSubData(unsigned int first, const void* data, unsigned int length)
+{
+  if (first + length > m_Length)
+  {
+    std::cout << "[ERROR] [OPENGL]: Index buffer update of " << length << " indices at " << first << " overflows " << m_Length << " indices" << std::endl;
+    return;
+  }
+
+  m_Storage.SetSubData(first * GetIndexSize(), data, length * GetIndexSize());
+}
+
+void IndexBuffer::Orphan()
+{
+  m_Storage.Orphan();
+}
+
+void IndexBuffer::Resize(unsigned int length)
+{
+  if (length == m_Length)
+    return;
+
+  m_Storage.Resize(length * GetIndexSize());
+  m_Length = length;
+}
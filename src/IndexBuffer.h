@@ -1,16 +1,47 @@
 #pragma once
 
+#include <memory>
+
+#include "BufferStorage.h"
+
 class IndexBuffer
 {
 private:
-  unsigned int m_RendererId;
+  BufferStorage m_Storage;
   unsigned int m_Length;
+  unsigned int m_Type; // GL_UNSIGNED_INT or GL_UNSIGNED_SHORT.
 public:
-  IndexBuffer(const unsigned int* data, unsigned int length);
-  ~IndexBuffer();
+  IndexBuffer(const unsigned int* data, unsigned int length, BufferUsage usage = BufferUsage::Static);
+  // 16-bit indices, for meshes with at most 65536 vertices; half the memory and index fetch bandwidth.
+  IndexBuffer(const unsigned short* data, unsigned int length, BufferUsage usage = BufferUsage::Static);
+
+  IndexBuffer(IndexBuffer&&) = default;
+  IndexBuffer& operator=(IndexBuffer&&) = default;
 
   void Bind() const;
   void Unbind() const;
 
+  // Replaces every index, switching the index type to match the data.
+  void SetData(const unsigned int* data, unsigned int length);
+  void SetData(const unsigned short* data, unsigned int length);
+  // Overwrites indices from first onwards; the data must match GetType.
+  void SetSubData(unsigned int first, const void* data, unsigned int length);
+  // Detaches the current storage so new writes don't wait for draws still reading the old data.
+  void Orphan();
+  // Changes the length keeping existing indices; the buffer object stays the same.
+  void Resize(unsigned int length);
+
   inline unsigned int GetLength() const { return m_Length; };
-};
\ No newline at end of file
+  inline unsigned int GetType() const { return m_Type; }
+  inline unsigned int GetIndexSize() const { return m_Type == GL_UNSIGNED_SHORT ? 2 : 4; }
+  inline unsigned int GetRendererId() const { return m_Storage.GetRendererId(); }
+  // Byte offset of the first index in GetRendererId, non-zero for static buffers in the shared
+  // GpuHeap. Draws add it to their index offsets.
+  inline unsigned int GetOffset() const { return m_Storage.GetOffset(); }
+
+  // Uses 16-bit indices when every index is below 0xFFFF, 32-bit otherwise. 0xFFFF itself is kept
+  // out of 16-bit buffers since it's the primitive restart index when restart is enabled.
+  static std::unique_ptr<IndexBuffer> CreateCompact(const unsigned int* data, unsigned int length, BufferUsage usage = BufferUsage::Static);
+private:
+  void Store(const void* data, unsigned int length, unsigned int type);
+};
@@ -0,0 +1,319 @@
+#include <imgui/imgui.h>
+
+#include <chrono>
+
+#include "JobSystem.h"
+
+static thread_local int t_ThreadIndex = -1;
+
+WorkStealingDeque::WorkStealingDeque()
+  : m_Top(0), m_Bottom(0)
+{
+  for (std::atomic<Job*>& job : m_Jobs)
+    job.store(nullptr, std::memory_order_relaxed);
+}
+
+bool WorkStealingDeque::Push(Job* job)
+{
+  int64_t bottom = m_Bottom.load(std::memory_order_relaxed);
+  int64_t top = m_Top.load(std::memory_order_acquire);
+  if (bottom - top >= CAPACITY)
+    return false;
+
+  m_Jobs[bottom & (CAPACITY - 1)].store(job, std::memory_order_relaxed);
+  m_Bottom.store(bottom + 1, std::memory_order_release);
+  return true;
+}
+
+Job* WorkStealingDeque::Pop()
+{
+  int64_t bottom = m_Bottom.load(std::memory_order_relaxed) - 1;
+  m_Bottom.store(bottom, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  int64_t top = m_Top.load(std::memory_order_relaxed);
+
+  if (top > bottom)
+  {
+    m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+    return nullptr;
+  }
+
+  Job* job = m_Jobs[bottom & (CAPACITY - 1)].load(std::memory_order_relaxed);
+  if (top == bottom)
+  {
+    // Last job: race any thieves for it.
+    if (!m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+      job = nullptr;
+    m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+  }
+  return job;
+}
+
+Job* WorkStealingDeque::Steal()
+{
+  int64_t top = m_Top.load(std::memory_order_acquire);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  int64_t bottom = m_Bottom.load(std::memory_order_acquire);
+  if (top >= bottom)
+    return nullptr;
+
+  Job* job = m_Jobs[top & (CAPACITY - 1)].load(std::memory_order_relaxed);
+  if (!m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+    return nullptr;
+  return job;
+}
+
+JobSystem& JobSystem::Get()
+{
+  static JobSystem instance;
+  return instance;
+}
+
+JobSystem::JobSystem()
+  : m_Running(false), m_Sleeping(0)
+{
+  // Constructed by the first Get, which makes that thread the main one.
+  t_ThreadIndex = 0;
+  m_Participants.push_back(CreateParticipant(0));
+  Start();
+}
+
+JobSystem::~JobSystem()
+{
+  Shutdown();
+}
+
+std::unique_ptr<JobSystem::Participant> JobSystem::CreateParticipant(int index)
+{
+  std::unique_ptr<Participant> participant(new Participant());
+  participant->Jobs.reset(new Job[JOB_POOL_SIZE]);
+  for (size_t i = 0; i < JOB_POOL_SIZE; i++)
+    participant->Jobs[i].Done.store(true, std::memory_order_relaxed);
+  participant->NextJob = 0;
+  participant->Random = 2654435761u * (uint32_t)(index + 1);
+  participant->JobsRun.store(0, std::memory_order_relaxed);
+  participant->Steals.store(0, std::memory_order_relaxed);
+  return participant;
+}
+
+void JobSystem::Start(unsigned int workerCount)
+{
+  Shutdown();
+
+  if (workerCount == 0)
+  {
+    // hardware_concurrency is zero when unknown.
+    unsigned int threads = std::thread::hardware_concurrency();
+    workerCount = threads > 1 ? threads - 1 : 1;
+  }
+
+  // Every deque has to exist before any worker starts stealing from them.
+  for (unsigned int i = 1; i <= workerCount; i++)
+    m_Participants.push_back(CreateParticipant((int)i));
+
+  m_Running = true;
+  for (unsigned int i = 1; i <= workerCount; i++)
+    m_Participants[i]->Thread = std::thread(&JobSystem::WorkerLoop, this, (int)i);
+}
+
+void JobSystem::Shutdown()
+{
+  m_Running = false;
+  m_SleepCondition.notify_all();
+  for (size_t i = 1; i < m_Participants.size(); i++)
+    m_Participants[i]->Thread.join();
+  m_Participants.resize(1);
+}
+
+void JobSystem::Wait(JobCounter& counter)
+{
+  int index = GetThreadIndex();
+  while (!counter.IsDone())
+  {
+    if (index < 0)
+    {
+      std::this_thread::yield();
+      continue;
+    }
+
+    Job* job = FindJob(index);
+    if (job)
+      Execute(job);
+    else
+      std::this_thread::yield();
+  }
+
+  // The last job zeroes the counter while holding its lock, so this returns only once that
+  // thread has let go of it and it's safe to destroy.
+  std::lock_guard<std::mutex> lock(counter.m_Mutex);
+}
+
+int JobSystem::GetThreadIndex() const
+{
+  return t_ThreadIndex;
+}
+
+JobSystem::Stats JobSystem::GetStats() const
+{
+  Stats stats = {};
+  for (const std::unique_ptr<Participant>& participant : m_Participants)
+  {
+    stats.JobsRun += participant->JobsRun.load(std::memory_order_relaxed);
+    stats.Steals += participant->Steals.load(std::memory_order_relaxed);
+  }
+  return stats;
+}
+
+void JobSystem::OnImGuiRender()
+{
+  Stats stats = GetStats();
+  ImGui::Text("Workers: %u", GetWorkerCount());
+  ImGui::Text("Jobs run: %llu (%llu stolen)", (unsigned long long)stats.JobsRun, (unsigned long long)stats.Steals);
+}
+
+Job* JobSystem::AllocateJob()
+{
+  int index = GetThreadIndex();
+  Participant& participant = *m_Participants[index];
+  while (true)
+  {
+    // Slots can still be taken when the ring wraps, by queued jobs or the very job scheduling
+    // this one, so skip over those.
+    for (size_t attempt = 0; attempt < JOB_POOL_SIZE; attempt++)
+    {
+      Job* job = &participant.Jobs[participant.NextJob++ % JOB_POOL_SIZE];
+      if (job->Done.load(std::memory_order_acquire))
+      {
+        job->Done.store(false, std::memory_order_relaxed);
+        return job;
+      }
+    }
+
+    // Every slot is taken: help out until one frees up.
+    Job* other = FindJob(index);
+    if (other)
+      Execute(other);
+    else
+      std::this_thread::yield();
+  }
+}
+
+void JobSystem::Submit(Job* job, JobCounter* counter, JobCounter* dependency)
+{
+  job->Counter = counter;
+  if (counter)
+    counter->m_Count.fetch_add(1, std::memory_order_relaxed);
+
+  if (dependency)
+  {
+    std::lock_guard<std::mutex> lock(dependency->m_Mutex);
+    if (!dependency->IsDone())
+    {
+      dependency->m_Waiting.push_back(job);
+      return;
+    }
+  }
+  Push(job);
+}
+
+void JobSystem::Push(Job* job)
+{
+  if (!m_Participants[GetThreadIndex()]->Queue.Push(job))
+  {
+    Execute(job);
+    return;
+  }
+
+  if (m_Sleeping.load(std::memory_order_relaxed) > 0)
+    m_SleepCondition.notify_one();
+}
+
+void JobSystem::Execute(Job* job)
+{
+  job->Function(*job);
+  JobCounter* counter = job->Counter;
+  job->Done.store(true, std::memory_order_release);
+  m_Participants[GetThreadIndex()]->JobsRun.fetch_add(1, std::memory_order_relaxed);
+  if (counter)
+    Complete(counter);
+}
+
+void JobSystem::Complete(JobCounter* counter)
+{
+  int count = counter->m_Count.load(std::memory_order_relaxed);
+  while (count > 1)
+  {
+    if (counter->m_Count.compare_exchange_weak(count, count - 1, std::memory_order_acq_rel, std::memory_order_relaxed))
+      return;
+  }
+
+  // Possibly the last one: zero it under the lock so waiters and dependent jobs see it safely.
+  std::vector<Job*> ready;
+  {
+    std::lock_guard<std::mutex> lock(counter->m_Mutex);
+    if (counter->m_Count.fetch_sub(1, std::memory_order_acq_rel) == 1)
+      ready.swap(counter->m_Waiting);
+  }
+  for (Job* job : ready)
+    Push(job);
+}
+
+Job* JobSystem::FindJob(int index)
+{
+  Participant& self = *m_Participants[index];
+  Job* job = self.Queue.Pop();
+  if (job)
+    return job;
+
+  size_t count = m_Participants.size();
+  if (count < 2)
+    return nullptr;
+
+  // Xorshift for where to start looking, so thieves don't all pile onto the same victim.
+  self.Random ^= self.Random << 13;
+  self.Random ^= self.Random >> 17;
+  self.Random ^= self.Random << 5;
+  size_t start = self.Random % count;
+  for (size_t i = 0; i < count; i++)
+  {
+    size_t victim = (start + i) % count;
+    if (victim == (size_t)index)
+      continue;
+
+    job = m_Participants[victim]->Queue.Steal();
+    if (job)
+    {
+      self.Steals.fetch_add(1, std::memory_order_relaxed);
+      return job;
+    }
+  }
+  return nullptr;
+}
+
+void JobSystem::WorkerLoop(int index)
+{
+  t_ThreadIndex = index;
+  int idle = 0;
+  while (m_Running.load(std::memory_order_relaxed))
+  {
+    Job* job = FindJob(index);
+    if (job)
+    {
+      Execute(job);
+      idle = 0;
+      continue;
+    }
+
+    // Spin briefly before sleeping, as new work usually follows soon. Pushes only wake sleepers
+    // when there are any, so the timeout covers a wake up landing just before the wait.
+    if (++idle < 64)
+    {
+      std::this_thread::yield();
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(m_SleepMutex);
+    m_Sleeping++;
+    m_SleepCondition.wait_for(lock, std::chrono::milliseconds(1));
+    m_Sleeping--;
+  }
+}
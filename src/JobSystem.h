@@ -0,0 +1,213 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+class JobCounter;
+
+// A function and its captures, stored inline so scheduling doesn't allocate.
+struct Job
+{
+  static constexpr size_t DATA_SIZE = 64;
+
+  void (*Function)(Job& job);
+  JobCounter* Counter; // Decremented once the job has run.
+  std::atomic<bool> Done;
+  typename std::aligned_storage<DATA_SIZE, 16>::type Data;
+};
+
+// Number of unfinished jobs scheduled with it. Other jobs can be scheduled to start once it
+// reaches zero, and any thread can Wait for it. Must outlive the jobs that use it.
+class JobCounter
+{
+private:
+  std::atomic<int> m_Count;
+  std::mutex m_Mutex;
+  std::vector<Job*> m_Waiting; // Jobs depending on this counter, scheduled when it reaches zero.
+
+  friend class JobSystem;
+
+public:
+  JobCounter() : m_Count(0) {}
+
+  JobCounter(const JobCounter&) = delete;
+  JobCounter& operator=(const JobCounter&) = delete;
+
+  inline bool IsDone() const { return m_Count.load(std::memory_order_acquire) == 0; }
+};
+
+// Fixed size Chase-Lev deque. The owning thread pushes and pops at the bottom, any other thread
+// steals from the top; only taking the last job needs a compare and swap.
+class WorkStealingDeque
+{
+public:
+  static constexpr int64_t CAPACITY = 4096;
+
+private:
+  std::atomic<int64_t> m_Top;
+  char m_Padding[64 - sizeof(std::atomic<int64_t>)]; // Keeps thieves and the owner off each other's cache line.
+  std::atomic<int64_t> m_Bottom;
+  std::atomic<Job*> m_Jobs[CAPACITY];
+
+public:
+  WorkStealingDeque();
+
+  // Owner only. Returns false when full.
+  bool Push(Job* job);
+  // Owner only. Null when empty.
+  Job* Pop();
+  // Any thread. Null when empty or another thread got there first.
+  Job* Steal();
+  inline int64_t GetSize() const { return std::max<int64_t>(0, m_Bottom.load(std::memory_order_relaxed) - m_Top.load(std::memory_order_relaxed)); }
+};
+
+// Worker threads with a deque each, stealing from one another when they run out of work. The main
+// thread is participant zero: it schedules into its own deque and runs jobs while it waits. Jobs
+// can run on any thread, so they mustn't make OpenGL calls; hand results back to the main thread
+// instead, as VirtualTexture does with its loaded pages.
+class JobSystem
+{
+public:
+  struct Stats
+  {
+    uint64_t JobsRun;
+    uint64_t Steals;
+  };
+
+private:
+  static constexpr size_t JOB_POOL_SIZE = 4096;
+
+  struct Participant
+  {
+    WorkStealingDeque Queue;
+    std::unique_ptr<Job[]> Jobs; // Ring of job storage for jobs scheduled from this thread.
+    size_t NextJob;
+    uint32_t Random;
+    std::atomic<uint64_t> JobsRun;
+    std::atomic<uint64_t> Steals;
+    std::thread Thread;
+  };
+
+  std::vector<std::unique_ptr<Participant>> m_Participants;
+  std::atomic<bool> m_Running;
+  std::mutex m_SleepMutex;
+  std::condition_variable m_SleepCondition;
+  std::atomic<int> m_Sleeping;
+
+public:
+  static JobSystem& Get();
+
+  // Zero workers means one per hardware thread besides the main one. Only call from the main
+  // thread with no jobs in flight.
+  void Start(unsigned int workerCount = 0);
+  // Joins the workers. Scheduling still works afterwards, with the main thread running everything.
+  void Shutdown();
+
+  // Runs function() on any thread. If dependency is given, the job is held back until that
+  // counter reaches zero. From threads outside the system the job runs immediately instead.
+  template<typename Function>
+  void Schedule(Function&& function, JobCounter* counter = nullptr, JobCounter* dependency = nullptr)
+  {
+    typedef typename std::decay<Function>::type Stored;
+    static_assert(sizeof(Stored) <= Job::DATA_SIZE, "Job captures too much, capture by reference or pointer instead");
+    static_assert(alignof(Stored) <= 16, "Job captures are over-aligned");
+
+    if (GetThreadIndex() < 0)
+    {
+      while (dependency && !dependency->IsDone())
+        std::this_thread::yield();
+      Stored stored(std::forward<Function>(function));
+      stored();
+      return;
+    }
+
+    Job* job = AllocateJob();
+    new (&job->Data) Stored(std::forward<Function>(function));
+    job->Function = &Invoke<Stored>;
+    Submit(job, counter, dependency);
+  }
+
+  // Runs other jobs until the counter reaches zero.
+  void Wait(JobCounter& counter);
+
+  // Calls function(begin, end) over ranges covering [0, count) and returns once all are done.
+  // Each thread works through its range a grain at a time and splits off the back half whenever
+  // it has nothing else queued for others to steal, so the split adapts to how busy the workers
+  // are while the loop runs. function is called with at most grainSize items at once.
+  template<typename Function>
+  void ParallelFor(size_t count, size_t grainSize, const Function& function)
+  {
+    if (count == 0)
+      return;
+
+    JobCounter counter;
+    ScheduleRange(0, count, std::max<size_t>(grainSize, 1), &function, &counter);
+    Wait(counter);
+  }
+
+  // Zero on the main thread, 1 to the worker count on workers, -1 on other threads.
+  int GetThreadIndex() const;
+  inline unsigned int GetWorkerCount() const { return (unsigned int)m_Participants.size() - 1; }
+  Stats GetStats() const;
+
+  void OnImGuiRender();
+private:
+  JobSystem();
+  ~JobSystem();
+  JobSystem(const JobSystem&) = delete;
+  JobSystem& operator=(const JobSystem&) = delete;
+
+  template<typename Stored>
+  static void Invoke(Job& job)
+  {
+    Stored& stored = *reinterpret_cast<Stored*>(&job.Data);
+    stored();
+    stored.~Stored();
+  }
+
+  template<typename Function>
+  void ScheduleRange(size_t begin, size_t end, size_t grainSize, const Function* function, JobCounter* counter)
+  {
+    Schedule([=]() { RunRange(begin, end, grainSize, function, counter); }, counter);
+  }
+
+  template<typename Function>
+  void RunRange(size_t begin, size_t end, size_t grainSize, const Function* function, JobCounter* counter)
+  {
+    // The deque is checked again after every grain, so once a thief takes the half pushed last
+    // the rest of this range is split for the next one.
+    int index = GetThreadIndex();
+    while (begin < end)
+    {
+      while (end - begin > grainSize && index >= 0 && m_Participants[index]->Queue.GetSize() == 0)
+      {
+        size_t middle = begin + (end - begin) / 2;
+        ScheduleRange(middle, end, grainSize, function, counter);
+        end = middle;
+      }
+      size_t next = end - begin > grainSize ? begin + grainSize : end;
+      (*function)(begin, next);
+      begin = next;
+    }
+  }
+
+  static std::unique_ptr<Participant> CreateParticipant(int index);
+  Job* AllocateJob();
+  void Submit(Job* job, JobCounter* counter, JobCounter* dependency);
+  void Push(Job* job);
+  void Execute(Job* job);
+  // Counts a job against the counter, scheduling whatever was waiting for it to reach zero.
+  void Complete(JobCounter* counter);
+  // Finds a job for the participant: its own newest first, then the oldest of a random other's.
+  Job* FindJob(int index);
+  void WorkerLoop(int index);
+};
@@ -0,0 +1,90 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Where empty files point, so they are valid without a mapping.
+static const unsigned char s_EmptyFile[1] = {};
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::string& filepath)
+  : m_FilePath(filepath), m_Data(nullptr), m_Size(0), m_FileHandle(INVALID_HANDLE_VALUE), m_MappingHandle(nullptr)
+{
+  m_FileHandle = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+    OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if (m_FileHandle == INVALID_HANDLE_VALUE)
+    return;
+
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(m_FileHandle, &size))
+    return;
+  if (size.QuadPart == 0)
+  {
+    m_Data = s_EmptyFile;
+    return;
+  }
+
+  m_MappingHandle = CreateFileMappingA(m_FileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (!m_MappingHandle)
+    return;
+
+  m_Data = (const unsigned char*)MapViewOfFile(m_MappingHandle, FILE_MAP_READ, 0, 0, 0);
+  if (m_Data)
+    m_Size = (size_t)size.QuadPart;
+}
+
+MappedFile::~MappedFile()
+{
+  if (m_Data && m_Data != s_EmptyFile)
+    UnmapViewOfFile(m_Data);
+  if (m_MappingHandle)
+    CloseHandle(m_MappingHandle);
+  if (m_FileHandle != INVALID_HANDLE_VALUE)
+    CloseHandle(m_FileHandle);
+}
+
+#else
+
+MappedFile::MappedFile(const std::string& filepath)
+  : m_FilePath(filepath), m_Data(nullptr), m_Size(0), m_FileDescriptor(-1)
+{
+  m_FileDescriptor = open(filepath.c_str(), O_RDONLY);
+  if (m_FileDescriptor < 0)
+    return;
+
+  struct stat status;
+  if (fstat(m_FileDescriptor, &status) != 0)
+    return;
+  if (status.st_size == 0)
+  {
+    m_Data = s_EmptyFile;
+    return;
+  }
+
+  void* data = mmap(nullptr, (size_t)status.st_size, PROT_READ, MAP_PRIVATE, m_FileDescriptor, 0);
+  if (data == MAP_FAILED)
+    return;
+
+  madvise(data, (size_t)status.st_size, MADV_SEQUENTIAL);
+  m_Data = (const unsigned char*)data;
+  m_Size = (size_t)status.st_size;
+}
+
+MappedFile::~MappedFile()
+{
+  if (m_Data && m_Data != s_EmptyFile)
+    munmap((void*)m_Data, m_Size);
+  if (m_FileDescriptor >= 0)
+    close(m_FileDescriptor);
+}
+
+#endif
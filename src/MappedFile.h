@@ -0,0 +1,32 @@
+#pragma once
+
+#include <string>
+
+// Read-only memory mapping of a whole file. The contents are paged in by the OS on first access,
+// so no read buffer is allocated and nothing is copied before the data is consumed.
+// An empty file can't be mapped, so it is a valid view of zero bytes instead.
+class MappedFile
+{
+private:
+  std::string m_FilePath;
+  const unsigned char* m_Data;
+  size_t m_Size;
+#ifdef _WIN32
+  void* m_FileHandle;
+  void* m_MappingHandle;
+#else
+  int m_FileDescriptor;
+#endif
+
+public:
+  MappedFile(const std::string& filepath);
+  ~MappedFile();
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  inline bool IsValid() const { return m_Data != nullptr; }
+  inline const unsigned char* GetData() const { return m_Data; }
+  inline size_t GetSize() const { return m_Size; }
+  inline const std::string& GetFilePath() const { return m_FilePath; }
+};
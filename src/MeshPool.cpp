@@ -0,0 +1,120 @@
+#include <algorithm>
+
+#include "MeshPool.h"
+
+MeshPool::MeshPool(const VertexBufferLayout& layout, unsigned int vertexCapacity, unsigned int indexCapacity)
+  : m_Layout(layout), m_VertexCapacity(0), m_IndexCapacity(0), m_VertexCount(0), m_IndexCount(0)
+{
+  Reserve(std::max(vertexCapacity, 1u), std::max(indexCapacity, 1u));
+}
+
+MeshPool::~MeshPool()
+{
+}
+
+bool MeshPool::IsIndirectSupported()
+{
+  return GLEW_VERSION_4_3 || GLEW_ARB_multi_draw_indirect;
+}
+
+void MeshPool::Reserve(unsigned int vertexCount, unsigned int indexCount)
+{
+  if (vertexCount <= m_VertexCapacity && indexCount <= m_IndexCapacity)
+    return;
+
+  unsigned int vertexCapacity = std::max(vertexCount, m_VertexCapacity * 2);
+  unsigned int indexCapacity = std::max(indexCount, m_IndexCapacity * 2);
+  if (!m_VertexBuffer)
+  {
+    m_VertexBuffer = std::make_unique<VertexBuffer>(nullptr, vertexCapacity * m_Layout.GetStride());
+    m_IndexBuffer = std::make_unique<IndexBuffer>((const unsigned int*)nullptr, indexCapacity);
+    m_VertexArray = std::make_unique<VertexArray>();
+  }
+  else
+  {
+    // Resizing keeps the meshes already added, but moves storage that started in the shared
+    // GpuHeap into buffer objects of its own, so the vertex array is pointed at them again.
+    m_VertexBuffer->Resize(vertexCapacity * m_Layout.GetStride());
+    m_IndexBuffer->Resize(indexCapacity);
+  }
+  m_VertexArray->AddBuffer(*m_VertexBuffer, m_Layout);
+  m_IndexBuffer->Bind();
+  m_VertexArray->Unbind();
+
+  m_VertexCapacity = vertexCapacity;
+  m_IndexCapacity = indexCapacity;
+}
+
+unsigned int MeshPool::Add(const void* vertices, unsigned int vertexCount, const unsigned int* indices, unsigned int indexCount)
+{
+  Reserve(m_VertexCount + vertexCount, m_IndexCount + indexCount);
+
+  unsigned int stride = m_Layout.GetStride();
+  m_VertexBuffer->SetSubData(m_VertexCount * stride, vertices, vertexCount * stride);
+  m_IndexBuffer->SetSubData(m_IndexCount, indices, indexCount);
+
+  m_Meshes.push_back({ indexCount, m_IndexCount, (int)m_VertexCount, vertexCount });
+  m_VertexCount += vertexCount;
+  m_IndexCount += indexCount;
+  return (unsigned int)m_Meshes.size() - 1;
+}
+
+void MeshPool::Clear()
+{
+  // Keeps the storage; new meshes overwrite it from the start.
+  m_Meshes.clear();
+  m_VertexCount = 0;
+  m_IndexCount = 0;
+}
+
+size_t MeshPool::GetMemorySize() const
+{
+  return (size_t)m_VertexCapacity * m_Layout.GetStride() + (size_t)m_IndexCapacity * sizeof(unsigned int);
+}
+
+DrawElementsIndirectCommand MeshPool::GetCommand(unsigned int mesh, unsigned int instanceCount, unsigned int baseInstance) const
+{
+  const Mesh& range = m_Meshes[mesh];
+  unsigned int indexBase = m_IndexBuffer->GetOffset() / sizeof(unsigned int);
+  return { range.IndexCount, instanceCount, indexBase + range.FirstIndex, range.BaseVertex, baseInstance };
+}
+
+void MeshPool::Draw(const std::vector<unsigned int>& meshes, const Shader& shader)
+{
+  if (meshes.empty())
+    return;
+
+  m_Counts.clear();
+  m_Offsets.clear();
+  m_BaseVertices.clear();
+  size_t indexOffset = m_IndexBuffer->GetOffset();
+  for (unsigned int id : meshes)
+  {
+    const Mesh& mesh = m_Meshes[id];
+    m_Counts.push_back((GLsizei)mesh.IndexCount);
+    m_Offsets.push_back((void*)(indexOffset + mesh.FirstIndex * sizeof(unsigned int)));
+    m_BaseVertices.push_back(mesh.BaseVertex);
+  }
+
+  shader.Bind();
+  m_VertexArray->Bind();
+  OpenGLCall(glMultiDrawElementsBaseVertex(GL_TRIANGLES, m_Counts.data(), GL_UNSIGNED_INT, m_Offsets.data(),
+    (GLsizei)meshes.size(), m_BaseVertices.data()));
+}
+
+void MeshPool::DrawIndirect(const std::vector<DrawElementsIndirectCommand>& commands, const Shader& shader)
+{
+  if (commands.empty())
+    return;
+
+  size_t size = commands.size() * sizeof(DrawElementsIndirectCommand);
+  if (!m_IndirectBuffer || m_IndirectBuffer->GetSize() < size)
+    m_IndirectBuffer = std::make_unique<StorageBuffer>(size, nullptr, GL_STREAM_DRAW);
+  m_IndirectBuffer->SetSubData(0, size, commands.data());
+
+  shader.Bind();
+  m_VertexArray->Bind();
+  m_IndirectBuffer->Bind(GL_DRAW_INDIRECT_BUFFER);
+  OpenGLCall(glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr, (GLsizei)commands.size(), 0));
+  OpenGLCall(glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0));
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "DrawElementsIndirectCommand.h"
+#include "Renderer.h"
+#include "StorageBuffer.h"
+#include "VertexBufferLayout.h"
+
+// Many meshes sharing one vertex array, vertex buffer and index buffer. Each mesh is appended
+// to the end of the buffers and remembered by its first index and base vertex, so any list of
+// them is drawn with one glMultiDrawElementsBaseVertex, or one glMultiDrawElementsIndirect with
+// per mesh instance counts, and no vertex array switches. The buffers double when they fill up.
+class MeshPool
+{
+public:
+  struct Mesh
+  {
+    unsigned int IndexCount;
+    unsigned int FirstIndex;
+    int BaseVertex;
+    unsigned int VertexCount;
+  };
+
+private:
+  VertexBufferLayout m_Layout;
+  std::unique_ptr<VertexArray> m_VertexArray;
+  std::unique_ptr<VertexBuffer> m_VertexBuffer;
+  std::unique_ptr<IndexBuffer> m_IndexBuffer;
+  std::unique_ptr<StorageBuffer> m_IndirectBuffer;
+  unsigned int m_VertexCapacity, m_IndexCapacity;
+  unsigned int m_VertexCount, m_IndexCount;
+  std::vector<Mesh> m_Meshes;
+  // Scratch arrays for glMultiDrawElementsBaseVertex, kept to avoid allocating every draw.
+  std::vector<GLsizei> m_Counts;
+  std::vector<void*> m_Offsets;
+  std::vector<GLint> m_BaseVertices;
+
+public:
+  MeshPool(const VertexBufferLayout& layout, unsigned int vertexCapacity = 65536, unsigned int indexCapacity = 196608);
+  ~MeshPool();
+
+  MeshPool(const MeshPool&) = delete;
+  MeshPool& operator=(const MeshPool&) = delete;
+
+  // Indices are relative to the mesh's own vertices. Returns the mesh's id.
+  unsigned int Add(const void* vertices, unsigned int vertexCount, const unsigned int* indices, unsigned int indexCount);
+  void Clear();
+
+  // One draw for all the listed meshes.
+  void Draw(const std::vector<unsigned int>& meshes, const Shader& shader);
+  // One indirect draw; commands come from GetCommand. Needs OpenGL 4.3 or ARB_multi_draw_indirect.
+  void DrawIndirect(const std::vector<DrawElementsIndirectCommand>& commands, const Shader& shader);
+  DrawElementsIndirectCommand GetCommand(unsigned int mesh, unsigned int instanceCount = 1, unsigned int baseInstance = 0) const;
+
+  inline const Mesh& GetMesh(unsigned int mesh) const { return m_Meshes[mesh]; }
+  inline unsigned int GetMeshCount() const { return (unsigned int)m_Meshes.size(); }
+  inline const VertexArray& GetVertexArray() const { return *m_VertexArray; }
+  inline const IndexBuffer& GetIndexBuffer() const { return *m_IndexBuffer; }
+  size_t GetMemorySize() const;
+
+  static bool IsIndirectSupported();
+private:
+  void Reserve(unsigned int vertexCount, unsigned int indexCount);
+};
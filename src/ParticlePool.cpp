@@ -0,0 +1,281 @@
+#include <algorithm>
+#include <functional>
+#include <immintrin.h>
+
+#include "JobSystem.h"
+#include "ParticlePool.h"
+
+constexpr size_t ParticlePool::CHUNK_SIZE;
+
+ParticlePool::ParticlePool(size_t capacity)
+  : m_Capacity(capacity), m_Count(0), m_Stats{}
+{
+  for (std::vector<float>* values : { &m_PositionX, &m_PositionY, &m_PositionZ, &m_VelocityX, &m_VelocityY, &m_VelocityZ, &m_Age, &m_Lifetime })
+    values->resize(capacity);
+  m_ChunkAlive.resize((capacity + CHUNK_SIZE - 1) / CHUNK_SIZE);
+}
+
+void ParticlePool::Add(const Particle& particle)
+{
+  if (m_Capacity == 0)
+    return;
+
+  MakeRoom(1);
+  size_t i = m_Count++;
+  m_PositionX[i] = particle.PositionAge.x;
+  m_PositionY[i] = particle.PositionAge.y;
+  m_PositionZ[i] = particle.PositionAge.z;
+  m_Age[i] = particle.PositionAge.w;
+  m_VelocityX[i] = particle.VelocityLifetime.x;
+  m_VelocityY[i] = particle.VelocityLifetime.y;
+  m_VelocityZ[i] = particle.VelocityLifetime.z;
+  m_Lifetime[i] = particle.VelocityLifetime.w;
+  m_Stats.Alive = m_Count;
+}
+
+void ParticlePool::MakeRoom(size_t count)
+{
+  size_t space = m_Capacity - m_Count;
+  if (count <= space)
+    return;
+
+  size_t remove = std::min(count - space, m_Count);
+  if (remove == m_Count)
+  {
+    m_Count = 0;
+    m_Stats.Alive = 0;
+    return;
+  }
+
+  // Everything older than the remove-th oldest age goes, then as many of that exact age as needed.
+  m_AgeScratch.assign(m_Age.begin(), m_Age.begin() + m_Count);
+  std::nth_element(m_AgeScratch.begin(), m_AgeScratch.begin() + (remove - 1), m_AgeScratch.end(), std::greater<float>());
+  float threshold = m_AgeScratch[remove - 1];
+  size_t older = (size_t)std::count_if(m_AgeScratch.begin(), m_AgeScratch.begin() + (remove - 1),
+    [threshold](float age) { return age > threshold; });
+  size_t ties = remove - older;
+
+  // Removed particles are replaced by the last one, which is checked again in their place.
+  size_t i = 0;
+  while (i < m_Count && remove > 0)
+  {
+    float age = m_Age[i];
+    if (age > threshold || (age == threshold && ties > 0))
+    {
+      if (age == threshold)
+        ties--;
+      remove--;
+      Move(--m_Count, i);
+    }
+    else
+    {
+      i++;
+    }
+  }
+  m_Stats.Alive = m_Count;
+}
+
+void ParticlePool::Clear()
+{
+  m_Count = 0;
+  m_Stats = {};
+}
+
+Particle ParticlePool::Get(size_t index) const
+{
+  Particle particle;
+  particle.PositionAge = glm::vec4(m_PositionX[index], m_PositionY[index], m_PositionZ[index], m_Age[index]);
+  particle.VelocityLifetime = glm::vec4(m_VelocityX[index], m_VelocityY[index], m_VelocityZ[index], m_Lifetime[index]);
+  return particle;
+}
+
+void ParticlePool::Update(float deltaTime, const glm::vec3& gravity, float drag, SimdKernel kernel, bool parallel)
+{
+  if (!IsSimdKernelSupported(kernel))
+    kernel = SimdKernel::Scalar;
+
+  Step step;
+  step.DeltaTime = deltaTime;
+  step.Acceleration = gravity * deltaTime;
+  step.Damping = std::max(1.0f - drag * deltaTime, 0.0f);
+
+  size_t count = m_Count;
+  size_t chunks = (count + CHUNK_SIZE - 1) / CHUNK_SIZE;
+  auto updateChunks = [&](size_t begin, size_t end)
+  {
+    for (size_t chunk = begin; chunk < end; chunk++)
+      m_ChunkAlive[chunk] = UpdateChunk(step, kernel, chunk * CHUNK_SIZE, std::min(count, (chunk + 1) * CHUNK_SIZE));
+  };
+  if (parallel)
+    JobSystem::Get().ParallelFor(chunks, 1, updateChunks);
+  else
+    updateChunks(0, chunks);
+
+  size_t alive = 0;
+  for (size_t chunk = 0; chunk < chunks; chunk++)
+    alive += m_ChunkAlive[chunk];
+
+  // Every gap below the new count has a live particle at or above it to fill it. Gaps are filled
+  // front to back, taking particles from the top of the last chunks first.
+  size_t moved = 0;
+  size_t source = chunks, sourceBegin = 0, sourceEnd = 0;
+  for (size_t chunk = 0; chunk < chunks && chunk * CHUNK_SIZE < alive; chunk++)
+  {
+    size_t gapEnd = std::min(alive, (chunk + 1) * CHUNK_SIZE);
+    for (size_t gap = chunk * CHUNK_SIZE + m_ChunkAlive[chunk]; gap < gapEnd; gap++)
+    {
+      while (sourceBegin == sourceEnd)
+      {
+        source--;
+        sourceBegin = std::max(source * CHUNK_SIZE, alive);
+        sourceEnd = std::max(source * CHUNK_SIZE + m_ChunkAlive[source], sourceBegin);
+      }
+      Move(--sourceEnd, gap);
+      moved++;
+    }
+  }
+
+  m_Count = alive;
+  m_Stats.Alive = alive;
+  m_Stats.DiedLastUpdate = count - alive;
+  m_Stats.MovedLastUpdate = moved;
+}
+
+size_t ParticlePool::UpdateChunk(const Step& step, SimdKernel kernel, size_t begin, size_t end)
+{
+  // The SIMD kernels only take whole groups of lanes, the scalar kernel finishes the rest.
+  size_t done = begin;
+  switch (kernel)
+  {
+    case SimdKernel::Sse:
+      done = begin + ((end - begin) & ~(size_t)3);
+      IntegrateSse(step, begin, done);
+      break;
+    case SimdKernel::Avx2:
+      done = begin + ((end - begin) & ~(size_t)7);
+      IntegrateAvx2(step, begin, done);
+      break;
+    default:
+      break;
+  }
+  IntegrateScalar(step, done, end);
+
+  // Same test as the shader, so a zero lifetime is dead from the start.
+  size_t alive = end;
+  for (size_t i = begin; i < alive;)
+  {
+    if (m_Age[i] < m_Lifetime[i])
+      i++;
+    else
+      Move(--alive, i);
+  }
+  return alive - begin;
+}
+
+void ParticlePool::IntegrateScalar(const Step& step, size_t begin, size_t end)
+{
+  for (size_t i = begin; i < end; i++)
+  {
+    m_VelocityX[i] = (m_VelocityX[i] + step.Acceleration.x) * step.Damping;
+    m_VelocityY[i] = (m_VelocityY[i] + step.Acceleration.y) * step.Damping;
+    m_VelocityZ[i] = (m_VelocityZ[i] + step.Acceleration.z) * step.Damping;
+    m_PositionX[i] += m_VelocityX[i] * step.DeltaTime;
+    m_PositionY[i] += m_VelocityY[i] * step.DeltaTime;
+    m_PositionZ[i] += m_VelocityZ[i] * step.DeltaTime;
+    m_Age[i] += step.DeltaTime;
+  }
+}
+
+void ParticlePool::IntegrateSse(const Step& step, size_t begin, size_t end)
+{
+  const __m128 ax = _mm_set1_ps(step.Acceleration.x), ay = _mm_set1_ps(step.Acceleration.y), az = _mm_set1_ps(step.Acceleration.z);
+  const __m128 damping = _mm_set1_ps(step.Damping);
+  const __m128 dt = _mm_set1_ps(step.DeltaTime);
+
+  for (size_t i = begin; i < end; i += 4)
+  {
+    __m128 vx = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(&m_VelocityX[i]), ax), damping);
+    __m128 vy = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(&m_VelocityY[i]), ay), damping);
+    __m128 vz = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(&m_VelocityZ[i]), az), damping);
+    _mm_storeu_ps(&m_VelocityX[i], vx);
+    _mm_storeu_ps(&m_VelocityY[i], vy);
+    _mm_storeu_ps(&m_VelocityZ[i], vz);
+    _mm_storeu_ps(&m_PositionX[i], _mm_add_ps(_mm_loadu_ps(&m_PositionX[i]), _mm_mul_ps(vx, dt)));
+    _mm_storeu_ps(&m_PositionY[i], _mm_add_ps(_mm_loadu_ps(&m_PositionY[i]), _mm_mul_ps(vy, dt)));
+    _mm_storeu_ps(&m_PositionZ[i], _mm_add_ps(_mm_loadu_ps(&m_PositionZ[i]), _mm_mul_ps(vz, dt)));
+    _mm_storeu_ps(&m_Age[i], _mm_add_ps(_mm_loadu_ps(&m_Age[i]), dt));
+  }
+}
+
+SIMD_TARGET_AVX2 void ParticlePool::IntegrateAvx2(const Step& step, size_t begin, size_t end)
+{
+  const __m256 ax = _mm256_set1_ps(step.Acceleration.x), ay = _mm256_set1_ps(step.Acceleration.y), az = _mm256_set1_ps(step.Acceleration.z);
+  const __m256 damping = _mm256_set1_ps(step.Damping);
+  const __m256 dt = _mm256_set1_ps(step.DeltaTime);
+
+  for (size_t i = begin; i < end; i += 8)
+  {
+    __m256 vx = _mm256_mul_ps(_mm256_add_ps(_mm256_loadu_ps(&m_VelocityX[i]), ax), damping);
+    __m256 vy = _mm256_mul_ps(_mm256_add_ps(_mm256_loadu_ps(&m_VelocityY[i]), ay), damping);
+    __m256 vz = _mm256_mul_ps(_mm256_add_ps(_mm256_loadu_ps(&m_VelocityZ[i]), az), damping);
+    _mm256_storeu_ps(&m_VelocityX[i], vx);
+    _mm256_storeu_ps(&m_VelocityY[i], vy);
+    _mm256_storeu_ps(&m_VelocityZ[i], vz);
+    _mm256_storeu_ps(&m_PositionX[i], _mm256_fmadd_ps(vx, dt, _mm256_loadu_ps(&m_PositionX[i])));
+    _mm256_storeu_ps(&m_PositionY[i], _mm256_fmadd_ps(vy, dt, _mm256_loadu_ps(&m_PositionY[i])));
+    _mm256_storeu_ps(&m_PositionZ[i], _mm256_fmadd_ps(vz, dt, _mm256_loadu_ps(&m_PositionZ[i])));
+    _mm256_storeu_ps(&m_Age[i], _mm256_add_ps(_mm256_loadu_ps(&m_Age[i]), dt));
+  }
+}
+
+void ParticlePool::Write(Particle* destination, bool parallel) const
+{
+  if (!parallel)
+  {
+    WriteRange(destination, 0, m_Count);
+    return;
+  }
+
+  size_t count = m_Count;
+  size_t chunks = (count + CHUNK_SIZE - 1) / CHUNK_SIZE;
+  JobSystem::Get().ParallelFor(chunks, 1, [&](size_t begin, size_t end)
+  {
+    WriteRange(destination, begin * CHUNK_SIZE, std::min(count, end * CHUNK_SIZE));
+  });
+}
+
+void ParticlePool::WriteRange(Particle* destination, size_t begin, size_t end) const
+{
+  // Transposing four particles' worth of each array gives their interleaved vectors. This is
+  // bound by the memory it writes, so SSE is as fast as anything wider.
+  size_t i = begin;
+  for (; i + 4 <= end; i += 4)
+  {
+    __m128 px = _mm_loadu_ps(&m_PositionX[i]), py = _mm_loadu_ps(&m_PositionY[i]), pz = _mm_loadu_ps(&m_PositionZ[i]), age = _mm_loadu_ps(&m_Age[i]);
+    __m128 vx = _mm_loadu_ps(&m_VelocityX[i]), vy = _mm_loadu_ps(&m_VelocityY[i]), vz = _mm_loadu_ps(&m_VelocityZ[i]), life = _mm_loadu_ps(&m_Lifetime[i]);
+    _MM_TRANSPOSE4_PS(px, py, pz, age);
+    _MM_TRANSPOSE4_PS(vx, vy, vz, life);
+    _mm_storeu_ps(&destination[i].PositionAge.x, px);
+    _mm_storeu_ps(&destination[i].VelocityLifetime.x, vx);
+    _mm_storeu_ps(&destination[i + 1].PositionAge.x, py);
+    _mm_storeu_ps(&destination[i + 1].VelocityLifetime.x, vy);
+    _mm_storeu_ps(&destination[i + 2].PositionAge.x, pz);
+    _mm_storeu_ps(&destination[i + 2].VelocityLifetime.x, vz);
+    _mm_storeu_ps(&destination[i + 3].PositionAge.x, age);
+    _mm_storeu_ps(&destination[i + 3].VelocityLifetime.x, life);
+  }
+  for (; i < end; i++)
+    destination[i] = Get(i);
+}
+
+void ParticlePool::Move(size_t from, size_t to)
+{
+  m_PositionX[to] = m_PositionX[from];
+  m_PositionY[to] = m_PositionY[from];
+  m_PositionZ[to] = m_PositionZ[from];
+  m_VelocityX[to] = m_VelocityX[from];
+  m_VelocityY[to] = m_VelocityY[from];
+  m_VelocityZ[to] = m_VelocityZ[from];
+  m_Age[to] = m_Age[from];
+  m_Lifetime[to] = m_Lifetime[from];
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "CpuFeatures.h"
+
+// State of one particle as stored in the GPU buffers and written out by ParticlePool. A particle
+// is dead once its age reaches its lifetime.
+struct Particle
+{
+  glm::vec4 PositionAge;
+  glm::vec4 VelocityLifetime;
+};
+
+// Particles simulated on the CPU in structure of arrays form, with the live ones packed at the
+// front. Update works through chunks of CHUNK_SIZE particles, as jobs if parallel: each chunk is
+// integrated four (SSE) or eight (AVX2) particles at a time, then its dead particles are removed by
+// swapping the chunk's last live one into their place. A serial pass finally closes the gaps the
+// chunks left with particles from the end. Removal doesn't keep the order.
+class ParticlePool
+{
+public:
+  // Particles per job; a chunk's arrays fit in L2 between integrating and compacting it.
+  static constexpr size_t CHUNK_SIZE = 4096;
+
+  struct Stats
+  {
+    size_t Alive;
+    size_t DiedLastUpdate;
+    size_t MovedLastUpdate; // Moved between chunks to close the gaps, on top of the swaps.
+  };
+
+private:
+  struct Step
+  {
+    float DeltaTime;
+    glm::vec3 Acceleration; // Gravity times the time step.
+    float Damping;
+  };
+
+  size_t m_Capacity;
+  size_t m_Count;
+  std::vector<float> m_PositionX, m_PositionY, m_PositionZ;
+  std::vector<float> m_VelocityX, m_VelocityY, m_VelocityZ;
+  std::vector<float> m_Age, m_Lifetime;
+  std::vector<size_t> m_ChunkAlive;
+  std::vector<float> m_AgeScratch; // For MakeRoom, kept to avoid allocating every frame.
+  Stats m_Stats;
+
+public:
+  explicit ParticlePool(size_t capacity);
+
+  // When the pool is full the oldest particle is replaced, as the GPU backend's emission ring
+  // does. Call MakeRoom first when adding several, so the oldest are found in one pass.
+  void Add(const Particle& particle);
+  // Removes the oldest particles, the ones with the greatest age, until count more fit.
+  void MakeRoom(size_t count);
+  void Clear();
+  inline size_t GetCount() const { return m_Count; }
+  inline size_t GetCapacity() const { return m_Capacity; }
+  Particle Get(size_t index) const;
+
+  // Integrates every particle like ParticleUpdate.vert and removes the ones that died. Falls back
+  // to the scalar kernel when the CPU lacks the requested one.
+  void Update(float deltaTime, const glm::vec3& gravity, float drag, SimdKernel kernel = GetBestSimdKernel(), bool parallel = true);
+  // Interleaves the live particles into destination, which needs room for GetCount() of them.
+  // Only ever writes to it, in order, so it can be a mapped buffer.
+  void Write(Particle* destination, bool parallel = true) const;
+
+  inline const Stats& GetStats() const { return m_Stats; }
+private:
+  // Returns how many of the chunk's particles are still alive, now at the front of the chunk.
+  size_t UpdateChunk(const Step& step, SimdKernel kernel, size_t begin, size_t end);
+  void IntegrateScalar(const Step& step, size_t begin, size_t end);
+  void IntegrateSse(const Step& step, size_t begin, size_t end);
+  void IntegrateAvx2(const Step& step, size_t begin, size_t end);
+  void WriteRange(Particle* destination, size_t begin, size_t end) const;
+  void Move(size_t from, size_t to);
+};
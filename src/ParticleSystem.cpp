@@ -0,0 +1,304 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#include "ParticleSystem.h"
+#include "Renderer.h"
+
+namespace
+{
+  // Dead particles have an age past their lifetime; zero lifetime keeps them dead.
+  const Particle DEAD_PARTICLE = { glm::vec4(0.0f, 0.0f, 0.0f, 1.0f), glm::vec4(0.0f) };
+
+  const float QUAD_CORNERS[] = {
+    -1.0f, -1.0f,
+     1.0f, -1.0f,
+    -1.0f,  1.0f,
+     1.0f,  1.0f
+  };
+
+  uint32_t Hash(uint32_t x)
+  {
+    x ^= x >> 16;
+    x *= 0x7feb352du;
+    x ^= x >> 15;
+    x *= 0x846ca68bu;
+    x ^= x >> 16;
+    return x;
+  }
+
+  glm::vec3 RandomDirection(uint32_t slot, uint32_t stream, uint32_t seed)
+  {
+    float z = ParticleSystem::Random(slot, stream, seed) * 2.0f - 1.0f;
+    float angle = ParticleSystem::Random(slot, stream + 1, seed) * 6.2831853f;
+    float r = std::sqrt(std::max(1.0f - z * z, 0.0f));
+    return glm::vec3(r * std::cos(angle), r * std::sin(angle), z);
+  }
+
+  void BindParticleAttributes(unsigned int buffer, unsigned int firstLocation, unsigned int divisor)
+  {
+    OpenGLCall(glBindBuffer(GL_ARRAY_BUFFER, buffer));
+    for (unsigned int i = 0; i < 2; i++)
+    {
+      OpenGLCall(glEnableVertexAttribArray(firstLocation + i));
+      OpenGLCall(glVertexAttribPointer(firstLocation + i, 4, GL_FLOAT, GL_FALSE, sizeof(Particle), (const void*)(i * sizeof(glm::vec4))));
+      OpenGLCall(glVertexAttribDivisor(firstLocation + i, divisor));
+    }
+  }
+}
+
+ParticleEmitterSettings ParticleEmitterSettings::Fountain()
+{
+  ParticleEmitterSettings settings;
+  settings.Position = glm::vec3(0.0f);
+  settings.Radius = 0.2f;
+  settings.Direction = glm::vec3(0.0f, 1.0f, 0.0f);
+  settings.Spread = 0.25f;
+  settings.SpeedMin = 8.0f;
+  settings.SpeedMax = 12.0f;
+  settings.LifetimeMin = 2.0f;
+  settings.LifetimeMax = 4.0f;
+  settings.Rate = 100000.0f;
+  settings.Gravity = glm::vec3(0.0f, -9.81f, 0.0f);
+  settings.Drag = 0.1f;
+  settings.StartColor = glm::vec4(1.0f, 0.6f, 0.2f, 0.6f);
+  settings.EndColor = glm::vec4(0.2f, 0.3f, 1.0f, 0.0f);
+  settings.StartSize = 0.05f;
+  settings.EndSize = 0.02f;
+  return settings;
+}
+
+ParticleSystem::ParticleSystem(unsigned int capacity, Backend backend)
+  : m_Capacity(std::max(capacity, 1u)), m_Backend(backend), m_Settings(ParticleEmitterSettings::Fountain()), m_Current(0),
+    m_CpuStreamCount(0), m_EmitCursor(0), m_EmitAccumulator(0.0f), m_Frame(0), m_TimerQueries{ 0, 0 }, m_QueryFrame(0), m_Stats{}
+{
+  std::vector<Particle> dead(m_Capacity, DEAD_PARTICLE);
+  m_Quad = std::make_unique<VertexBuffer>(QUAD_CORNERS, (unsigned int)sizeof(QUAD_CORNERS));
+  for (int i = 0; i < 2; i++)
+  {
+    m_States[i] = std::make_unique<StorageBuffer>(m_Capacity * sizeof(Particle), dead.data(), GL_DYNAMIC_COPY);
+
+    unsigned int ids[2] = { 0, 0 };
+    OpenGLCall(glGenVertexArrays(2, ids));
+    m_UpdateArrays[i].Reset(ids[0]);
+    m_RenderArrays[i].Reset(ids[1]);
+
+    OpenGLCall(glBindVertexArray(ids[0]));
+    BindParticleAttributes(m_States[i]->GetRendererId(), 0, 0);
+
+    OpenGLCall(glBindVertexArray(ids[1]));
+    BindQuad();
+    BindParticleAttributes(m_States[i]->GetRendererId(), 1, 1);
+  }
+  OpenGLCall(glBindVertexArray(0));
+
+  m_UpdateShader = std::make_unique<Shader>("src/resources/ParticleUpdate.vert", std::vector<std::string>{ "v_PositionAge", "v_VelocityLifetime" });
+  m_RenderShader = std::make_unique<Shader>("src/resources/Particle.vert", "src/resources/Particle.frag");
+  OpenGLCall(glGenQueries(2, m_TimerQueries));
+
+  SetBackend(backend);
+}
+
+ParticleSystem::~ParticleSystem()
+{
+  OpenGLCall(glDeleteQueries(2, m_TimerQueries));
+}
+
+void ParticleSystem::SetBackend(Backend backend)
+{
+  m_Backend = backend;
+  if (m_Backend == Backend::Cpu)
+  {
+    m_CpuParticles = std::make_unique<ParticlePool>(m_Capacity);
+    m_CpuStream = std::make_unique<VertexBuffer>(nullptr, m_Capacity * (unsigned int)sizeof(Particle), BufferUsage::Stream);
+    unsigned int id = 0;
+    OpenGLCall(glGenVertexArrays(1, &id));
+    m_CpuRenderArray.Reset(id);
+    OpenGLCall(glBindVertexArray(id));
+    BindQuad();
+    BindParticleAttributes(m_CpuStream->GetRendererId(), 1, 1);
+    OpenGLCall(glBindVertexArray(0));
+  }
+  else
+  {
+    m_CpuParticles.reset();
+    m_CpuStream.reset();
+    m_CpuRenderArray.Reset();
+  }
+  Reset();
+}
+
+void ParticleSystem::Reset()
+{
+  std::vector<Particle> dead(m_Capacity, DEAD_PARTICLE);
+  m_States[m_Current]->SetSubData(0, m_Capacity * sizeof(Particle), dead.data());
+  if (m_CpuParticles)
+    m_CpuParticles->Clear();
+  m_CpuStreamCount = 0;
+  m_EmitCursor = 0;
+  m_EmitAccumulator = 0.0f;
+  m_QueryFrame = 0;
+  m_Stats = {};
+}
+
+float ParticleSystem::Random(uint32_t slot, uint32_t stream, uint32_t seed)
+{
+  return (float)(Hash(slot * 8 + stream + Hash(seed)) >> 8) / 16777216.0f;
+}
+
+void ParticleSystem::Update(float deltaTime)
+{
+  auto start = std::chrono::high_resolution_clock::now();
+
+  m_EmitAccumulator += std::max(m_Settings.Rate, 0.0f) * deltaTime;
+  unsigned int emitCount = (unsigned int)std::min(m_EmitAccumulator, (float)m_Capacity);
+  m_EmitAccumulator = std::min(m_EmitAccumulator - emitCount, 1.0f);
+
+  if (m_Backend == Backend::Gpu)
+    UpdateGpu(deltaTime, emitCount);
+  else
+    UpdateCpu(deltaTime, emitCount);
+
+  m_EmitCursor = (m_EmitCursor + emitCount) % m_Capacity;
+  m_Frame++;
+  m_Stats.Capacity = m_Capacity;
+  m_Stats.EmittedLastFrame = emitCount;
+  m_Stats.CpuMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+void ParticleSystem::UpdateGpu(float deltaTime, unsigned int emitCount)
+{
+  // Timing of the pass from two updates ago, read only if it's ready so it never stalls.
+  unsigned int query = m_TimerQueries[m_QueryFrame & 1];
+  if (m_QueryFrame >= 2)
+  {
+    GLuint available = 0;
+    OpenGLCall(glGetQueryObjectuiv(query, GL_QUERY_RESULT_AVAILABLE, &available));
+    if (available)
+    {
+      GLuint64 nanoseconds = 0;
+      OpenGLCall(glGetQueryObjectui64v(query, GL_QUERY_RESULT, &nanoseconds));
+      m_Stats.GpuMilliseconds = nanoseconds / 1e6;
+    }
+  }
+  m_QueryFrame++;
+
+  Shader& shader = *m_UpdateShader;
+  shader.Bind();
+  shader.SetUniform1f("u_DeltaTime", deltaTime);
+  shader.SetUniform3f("u_Gravity", m_Settings.Gravity.x, m_Settings.Gravity.y, m_Settings.Gravity.z);
+  shader.SetUniform1f("u_Drag", m_Settings.Drag);
+  shader.SetUniform1ui("u_Capacity", m_Capacity);
+  shader.SetUniform1ui("u_EmitStart", m_EmitCursor);
+  shader.SetUniform1ui("u_EmitCount", emitCount);
+  shader.SetUniform1ui("u_Seed", m_Frame);
+  shader.SetUniform3f("u_EmitterPosition", m_Settings.Position.x, m_Settings.Position.y, m_Settings.Position.z);
+  shader.SetUniform1f("u_EmitterRadius", m_Settings.Radius);
+  shader.SetUniform3f("u_Direction", m_Settings.Direction.x, m_Settings.Direction.y, m_Settings.Direction.z);
+  shader.SetUniform1f("u_Spread", m_Settings.Spread);
+  shader.SetUniform2f("u_Speed", m_Settings.SpeedMin, m_Settings.SpeedMax);
+  shader.SetUniform2f("u_Lifetime", m_Settings.LifetimeMin, m_Settings.LifetimeMax);
+
+  int next = 1 - m_Current;
+  OpenGLCall(glBindVertexArray(m_UpdateArrays[m_Current].Get()));
+  m_States[next]->BindBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0);
+  OpenGLCall(glEnable(GL_RASTERIZER_DISCARD));
+  OpenGLCall(glBeginQuery(GL_TIME_ELAPSED, query));
+  OpenGLCall(glBeginTransformFeedback(GL_POINTS));
+  OpenGLCall(glDrawArrays(GL_POINTS, 0, m_Capacity));
+  OpenGLCall(glEndTransformFeedback());
+  OpenGLCall(glEndQuery(GL_TIME_ELAPSED));
+  OpenGLCall(glDisable(GL_RASTERIZER_DISCARD));
+  OpenGLCall(glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0));
+  OpenGLCall(glBindVertexArray(0));
+  m_Current = next;
+}
+
+void ParticleSystem::UpdateCpu(float deltaTime, unsigned int emitCount)
+{
+  ParticlePool& particles = *m_CpuParticles;
+  particles.Update(deltaTime, m_Settings.Gravity, m_Settings.Drag);
+
+  // Spawning after integrating matches the shader, which leaves new particles at age zero.
+  // As on the GPU, a full pool gives the oldest particles' places to the new ones.
+  particles.MakeRoom(emitCount);
+  Particle particle;
+  for (unsigned int i = 0; i < emitCount; i++)
+  {
+    Spawn(particle, (m_EmitCursor + i) % m_Capacity);
+    particles.Add(particle);
+  }
+  m_Stats.Alive = (unsigned int)particles.GetCount();
+  m_Stats.Died = (unsigned int)particles.GetStats().DiedLastUpdate;
+
+  m_CpuStreamCount = 0;
+  unsigned int size = (unsigned int)(particles.GetCount() * sizeof(Particle));
+  if (size == 0)
+    return;
+
+  Particle* destination = (Particle*)m_CpuStream->Map(size);
+  if (!destination)
+    return;
+  particles.Write(destination);
+  if (m_CpuStream->Unmap())
+    m_CpuStreamCount = (unsigned int)particles.GetCount();
+}
+
+void ParticleSystem::Spawn(Particle& particle, uint32_t slot) const
+{
+  glm::vec3 offset = RandomDirection(slot, 0, m_Frame) * m_Settings.Radius * Random(slot, 2, m_Frame);
+  glm::vec3 direction = m_Settings.Direction + RandomDirection(slot, 3, m_Frame) * m_Settings.Spread;
+  float speed = glm::mix(m_Settings.SpeedMin, m_Settings.SpeedMax, Random(slot, 5, m_Frame));
+  float lifetime = glm::mix(m_Settings.LifetimeMin, m_Settings.LifetimeMax, Random(slot, 6, m_Frame));
+  particle.PositionAge = glm::vec4(m_Settings.Position + offset, 0.0f);
+  particle.VelocityLifetime = glm::vec4(direction * speed, lifetime);
+}
+
+void ParticleSystem::Render(const glm::mat4& view, const glm::mat4& projection)
+{
+  OpenGLCall(GLboolean blendEnabled = glIsEnabled(GL_BLEND));
+  GLint blendSource = GL_ONE, blendDestination = GL_ZERO;
+  OpenGLCall(glGetIntegerv(GL_BLEND_SRC_RGB, &blendSource));
+  OpenGLCall(glGetIntegerv(GL_BLEND_DST_RGB, &blendDestination));
+  GLboolean depthWrites = GL_TRUE;
+  OpenGLCall(glGetBooleanv(GL_DEPTH_WRITEMASK, &depthWrites));
+  OpenGLCall(glEnable(GL_BLEND));
+  OpenGLCall(glBlendFunc(GL_SRC_ALPHA, GL_ONE));
+  OpenGLCall(glDepthMask(GL_FALSE));
+
+  Shader& shader = *m_RenderShader;
+  shader.Bind();
+  shader.SetUniformMat4f("u_ViewProjection", projection * view);
+  // The view matrix's rows are the camera axes in world space.
+  shader.SetUniform3f("u_CameraRight", view[0][0], view[1][0], view[2][0]);
+  shader.SetUniform3f("u_CameraUp", view[0][1], view[1][1], view[2][1]);
+  shader.SetUniform4f("u_StartColor", m_Settings.StartColor.r, m_Settings.StartColor.g, m_Settings.StartColor.b, m_Settings.StartColor.a);
+  shader.SetUniform4f("u_EndColor", m_Settings.EndColor.r, m_Settings.EndColor.g, m_Settings.EndColor.b, m_Settings.EndColor.a);
+  shader.SetUniform2f("u_Size", m_Settings.StartSize, m_Settings.EndSize);
+
+  if (m_Backend == Backend::Cpu)
+  {
+    OpenGLCall(glBindVertexArray(m_CpuRenderArray.Get()));
+    OpenGLCall(glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, m_CpuStreamCount));
+  }
+  else
+  {
+    OpenGLCall(glBindVertexArray(m_RenderArrays[m_Current].Get()));
+    OpenGLCall(glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, m_Capacity));
+  }
+  OpenGLCall(glBindVertexArray(0));
+
+  OpenGLCall(glDepthMask(depthWrites));
+  OpenGLCall(glBlendFunc(blendSource, blendDestination));
+  if (!blendEnabled)
+  {
+    OpenGLCall(glDisable(GL_BLEND));
+  }
+}
+
+void ParticleSystem::BindQuad()
+{
+  m_Quad->Bind();
+  OpenGLCall(glEnableVertexAttribArray(0));
+  OpenGLCall(glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (const void*)(size_t)m_Quad->GetOffset()));
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "GLHandle.h"
+#include "ParticlePool.h"
+#include "Shader.h"
+#include "StorageBuffer.h"
+#include "VertexBuffer.h"
+
+struct ParticleEmitterSettings
+{
+  glm::vec3 Position;
+  float Radius;        // New particles start anywhere within this distance of Position.
+  glm::vec3 Direction; // Scaled by the speed, so its length matters.
+  float Spread;        // How far a random unit vector is mixed into Direction.
+  float SpeedMin, SpeedMax;
+  float LifetimeMin, LifetimeMax; // Seconds.
+  float Rate; // Particles per second.
+  glm::vec3 Gravity;
+  float Drag; // Fraction of the velocity lost per second.
+  glm::vec4 StartColor, EndColor;
+  float StartSize, EndSize;
+
+  static ParticleEmitterSettings Fountain();
+};
+
+// Fixed pool of particles simulated by a transform feedback pass ping-ponging between two buffers
+// and drawn as instanced camera facing quads. Emission walks a ring over the pool: every frame the
+// next slots in line are respawned, so the pool size caps rate times lifetime. Random numbers are
+// hashes of the slot and frame, which lets the CPU backend spawn identical particles.
+// The CPU backend keeps only live particles, in a ParticlePool streamed each frame into a mapped
+// vertex buffer. When it's full the oldest particles are replaced, matching the ring on the GPU.
+class ParticleSystem
+{
+public:
+  enum class Backend
+  {
+    Gpu, Cpu
+  };
+
+  struct Stats
+  {
+    unsigned int Capacity;
+    unsigned int EmittedLastFrame;
+    unsigned int Alive; // CPU backend only; the GPU's count would need reading back.
+    unsigned int Died; // CPU backend only.
+    double CpuMilliseconds; // Update on the CPU, or the time to submit it on the GPU.
+    double GpuMilliseconds; // Update pass from a timer query a couple of frames old.
+  };
+
+private:
+  unsigned int m_Capacity;
+  Backend m_Backend;
+  ParticleEmitterSettings m_Settings;
+  std::unique_ptr<StorageBuffer> m_States[2];
+  VertexArrayHandle m_UpdateArrays[2]; // Reading state buffer i.
+  VertexArrayHandle m_RenderArrays[2];
+  std::unique_ptr<VertexBuffer> m_Quad;
+  std::unique_ptr<Shader> m_UpdateShader;
+  std::unique_ptr<Shader> m_RenderShader;
+  int m_Current;
+  std::unique_ptr<ParticlePool> m_CpuParticles;
+  std::unique_ptr<VertexBuffer> m_CpuStream;
+  VertexArrayHandle m_CpuRenderArray;
+  unsigned int m_CpuStreamCount; // Particles in m_CpuStream.
+  unsigned int m_EmitCursor;
+  float m_EmitAccumulator;
+  uint32_t m_Frame;
+  unsigned int m_TimerQueries[2];
+  unsigned int m_QueryFrame; // Updates since the queries were last started from scratch.
+  Stats m_Stats;
+
+public:
+  ParticleSystem(unsigned int capacity, Backend backend = Backend::Gpu);
+  ~ParticleSystem();
+
+  ParticleSystem(const ParticleSystem&) = delete;
+  ParticleSystem& operator=(const ParticleSystem&) = delete;
+
+  // Switching restarts the simulation.
+  void SetBackend(Backend backend);
+  inline Backend GetBackend() const { return m_Backend; }
+  inline unsigned int GetCapacity() const { return m_Capacity; }
+  inline ParticleEmitterSettings& GetSettings() { return m_Settings; }
+  // Kills every particle.
+  void Reset();
+
+  void Update(float deltaTime);
+  // Additive blending, depth tested but not written. Restores the blend state afterwards.
+  void Render(const glm::mat4& view, const glm::mat4& projection);
+
+  inline const Stats& GetStats() const { return m_Stats; }
+  // Random number the spawn of a slot uses, in [0, 1). Shared with ParticleUpdate.vert.
+  static float Random(uint32_t slot, uint32_t stream, uint32_t seed);
+private:
+  void UpdateGpu(float deltaTime, unsigned int emitCount);
+  void UpdateCpu(float deltaTime, unsigned int emitCount);
+  void Spawn(Particle& particle, uint32_t slot) const;
+  // Quad corners as attribute 0 of the bound vertex array.
+  void BindQuad();
+};
@@ -0,0 +1,62 @@
+#include <algorithm>
+#include <cstdint>
+
+#include "PoolAllocator.h"
+
+PoolAllocator::PoolAllocator(size_t blockSize, unsigned int blocksPerPage, size_t alignment)
+  : m_Alignment(alignment), m_BlocksPerPage(std::max(blocksPerPage, 1u)), m_FreeList(nullptr), m_Stats{}
+{
+  blockSize = std::max(blockSize, sizeof(FreeBlock));
+  m_BlockSize = (blockSize + alignment - 1) & ~(alignment - 1);
+  m_Stats.BlockSize = m_BlockSize;
+}
+
+void* PoolAllocator::Allocate()
+{
+  if (!m_FreeList)
+    AddPage();
+
+  FreeBlock* block = m_FreeList;
+  m_FreeList = block->Next;
+  m_Stats.Live++;
+  m_Stats.HighWater = std::max(m_Stats.HighWater, m_Stats.Live);
+  m_Stats.Allocations++;
+  return block;
+}
+
+void PoolAllocator::Free(void* block)
+{
+  if (!block)
+    return;
+
+  FreeBlock* freed = static_cast<FreeBlock*>(block);
+  freed->Next = m_FreeList;
+  m_FreeList = freed;
+  m_Stats.Live--;
+}
+
+void PoolAllocator::Reserve(unsigned int count)
+{
+  unsigned int capacity = (unsigned int)m_Pages.size() * m_BlocksPerPage;
+  while (capacity < m_Stats.Live + count)
+  {
+    AddPage();
+    capacity += m_BlocksPerPage;
+  }
+}
+
+void PoolAllocator::AddPage()
+{
+  // Extra room to align the first block, as new only guarantees the default alignment.
+  m_Pages.emplace_back(new unsigned char[m_BlockSize * m_BlocksPerPage + m_Alignment]);
+  uintptr_t start = ((uintptr_t)m_Pages.back().get() + m_Alignment - 1) & ~(uintptr_t)(m_Alignment - 1);
+
+  // Pushed in reverse so blocks come out in address order.
+  for (unsigned int i = m_BlocksPerPage; i > 0; i--)
+  {
+    FreeBlock* block = reinterpret_cast<FreeBlock*>(start + (i - 1) * m_BlockSize);
+    block->Next = m_FreeList;
+    m_FreeList = block;
+  }
+  m_Stats.Pages++;
+}
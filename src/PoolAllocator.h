@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <vector>
+
+// Fixed size blocks carved out of pages, with freed blocks kept on an intrusive free list. Pages
+// are never returned to the heap, so once a pool has reached its high-water mark allocating and
+// freeing cost a couple of pointer moves. Not thread safe.
+class PoolAllocator
+{
+public:
+  struct Stats
+  {
+    size_t BlockSize;
+    unsigned int Pages;
+    unsigned int Live, HighWater;
+    unsigned int Allocations;
+  };
+
+private:
+  struct FreeBlock
+  {
+    FreeBlock* Next;
+  };
+
+  size_t m_BlockSize;
+  size_t m_Alignment;
+  unsigned int m_BlocksPerPage;
+  std::vector<std::unique_ptr<unsigned char[]>> m_Pages;
+  FreeBlock* m_FreeList;
+  Stats m_Stats;
+
+public:
+  // alignment must be a power of two. Blocks are at least pointer sized.
+  PoolAllocator(size_t blockSize, unsigned int blocksPerPage = 256, size_t alignment = alignof(std::max_align_t));
+
+  PoolAllocator(const PoolAllocator&) = delete;
+  PoolAllocator& operator=(const PoolAllocator&) = delete;
+
+  void* Allocate();
+  // block must have come from this pool.
+  void Free(void* block);
+  // Adds pages until at least count blocks are free.
+  void Reserve(unsigned int count);
+
+  inline size_t GetBlockSize() const { return m_BlockSize; }
+  inline size_t GetAlignment() const { return m_Alignment; }
+  inline const Stats& GetStats() const { return m_Stats; }
+private:
+  void AddPage();
+};
+
+// Lets node based containers (std::list, std::map, std::set, ...) take their nodes from a pool
+// sized for them. Anything bigger than a block, like a hash table's bucket array, goes to the
+// global heap instead.
+template<typename T>
+class PoolStlAllocator
+{
+private:
+  PoolAllocator* m_Pool;
+
+  template<typename U>
+  friend class PoolStlAllocator;
+
+public:
+  typedef T value_type;
+
+  PoolStlAllocator(PoolAllocator& pool) : m_Pool(&pool) {}
+  template<typename U>
+  PoolStlAllocator(const PoolStlAllocator<U>& other) : m_Pool(other.m_Pool) {}
+
+  T* allocate(size_t count)
+  {
+    if (FitsBlock(count))
+      return static_cast<T*>(m_Pool->Allocate());
+    return static_cast<T*>(::operator new(count * sizeof(T)));
+  }
+
+  void deallocate(T* pointer, size_t count)
+  {
+    if (FitsBlock(count))
+      m_Pool->Free(pointer);
+    else
+      ::operator delete(pointer);
+  }
+
+  inline PoolAllocator* GetPool() const { return m_Pool; }
+private:
+  inline bool FitsBlock(size_t count) const { return count * sizeof(T) <= m_Pool->GetBlockSize() && alignof(T) <= m_Pool->GetAlignment(); }
+};
+
+template<typename T, typename U>
+inline bool operator==(const PoolStlAllocator<T>& a, const PoolStlAllocator<U>& b) { return a.GetPool() == b.GetPool(); }
+template<typename T, typename U>
+inline bool operator!=(const PoolStlAllocator<T>& a, const PoolStlAllocator<U>& b) { return a.GetPool() != b.GetPool(); }
@@ -0,0 +1,304 @@
+#include <algorithm>
+
+#include <imgui/imgui.h>
+
+#include "PostProcessStack.h"
+#include "RenderTargetPool.h"
+
+static const unsigned int COMPOSITE_BLOOM = 1 << 0;
+static const unsigned int COMPOSITE_TONEMAP_REINHARD = 1 << 1;
+static const unsigned int COMPOSITE_TONEMAP_ACES = 1 << 2;
+static const unsigned int COMPOSITE_COLOR_GRADING = 1 << 3;
+static const unsigned int COMPOSITE_VIGNETTE = 1 << 4;
+static const unsigned int COMPOSITE_OUTPUT_LUMA = 1 << 5;
+
+static const unsigned int BLOOM_FORMAT = GL_R11F_G11F_B10F;
+
+PostProcessStack::PostProcessStack()
+  : m_Settings{ 1.0f, Tonemapper::Aces, true, 0.8f, 0.5f, 0.6f, 1.0f, 6, true, 1.0f, true, 0.5f, 0.75f, 0.45f, true },
+    m_Stats{}
+{
+  // Full-screen passes generate their vertices from gl_VertexID; the core profile still needs a bound VAO.
+  m_VertexArray = std::make_unique<VertexArray>();
+  m_PrefilterShader = std::make_unique<Shader>("src/resources/PostProcess.vert", "src/resources/BloomDownsample.frag", std::vector<std::string>{ "PREFILTER" });
+  m_DownsampleShader = std::make_unique<Shader>("src/resources/PostProcess.vert", "src/resources/BloomDownsample.frag");
+  m_UpsampleShader = std::make_unique<Shader>("src/resources/PostProcess.vert", "src/resources/BloomUpsample.frag");
+  m_FxaaShader = std::make_unique<Shader>("src/resources/PostProcess.vert", "src/resources/Fxaa.frag");
+}
+
+PostProcessStack::~PostProcessStack()
+{
+}
+
+void PostProcessStack::SetLut(std::unique_ptr<Texture3D> lut)
+{
+  m_Lut = std::move(lut);
+}
+
+unsigned int PostProcessStack::GetCompositeFeatures() const
+{
+  unsigned int features = 0;
+  if (m_Settings.Bloom)
+    features |= COMPOSITE_BLOOM;
+  if (m_Settings.Tonemapping == Tonemapper::Reinhard)
+    features |= COMPOSITE_TONEMAP_REINHARD;
+  if (m_Settings.Tonemapping == Tonemapper::Aces)
+    features |= COMPOSITE_TONEMAP_ACES;
+  if (m_Settings.ColorGrading && m_Lut)
+    features |= COMPOSITE_COLOR_GRADING;
+  if (m_Settings.Vignette)
+    features |= COMPOSITE_VIGNETTE;
+  if (m_Settings.Fxaa)
+    features |= COMPOSITE_OUTPUT_LUMA;
+  return features;
+}
+
+Shader& PostProcessStack::GetCompositeShader(unsigned int features)
+{
+  auto it = m_CompositeShaders.find(features);
+  if (it != m_CompositeShaders.end())
+    return *it->second;
+
+  static const char* names[] = { "BLOOM", "TONEMAP_REINHARD", "TONEMAP_ACES", "COLOR_GRADING", "VIGNETTE", "OUTPUT_LUMA" };
+  std::vector<std::string> defines;
+  for (int i = 0; i < 6; i++)
+  {
+    if (features & (1u << i))
+      defines.push_back(names[i]);
+  }
+
+  std::unique_ptr<Shader>& shader = m_CompositeShaders[features];
+  shader = std::make_unique<Shader>("src/resources/PostProcess.vert", "src/resources/PostProcess.frag", defines);
+  return *shader;
+}
+
+void PostProcessStack::DrawFullscreen(const Framebuffer* target) const
+{
+  if (target)
+  {
+    target->Bind();
+  }
+  else
+  {
+    OpenGLCall(glBindFramebuffer(GL_FRAMEBUFFER, 0));
+    OpenGLCall(glViewport(0, 0, (GLsizei)WINDOW_WIDTH, (GLsizei)WINDOW_HEIGHT));
+  }
+
+  m_VertexArray->Bind();
+  OpenGLCall(glDrawArrays(GL_TRIANGLES, 0, 3));
+}
+
+void PostProcessStack::RenderBloom(const RenderTexture& source, FrameVector<Framebuffer*>& chain)
+{
+  RenderTargetPool& pool = RenderTargetPool::Get();
+  const RenderTexture* input = &source;
+  int width = source.GetWidth(), height = source.GetHeight();
+
+  for (int level = 0; level < m_Settings.BloomLevels && width > 1 && height > 1; level++)
+  {
+    width /= 2;
+    height /= 2;
+    Framebuffer* output = pool.Acquire({ width, height, { BLOOM_FORMAT }, 0, 0 });
+
+    // The first downsample also thresholds, so the rest of the chain only carries bright areas.
+    Shader& shader = level == 0 ? *m_PrefilterShader : *m_DownsampleShader;
+    shader.Bind();
+    shader.SetUniform1i("u_Texture", 0);
+    shader.SetUniform2f("u_TexelSize", 1.0f / input->GetWidth(), 1.0f / input->GetHeight());
+    if (level == 0)
+    {
+      shader.SetUniform1f("u_Threshold", m_Settings.BloomThreshold);
+      shader.SetUniform1f("u_Knee", std::max(m_Settings.BloomKnee * m_Settings.BloomThreshold, 0.0001f));
+    }
+    input->Bind(0);
+    DrawFullscreen(output);
+
+    size_t bytes = (size_t)input->GetWidth() * input->GetHeight() * Texture::GetBytesPerTexel(input->GetInternalFormat()) +
+      (size_t)width * height * Texture::GetBytesPerTexel(BLOOM_FORMAT);
+    m_Stats.Passes++;
+    m_Stats.Bandwidth += bytes;
+
+    chain.push_back(output);
+    input = &output->GetColorAttachment();
+  }
+
+  // Walk back up, adding each blurred level onto the next larger one.
+  OpenGLCall(glEnable(GL_BLEND));
+  OpenGLCall(glBlendFunc(GL_ONE, GL_ONE));
+  m_UpsampleShader->Bind();
+  m_UpsampleShader->SetUniform1i("u_Texture", 0);
+  m_UpsampleShader->SetUniform1f("u_Radius", m_Settings.BloomRadius);
+  for (int level = (int)chain.size() - 1; level > 0; level--)
+  {
+    const RenderTexture& smaller = chain[level]->GetColorAttachment();
+    const RenderTexture& larger = chain[level - 1]->GetColorAttachment();
+    m_UpsampleShader->SetUniform2f("u_TexelSize", 1.0f / smaller.GetWidth(), 1.0f / smaller.GetHeight());
+    smaller.Bind(0);
+    DrawFullscreen(chain[level - 1]);
+
+    // Blending reads the destination as well as writing it.
+    size_t bytes = (size_t)smaller.GetWidth() * smaller.GetHeight() * Texture::GetBytesPerTexel(BLOOM_FORMAT) +
+      2 * (size_t)larger.GetWidth() * larger.GetHeight() * Texture::GetBytesPerTexel(BLOOM_FORMAT);
+    m_Stats.Passes++;
+    m_Stats.Bandwidth += bytes;
+  }
+  OpenGLCall(glDisable(GL_BLEND));
+}
+
+void PostProcessStack::Apply(const Framebuffer& source, const Framebuffer* target)
+{
+  RenderTargetPool& pool = RenderTargetPool::Get();
+  const RenderTexture& scene = source.GetColorAttachment();
+  int width = scene.GetWidth(), height = scene.GetHeight();
+
+  OpenGLCall(GLboolean blendEnabled = glIsEnabled(GL_BLEND));
+  GLint blendSource = GL_ONE, blendDestination = GL_ZERO;
+  OpenGLCall(glGetIntegerv(GL_BLEND_SRC_RGB, &blendSource));
+  OpenGLCall(glGetIntegerv(GL_BLEND_DST_RGB, &blendDestination));
+  OpenGLCall(GLboolean depthTestEnabled = glIsEnabled(GL_DEPTH_TEST));
+  OpenGLCall(glDisable(GL_BLEND));
+  OpenGLCall(glDisable(GL_DEPTH_TEST));
+
+  m_Stats = {};
+  FrameVector<Framebuffer*> bloomChain;
+  if (m_Settings.Bloom)
+  {
+    bloomChain.reserve(m_Settings.BloomLevels);
+    RenderBloom(scene, bloomChain);
+  }
+  // Bloom passes cost the same fused or not.
+  m_Stats.UnfusedPasses = m_Stats.Passes;
+  m_Stats.UnfusedBandwidth = m_Stats.Bandwidth;
+
+  unsigned int features = GetCompositeFeatures();
+  if (bloomChain.empty())
+    features &= ~COMPOSITE_BLOOM;
+  Shader& composite = GetCompositeShader(features);
+  composite.Bind();
+  composite.SetUniform1i("u_Scene", 0);
+  composite.SetUniform1f("u_Exposure", m_Settings.Exposure);
+  scene.Bind(0);
+
+  size_t pixels = (size_t)width * height;
+  size_t hdrBytes = pixels * Texture::GetBytesPerTexel(scene.GetInternalFormat());
+  size_t ldrBytes = pixels * 4;
+  size_t bloomBytes = 0;
+  if (features & COMPOSITE_BLOOM)
+  {
+    const RenderTexture& bloom = bloomChain.front()->GetColorAttachment();
+    bloomBytes = (size_t)bloom.GetWidth() * bloom.GetHeight() * Texture::GetBytesPerTexel(BLOOM_FORMAT);
+    composite.SetUniform1i("u_Bloom", 1);
+    composite.SetUniform1f("u_BloomIntensity", m_Settings.BloomIntensity);
+    bloom.Bind(1);
+  }
+  if (features & COMPOSITE_COLOR_GRADING)
+  {
+    composite.SetUniform1i("u_Lut", 2);
+    composite.SetUniform1f("u_LutSize", (float)m_Lut->GetWidth());
+    composite.SetUniform1f("u_LutContribution", m_Settings.LutContribution);
+    m_Lut->Bind(2);
+  }
+  if (features & COMPOSITE_VIGNETTE)
+  {
+    composite.SetUniform1f("u_VignetteIntensity", m_Settings.VignetteIntensity);
+    composite.SetUniform1f("u_VignetteRadius", m_Settings.VignetteRadius);
+    composite.SetUniform1f("u_VignetteSmoothness", m_Settings.VignetteSmoothness);
+  }
+
+  // One pass per effect would add the bloom in HDR, tonemap into LDR, then grade and vignette
+  // with a full read and write of the image each.
+  m_Stats.Passes++;
+  m_Stats.Bandwidth += hdrBytes + bloomBytes + ldrBytes;
+  if (features & COMPOSITE_BLOOM)
+  {
+    m_Stats.UnfusedPasses++;
+    m_Stats.UnfusedBandwidth += 2 * hdrBytes + bloomBytes;
+  }
+  m_Stats.UnfusedPasses++;
+  m_Stats.UnfusedBandwidth += hdrBytes + ldrBytes;
+  if (features & COMPOSITE_COLOR_GRADING)
+  {
+    m_Stats.UnfusedPasses++;
+    m_Stats.UnfusedBandwidth += 2 * ldrBytes;
+  }
+  if (features & COMPOSITE_VIGNETTE)
+  {
+    m_Stats.UnfusedPasses++;
+    m_Stats.UnfusedBandwidth += 2 * ldrBytes;
+  }
+
+  if (m_Settings.Fxaa)
+  {
+    Framebuffer* tonemapped = pool.Acquire({ width, height, { GL_RGBA8 }, 0, 0 });
+    DrawFullscreen(tonemapped);
+
+    m_FxaaShader->Bind();
+    m_FxaaShader->SetUniform1i("u_Texture", 0);
+    m_FxaaShader->SetUniform2f("u_TexelSize", 1.0f / width, 1.0f / height);
+    tonemapped->GetColorAttachment().Bind(0);
+    DrawFullscreen(target);
+    pool.Release(tonemapped);
+
+    m_Stats.Passes++;
+    m_Stats.Bandwidth += 2 * ldrBytes;
+    m_Stats.UnfusedPasses++;
+    m_Stats.UnfusedBandwidth += 2 * ldrBytes;
+  }
+  else
+  {
+    DrawFullscreen(target);
+  }
+
+  for (Framebuffer* level : bloomChain)
+    pool.Release(level);
+
+  OpenGLCall(glBindFramebuffer(GL_FRAMEBUFFER, 0));
+  OpenGLCall(glViewport(0, 0, (GLsizei)WINDOW_WIDTH, (GLsizei)WINDOW_HEIGHT));
+  OpenGLCall(glBlendFunc(blendSource, blendDestination));
+  if (blendEnabled)
+  {
+    OpenGLCall(glEnable(GL_BLEND));
+  }
+  if (depthTestEnabled)
+  {
+    OpenGLCall(glEnable(GL_DEPTH_TEST));
+  }
+}
+
+void PostProcessStack::OnImGuiRender()
+{
+  PostProcessSettings& settings = m_Settings;
+  ImGui::SliderFloat("Exposure", &settings.Exposure, 0.0f, 4.0f);
+  int tonemapping = (int)settings.Tonemapping;
+  if (ImGui::Combo("Tonemapping", &tonemapping, "None\0Reinhard\0ACES\0"))
+    settings.Tonemapping = (Tonemapper)tonemapping;
+
+  ImGui::Checkbox("Bloom", &settings.Bloom);
+  if (settings.Bloom)
+  {
+    ImGui::SliderFloat("Threshold", &settings.BloomThreshold, 0.0f, 2.0f);
+    ImGui::SliderFloat("Knee", &settings.BloomKnee, 0.0f, 1.0f);
+    ImGui::SliderFloat("Intensity", &settings.BloomIntensity, 0.0f, 2.0f);
+    ImGui::SliderFloat("Radius", &settings.BloomRadius, 0.5f, 3.0f);
+    ImGui::SliderInt("Levels", &settings.BloomLevels, 1, 8);
+  }
+
+  ImGui::Checkbox("Colour grading", &settings.ColorGrading);
+  if (settings.ColorGrading)
+    ImGui::SliderFloat("LUT contribution", &settings.LutContribution, 0.0f, 1.0f);
+
+  ImGui::Checkbox("Vignette", &settings.Vignette);
+  if (settings.Vignette)
+  {
+    ImGui::SliderFloat("Vignette intensity", &settings.VignetteIntensity, 0.0f, 1.0f);
+    ImGui::SliderFloat("Vignette radius", &settings.VignetteRadius, 0.0f, 1.0f);
+    ImGui::SliderFloat("Vignette smoothness", &settings.VignetteSmoothness, 0.01f, 1.0f);
+  }
+
+  ImGui::Checkbox("FXAA", &settings.Fxaa);
+
+  const double megabyte = 1024.0 * 1024.0;
+  ImGui::Text("Passes: %d (%d unfused)", m_Stats.Passes, m_Stats.UnfusedPasses);
+  ImGui::Text("Bandwidth: %.2f MB (%.2f MB unfused)", m_Stats.Bandwidth / megabyte, m_Stats.UnfusedBandwidth / megabyte);
+  ImGui::Text("Composite variants compiled: %d", (int)m_CompositeShaders.size());
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+
+#include "FrameAllocator.h"
+#include "Framebuffer.h"
+#include "Texture3D.h"
+
+enum class Tonemapper
+{
+  None, Reinhard, Aces
+};
+
+struct PostProcessSettings
+{
+  float Exposure;
+  Tonemapper Tonemapping;
+
+  bool Bloom;
+  float BloomThreshold, BloomKnee, BloomIntensity, BloomRadius;
+  int BloomLevels;
+
+  bool ColorGrading; // Only applies once a LUT has been set.
+  float LutContribution;
+
+  bool Vignette;
+  float VignetteIntensity, VignetteRadius, VignetteSmoothness;
+
+  bool Fxaa;
+};
+
+// Post-processing for an offscreen HDR framebuffer. Bloom builds its own downsample/upsample mip
+// chain, then every per-pixel effect (bloom composite, exposure, tonemapping, colour grading,
+// vignette) runs in a single full-screen pass compiled for the enabled combination, so the image
+// is read and written once instead of once per effect. FXAA needs the neighbours of the final
+// colour and stays a separate pass.
+class PostProcessStack
+{
+public:
+  struct Stats
+  {
+    int Passes;         // Full-screen passes issued last frame.
+    int UnfusedPasses;  // What one pass per effect would have issued.
+    size_t Bandwidth, UnfusedBandwidth; // Estimated bytes read and written by those passes.
+  };
+
+private:
+  PostProcessSettings m_Settings;
+  std::unique_ptr<VertexArray> m_VertexArray;
+  std::unique_ptr<Shader> m_PrefilterShader, m_DownsampleShader, m_UpsampleShader, m_FxaaShader;
+  std::unordered_map<unsigned int, std::unique_ptr<Shader>> m_CompositeShaders;
+  std::unique_ptr<Texture3D> m_Lut;
+  Stats m_Stats;
+
+public:
+  PostProcessStack();
+  ~PostProcessStack();
+
+  PostProcessStack(const PostProcessStack&) = delete;
+  PostProcessStack& operator=(const PostProcessStack&) = delete;
+
+  // Processes colour attachment 0 of source, which must not be multisampled, into target
+  // (nullptr for the default framebuffer).
+  void Apply(const Framebuffer& source, const Framebuffer* target);
+
+  void SetLut(std::unique_ptr<Texture3D> lut);
+
+  inline PostProcessSettings& GetSettings() { return m_Settings; }
+  inline const Stats& GetStats() const { return m_Stats; }
+
+  void OnImGuiRender();
+private:
+  // Leaves the bloom result in level 0 of chain, which the caller releases to the RenderTargetPool.
+  void RenderBloom(const RenderTexture& source, FrameVector<Framebuffer*>& chain);
+  unsigned int GetCompositeFeatures() const;
+  Shader& GetCompositeShader(unsigned int features);
+  void DrawFullscreen(const Framebuffer* target) const;
+};
@@ -0,0 +1,247 @@
+#include <algorithm>
+
+#include "Quadtree.h"
+
+LooseQuadtree::LooseQuadtree(const BoundingRect& world, unsigned int maxDepth)
+  : m_World(world), m_MaxDepth(maxDepth), m_Stats{}
+{
+  Clear();
+}
+
+unsigned int LooseQuadtree::Insert(const BoundingRect& bounds)
+{
+  unsigned int object;
+  if (!m_FreeObjects.empty())
+  {
+    object = m_FreeObjects.back();
+    m_FreeObjects.pop_back();
+  }
+  else
+  {
+    object = (unsigned int)m_Objects.size();
+    m_Objects.push_back({});
+  }
+
+  m_Objects[object].Bounds = bounds;
+  Link(object, FindNode(bounds));
+  m_Stats.Objects++;
+  return object;
+}
+
+void LooseQuadtree::Move(unsigned int object, const BoundingRect& bounds)
+{
+  if (!IsValid(object))
+    return;
+
+  int node = FindNode(bounds);
+  m_Objects[object].Bounds = bounds;
+  if (node != m_Objects[object].Node)
+  {
+    Unlink(object);
+    Link(object, node);
+  }
+}
+
+void LooseQuadtree::Remove(unsigned int object)
+{
+  if (!IsValid(object))
+    return;
+
+  Unlink(object);
+  m_Objects[object].Node = -1;
+  m_FreeObjects.push_back(object);
+  m_Stats.Objects--;
+}
+
+void LooseQuadtree::Clear()
+{
+  m_Nodes.clear();
+  m_Objects.clear();
+  m_FreeObjects.clear();
+
+  glm::vec2 extents = m_World.GetExtents();
+  Node root;
+  root.Center = m_World.GetCenter();
+  root.HalfSize = std::max(extents.x, extents.y);
+  root.Parent = -1;
+  std::fill(root.Children, root.Children + 4, -1);
+  root.FirstObject = -1;
+  root.SubtreeObjects = 0;
+  m_Nodes.push_back(root);
+  m_Stats = {};
+  m_Stats.Nodes = 1;
+}
+
+int LooseQuadtree::FindNode(const BoundingRect& bounds)
+{
+  glm::vec2 center = bounds.GetCenter(), extents = bounds.GetExtents();
+  if (!m_World.Contains(center))
+    return 0;
+
+  // The object fits a cell whose half size is at least its largest extent, wherever its centre
+  // falls in the cell.
+  float size = std::max(extents.x, extents.y);
+  int node = 0;
+  for (unsigned int depth = 0; depth < m_MaxDepth && size <= m_Nodes[node].HalfSize * 0.5f; depth++)
+  {
+    int quadrant = (center.x >= m_Nodes[node].Center.x ? 1 : 0) | (center.y >= m_Nodes[node].Center.y ? 2 : 0);
+    int child = m_Nodes[node].Children[quadrant];
+    if (child < 0)
+    {
+      float halfSize = m_Nodes[node].HalfSize * 0.5f;
+      Node created;
+      created.Center = m_Nodes[node].Center + glm::vec2(quadrant & 1 ? halfSize : -halfSize, quadrant & 2 ? halfSize : -halfSize);
+      created.HalfSize = halfSize;
+      created.Parent = node;
+      std::fill(created.Children, created.Children + 4, -1);
+      created.FirstObject = -1;
+      created.SubtreeObjects = 0;
+
+      child = (int)m_Nodes.size();
+      m_Nodes.push_back(created);
+      m_Nodes[node].Children[quadrant] = child;
+      m_Stats.Nodes++;
+    }
+    node = child;
+  }
+  return node;
+}
+
+void LooseQuadtree::Link(unsigned int object, int node)
+{
+  Object& linked = m_Objects[object];
+  linked.Node = node;
+  linked.Previous = -1;
+  linked.Next = m_Nodes[node].FirstObject;
+  if (linked.Next >= 0)
+    m_Objects[linked.Next].Previous = (int)object;
+  m_Nodes[node].FirstObject = (int)object;
+
+  for (int ancestor = node; ancestor >= 0; ancestor = m_Nodes[ancestor].Parent)
+    m_Nodes[ancestor].SubtreeObjects++;
+}
+
+void LooseQuadtree::Unlink(unsigned int object)
+{
+  Object& unlinked = m_Objects[object];
+  if (unlinked.Previous >= 0)
+    m_Objects[unlinked.Previous].Next = unlinked.Next;
+  else
+    m_Nodes[unlinked.Node].FirstObject = unlinked.Next;
+  if (unlinked.Next >= 0)
+    m_Objects[unlinked.Next].Previous = unlinked.Previous;
+
+  for (int ancestor = unlinked.Node; ancestor >= 0; ancestor = m_Nodes[ancestor].Parent)
+    m_Nodes[ancestor].SubtreeObjects--;
+}
+
+BoundingRect LooseQuadtree::GetLooseBounds(const Node& node) const
+{
+  glm::vec2 extents(node.HalfSize * 2.0f);
+  return { node.Center - extents, node.Center + extents };
+}
+
+void LooseQuadtree::CollectSubtree(int node, std::vector<unsigned int>& results) const
+{
+  std::vector<int> stack(1, node);
+  while (!stack.empty())
+  {
+    const Node& current = m_Nodes[stack.back()];
+    stack.pop_back();
+    m_Stats.NodesVisited++;
+
+    for (int object = current.FirstObject; object >= 0; object = m_Objects[object].Next)
+      results.push_back((unsigned int)object);
+    for (int child : current.Children)
+    {
+      if (child >= 0 && m_Nodes[child].SubtreeObjects)
+        stack.push_back(child);
+    }
+  }
+}
+
+template<typename NodeTest, typename ObjectTest>
+void LooseQuadtree::Traverse(NodeTest nodeTest, ObjectTest objectTest, std::vector<unsigned int>& results) const
+{
+  struct Entry
+  {
+    int Node;
+    unsigned int PlaneMask;
+  };
+
+  results.clear();
+  m_Stats.NodesVisited = 0;
+  m_Stats.ObjectsTested = 0;
+
+  // The root holds whatever lies outside the world, so its own bounds can't rule anything out.
+  std::vector<Entry> stack(1, { 0, Frustum::ALL_PLANES });
+  bool root = true;
+  while (!stack.empty())
+  {
+    Entry entry = stack.back();
+    stack.pop_back();
+    const Node& node = m_Nodes[entry.Node];
+
+    if (!root)
+    {
+      Frustum::Containment containment = nodeTest(GetLooseBounds(node), entry.PlaneMask);
+      if (containment == Frustum::Containment::Outside)
+      {
+        m_Stats.NodesVisited++;
+        continue;
+      }
+      if (containment == Frustum::Containment::Inside)
+      {
+        CollectSubtree(entry.Node, results);
+        continue;
+      }
+    }
+    root = false;
+    m_Stats.NodesVisited++;
+
+    for (int object = node.FirstObject; object >= 0; object = m_Objects[object].Next)
+    {
+      m_Stats.ObjectsTested++;
+      if (objectTest(m_Objects[object].Bounds))
+        results.push_back((unsigned int)object);
+    }
+    for (int child : node.Children)
+    {
+      if (child >= 0 && m_Nodes[child].SubtreeObjects)
+        stack.push_back({ child, entry.PlaneMask });
+    }
+  }
+}
+
+void LooseQuadtree::Query(const Frustum& frustum, std::vector<unsigned int>& results) const
+{
+  Traverse(
+    [&frustum](const BoundingRect& bounds, unsigned int& planeMask) { return frustum.Classify(bounds.ToBox(), planeMask); },
+    [&frustum](const BoundingRect& bounds) { return frustum.Intersects(bounds.ToBox()); },
+    results);
+}
+
+void LooseQuadtree::Query(const BoundingRect& rect, std::vector<unsigned int>& results) const
+{
+  Traverse(
+    [&rect](const BoundingRect& bounds, unsigned int&)
+    {
+      if (!rect.Overlaps(bounds))
+        return Frustum::Containment::Outside;
+      bool inside = glm::all(glm::greaterThanEqual(bounds.Min, rect.Min)) && glm::all(glm::lessThanEqual(bounds.Max, rect.Max));
+      return inside ? Frustum::Containment::Inside : Frustum::Containment::Intersects;
+    },
+    [&rect](const BoundingRect& bounds) { return rect.Overlaps(bounds); },
+    results);
+}
+
+void LooseQuadtree::QueryPoint(const glm::vec2& point, std::vector<unsigned int>& results) const
+{
+  Traverse(
+    [&point](const BoundingRect& bounds, unsigned int&)
+    {
+      return bounds.Contains(point) ? Frustum::Containment::Intersects : Frustum::Containment::Outside;
+    },
+    [&point](const BoundingRect& bounds) { return bounds.Contains(point); },
+    results);
+}
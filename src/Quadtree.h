@@ -0,0 +1,79 @@
+#pragma once
+
+#include <vector>
+
+#include "Bounds.h"
+#include "Frustum.h"
+
+// Loose quadtree over a fixed 2D world. Every node's bounds are its cell grown to twice the size,
+// so an object goes straight to the deepest level whose cells are at least as large as it and the
+// cell holding its centre; inserting and moving never have to search or split. Objects outside the
+// world, or too large for any cell, stay in the root. Nodes are created on demand and kept, and
+// empty branches are skipped by their object counts.
+class LooseQuadtree
+{
+public:
+  static constexpr unsigned int INVALID_OBJECT = 0xFFFFFFFF;
+
+  struct Stats
+  {
+    unsigned int Objects;
+    unsigned int Nodes;
+    unsigned int NodesVisited; // By the last query.
+    unsigned int ObjectsTested;
+  };
+
+private:
+  struct Node
+  {
+    glm::vec2 Center;
+    float HalfSize; // Of the cell, so the loose bounds extend twice as far.
+    int Parent;
+    int Children[4]; // -1 until something is put there.
+    int FirstObject;
+    unsigned int SubtreeObjects;
+  };
+
+  struct Object
+  {
+    BoundingRect Bounds;
+    int Node; // -1 while the id is free.
+    int Next, Previous;
+  };
+
+  BoundingRect m_World;
+  unsigned int m_MaxDepth;
+  std::vector<Node> m_Nodes;
+  std::vector<Object> m_Objects;
+  std::vector<unsigned int> m_FreeObjects;
+  mutable Stats m_Stats;
+
+public:
+  LooseQuadtree(const BoundingRect& world, unsigned int maxDepth = 10);
+
+  // Returns the new object's id.
+  unsigned int Insert(const BoundingRect& bounds);
+  void Move(unsigned int object, const BoundingRect& bounds);
+  void Remove(unsigned int object);
+  void Clear();
+
+  inline const BoundingRect& GetBounds(unsigned int object) const { return m_Objects[object].Bounds; }
+  inline bool IsValid(unsigned int object) const { return object < m_Objects.size() && m_Objects[object].Node >= 0; }
+
+  // Each query replaces the contents of results with the ids of the objects found.
+  void Query(const Frustum& frustum, std::vector<unsigned int>& results) const;
+  void Query(const BoundingRect& rect, std::vector<unsigned int>& results) const;
+  // Picking: every object whose bounds contain the point.
+  void QueryPoint(const glm::vec2& point, std::vector<unsigned int>& results) const;
+
+  inline const Stats& GetStats() const { return m_Stats; }
+private:
+  int FindNode(const BoundingRect& bounds);
+  void Link(unsigned int object, int node);
+  void Unlink(unsigned int object);
+  BoundingRect GetLooseBounds(const Node& node) const;
+  void CollectSubtree(int node, std::vector<unsigned int>& results) const;
+
+  template<typename NodeTest, typename ObjectTest>
+  void Traverse(NodeTest nodeTest, ObjectTest objectTest, std::vector<unsigned int>& results) const;
+};
@@ -0,0 +1,274 @@
+#include <algorithm>
+
+#include <imgui/imgui.h>
+
+#include "FrameAllocator.h"
+#include "RenderGraph.h"
+#include "RenderTargetPool.h"
+
+RenderGraphResource RenderGraphBuilder::Create(const std::string& name, const RenderGraphTextureDescription& description)
+{
+  m_Graph.m_Resources.push_back({ name, description, false, nullptr, -1, -1 });
+  return Write((RenderGraphResource)m_Graph.m_Resources.size() - 1);
+}
+
+RenderGraphResource RenderGraphBuilder::Read(RenderGraphResource resource, RenderGraphUsage usage)
+{
+  m_Graph.m_Passes[m_Pass].Reads.push_back({ resource, usage });
+  return resource;
+}
+
+RenderGraphResource RenderGraphBuilder::Write(RenderGraphResource resource, RenderGraphUsage usage)
+{
+  m_Graph.m_Passes[m_Pass].Writes.push_back({ resource, usage });
+  return resource;
+}
+
+void RenderGraphBuilder::SetSideEffect()
+{
+  m_Graph.m_Passes[m_Pass].SideEffect = true;
+}
+
+Framebuffer* RenderGraphContext::GetFramebuffer(RenderGraphResource resource) const
+{
+  return m_Graph.m_Resources[resource].Target;
+}
+
+const RenderTexture& RenderGraphContext::GetTexture(RenderGraphResource resource) const
+{
+  return m_Graph.m_Resources[resource].Target->GetColorAttachment();
+}
+
+RenderGraph::RenderGraph() : m_Compiled(false), m_Stats{}
+{
+}
+
+RenderGraph::~RenderGraph()
+{
+  // Hand back anything still held if Execute never ran to completion.
+  for (Resource& resource : m_Resources)
+  {
+    if (!resource.Imported && resource.Target)
+      RenderTargetPool::Get().Release(resource.Target);
+  }
+}
+
+void RenderGraph::AddPass(const std::string& name, const SetupCallback& setup, const ExecuteCallback& execute)
+{
+  m_Passes.push_back({ name, execute, {}, {}, false, false, 0 });
+  RenderGraphBuilder builder(*this, (int)m_Passes.size() - 1);
+  setup(builder);
+  m_Compiled = false;
+}
+
+RenderGraphResource RenderGraph::Import(const std::string& name, Framebuffer* framebuffer)
+{
+  RenderGraphTextureDescription description = { (int)WINDOW_WIDTH, (int)WINDOW_HEIGHT, 0, 0, 0 };
+  if (framebuffer)
+  {
+    const FramebufferSpecification& spec = framebuffer->GetSpecification();
+    description = { spec.Width, spec.Height, spec.ColorFormats.empty() ? 0 : spec.ColorFormats[0], spec.DepthFormat, spec.Samples };
+  }
+  m_Resources.push_back({ name, description, true, framebuffer, -1, -1 });
+  return (RenderGraphResource)m_Resources.size() - 1;
+}
+
+static unsigned int GetBarrierBits(RenderGraphUsage usage, bool write)
+{
+  switch (usage)
+  {
+  case RenderGraphUsage::Sampled:    return GL_TEXTURE_FETCH_BARRIER_BIT;
+  case RenderGraphUsage::Image:      return GL_SHADER_IMAGE_ACCESS_BARRIER_BIT;
+  case RenderGraphUsage::Attachment: return GL_FRAMEBUFFER_BARRIER_BIT | (write ? 0 : GL_TEXTURE_FETCH_BARRIER_BIT);
+  }
+  return 0;
+}
+
+void RenderGraph::Compile()
+{
+  m_Order.clear();
+  m_Stats = {};
+  m_Stats.Passes = (int)m_Passes.size();
+
+  // Walk backwards from the passes that must run (side effects or imported outputs), keeping
+  // any pass that writes something a kept pass reads. Passes are declared in submission order,
+  // so every producer comes before its consumers.
+  std::vector<bool> needed(m_Resources.size(), false);
+  for (int i = (int)m_Passes.size() - 1; i >= 0; i--)
+  {
+    Pass& pass = m_Passes[i];
+    bool keep = pass.SideEffect;
+    for (const Access& write : pass.Writes)
+      keep = keep || m_Resources[write.Resource].Imported || needed[write.Resource];
+
+    pass.Culled = !keep;
+    if (pass.Culled)
+    {
+      m_Stats.CulledPasses++;
+      continue;
+    }
+
+    for (const Access& read : pass.Reads)
+      needed[read.Resource] = true;
+  }
+
+  for (int i = 0; i < (int)m_Passes.size(); i++)
+  {
+    if (!m_Passes[i].Culled)
+      m_Order.push_back(i);
+  }
+
+  // Lifetimes in execution order, and the barriers incoherent image writes need before the next access.
+  for (Resource& resource : m_Resources)
+    resource.FirstUse = resource.LastUse = -1;
+
+  std::vector<bool> written(m_Resources.size(), false);
+  std::vector<bool> pendingImageWrite(m_Resources.size(), false);
+  for (int index = 0; index < (int)m_Order.size(); index++)
+  {
+    Pass& pass = m_Passes[m_Order[index]];
+    pass.Barriers = 0;
+
+    auto use = [&](const Access& access, bool write)
+    {
+      Resource& resource = m_Resources[access.Resource];
+      if (resource.FirstUse < 0)
+        resource.FirstUse = index;
+      resource.LastUse = index;
+
+      if (pendingImageWrite[access.Resource])
+      {
+        pass.Barriers |= GetBarrierBits(access.Usage, write);
+        pendingImageWrite[access.Resource] = false;
+      }
+    };
+
+    for (const Access& read : pass.Reads)
+    {
+      if (!written[read.Resource] && !m_Resources[read.Resource].Imported)
+        std::cout << "[WARNING] RenderGraph: pass '" << pass.Name << "' reads '" << m_Resources[read.Resource].Name << "' before anything writes it" << std::endl;
+      use(read, false);
+    }
+
+    for (const Access& write : pass.Writes)
+    {
+      use(write, true);
+      written[write.Resource] = true;
+      if (write.Usage == RenderGraphUsage::Image)
+        pendingImageWrite[write.Resource] = true;
+    }
+
+    if (pass.Barriers)
+      m_Stats.Barriers++;
+  }
+
+  for (const Resource& resource : m_Resources)
+  {
+    if (resource.Imported || resource.FirstUse < 0)
+      continue;
+
+    const RenderGraphTextureDescription& description = resource.Description;
+    size_t texels = (size_t)description.Width * description.Height * std::max(description.Samples, 1);
+    size_t bytesPerTexel = Texture::GetBytesPerTexel(description.ColorFormat) +
+      (description.DepthFormat ? Texture::GetBytesPerTexel(description.DepthFormat) : 0);
+    m_Stats.TransientResources++;
+    m_Stats.TransientMemory += texels * bytesPerTexel;
+  }
+
+  m_Compiled = true;
+}
+
+void RenderGraph::Execute()
+{
+  if (!m_Compiled)
+    Compile();
+
+  RenderTargetPool& pool = RenderTargetPool::Get();
+  RenderGraphContext context(*this);
+  FrameVector<Framebuffer*> physicalTargets;
+  physicalTargets.reserve(m_Resources.size());
+  bool barriersSupported = GLEW_VERSION_4_2 || GLEW_ARB_shader_image_load_store;
+
+  // Compile's stats describe the graph and stay; these describe this execution.
+  m_Stats.AliasedMemory = 0;
+  m_Stats.PhysicalTargets = 0;
+
+  for (int index = 0; index < (int)m_Order.size(); index++)
+  {
+    Pass& pass = m_Passes[m_Order[index]];
+
+    for (Resource& resource : m_Resources)
+    {
+      if (resource.Imported || resource.FirstUse != index)
+        continue;
+
+      const RenderGraphTextureDescription& description = resource.Description;
+      FramebufferSpecification spec = { description.Width, description.Height, {}, description.DepthFormat, description.Samples };
+      if (description.ColorFormat)
+        spec.ColorFormats.push_back(description.ColorFormat);
+
+      resource.Target = pool.Acquire(spec);
+      if (std::find(physicalTargets.begin(), physicalTargets.end(), resource.Target) == physicalTargets.end())
+      {
+        physicalTargets.push_back(resource.Target);
+        m_Stats.AliasedMemory += resource.Target->GetMemorySize();
+      }
+    }
+
+    if (pass.Barriers && barriersSupported)
+    {
+      OpenGLCall(glMemoryBarrier(pass.Barriers));
+    }
+
+    // Render into the first attachment the pass writes; passes without one leave the binding alone.
+    for (const Access& write : pass.Writes)
+    {
+      if (write.Usage != RenderGraphUsage::Attachment)
+        continue;
+
+      const Resource& resource = m_Resources[write.Resource];
+      if (resource.Target)
+      {
+        resource.Target->Bind();
+      }
+      else
+      {
+        OpenGLCall(glBindFramebuffer(GL_FRAMEBUFFER, 0));
+        OpenGLCall(glViewport(0, 0, (GLsizei)WINDOW_WIDTH, (GLsizei)WINDOW_HEIGHT));
+      }
+      break;
+    }
+
+    pass.Execute(context);
+
+    for (Resource& resource : m_Resources)
+    {
+      if (resource.Imported || resource.LastUse != index)
+        continue;
+
+      pool.Release(resource.Target);
+      resource.Target = nullptr;
+    }
+  }
+
+  m_Stats.PhysicalTargets = (int)physicalTargets.size();
+  OpenGLCall(glBindFramebuffer(GL_FRAMEBUFFER, 0));
+  OpenGLCall(glViewport(0, 0, (GLsizei)WINDOW_WIDTH, (GLsizei)WINDOW_HEIGHT));
+}
+
+void RenderGraph::OnImGuiRender() const
+{
+  const double megabyte = 1024.0 * 1024.0;
+  ImGui::Text("Passes: %d (%d culled)  Barriers: %d", m_Stats.Passes, m_Stats.CulledPasses, m_Stats.Barriers);
+  ImGui::Text("Transients: %d on %d targets, %.2f MB aliased into %.2f MB", m_Stats.TransientResources,
+    m_Stats.PhysicalTargets, m_Stats.TransientMemory / megabyte, m_Stats.AliasedMemory / megabyte);
+
+  for (int i = 0; i < (int)m_Passes.size(); i++)
+  {
+    const Pass& pass = m_Passes[i];
+    if (pass.Culled)
+      ImGui::TextDisabled("  %s (culled)", pass.Name.c_str());
+    else
+      ImGui::Text("  %s", pass.Name.c_str());
+  }
+}
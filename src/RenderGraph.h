@@ -0,0 +1,135 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "Framebuffer.h"
+
+typedef int RenderGraphResource;
+
+enum class RenderGraphUsage
+{
+  Attachment, // Rendered to as a framebuffer attachment.
+  Sampled,    // Read through a sampler.
+  Image       // Accessed with image load/store, which needs explicit memory barriers.
+};
+
+struct RenderGraphTextureDescription
+{
+  int Width, Height;
+  unsigned int ColorFormat;
+  unsigned int DepthFormat; // 0 for none.
+  int Samples;
+};
+
+class RenderGraph;
+
+// Passed to a pass's setup callback to declare what it creates, reads and writes.
+class RenderGraphBuilder
+{
+private:
+  RenderGraph& m_Graph;
+  int m_Pass;
+
+public:
+  RenderGraphBuilder(RenderGraph& graph, int pass) : m_Graph(graph), m_Pass(pass) {}
+
+  // Declares a transient texture that this pass writes first. Its storage comes from the
+  // RenderTargetPool only for the span of passes that use it.
+  RenderGraphResource Create(const std::string& name, const RenderGraphTextureDescription& description);
+  RenderGraphResource Read(RenderGraphResource resource, RenderGraphUsage usage = RenderGraphUsage::Sampled);
+  RenderGraphResource Write(RenderGraphResource resource, RenderGraphUsage usage = RenderGraphUsage::Attachment);
+  // Keeps the pass even if nothing reads its output (e.g. it writes buffers or reads back).
+  void SetSideEffect();
+};
+
+// Passed to a pass's execute callback to look up the physical resources.
+class RenderGraphContext
+{
+private:
+  const RenderGraph& m_Graph;
+
+public:
+  RenderGraphContext(const RenderGraph& graph) : m_Graph(graph) {}
+
+  // Framebuffer backing a resource, nullptr for the default framebuffer.
+  Framebuffer* GetFramebuffer(RenderGraphResource resource) const;
+  const RenderTexture& GetTexture(RenderGraphResource resource) const;
+};
+
+// Frame graph of passes declaring reads and writes of virtual resources. Compile culls passes
+// whose results nobody uses, orders the rest, works out each transient texture's lifetime and
+// which memory barriers image writes need. Execute then acquires each transient from the
+// RenderTargetPool right before its first use and releases it after its last, so transients with
+// disjoint lifetimes alias the same physical target.
+class RenderGraph
+{
+public:
+  typedef std::function<void(RenderGraphBuilder&)> SetupCallback;
+  typedef std::function<void(RenderGraphContext&)> ExecuteCallback;
+
+  struct Stats
+  {
+    int Passes, CulledPasses;
+    int TransientResources, PhysicalTargets;
+    size_t TransientMemory; // Sum of every transient's size, as if each had its own target.
+    size_t AliasedMemory;   // Memory of the physical targets actually used.
+    int Barriers;
+  };
+
+private:
+  struct Access
+  {
+    RenderGraphResource Resource;
+    RenderGraphUsage Usage;
+  };
+
+  struct Pass
+  {
+    std::string Name;
+    ExecuteCallback Execute;
+    std::vector<Access> Reads, Writes;
+    bool SideEffect;
+    bool Culled;
+    unsigned int Barriers; // glMemoryBarrier bits issued before the pass.
+  };
+
+  struct Resource
+  {
+    std::string Name;
+    RenderGraphTextureDescription Description;
+    bool Imported;
+    Framebuffer* Target;
+    int FirstUse, LastUse; // Indices into m_Order.
+  };
+
+  std::vector<Pass> m_Passes;
+  std::vector<Resource> m_Resources;
+  std::vector<int> m_Order;
+  bool m_Compiled;
+  Stats m_Stats;
+
+public:
+  RenderGraph();
+  ~RenderGraph();
+
+  RenderGraph(const RenderGraph&) = delete;
+  RenderGraph& operator=(const RenderGraph&) = delete;
+
+  // Runs setup immediately; execute runs during Execute if the pass survives culling.
+  void AddPass(const std::string& name, const SetupCallback& setup, const ExecuteCallback& execute);
+
+  // Makes an existing framebuffer (nullptr for the default framebuffer) available to passes.
+  // Passes writing imported resources are never culled.
+  RenderGraphResource Import(const std::string& name, Framebuffer* framebuffer);
+
+  void Compile();
+  void Execute();
+
+  inline const Stats& GetStats() const { return m_Stats; }
+  void OnImGuiRender() const;
+
+  friend class RenderGraphBuilder;
+  friend class RenderGraphContext;
+};
@@ -0,0 +1,105 @@
+#include <algorithm>
+
+#include <imgui/imgui.h>
+
+#include "RenderTargetPool.h"
+
+RenderTargetPool::RenderTargetPool()
+  : m_Frame(0), m_MaxIdleFrames(3), m_DedicatedMemoryThisFrame(0), m_AcquisitionsThisFrame(0),
+    m_AllocationsThisFrame(0), m_Stats{}
+{
+}
+
+RenderTargetPool& RenderTargetPool::Get()
+{
+  static RenderTargetPool instance;
+  return instance;
+}
+
+Framebuffer* RenderTargetPool::Acquire(const FramebufferSpecification& specification)
+{
+  m_AcquisitionsThisFrame++;
+
+  PooledTarget* found = nullptr;
+  for (PooledTarget& pooled : m_Targets)
+  {
+    if (!pooled.InUse && pooled.Target->GetSpecification() == specification)
+    {
+      found = &pooled;
+      break;
+    }
+  }
+
+  if (!found)
+  {
+    m_Targets.push_back({ std::unique_ptr<Framebuffer>(new Framebuffer(specification)), false, m_Frame });
+    found = &m_Targets.back();
+    m_AllocationsThisFrame++;
+    m_Stats.TotalAllocations++;
+  }
+
+  found->InUse = true;
+  found->LastUsedFrame = m_Frame;
+  m_DedicatedMemoryThisFrame += found->Target->GetMemorySize();
+  return found->Target.get();
+}
+
+void RenderTargetPool::Release(Framebuffer* target)
+{
+  for (PooledTarget& pooled : m_Targets)
+  {
+    if (pooled.Target.get() == target)
+    {
+      pooled.InUse = false;
+      return;
+    }
+  }
+}
+
+void RenderTargetPool::EndFrame()
+{
+  m_Targets.erase(std::remove_if(m_Targets.begin(), m_Targets.end(), [this](const PooledTarget& pooled) {
+    return !pooled.InUse && m_Frame - pooled.LastUsedFrame > m_MaxIdleFrames;
+  }), m_Targets.end());
+
+  // Exponential moving averages keep the averages responsive when the pass setup changes.
+  const double smoothing = 0.05;
+  size_t memory = GetMemoryUsage();
+  m_Stats.CurrentMemory = memory;
+  m_Stats.PeakMemory = std::max(m_Stats.PeakMemory, memory);
+  m_Stats.AverageMemory += (memory - m_Stats.AverageMemory) * smoothing;
+  m_Stats.DedicatedMemoryLastFrame = m_DedicatedMemoryThisFrame;
+  m_Stats.PeakDedicatedMemory = std::max(m_Stats.PeakDedicatedMemory, m_DedicatedMemoryThisFrame);
+  m_Stats.AverageDedicatedMemory += (m_DedicatedMemoryThisFrame - m_Stats.AverageDedicatedMemory) * smoothing;
+  m_Stats.AcquisitionsLastFrame = m_AcquisitionsThisFrame;
+  m_Stats.AllocationsLastFrame = m_AllocationsThisFrame;
+
+  m_DedicatedMemoryThisFrame = 0;
+  m_AcquisitionsThisFrame = 0;
+  m_AllocationsThisFrame = 0;
+  m_Frame++;
+}
+
+void RenderTargetPool::Clear()
+{
+  m_Targets.clear();
+}
+
+size_t RenderTargetPool::GetMemoryUsage() const
+{
+  size_t memory = 0;
+  for (const PooledTarget& pooled : m_Targets)
+    memory += pooled.Target->GetMemorySize();
+  return memory;
+}
+
+void RenderTargetPool::OnImGuiRender()
+{
+  const double megabyte = 1024.0 * 1024.0;
+  ImGui::Text("Targets: %d  Acquired: %u  Allocated: %u this frame (%u total)", (int)m_Targets.size(),
+    m_Stats.AcquisitionsLastFrame, m_Stats.AllocationsLastFrame, m_Stats.TotalAllocations);
+  ImGui::Text("Pooled:    %.2f MB now, %.2f MB peak, %.2f MB average", m_Stats.CurrentMemory / megabyte,
+    m_Stats.PeakMemory / megabyte, m_Stats.AverageMemory / megabyte);
+  ImGui::Text("Dedicated: %.2f MB now, %.2f MB peak, %.2f MB average", m_Stats.DedicatedMemoryLastFrame / megabyte,
+    m_Stats.PeakDedicatedMemory / megabyte, m_Stats.AverageDedicatedMemory / megabyte);
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "Framebuffer.h"
+
+// Recycles framebuffers between passes and frames. Acquire returns an idle target with a matching
+// specification or creates one; Release hands it back so a later pass (or the next frame) can reuse
+// the same storage. Targets nobody acquired for a few frames are freed at EndFrame.
+class RenderTargetPool
+{
+public:
+  struct Stats
+  {
+    size_t CurrentMemory, PeakMemory;
+    double AverageMemory;
+    // What the same acquisitions would cost if every one owned a dedicated target.
+    size_t DedicatedMemoryLastFrame, PeakDedicatedMemory;
+    double AverageDedicatedMemory;
+    unsigned int AcquisitionsLastFrame, AllocationsLastFrame, TotalAllocations;
+  };
+
+private:
+  struct PooledTarget
+  {
+    std::unique_ptr<Framebuffer> Target;
+    bool InUse;
+    unsigned int LastUsedFrame;
+  };
+
+  std::vector<PooledTarget> m_Targets;
+  unsigned int m_Frame;
+  unsigned int m_MaxIdleFrames;
+  size_t m_DedicatedMemoryThisFrame;
+  unsigned int m_AcquisitionsThisFrame, m_AllocationsThisFrame;
+  Stats m_Stats;
+
+public:
+  static RenderTargetPool& Get();
+
+  Framebuffer* Acquire(const FramebufferSpecification& specification);
+  void Release(Framebuffer* target);
+
+  // Frees idle targets and updates the statistics. Call once per frame.
+  void EndFrame();
+  // Frees every target. Must be called while the OpenGL context is still alive.
+  void Clear();
+
+  inline const Stats& GetStats() const { return m_Stats; }
+  inline void SetMaxIdleFrames(unsigned int frames) { m_MaxIdleFrames = frames; }
+
+  void OnImGuiRender();
+private:
+  RenderTargetPool();
+  RenderTargetPool(const RenderTargetPool&) = delete;
+  RenderTargetPool& operator=(const RenderTargetPool&) = delete;
+
+  size_t GetMemoryUsage() const;
+};
@@ -0,0 +1,20 @@
+#include "RenderTexture.h"
+
+RenderTexture::RenderTexture(int width, int height, unsigned int internalFormat, int levels, int samples)
+  : Texture(samples > 0 ? GL_TEXTURE_2D_MULTISAMPLE : GL_TEXTURE_2D)
+{
+  Create(internalFormat, width, height, 1, samples > 0 ? 1 : levels, samples);
+
+  // Multisampled textures have no sampler state.
+  if (samples == 0)
+  {
+    SetFilter(levels > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR, GL_LINEAR);
+    SetWrap(GL_CLAMP_TO_EDGE);
+  }
+}
+
+void RenderTexture::GenerateMipmaps() const
+{
+  OpenGLCall(glBindTexture(m_Target, m_RendererId.Get()));
+  OpenGLCall(glGenerateMipmap(m_Target));
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include "Texture.h"
+
+// Empty 2D texture with a chosen format, used as a colour or depth attachment. Storage is
+// immutable, so a render target is created once and reused every frame rather than re-specified.
+class RenderTexture : public Texture
+{
+public:
+  // samples > 0 creates a multisampled texture, which can only be resolved, not sampled with filtering.
+  RenderTexture(int width, int height, unsigned int internalFormat, int levels = 1, int samples = 0);
+
+  void GenerateMipmaps() const;
+};
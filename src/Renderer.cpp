@@ -1,16 +1,194 @@
+#include <algorithm>
+#include <limits>
+
 #include "Renderer.h"
 
-void Renderer::Clear() const
+Renderer::Renderer()
+  : m_ViewProjection(1.0f), m_DepthMode(DepthMode::Disabled), m_DepthFunction(GL_LESS),
+    m_SortMode(SortMode::FrontToBack), m_DepthPrePass(false), m_Overdraw(false), m_OverdrawIncrement(0.1f),
+    m_FrustumCulling(true), m_Queries{ 0, 0 }, m_QueryFrame(0), m_Stats{}
+{
+}
+
+Renderer::~Renderer()
+{
+  if (m_Queries[0])
+  {
+    OpenGLCall(glDeleteQueries(2, m_Queries));
+  }
+}
+
+void Renderer::Clear(unsigned int flags) const
+{
+  if (flags & GL_DEPTH_BUFFER_BIT)
+  {
+    OpenGLCall(glDepthMask(GL_TRUE));
+  }
+  if (flags & GL_STENCIL_BUFFER_BIT)
+  {
+    OpenGLCall(glStencilMask(0xFF));
+  }
+  OpenGLCall(glClear(flags));
+}
+
+void Renderer::SetDepthMode(DepthMode mode, unsigned int function)
 {
-  OpenGLCall(glClear(GL_COLOR_BUFFER_BIT));
+  m_DepthMode = mode;
+  m_DepthFunction = function;
+  ApplyDepthState(mode, function);
+}
+
+void Renderer::ApplyDepthState(DepthMode mode, unsigned int function) const
+{
+  if (mode == DepthMode::Disabled)
+  {
+    // Without the test nothing is written either.
+    OpenGLCall(glDisable(GL_DEPTH_TEST));
+    return;
+  }
+
+  OpenGLCall(glEnable(GL_DEPTH_TEST));
+  OpenGLCall(glDepthFunc(function));
+  OpenGLCall(glDepthMask(mode == DepthMode::ReadWrite ? GL_TRUE : GL_FALSE));
 }
 
 void Renderer::Draw(const VertexArray& vertexArray, const IndexBuffer& indexBuffer, const Shader& shader) const
 {
   shader.Bind();
-  indexBuffer.Bind();
+  // The element array binding belongs to the vertex array, so bind that first.
   vertexArray.Bind();
+  indexBuffer.Bind();
+
+  OpenGLCall(glDrawElements(GL_TRIANGLES, indexBuffer.GetLength(), indexBuffer.GetType(), (const void*)(size_t)indexBuffer.GetOffset()));
+
+}
+
+void Renderer::BeginScene(const glm::mat4& viewProjection)
+{
+  m_ViewProjection = viewProjection;
+  m_Queue.clear();
+  m_Culler.Clear();
+}
+
+void Renderer::Submit(const VertexArray& vertexArray, const IndexBuffer& indexBuffer, Shader& shader, const glm::mat4& transform)
+{
+  glm::vec4 origin = m_ViewProjection * transform * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+  float depth = origin.w != 0.0f ? origin.z / origin.w : origin.z;
+  m_Queue.push_back({ &vertexArray, &indexBuffer, &shader, transform, depth });
+  m_Culler.AddSphere({ glm::vec3(0.0f), std::numeric_limits<float>::infinity() });
+}
+
+void Renderer::Submit(const VertexArray& vertexArray, const IndexBuffer& indexBuffer, Shader& shader, const glm::mat4& transform,
+  const BoundingSphere& bounds)
+{
+  Submit(vertexArray, indexBuffer, shader, transform);
+  m_Culler.SetSphere(m_Culler.GetSphereCount() - 1, bounds.Transform(transform));
+}
+
+void Renderer::DrawQueue(Shader* overrideShader, unsigned int& drawCalls)
+{
+  for (const RenderCommand& command : m_Queue)
+  {
+    Shader& shader = overrideShader ? *overrideShader : *command.Material;
+    shader.Bind();
+    shader.SetUniformMat4f("u_ModelViewProjectionMatrix", m_ViewProjection * command.Transform);
+    Draw(*command.Vertices, *command.Indices, shader);
+    drawCalls++;
+  }
+}
+
+void Renderer::EndScene()
+{
+  m_Stats.DrawCalls = 0;
+  m_Stats.PrePassDrawCalls = 0;
+  m_Stats.Culled = 0;
+
+  if (m_FrustumCulling && !m_Queue.empty())
+  {
+    // The visible indices are ascending, so the queue can be compacted in place.
+    m_Culler.CullSpheres(Frustum(m_ViewProjection), m_Visible);
+    for (size_t i = 0; i < m_Visible.size(); i++)
+      m_Queue[i] = m_Queue[m_Visible[i]];
+    m_Stats.Culled = (unsigned int)(m_Queue.size() - m_Visible.size());
+    m_Queue.resize(m_Visible.size());
+  }
+
+  if (m_SortMode == SortMode::FrontToBack)
+  {
+    std::stable_sort(m_Queue.begin(), m_Queue.end(),
+      [](const RenderCommand& a, const RenderCommand& b) { return a.Depth < b.Depth; });
+  }
+  else if (m_SortMode == SortMode::BackToFront)
+  {
+    std::stable_sort(m_Queue.begin(), m_Queue.end(),
+      [](const RenderCommand& a, const RenderCommand& b) { return a.Depth > b.Depth; });
+  }
+
+  bool depthTest = m_DepthMode != DepthMode::Disabled;
+  if (m_DepthPrePass && depthTest)
+  {
+    // Lay down depth only, then shade with an equal-or-less test and writes off so every pixel
+    // runs the expensive fragment shader once.
+    OpenGLCall(glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE));
+    ApplyDepthState(DepthMode::ReadWrite, m_DepthFunction);
+    DrawQueue(nullptr, m_Stats.PrePassDrawCalls);
+    OpenGLCall(glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE));
+    ApplyDepthState(DepthMode::ReadOnly, GL_LEQUAL);
+  }
+  else
+  {
+    ApplyDepthState(m_DepthMode, m_DepthFunction);
+  }
+
+  OpenGLCall(GLboolean blendEnabled = glIsEnabled(GL_BLEND));
+  GLint blendSource = GL_ONE, blendDestination = GL_ZERO;
+  OpenGLCall(glGetIntegerv(GL_BLEND_SRC_RGB, &blendSource));
+  OpenGLCall(glGetIntegerv(GL_BLEND_DST_RGB, &blendDestination));
+  Shader* overrideShader = nullptr;
+  if (m_Overdraw)
+  {
+    if (!m_OverdrawShader)
+      m_OverdrawShader = std::make_unique<Shader>("src/resources/Basic.vert", "src/resources/Overdraw.frag");
+
+    m_OverdrawShader->Bind();
+    m_OverdrawShader->SetUniform4f("u_Color", m_OverdrawIncrement, m_OverdrawIncrement * 0.5f, m_OverdrawIncrement * 0.25f, 1.0f);
+    OpenGLCall(glEnable(GL_BLEND));
+    OpenGLCall(glBlendFunc(GL_ONE, GL_ONE));
+    overrideShader = m_OverdrawShader.get();
+  }
+
+  // Two queries used alternately: the one issued last frame has usually finished by now.
+  if (!m_Queries[0])
+  {
+    OpenGLCall(glGenQueries(2, m_Queries));
+  }
+  unsigned int query = m_Queries[m_QueryFrame & 1];
+  if (m_QueryFrame >= 2)
+  {
+    GLuint available = 0;
+    OpenGLCall(glGetQueryObjectuiv(query, GL_QUERY_RESULT_AVAILABLE, &available));
+    if (available)
+    {
+      GLuint64 samples = 0;
+      OpenGLCall(glGetQueryObjectui64v(query, GL_QUERY_RESULT, &samples));
+      m_Stats.SamplesPassed = samples;
+    }
+  }
 
-  OpenGLCall(glDrawElements(GL_TRIANGLES, indexBuffer.GetLength(), GL_UNSIGNED_INT, nullptr));
+  OpenGLCall(glBeginQuery(GL_SAMPLES_PASSED, query));
+  DrawQueue(overrideShader, m_Stats.DrawCalls);
+  OpenGLCall(glEndQuery(GL_SAMPLES_PASSED));
+  m_QueryFrame++;
 
+  if (m_Overdraw)
+  {
+    OpenGLCall(glBlendFunc(blendSource, blendDestination));
+    if (!blendEnabled)
+    {
+      OpenGLCall(glDisable(GL_BLEND));
+    }
+  }
+  ApplyDepthState(m_DepthMode, m_DepthFunction);
+  m_Queue.clear();
+  m_Culler.Clear();
 }
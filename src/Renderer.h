@@ -3,7 +3,10 @@
 #include <GL/glew.h>
 #include <cassert>
 #include <iostream>
+#include <memory>
+#include <vector>
 
+#include "FrustumCuller.h"
 #include "VertexArray.h"
 #include "IndexBuffer.h"
 #include "Shader.h"
@@ -35,9 +38,93 @@ static bool OpenGL_LogCall(const char* function, const char* file, int line)
   return true;
 }
 
+enum class DepthMode
+{
+  Disabled,  // No depth test or writes.
+  ReadWrite, // Test and write, for opaque geometry.
+  ReadOnly   // Test without writing, e.g. after a depth pre-pass or for transparent geometry.
+};
+
+// Opaque draw queued between BeginScene and EndScene. The shader must take the model view
+// projection matrix as "u_ModelViewProjectionMatrix", like Basic.vert.
+struct RenderCommand
+{
+  const VertexArray* Vertices;
+  const IndexBuffer* Indices;
+  Shader* Material;
+  glm::mat4 Transform;
+  float Depth; // NDC depth of the object's origin, used for sorting.
+};
+
 class Renderer
 {
 public:
-  void Clear() const;
+  enum class SortMode
+  {
+    Submission, FrontToBack, BackToFront
+  };
+
+  struct Stats
+  {
+    unsigned int DrawCalls;        // Colour pass only.
+    unsigned int PrePassDrawCalls; // Depth pre-pass, when enabled.
+    unsigned int Culled; // Submitted objects outside the view frustum.
+    // Fragments that passed the depth test in the colour pass, from an occlusion query a
+    // couple of frames old so reading it never stalls.
+    unsigned long long SamplesPassed;
+  };
+
+private:
+  std::vector<RenderCommand> m_Queue;
+  glm::mat4 m_ViewProjection;
+  DepthMode m_DepthMode;
+  unsigned int m_DepthFunction;
+  SortMode m_SortMode;
+  bool m_DepthPrePass;
+  bool m_Overdraw;
+  float m_OverdrawIncrement;
+  bool m_FrustumCulling;
+  FrustumCuller m_Culler; // World space bounds of the queued commands, in queue order.
+  std::vector<unsigned int> m_Visible;
+  std::unique_ptr<Shader> m_OverdrawShader;
+  unsigned int m_Queries[2];
+  int m_QueryFrame;
+  Stats m_Stats;
+
+public:
+  Renderer();
+  ~Renderer();
+
+  Renderer(const Renderer&) = delete;
+  Renderer& operator=(const Renderer&) = delete;
+
+  // Any combination of GL_COLOR_BUFFER_BIT, GL_DEPTH_BUFFER_BIT and GL_STENCIL_BUFFER_BIT.
+  // Depth and stencil writes are re-enabled first, as masked writes also mask clears.
+  void Clear(unsigned int flags = GL_COLOR_BUFFER_BIT) const;
+  void SetDepthMode(DepthMode mode, unsigned int function = GL_LESS);
+
   void Draw(const VertexArray& va, const IndexBuffer& ia, const Shader& shader) const;
+
+  // Queues opaque draws so they can be sorted and optionally preceded by a depth pre-pass,
+  // letting early depth testing reject hidden fragments before they are shaded.
+  void BeginScene(const glm::mat4& viewProjection);
+  void Submit(const VertexArray& vertexArray, const IndexBuffer& indexBuffer, Shader& shader, const glm::mat4& transform);
+  // Same, with the mesh's model space bounds so EndScene can skip it when it's off screen.
+  void Submit(const VertexArray& vertexArray, const IndexBuffer& indexBuffer, Shader& shader, const glm::mat4& transform,
+    const BoundingSphere& bounds);
+  void EndScene();
+
+  inline void SetSortMode(SortMode mode) { m_SortMode = mode; }
+  inline void SetDepthPrePass(bool enabled) { m_DepthPrePass = enabled; }
+  // Drops queued objects whose bounds are outside the view frustum. Objects submitted without
+  // bounds are always drawn.
+  inline void SetFrustumCulling(bool enabled) { m_FrustumCulling = enabled; }
+  // Draws every queued object with a flat colour and additive blending instead of its own shader,
+  // so the brightness of a pixel shows how many times it was shaded.
+  inline void SetOverdrawVisualisation(bool enabled, float increment = 0.1f) { m_Overdraw = enabled; m_OverdrawIncrement = increment; }
+
+  inline const Stats& GetStats() const { return m_Stats; }
+private:
+  void ApplyDepthState(DepthMode mode, unsigned int function) const;
+  void DrawQueue(Shader* overrideShader, unsigned int& drawCalls);
 };
\ No newline at end of file
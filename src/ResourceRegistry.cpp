@@ -0,0 +1,96 @@
+#include <imgui/imgui.h>
+
+#include "Renderer.h"
+#include "ResourceRegistry.h"
+
+ResourceRegistry::ResourceRegistry()
+  : m_Frame(0), m_CompletedFrame(0)
+{
+}
+
+ResourceRegistry& ResourceRegistry::Get()
+{
+  static ResourceRegistry instance;
+  return instance;
+}
+
+ShaderHandle ResourceRegistry::LoadShader(const std::string& vertexFilePath, const std::string& fragmentFilePath,
+  const std::vector<std::string>& defines)
+{
+  std::string key = vertexFilePath + ";" + fragmentFilePath;
+  for (const std::string& define : defines)
+    key += ";" + define;
+
+  ShaderHandle handle = defines.empty() ? m_Shaders.Create(key, vertexFilePath, fragmentFilePath)
+    : m_Shaders.Create(key, vertexFilePath, fragmentFilePath, defines);
+  Shader* shader = m_Shaders.Resolve(handle);
+  if (shader && !shader->IsValid())
+    m_Shaders.Unshare(handle);
+  return handle;
+}
+
+ComputeShaderHandle ResourceRegistry::LoadComputeShader(const std::string& filePath)
+{
+  ComputeShaderHandle handle = m_ComputeShaders.Create(filePath, filePath);
+  ComputeShader* shader = m_ComputeShaders.Resolve(handle);
+  if (shader && !shader->IsValid())
+    m_ComputeShaders.Unshare(handle);
+  return handle;
+}
+
+void ResourceRegistry::EndFrame()
+{
+  m_Frame++;
+  unsigned int retired = m_Shaders.Retire(m_Frame) + m_ComputeShaders.Retire(m_Frame);
+
+  // A fence after the frame's commands signals once the GPU is done with everything released in it.
+  if (retired > 0)
+  {
+    OpenGLCall(GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+    m_Fences.push_back({ fence, m_Frame });
+  }
+
+  while (!m_Fences.empty())
+  {
+    OpenGLCall(GLenum status = glClientWaitSync(m_Fences.front().Fence, 0, 0));
+    if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+      break;
+
+    m_CompletedFrame = m_Fences.front().Frame;
+    OpenGLCall(glDeleteSync(m_Fences.front().Fence));
+    m_Fences.pop_front();
+  }
+
+  m_Shaders.Collect(m_CompletedFrame);
+  m_ComputeShaders.Collect(m_CompletedFrame);
+}
+
+void ResourceRegistry::Clear()
+{
+  for (const FrameFence& fence : m_Fences)
+  {
+    OpenGLCall(glDeleteSync(fence.Fence));
+  }
+  m_Fences.clear();
+
+  m_Shaders.Clear();
+  m_ComputeShaders.Clear();
+}
+
+template<typename T>
+static void ShowPool(const char* name, const ResourcePool<T>& pool)
+{
+  typename ResourcePool<T>::Stats stats = pool.GetStats();
+  ImGui::Text("%s: %u live, %u pending, %u slots  (created %u, shared %u, destroyed %u)", name,
+    stats.Live, stats.Pending, stats.Slots, stats.Created, stats.Shared, stats.Destroyed);
+  pool.ForEach([](const std::string& key, uint32_t refCount) {
+    ImGui::BulletText("%s  (refs %u)", key.empty() ? "<unnamed>" : key.c_str(), refCount);
+  });
+}
+
+void ResourceRegistry::OnImGuiRender()
+{
+  ShowPool("Shaders", m_Shaders);
+  ShowPool("Compute shaders", m_ComputeShaders);
+  ImGui::Text("Frames awaiting the GPU: %d", (int)m_Fences.size());
+}
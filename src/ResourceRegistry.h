@@ -0,0 +1,342 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <cstdint>
+#include <deque>
+#include <iostream>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "ComputeShader.h"
+#include "Shader.h"
+
+// 32-bit reference to a resource in a ResourcePool: the slot index in the low bits and the slot's
+// generation in the high bits. Destroying a resource bumps its slot's generation, so old handles
+// stop resolving instead of pointing at whatever reuses the slot. Zero is never a valid handle.
+template<typename T>
+struct ResourceHandle
+{
+  static constexpr uint32_t INDEX_BITS = 20;
+  static constexpr uint32_t INDEX_MASK = (1u << INDEX_BITS) - 1;
+  static constexpr uint32_t MAX_GENERATION = (1u << (32 - INDEX_BITS)) - 1;
+
+  uint32_t Value;
+
+  ResourceHandle() : Value(0) {}
+  ResourceHandle(uint32_t index, uint32_t generation) : Value((generation << INDEX_BITS) | index) {}
+
+  inline uint32_t GetIndex() const { return Value & INDEX_MASK; }
+  inline uint32_t GetGeneration() const { return Value >> INDEX_BITS; }
+  inline bool IsValid() const { return Value != 0; }
+
+  inline bool operator==(const ResourceHandle& other) const { return Value == other.Value; }
+  inline bool operator!=(const ResourceHandle& other) const { return Value != other.Value; }
+};
+
+// Slot array of one resource type. Resources live by value in the slots and are reference
+// counted; when the last reference goes, the resource waits in a pending list until the frame it
+// was released in has finished on the GPU, and is only then destroyed. Resources created with a
+// key (usually their file path) are shared: creating the same key again returns the same handle,
+// reviving it if it was pending destruction. Slots are kept in a deque, so pointers from Resolve
+// stay valid while other resources are created.
+template<typename T>
+class ResourcePool
+{
+public:
+  typedef ResourceHandle<T> Handle;
+
+  struct Stats
+  {
+    unsigned int Live, Pending, Slots;
+    unsigned int Created, Destroyed, Shared;
+  };
+
+private:
+  struct Slot
+  {
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type Storage;
+    uint32_t Generation;
+    uint32_t RefCount;
+    uint64_t ReleasedFrame; // 0 until EndFrame tags it with the frame it was released in.
+    bool HasValue;
+    bool Pending;
+
+    Slot() : Generation(1), RefCount(0), ReleasedFrame(0), HasValue(false), Pending(false) {}
+    Slot(const Slot&) = delete;
+    Slot& operator=(const Slot&) = delete;
+    ~Slot()
+    {
+      if (HasValue)
+        Get().~T();
+    }
+
+    inline T& Get() { return *reinterpret_cast<T*>(&Storage); }
+    inline const T& Get() const { return *reinterpret_cast<const T*>(&Storage); }
+  };
+
+  std::deque<Slot> m_Slots; // Never moves a slot once it's added.
+  std::vector<std::string> m_Keys; // Parallel to m_Slots, kept apart so the slots stay small.
+  std::vector<uint32_t> m_FreeSlots;
+  std::vector<uint32_t> m_PendingSlots;
+  std::unordered_map<std::string, uint32_t> m_Lookup;
+  Stats m_Stats;
+
+public:
+  ResourcePool() : m_Stats{} {}
+
+  ResourcePool(const ResourcePool&) = delete;
+  ResourcePool& operator=(const ResourcePool&) = delete;
+
+  // Returns the resource already registered under key with an extra reference, or constructs a
+  // new one from args. An empty key creates an unshared resource.
+  template<typename... Args>
+  Handle Create(const std::string& key, Args&&... args)
+  {
+    if (!key.empty())
+    {
+      Handle existing = Find(key);
+      if (existing.IsValid())
+      {
+        m_Slots[existing.GetIndex()].RefCount++;
+        m_Stats.Shared++;
+        return existing;
+      }
+    }
+
+    uint32_t index;
+    if (!m_FreeSlots.empty())
+    {
+      index = m_FreeSlots.back();
+      m_FreeSlots.pop_back();
+    }
+    else
+    {
+      if (m_Slots.size() > Handle::INDEX_MASK)
+      {
+        std::cout << "[ERROR] Resource pool is full, can't create '" << key << "'" << std::endl;
+        return Handle();
+      }
+      index = (uint32_t)m_Slots.size();
+      m_Slots.emplace_back();
+      m_Keys.emplace_back();
+    }
+
+    Slot& slot = m_Slots[index];
+    new (&slot.Storage) T(std::forward<Args>(args)...);
+    slot.HasValue = true;
+    slot.RefCount = 1;
+    m_Keys[index] = key;
+    if (!key.empty())
+      m_Lookup[key] = index;
+
+    m_Stats.Created++;
+    return Handle(index, slot.Generation);
+  }
+
+  // Stops sharing the resource under its key, so the next Create with that key constructs a new
+  // one. Used for resources that failed to load, so a fixed file is picked up on the next try.
+  void Unshare(Handle handle)
+  {
+    if (!IsAlive(handle))
+      return;
+
+    auto it = m_Lookup.find(m_Keys[handle.GetIndex()]);
+    if (it != m_Lookup.end() && it->second == handle.GetIndex())
+      m_Lookup.erase(it);
+  }
+
+  // Looks a resource up by key without adding a reference.
+  Handle Find(const std::string& key) const
+  {
+    auto it = m_Lookup.find(key);
+    if (it == m_Lookup.end())
+      return Handle();
+    return Handle(it->second, m_Slots[it->second].Generation);
+  }
+
+  // Null for invalid or stale handles.
+  T* Resolve(Handle handle)
+  {
+    if (!IsAlive(handle))
+      return nullptr;
+    return &m_Slots[handle.GetIndex()].Get();
+  }
+
+  bool IsAlive(Handle handle) const
+  {
+    uint32_t index = handle.GetIndex();
+    return handle.IsValid() && index < m_Slots.size() && m_Slots[index].HasValue &&
+      m_Slots[index].Generation == handle.GetGeneration();
+  }
+
+  void AddRef(Handle handle)
+  {
+    if (IsAlive(handle))
+      m_Slots[handle.GetIndex()].RefCount++;
+  }
+
+  void Release(Handle handle)
+  {
+    if (!IsAlive(handle))
+      return;
+
+    Slot& slot = m_Slots[handle.GetIndex()];
+    if (slot.RefCount == 0 || --slot.RefCount > 0)
+      return;
+
+    slot.ReleasedFrame = 0;
+    if (!slot.Pending)
+    {
+      slot.Pending = true;
+      m_PendingSlots.push_back(handle.GetIndex());
+    }
+  }
+
+  // Tags everything released since the last call with frame. Returns how many were tagged.
+  unsigned int Retire(uint64_t frame)
+  {
+    unsigned int retired = 0;
+    for (uint32_t index : m_PendingSlots)
+    {
+      Slot& slot = m_Slots[index];
+      if (slot.RefCount == 0 && slot.ReleasedFrame == 0)
+      {
+        slot.ReleasedFrame = frame;
+        retired++;
+      }
+    }
+    return retired;
+  }
+
+  // Destroys pending resources released in or before completedFrame, which the GPU has finished.
+  void Collect(uint64_t completedFrame)
+  {
+    size_t kept = 0;
+    for (size_t i = 0; i < m_PendingSlots.size(); i++)
+    {
+      uint32_t index = m_PendingSlots[i];
+      Slot& slot = m_Slots[index];
+      if (slot.RefCount > 0)
+        slot.Pending = false; // Revived by Create.
+      else if (slot.ReleasedFrame != 0 && slot.ReleasedFrame <= completedFrame)
+        Destroy(index);
+      else
+        m_PendingSlots[kept++] = index;
+    }
+    m_PendingSlots.resize(kept);
+  }
+
+  // Destroys every resource immediately, live or not. Slot generations survive, so handles
+  // from before stay stale.
+  void Clear()
+  {
+    for (uint32_t index = 0; index < m_Slots.size(); index++)
+    {
+      if (m_Slots[index].HasValue)
+        Destroy(index);
+    }
+    m_PendingSlots.clear();
+  }
+
+  Stats GetStats() const
+  {
+    // Slots revived by Create stay on the pending list until the next Collect, but count as live.
+    Stats stats = m_Stats;
+    stats.Pending = 0;
+    for (uint32_t index : m_PendingSlots)
+    {
+      if (m_Slots[index].RefCount == 0)
+        stats.Pending++;
+    }
+    stats.Slots = (unsigned int)m_Slots.size();
+    stats.Live = stats.Slots - (unsigned int)m_FreeSlots.size() - stats.Pending;
+    return stats;
+  }
+
+  // Calls function(key, refCount) for every resource still holding a slot.
+  template<typename Function>
+  void ForEach(Function function) const
+  {
+    for (size_t index = 0; index < m_Slots.size(); index++)
+    {
+      if (m_Slots[index].HasValue)
+        function(m_Keys[index], m_Slots[index].RefCount);
+    }
+  }
+
+private:
+  void Destroy(uint32_t index)
+  {
+    Slot& slot = m_Slots[index];
+    slot.Get().~T();
+    slot.HasValue = false;
+    slot.RefCount = 0;
+    slot.Pending = false;
+    slot.Generation = slot.Generation % Handle::MAX_GENERATION + 1;
+
+    if (!m_Keys[index].empty())
+    {
+      // An unshared slot's key may have been taken by a newer resource since.
+      auto it = m_Lookup.find(m_Keys[index]);
+      if (it != m_Lookup.end() && it->second == index)
+        m_Lookup.erase(it);
+      m_Keys[index].clear();
+    }
+    m_FreeSlots.push_back(index);
+    m_Stats.Destroyed++;
+  }
+};
+
+typedef ResourceHandle<Shader> ShaderHandle;
+typedef ResourceHandle<ComputeShader> ComputeShaderHandle;
+
+// Shared home for GPU resources loaded from files, so tests and systems asking for the same
+// shader get one program between them. Keys are built from the file paths (and defines).
+class ResourceRegistry
+{
+private:
+  struct FrameFence
+  {
+    GLsync Fence;
+    uint64_t Frame;
+  };
+
+  ResourcePool<Shader> m_Shaders;
+  ResourcePool<ComputeShader> m_ComputeShaders;
+  std::deque<FrameFence> m_Fences;
+  uint64_t m_Frame;
+  uint64_t m_CompletedFrame;
+
+public:
+  static ResourceRegistry& Get();
+
+  // Shaders that fail to compile are still returned, invalid, but aren't shared under their key,
+  // so loading the same files again recompiles them.
+  ShaderHandle LoadShader(const std::string& vertexFilePath, const std::string& fragmentFilePath,
+    const std::vector<std::string>& defines = {});
+  ComputeShaderHandle LoadComputeShader(const std::string& filePath);
+
+  inline Shader* Resolve(ShaderHandle handle) { return m_Shaders.Resolve(handle); }
+  inline ComputeShader* Resolve(ComputeShaderHandle handle) { return m_ComputeShaders.Resolve(handle); }
+  inline void Release(ShaderHandle handle) { m_Shaders.Release(handle); }
+  inline void Release(ComputeShaderHandle handle) { m_ComputeShaders.Release(handle); }
+
+  inline ResourcePool<Shader>& GetShaders() { return m_Shaders; }
+  inline ResourcePool<ComputeShader>& GetComputeShaders() { return m_ComputeShaders; }
+
+  // Fences the frame's releases and destroys resources whose release frame the GPU has finished.
+  // Call once per frame.
+  void EndFrame();
+  // Destroys every resource. Must be called while the OpenGL context is still alive.
+  void Clear();
+
+  void OnImGuiRender();
+private:
+  ResourceRegistry();
+  ResourceRegistry(const ResourceRegistry&) = delete;
+  ResourceRegistry& operator=(const ResourceRegistry&) = delete;
+};
@@ -0,0 +1,260 @@
+#include <algorithm>
+#include <numeric>
+
+#include "SceneGraph.h"
+
+template<typename T>
+static void Reorder(std::vector<T>& values, const std::vector<unsigned int>& order)
+{
+  std::vector<T> reordered;
+  reordered.reserve(order.size());
+  for (unsigned int index : order)
+    reordered.push_back(values[index]);
+  values.swap(reordered);
+}
+
+SceneGraph::SceneGraph()
+  : m_FirstDirty(0), m_Frame(0), m_NeedsSort(false), m_Stats{}
+{
+}
+
+SceneNodeId SceneGraph::CreateNode(SceneNodeId parent, const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale)
+{
+  int parentIndex = IsValid(parent) ? (int)m_IdToIndex[parent] : -1;
+  unsigned int depth = parentIndex >= 0 ? m_Depth[parentIndex] + 1 : 0;
+
+  // Appending keeps parents ahead of children but only stays sorted by depth if nothing deeper
+  // was added before.
+  if (!m_Depth.empty() && depth < m_Depth.back())
+    m_NeedsSort = true;
+
+  SceneNodeId id = (SceneNodeId)m_IdToIndex.size();
+  unsigned int index = (unsigned int)m_Ids.size();
+  m_IdToIndex.push_back(index);
+  m_Ids.push_back(id);
+  m_Parent.push_back(parentIndex);
+  m_Depth.push_back(depth);
+  m_Position.push_back(position);
+  m_Rotation.push_back(rotation);
+  m_Scale.push_back(scale);
+  m_Local.emplace_back(1.0f);
+  m_World.emplace_back(1.0f);
+  m_Dirty.push_back(0);
+  m_UpdatedFrame.push_back(0);
+  MarkDirty(index);
+  return id;
+}
+
+void SceneGraph::DestroyNode(SceneNodeId node)
+{
+  if (!IsValid(node))
+    return;
+
+  // Descendants come after their ancestors once sorted, so one forward pass finds the subtree.
+  if (m_NeedsSort)
+    Sort();
+
+  std::vector<unsigned char> removed(m_Ids.size(), 0);
+  unsigned int root = m_IdToIndex[node];
+  removed[root] = 1;
+  for (size_t i = root + 1; i < m_Ids.size(); i++)
+  {
+    if (m_Parent[i] >= 0 && removed[m_Parent[i]])
+      removed[i] = 1;
+  }
+
+  std::vector<unsigned int> order;
+  for (unsigned int i = 0; i < m_Ids.size(); i++)
+  {
+    if (removed[i])
+      m_IdToIndex[m_Ids[i]] = INVALID_NODE;
+    else
+      order.push_back(i);
+  }
+  ApplyOrder(order);
+}
+
+bool SceneGraph::SetParent(SceneNodeId node, SceneNodeId parent)
+{
+  if (!IsValid(node))
+    return false;
+
+  unsigned int index = m_IdToIndex[node];
+  int parentIndex = IsValid(parent) ? (int)m_IdToIndex[parent] : -1;
+  for (int ancestor = parentIndex; ancestor >= 0; ancestor = m_Parent[ancestor])
+  {
+    if (ancestor == (int)index)
+      return false;
+  }
+
+  m_Parent[index] = parentIndex;
+  m_NeedsSort = true;
+  MarkDirty(index);
+  return true;
+}
+
+void SceneGraph::Clear()
+{
+  m_Parent.clear();
+  m_Depth.clear();
+  m_Position.clear();
+  m_Rotation.clear();
+  m_Scale.clear();
+  m_Local.clear();
+  m_World.clear();
+  m_Dirty.clear();
+  m_UpdatedFrame.clear();
+  m_Ids.clear();
+  m_IdToIndex.clear();
+  m_FirstDirty = 0;
+  m_NeedsSort = false;
+}
+
+void SceneGraph::SetPosition(SceneNodeId node, const glm::vec3& position)
+{
+  unsigned int index = m_IdToIndex[node];
+  m_Position[index] = position;
+  MarkDirty(index);
+}
+
+void SceneGraph::SetRotation(SceneNodeId node, const glm::quat& rotation)
+{
+  unsigned int index = m_IdToIndex[node];
+  m_Rotation[index] = rotation;
+  MarkDirty(index);
+}
+
+void SceneGraph::SetScale(SceneNodeId node, const glm::vec3& scale)
+{
+  unsigned int index = m_IdToIndex[node];
+  m_Scale[index] = scale;
+  MarkDirty(index);
+}
+
+SceneNodeId SceneGraph::GetParent(SceneNodeId node) const
+{
+  int parent = m_Parent[m_IdToIndex[node]];
+  return parent >= 0 ? m_Ids[parent] : INVALID_NODE;
+}
+
+void SceneGraph::MarkDirty(unsigned int index)
+{
+  m_Dirty[index] = 1;
+  m_FirstDirty = std::min(m_FirstDirty, (size_t)index);
+}
+
+void SceneGraph::MarkAllDirty()
+{
+  std::fill(m_Dirty.begin(), m_Dirty.end(), 1);
+  m_FirstDirty = 0;
+}
+
+void SceneGraph::Update()
+{
+  if (m_NeedsSort)
+    Sort();
+
+  m_Frame++;
+  unsigned int updated = 0;
+  size_t count = m_Ids.size();
+  for (size_t i = m_FirstDirty; i < count; i++)
+  {
+    int parent = m_Parent[i];
+    bool parentMoved = parent >= 0 && m_UpdatedFrame[parent] == m_Frame;
+    if (!m_Dirty[i] && !parentMoved)
+      continue;
+
+    if (m_Dirty[i])
+    {
+      // Same as translate * rotate * scale, without multiplying out the zeros.
+      glm::mat4 local = glm::mat4_cast(m_Rotation[i]);
+      local[0] *= m_Scale[i].x;
+      local[1] *= m_Scale[i].y;
+      local[2] *= m_Scale[i].z;
+      local[3] = glm::vec4(m_Position[i], 1.0f);
+      m_Local[i] = local;
+      m_Dirty[i] = 0;
+    }
+
+    m_World[i] = parent >= 0 ? m_World[parent] * m_Local[i] : m_Local[i];
+    m_UpdatedFrame[i] = m_Frame;
+    updated++;
+  }
+
+  m_FirstDirty = count;
+  m_Stats.Nodes = (unsigned int)count;
+  m_Stats.Depth = m_Depth.empty() ? 0 : m_Depth.back() + 1;
+  m_Stats.UpdatedLastFrame = updated;
+}
+
+void SceneGraph::Sort()
+{
+  // Depths from the parent links, as reparenting leaves the stored ones stale.
+  size_t count = m_Ids.size();
+  std::vector<int> depths(count, -1);
+  std::vector<unsigned int> chain;
+  for (unsigned int i = 0; i < count; i++)
+  {
+    unsigned int node = i;
+    chain.clear();
+    while (depths[node] < 0)
+    {
+      chain.push_back(node);
+      if (m_Parent[node] < 0)
+        break;
+      node = m_Parent[node];
+    }
+
+    int depth = depths[node];
+    for (auto it = chain.rbegin(); it != chain.rend(); ++it)
+      depths[*it] = ++depth;
+  }
+
+  for (size_t i = 0; i < count; i++)
+    m_Depth[i] = (unsigned int)depths[i];
+
+  std::vector<unsigned int> order(count);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&depths](unsigned int a, unsigned int b) { return depths[a] < depths[b]; });
+  ApplyOrder(order);
+
+  m_NeedsSort = false;
+  m_Stats.Sorts++;
+}
+
+void SceneGraph::ApplyOrder(const std::vector<unsigned int>& order)
+{
+  std::vector<int> newIndex(m_Ids.size(), -1);
+  for (unsigned int i = 0; i < order.size(); i++)
+    newIndex[order[i]] = (int)i;
+
+  for (int& parent : m_Parent)
+  {
+    if (parent >= 0)
+      parent = newIndex[parent];
+  }
+
+  Reorder(m_Parent, order);
+  Reorder(m_Depth, order);
+  Reorder(m_Position, order);
+  Reorder(m_Rotation, order);
+  Reorder(m_Scale, order);
+  Reorder(m_Local, order);
+  Reorder(m_World, order);
+  Reorder(m_Dirty, order);
+  Reorder(m_UpdatedFrame, order);
+  Reorder(m_Ids, order);
+
+  for (unsigned int i = 0; i < m_Ids.size(); i++)
+    m_IdToIndex[m_Ids[i]] = i;
+
+  m_FirstDirty = m_Ids.size();
+  for (size_t i = 0; i < m_Dirty.size(); i++)
+  {
+    if (m_Dirty[i])
+    {
+      m_FirstDirty = i;
+      break;
+    }
+  }
+}
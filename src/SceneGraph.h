@@ -0,0 +1,86 @@
+#pragma once
+
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+typedef unsigned int SceneNodeId;
+
+// Transform hierarchy kept as flat arrays sorted by depth, so every parent comes before its
+// children. Changing a node only marks it dirty; Update then walks the arrays once and recomputes
+// the world matrices of dirty nodes and their descendants, leaving the rest untouched.
+// Node ids stay valid while nodes are re-sorted; they're only invalidated by DestroyNode.
+class SceneGraph
+{
+public:
+  static constexpr SceneNodeId INVALID_NODE = 0xFFFFFFFF;
+
+  struct Stats
+  {
+    unsigned int Nodes;
+    unsigned int Depth;
+    unsigned int UpdatedLastFrame;
+    unsigned int Sorts;
+  };
+
+private:
+  // Everything below is indexed by a node's position in depth order.
+  std::vector<int> m_Parent; // Position of the parent, -1 for roots.
+  std::vector<unsigned int> m_Depth;
+  std::vector<glm::vec3> m_Position;
+  std::vector<glm::quat> m_Rotation;
+  std::vector<glm::vec3> m_Scale;
+  std::vector<glm::mat4> m_Local;
+  std::vector<glm::mat4> m_World;
+  std::vector<unsigned char> m_Dirty;
+  // Frame the world matrix was last recomputed in; children compare it with the current frame
+  // to know their parent moved.
+  std::vector<unsigned int> m_UpdatedFrame;
+  std::vector<SceneNodeId> m_Ids;
+
+  std::vector<unsigned int> m_IdToIndex;
+  size_t m_FirstDirty;
+  unsigned int m_Frame;
+  bool m_NeedsSort;
+  Stats m_Stats;
+
+public:
+  SceneGraph();
+
+  SceneNodeId CreateNode(SceneNodeId parent = INVALID_NODE, const glm::vec3& position = glm::vec3(0.0f),
+    const glm::quat& rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f), const glm::vec3& scale = glm::vec3(1.0f));
+  // Destroys the node and its whole subtree.
+  void DestroyNode(SceneNodeId node);
+  // Moves the node (and its subtree) under a new parent, or makes it a root with INVALID_NODE.
+  // Returns false if that would create a cycle.
+  bool SetParent(SceneNodeId node, SceneNodeId parent);
+  void Clear();
+
+  void SetPosition(SceneNodeId node, const glm::vec3& position);
+  void SetRotation(SceneNodeId node, const glm::quat& rotation);
+  void SetScale(SceneNodeId node, const glm::vec3& scale);
+  inline const glm::vec3& GetPosition(SceneNodeId node) const { return m_Position[m_IdToIndex[node]]; }
+  inline const glm::quat& GetRotation(SceneNodeId node) const { return m_Rotation[m_IdToIndex[node]]; }
+  inline const glm::vec3& GetScale(SceneNodeId node) const { return m_Scale[m_IdToIndex[node]]; }
+  SceneNodeId GetParent(SceneNodeId node) const;
+  inline bool IsValid(SceneNodeId node) const { return node < m_IdToIndex.size() && m_IdToIndex[node] != INVALID_NODE; }
+
+  // Up to date as of the last Update.
+  inline const glm::mat4& GetWorldMatrix(SceneNodeId node) const { return m_World[m_IdToIndex[node]]; }
+  // World matrices of every node in depth order, alongside GetNodesInOrder.
+  inline const std::vector<glm::mat4>& GetWorldMatrices() const { return m_World; }
+  inline const std::vector<SceneNodeId>& GetNodesInOrder() const { return m_Ids; }
+
+  // Re-sorts after structural changes and recomputes dirty world matrices.
+  void Update();
+  // Marks every node dirty, so the next Update recomputes the whole hierarchy.
+  void MarkAllDirty();
+
+  inline const Stats& GetStats() const { return m_Stats; }
+private:
+  void MarkDirty(unsigned int index);
+  void Sort();
+  // Rebuilds every array from the given old indices, dropping nodes not listed.
+  void ApplyOrder(const std::vector<unsigned int>& order);
+};
@@ -6,22 +6,32 @@
 
 #include "Renderer.h"
 #include "Shader.h"
+#include "VirtualFileSystem.h"
 
 Shader::Shader(const std::string& vertexFile, const std::string& fragmentFile)
-  : m_VertexFilePath(vertexFile), m_FragmentFilePath(fragmentFile), m_RendererId(0)
+  : m_VertexFilePath(vertexFile), m_FragmentFilePath(fragmentFile)
 {
   ShaderProgramSource shaderSource = ParseShader();
-  m_RendererId = CreateShader(shaderSource);
+  m_RendererId.Reset(CreateShader(shaderSource));
 }
 
-Shader::~Shader()
+Shader::Shader(const std::string& vertexFile, const std::string& fragmentFile, const std::vector<std::string>& defines)
+  : m_VertexFilePath(vertexFile), m_FragmentFilePath(fragmentFile), m_Defines(defines)
 {
-  OpenGLCall(glDeleteProgram(m_RendererId));
+  ShaderProgramSource shaderSource = ParseShader();
+  m_RendererId.Reset(CreateShader(shaderSource));
+}
+
+Shader::Shader(const std::string& vertexFile, const std::vector<std::string>& feedbackVaryings)
+  : m_VertexFilePath(vertexFile), m_FeedbackVaryings(feedbackVaryings)
+{
+  ShaderProgramSource shaderSource = ParseShader();
+  m_RendererId.Reset(CreateShader(shaderSource));
 }
 
 void Shader::Bind() const
 {
-  OpenGLCall(glUseProgram(m_RendererId));
+  OpenGLCall(glUseProgram(m_RendererId.Get()));
 }
 
 void Shader::Unbind() const
@@ -29,37 +39,52 @@ void Shader::Unbind() const
   OpenGLCall(glUseProgram(0));
 }
 
-void Shader::SetUniform1i(const std::string& name, int value)
+void Shader::SetUniform1i(const char* name, int value)
 {
   OpenGLCall(glUniform1i(GetUniformLocation(name), value));
 }
 
-void Shader::SetUniform1f(const std::string& name, float value)
+void Shader::SetUniform1ui(const char* name, unsigned int value)
+{
+  OpenGLCall(glUniform1ui(GetUniformLocation(name), value));
+}
+
+void Shader::SetUniform1f(const char* name, float value)
 {
   OpenGLCall(glUniform1f(GetUniformLocation(name), value));
 }
 
-void Shader::SetUniform4f(const std::string& name, float v0, float v1, float v2, float v3)
+void Shader::SetUniform2f(const char* name, float v0, float v1)
+{
+  OpenGLCall(glUniform2f(GetUniformLocation(name), v0, v1));
+}
+
+void Shader::SetUniform3f(const char* name, float v0, float v1, float v2)
+{
+  OpenGLCall(glUniform3f(GetUniformLocation(name), v0, v1, v2));
+}
+
+void Shader::SetUniform4f(const char* name, float v0, float v1, float v2, float v3)
 {
   OpenGLCall(glUniform4f(GetUniformLocation(name), v0, v1, v2, v3));
 }
 
-void Shader::SetUniformMat4f(const std::string& name, const glm::mat4& matrix)
+void Shader::SetUniformMat4f(const char* name, const glm::mat4& matrix)
 {
   OpenGLCall(glUniformMatrix4fv(GetUniformLocation(name), 1, GL_FALSE, &matrix[0][0]));
 }
 
-int Shader::GetUniformLocation(const std::string& name)
+int Shader::GetUniformLocation(const char* name)
 {
-  if (m_UniformLocationCache.find(name) != m_UniformLocationCache.end())
-    return m_UniformLocationCache[name];
+  const int* cached = m_UniformLocationCache.Find(name);
+  if (cached)
+    return *cached;
 
-  OpenGLCall(int location = glGetUniformLocation(m_RendererId, name.c_str()));
+  OpenGLCall(int location = glGetUniformLocation(m_RendererId.Get(), name));
   if (location == -1)
     std::cout << "[WARNING] [OPENGL]: Uniform '" << name << "' doesn't exist!" << std::endl;
-  
-  m_UniformLocationCache[name] = location;
-  
+
+  m_UniformLocationCache.Add(name, location);
   return location;
 }
 
@@ -84,6 +109,7 @@ unsigned int Shader::CompileShader(unsigned int type, const std::string& source)
 
     std::cout << "Failed to compile " << (type == GL_VERTEX_SHADER ? "vertex" : "fragment") << " shader!" << std::endl;
     std::cout << message << std::endl;
+    glDeleteShader(id);
     return 0;
   }
 
@@ -94,31 +120,64 @@ unsigned int Shader::CreateShader(const ShaderProgramSource& source)
 {
   OpenGLCall(unsigned int program = glCreateProgram());
   OpenGLCall(unsigned int vs = CompileShader(GL_VERTEX_SHADER, source.VertexSource));
-  OpenGLCall(unsigned int fs = CompileShader(GL_FRAGMENT_SHADER, source.FragmentSource));
+  unsigned int fs = 0;
+  if (!m_FragmentFilePath.empty())
+  {
+    OpenGLCall(fs = CompileShader(GL_FRAGMENT_SHADER, source.FragmentSource));
+  }
+
+  if (!vs || (!m_FragmentFilePath.empty() && !fs))
+  {
+    OpenGLCall(glDeleteShader(vs));
+    OpenGLCall(glDeleteShader(fs));
+    OpenGLCall(glDeleteProgram(program));
+    return 0;
+  }
 
   OpenGLCall(glAttachShader(program, vs));
-  OpenGLCall(glAttachShader(program, fs));
+  if (fs)
+  {
+    OpenGLCall(glAttachShader(program, fs));
+  }
 
-  OpenGLCall(glLinkProgram(program));
-  OpenGLCall(glValidateProgram(program));
+  // Has to be set before linking.
+  if (!m_FeedbackVaryings.empty())
+  {
+    std::vector<const char*> names;
+    for (const std::string& varying : m_FeedbackVaryings)
+      names.push_back(varying.c_str());
+    OpenGLCall(glTransformFeedbackVaryings(program, (GLsizei)names.size(), names.data(), GL_INTERLEAVED_ATTRIBS));
+  }
 
+  OpenGLCall(glLinkProgram(program));
   OpenGLCall(glDeleteShader(vs));
-  OpenGLCall(glDeleteShader(fs));
+  if (fs)
+  {
+    OpenGLCall(glDeleteShader(fs));
+  }
+
+  int result;
+  OpenGLCall(glGetProgramiv(program, GL_LINK_STATUS, &result));
+  if (result == GL_FALSE)
+  {
+    std::cout << "Failed to link shader '" << m_VertexFilePath << "'!" << std::endl;
+    OpenGLCall(glDeleteProgram(program));
+    return 0;
+  }
 
+  OpenGLCall(glValidateProgram(program));
   return program;
 }
 
 std::stringstream Shader::ParseFile(const std::string& filepath)
 {
-  std::ifstream filestream(filepath);
+  FileView file = VirtualFileSystem::Get().Open(filepath);
 
-  std::string line;
   std::stringstream resultstream;
-
-  while (getline(filestream, line))
-  {
-    resultstream << line << "\n";
-  }
+  if (file.IsValid())
+    resultstream.write((const char*)file.Data, file.Size);
+  else
+    std::cout << "[ERROR] [OPENGL]: Shader file '" << filepath << "' not found!" << std::endl;
 
   return resultstream;
 }
@@ -126,6 +185,25 @@ std::stringstream Shader::ParseFile(const std::string& filepath)
 ShaderProgramSource Shader::ParseShader()
 {
   std::string vertexSource = ParseFile(m_VertexFilePath).str();
-  std::string fragmentSource = ParseFile(m_FragmentFilePath).str();
-  return { vertexSource, fragmentSource };
+  std::string fragmentSource = m_FragmentFilePath.empty() ? std::string() : ParseFile(m_FragmentFilePath).str();
+  return { InsertDefines(vertexSource), InsertDefines(fragmentSource) };
+}
+
+std::string Shader::InsertDefines(const std::string& source) const
+{
+  if (m_Defines.empty())
+    return source;
+
+  std::string defines;
+  for (const std::string& define : m_Defines)
+    defines += "#define " + define + "\n";
+
+  // #version has to stay the first statement, so the defines go on the line after it.
+  size_t position = 0;
+  if (source.compare(0, 8, "#version") == 0)
+  {
+    position = source.find('\n');
+    position = position == std::string::npos ? source.size() : position + 1;
+  }
+  return source.substr(0, position) + defines + source.substr(position);
 }
\ No newline at end of file
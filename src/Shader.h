@@ -1,7 +1,10 @@
 #pragma once
 #include <glm/glm.hpp>
 #include <string>
-#include <unordered_map>
+#include <vector>
+
+#include "GLHandle.h"
+#include "UniformLocationCache.h"
 
 struct ShaderProgramSource
 {
@@ -14,25 +17,39 @@ class Shader
 private:
   std::string m_VertexFilePath;
   std::string m_FragmentFilePath;
-  unsigned int m_RendererId;
-  std::unordered_map<std::string, int> m_UniformLocationCache;
+  std::vector<std::string> m_Defines;
+  std::vector<std::string> m_FeedbackVaryings;
+  ProgramHandle m_RendererId;
+  UniformLocationCache m_UniformLocationCache;
 public:
   Shader(const std::string& vertexFilePath, const std::string& fragmentFilePath);
-  ~Shader();
+  // Compiles a variant with a "#define" line per entry inserted after each stage's #version line.
+  Shader(const std::string& vertexFilePath, const std::string& fragmentFilePath, const std::vector<std::string>& defines);
+  // Vertex stage only, for transform feedback: the named outputs are captured interleaved into the
+  // buffer bound to GL_TRANSFORM_FEEDBACK_BUFFER index 0. Draw with GL_RASTERIZER_DISCARD enabled.
+  Shader(const std::string& vertexFilePath, const std::vector<std::string>& feedbackVaryings);
+
+  Shader(Shader&&) = default;
+  Shader& operator=(Shader&&) = default;
 
   void Bind() const;
   void Unbind() const;
+  // False when a stage failed to compile or the program failed to link.
+  inline bool IsValid() const { return static_cast<bool>(m_RendererId); }
 
+  void SetUniform1f(const char* name, float value);
+  void SetUniform1i(const char* name, int value);
+  void SetUniform1ui(const char* name, unsigned int value);
+  void SetUniform2f(const char* name, float v0, float v1);
+  void SetUniform3f(const char* name, float v0, float v1, float v2);
 
-  void SetUniform1f(const std::string& name, float value);
-  void SetUniform1i(const std::string& name, int value);
-
-  void SetUniform4f(const std::string& name, float v0, float v1, float v2, float v3);
-  void SetUniformMat4f(const std::string& name, const glm::mat4& matrix);
+  void SetUniform4f(const char* name, float v0, float v1, float v2, float v3);
+  void SetUniformMat4f(const char* name, const glm::mat4& matrix);
 private:
-  int GetUniformLocation(const std::string& name);
+  int GetUniformLocation(const char* name);
   unsigned int CompileShader(unsigned int type, const std::string& source);
   unsigned int CreateShader(const ShaderProgramSource& source);
   ShaderProgramSource ParseShader();
+  std::string InsertDefines(const std::string& source) const;
   std::stringstream ParseFile(const std::string& filepath);
 };
\ No newline at end of file
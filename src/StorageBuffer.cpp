@@ -0,0 +1,42 @@
+#include "Renderer.h"
+#include "StorageBuffer.h"
+
+StorageBuffer::StorageBuffer(size_t size, const void* data, unsigned int usage)
+  : m_Size(size)
+{
+  // Uploads go through the copy binding points so they never disturb the caller's bindings.
+  unsigned int id = 0;
+  OpenGLCall(glGenBuffers(1, &id));
+  m_RendererId.Reset(id);
+  OpenGLCall(glBindBuffer(GL_COPY_WRITE_BUFFER, id));
+  OpenGLCall(glBufferData(GL_COPY_WRITE_BUFFER, size, data, usage));
+}
+
+void StorageBuffer::Bind(unsigned int target) const
+{
+  OpenGLCall(glBindBuffer(target, m_RendererId.Get()));
+}
+
+void StorageBuffer::BindBase(unsigned int target, unsigned int index) const
+{
+  OpenGLCall(glBindBufferBase(target, index, m_RendererId.Get()));
+}
+
+void StorageBuffer::SetSubData(size_t offset, size_t size, const void* data) const
+{
+  OpenGLCall(glBindBuffer(GL_COPY_WRITE_BUFFER, m_RendererId.Get()));
+  OpenGLCall(glBufferSubData(GL_COPY_WRITE_BUFFER, offset, size, data));
+}
+
+void StorageBuffer::GetSubData(size_t offset, size_t size, void* data) const
+{
+  OpenGLCall(glBindBuffer(GL_COPY_READ_BUFFER, m_RendererId.Get()));
+  OpenGLCall(glGetBufferSubData(GL_COPY_READ_BUFFER, offset, size, data));
+}
+
+void StorageBuffer::CopyTo(const StorageBuffer& target, size_t sourceOffset, size_t targetOffset, size_t size) const
+{
+  OpenGLCall(glBindBuffer(GL_COPY_READ_BUFFER, m_RendererId.Get()));
+  OpenGLCall(glBindBuffer(GL_COPY_WRITE_BUFFER, target.m_RendererId.Get()));
+  OpenGLCall(glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, sourceOffset, targetOffset, size));
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <cstddef>
+
+#include "GLHandle.h"
+
+// Untyped GL buffer for data shaders read and write directly: shader storage, indirect draw
+// commands, atomic counters and read backs. Not tied to one binding point.
+class StorageBuffer
+{
+private:
+  BufferHandle m_RendererId;
+  size_t m_Size;
+public:
+  StorageBuffer(size_t size, const void* data = nullptr, unsigned int usage = GL_DYNAMIC_DRAW);
+
+  StorageBuffer(StorageBuffer&&) = default;
+  StorageBuffer& operator=(StorageBuffer&&) = default;
+
+  void Bind(unsigned int target) const;
+  // Binds to an indexed target (GL_SHADER_STORAGE_BUFFER, GL_UNIFORM_BUFFER, ...) at the given index.
+  void BindBase(unsigned int target, unsigned int index) const;
+
+  void SetSubData(size_t offset, size_t size, const void* data) const;
+  // Copies back to the CPU; waits for any pending GPU writes to the buffer.
+  void GetSubData(size_t offset, size_t size, void* data) const;
+  void CopyTo(const StorageBuffer& target, size_t sourceOffset, size_t targetOffset, size_t size) const;
+
+  inline unsigned int GetRendererId() const { return m_RendererId.Get(); }
+  inline size_t GetSize() const { return m_Size; }
+};
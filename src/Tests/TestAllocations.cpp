@@ -0,0 +1,182 @@
+#include <imgui/imgui.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <list>
+#include <map>
+#include <new>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "TestAllocations.h"
+
+#include "FrameAllocator.h"
+#include "PoolAllocator.h"
+
+// Replaces the global allocation functions for the whole program; the array and nothrow forms
+// forward to these by default.
+static std::atomic<size_t> s_HeapAllocations(0);
+static std::atomic<size_t> s_HeapBytes(0);
+
+void* operator new(size_t size)
+{
+  s_HeapAllocations.fetch_add(1, std::memory_order_relaxed);
+  s_HeapBytes.fetch_add(size, std::memory_order_relaxed);
+  void* memory = std::malloc(size ? size : 1);
+  if (!memory)
+    throw std::bad_alloc();
+  return memory;
+}
+
+void operator delete(void* memory) noexcept
+{
+  std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+  std::free(memory);
+}
+
+namespace test
+{
+  namespace
+  {
+    typedef std::chrono::high_resolution_clock Clock;
+
+    const int POOL_ITERATIONS = 100000;
+
+    // Churns a container the way a free list of short lived render items would.
+    template<typename List>
+    void ChurnList(List& list)
+    {
+      for (int i = 0; i < POOL_ITERATIONS; i++)
+      {
+        list.push_back(i);
+        if (list.size() > 64)
+          list.pop_front();
+      }
+      list.clear();
+    }
+
+    template<typename Map>
+    void ChurnMap(Map& map)
+    {
+      for (int i = 0; i < POOL_ITERATIONS; i++)
+      {
+        map[i] = (float)i;
+        if (i >= 64)
+          map.erase(i - 64);
+      }
+      map.clear();
+    }
+  }
+
+  Allocations::Allocations()
+    : m_TransientCount(1000), m_UseFrameAllocator(true), m_LastCount(s_HeapAllocations), m_AllocationsLastFrame(0),
+      m_BytesLastFrame(0), m_LastBytes(s_HeapBytes), m_AllocationFreeFrames(0), m_Checksum(0.0f)
+  {
+  }
+
+  Allocations::~Allocations()
+  {
+  }
+
+  void Allocations::OnUpdate(float deltatime)
+  {
+    // Everything since the last call, so the whole application loop rather than just this test.
+    size_t count = s_HeapAllocations, bytes = s_HeapBytes;
+    m_AllocationsLastFrame = count - m_LastCount;
+    m_BytesLastFrame = bytes - m_LastBytes;
+    m_AllocationFreeFrames = m_AllocationsLastFrame == 0 ? m_AllocationFreeFrames + 1 : 0;
+
+    m_LastCount = count;
+    m_LastBytes = bytes;
+
+    BuildTransientData();
+  }
+
+  void Allocations::BuildTransientData()
+  {
+    // Per object matrices and a debug label, the kind of data thrown away at the end of a frame.
+    float checksum = 0.0f;
+    if (m_UseFrameAllocator)
+    {
+      FrameVector<glm::mat4> matrices;
+      matrices.reserve(m_TransientCount);
+      for (int i = 0; i < m_TransientCount; i++)
+        matrices.push_back(glm::translate(glm::mat4(1.0f), glm::vec3((float)i, 0.0f, 0.0f)));
+      FrameString label("Transient matrices built from the frame arena");
+      checksum = matrices.empty() ? 0.0f : matrices.back()[3][0] + (float)label.size();
+    }
+    else
+    {
+      std::vector<glm::mat4> matrices;
+      for (int i = 0; i < m_TransientCount; i++)
+        matrices.push_back(glm::translate(glm::mat4(1.0f), glm::vec3((float)i, 0.0f, 0.0f)));
+      std::string label("Transient matrices built from the global heap");
+      checksum = matrices.empty() ? 0.0f : matrices.back()[3][0] + (float)label.size();
+    }
+    m_Checksum = checksum;
+  }
+
+  void Allocations::RunPoolBenchmark()
+  {
+    m_Results.clear();
+    auto measure = [this](const char* name, auto function)
+    {
+      size_t before = s_HeapAllocations;
+      auto start = Clock::now();
+      function();
+      double milliseconds = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+      size_t allocations = s_HeapAllocations - before;
+      m_Results.push_back({ name, milliseconds, allocations });
+    };
+
+    measure("std::list, default allocator", []()
+    {
+      std::list<int> list;
+      ChurnList(list);
+    });
+    measure("std::list, pool allocator", []()
+    {
+      // List nodes: two links and the value.
+      PoolAllocator pool(2 * sizeof(void*) + sizeof(int), 128);
+      std::list<int, PoolStlAllocator<int>> list{ PoolStlAllocator<int>(pool) };
+      ChurnList(list);
+    });
+    measure("std::map, default allocator", []()
+    {
+      std::map<int, float> map;
+      ChurnMap(map);
+    });
+    measure("std::map, pool allocator", []()
+    {
+      // Red-black tree nodes: three links, a colour and the value.
+      PoolAllocator pool(4 * sizeof(void*) + sizeof(std::pair<const int, float>), 128);
+      PoolStlAllocator<std::pair<const int, float>> allocator(pool);
+      std::map<int, float, std::less<int>, PoolStlAllocator<std::pair<const int, float>>> map(std::less<int>(), allocator);
+      ChurnMap(map);
+    });
+  }
+
+  void Allocations::OnImGuiRender()
+  {
+    ImGui::Text("Heap allocations last frame: %zu (%.1f KB)", m_AllocationsLastFrame, m_BytesLastFrame / 1024.0f);
+    ImGui::Text("Frames in a row without heap allocations: %u", m_AllocationFreeFrames);
+    ImGui::SliderInt("Transient objects", &m_TransientCount, 0, 100000);
+    ImGui::Checkbox("Transient data from the frame allocator", &m_UseFrameAllocator);
+    ImGui::Text("Checksum: %.0f", m_Checksum);
+
+    ImGui::Separator();
+    FrameAllocator::Get().OnImGuiRender();
+
+    ImGui::Separator();
+    if (ImGui::Button("Run pool benchmark"))
+      RunPoolBenchmark();
+    for (const Result& result : m_Results)
+      ImGui::Text("%-32s %8.3f ms  %7zu heap allocations", result.Name.c_str(), result.Milliseconds, result.HeapAllocations);
+  }
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Test.h"
+
+namespace test
+{
+  // Counts global heap allocations through a replaced operator new. Shows how many each whole frame
+  // makes, with a transient workload built either on the heap or in the FrameAllocator, and compares
+  // node based containers using the default allocator against a PoolAllocator.
+  class Allocations : public Test
+  {
+  private:
+    struct Result
+    {
+      std::string Name;
+      double Milliseconds;
+      size_t HeapAllocations;
+    };
+
+    int m_TransientCount;
+    bool m_UseFrameAllocator;
+    size_t m_LastCount;
+    size_t m_AllocationsLastFrame, m_BytesLastFrame;
+    size_t m_LastBytes;
+    unsigned int m_AllocationFreeFrames;
+    float m_Checksum;
+    std::vector<Result> m_Results;
+
+  public:
+    Allocations();
+    ~Allocations();
+
+    void OnUpdate(float deltatime);
+    void OnImGuiRender();
+  private:
+    void BuildTransientData();
+    void RunPoolBenchmark();
+  };
+}
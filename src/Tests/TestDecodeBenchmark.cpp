@@ -0,0 +1,99 @@
+#include <imgui/imgui.h>
+
+#include <chrono>
+#include <fstream>
+
+#include "TestDecodeBenchmark.h"
+
+#include "ImageDecoder.h"
+#include "MappedFile.h"
+
+namespace test
+{
+  DecodeBenchmark::DecodeBenchmark() : m_CorpusPath{ "src/resources/decode-corpus.txt" }, m_Iterations(10)
+  {
+  }
+
+  DecodeBenchmark::~DecodeBenchmark()
+  {
+  }
+
+  void DecodeBenchmark::Run()
+  {
+    m_Results.clear();
+
+    // The corpus file lists one image path per line.
+    std::ifstream corpus(m_CorpusPath);
+    std::string filepath;
+    while (getline(corpus, filepath))
+    {
+      if (filepath.empty() || filepath[0] == '#')
+        continue;
+
+      MappedFile file(filepath);
+      if (!file.IsValid())
+      {
+        std::cout << "[WARNING] Decode benchmark couldn't open '" << filepath << "'" << std::endl;
+        continue;
+      }
+
+      for (const auto& decoder : ImageDecoder::GetDecoders())
+      {
+        ImageInfo info;
+        if (!decoder->CanDecode(file.GetData(), file.GetSize()) || !decoder->ReadInfo(file.GetData(), file.GetSize(), info))
+          continue;
+
+        // Decode as the texture upload path would, so the destination is allocated once up front.
+        std::vector<unsigned char> pixels((size_t)info.Width * info.Height * info.Channels);
+
+        auto start = std::chrono::high_resolution_clock::now();
+        bool decoded = true;
+        for (int i = 0; i < m_Iterations && decoded; i++)
+          decoded = decoder->Decode(file.GetData(), file.GetSize(), pixels.data(), pixels.size(), info.Channels, true);
+        auto end = std::chrono::high_resolution_clock::now();
+
+        if (!decoded)
+        {
+          std::cout << "[WARNING] " << decoder->GetName() << " failed on '" << filepath << "': " << decoder->GetFailureReason() << std::endl;
+          continue;
+        }
+
+        const double megabyte = 1024.0 * 1024.0;
+        double seconds = std::chrono::duration<double>(end - start).count();
+        Result result;
+        result.FilePath = filepath;
+        result.Decoder = decoder->GetName();
+        result.Width = info.Width;
+        result.Height = info.Height;
+        result.Channels = info.Channels;
+        result.MillisecondsPerImage = seconds * 1000.0 / m_Iterations;
+        result.EncodedMegabytesPerSecond = file.GetSize() * m_Iterations / megabyte / seconds;
+        result.DecodedMegabytesPerSecond = pixels.size() * m_Iterations / megabyte / seconds;
+        m_Results.push_back(result);
+      }
+    }
+  }
+
+  void DecodeBenchmark::OnImGuiRender()
+  {
+    ImGui::InputText("Corpus", m_CorpusPath, sizeof(m_CorpusPath));
+    ImGui::SliderInt("Iterations", &m_Iterations, 1, 100);
+    if (ImGui::Button("Run"))
+      Run();
+
+    ImGui::Text("Backends:");
+    for (const auto& decoder : ImageDecoder::GetDecoders())
+    {
+      ImGui::SameLine();
+      ImGui::Text("%s", decoder->GetName());
+    }
+
+    ImGui::Separator();
+    for (const Result& result : m_Results)
+    {
+      ImGui::Text("%s [%s]", result.FilePath.c_str(), result.Decoder.c_str());
+      ImGui::Text("  %dx%dx%d  %.2f ms  %.1f MB/s encoded  %.1f MB/s decoded", result.Width, result.Height,
+        result.Channels, result.MillisecondsPerImage, result.EncodedMegabytesPerSecond, result.DecodedMegabytesPerSecond);
+    }
+  }
+}
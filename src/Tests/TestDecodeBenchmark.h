@@ -0,0 +1,37 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Test.h"
+
+namespace test
+{
+  // Decodes every image listed in the corpus file with each available ImageDecoder backend
+  // and reports throughput in MB/s of decoded pixels.
+  class DecodeBenchmark : public Test
+  {
+  private:
+    struct Result
+    {
+      std::string FilePath;
+      std::string Decoder;
+      int Width, Height, Channels;
+      double MillisecondsPerImage;
+      double EncodedMegabytesPerSecond;
+      double DecodedMegabytesPerSecond;
+    };
+
+    char m_CorpusPath[256];
+    int m_Iterations;
+    std::vector<Result> m_Results;
+
+  public:
+    DecodeBenchmark();
+    ~DecodeBenchmark();
+
+    void OnImGuiRender();
+  private:
+    void Run();
+  };
+}
@@ -0,0 +1,137 @@
+#include <chrono>
+#include <cmath>
+
+#include <imgui/imgui.h>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "TestDynamicMesh.h"
+
+namespace test
+{
+  enum UpdateMode
+  {
+    UPDATE_RECREATE, UPDATE_SET_DATA, UPDATE_ORPHAN_SUB_DATA
+  };
+
+  DynamicMesh::DynamicMesh()
+    : m_Resolution(200), m_UpdateMode(UPDATE_ORPHAN_SUB_DATA), m_ShortIndices(true), m_Time(0.0f), m_UpdateMilliseconds(0.0f)
+  {
+    m_Shader = ResourceRegistry::Get().LoadShader("src/resources/StaticMesh.vert", "src/resources/Instanced.frag");
+    CreateIndices();
+    OnUpdate(0.0f);
+    CreateBuffers();
+    OpenGLCall(glDisable(GL_BLEND));
+  }
+
+  DynamicMesh::~DynamicMesh()
+  {
+    ResourceRegistry::Get().Release(m_Shader);
+    m_Renderer.SetDepthMode(DepthMode::Disabled);
+    OpenGLCall(glEnable(GL_BLEND));
+  }
+
+  void DynamicMesh::CreateIndices()
+  {
+    std::vector<unsigned int> indices;
+    int size = m_Resolution + 1;
+    for (int z = 0; z < m_Resolution; z++)
+    {
+      for (int x = 0; x < m_Resolution; x++)
+      {
+        unsigned int corner = z * size + x;
+        indices.insert(indices.end(), { corner, corner + size, corner + 1, corner + 1, corner + size, corner + size + 1 });
+      }
+    }
+
+    if (m_ShortIndices)
+      m_IndexBuffer = IndexBuffer::CreateCompact(indices.data(), (unsigned int)indices.size());
+    else
+      m_IndexBuffer = std::make_unique<IndexBuffer>(indices.data(), (unsigned int)indices.size());
+  }
+
+  void DynamicMesh::CreateBuffers()
+  {
+    m_VertexBuffer = std::make_unique<VertexBuffer>(m_Vertices.data(), (unsigned int)(m_Vertices.size() * sizeof(float)), BufferUsage::Stream);
+    VertexBufferLayout layout;
+    layout.Push<float>(3);
+    layout.Push<float>(3);
+    m_VertexArray = std::make_unique<VertexArray>();
+    m_VertexArray->AddBuffer(*m_VertexBuffer, layout);
+  }
+
+  void DynamicMesh::OnUpdate(float deltatime)
+  {
+    m_Time += deltatime;
+
+    // Radial ripple with analytic normals.
+    int size = m_Resolution + 1;
+    m_Vertices.resize((size_t)size * size * 6);
+    float* vertex = m_Vertices.data();
+    for (int z = 0; z < size; z++)
+    {
+      for (int x = 0; x < size; x++)
+      {
+        float px = (float)x / m_Resolution * 2.0f - 1.0f, pz = (float)z / m_Resolution * 2.0f - 1.0f;
+        float distance = std::sqrt(px * px + pz * pz) + 0.0001f;
+        float phase = distance * 20.0f - m_Time * 4.0f;
+        float height = std::sin(phase) * 0.05f;
+        float slope = std::cos(phase) * 20.0f * 0.05f / distance;
+        glm::vec3 normal = glm::normalize(glm::vec3(-slope * px, 1.0f, -slope * pz));
+        vertex[0] = px; vertex[1] = height; vertex[2] = pz;
+        vertex[3] = normal.x; vertex[4] = normal.y; vertex[5] = normal.z;
+        vertex += 6;
+      }
+    }
+  }
+
+  void DynamicMesh::OnRender()
+  {
+    auto start = std::chrono::high_resolution_clock::now();
+    unsigned int size = (unsigned int)(m_Vertices.size() * sizeof(float));
+    if (m_UpdateMode == UPDATE_RECREATE || m_VertexBuffer->GetSize() != size)
+    {
+      CreateBuffers();
+    }
+    else if (m_UpdateMode == UPDATE_SET_DATA)
+    {
+      m_VertexBuffer->SetData(m_Vertices.data(), size);
+    }
+    else
+    {
+      m_VertexBuffer->Orphan();
+      m_VertexBuffer->SetSubData(0, m_Vertices.data(), size);
+    }
+    m_UpdateMilliseconds = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+    m_Renderer.SetDepthMode(DepthMode::ReadWrite);
+    OpenGLCall(glClearColor(0.05f, 0.05f, 0.08f, 1.0f));
+    m_Renderer.Clear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    glm::mat4 projection = glm::perspective(glm::radians(50.0f), WINDOW_WIDTH / WINDOW_HEIGHT, 0.1f, 10.0f);
+    glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 1.2f, 1.8f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    Shader& shader = *ResourceRegistry::Get().Resolve(m_Shader);
+    shader.Bind();
+    shader.SetUniformMat4f("u_ViewProjection", projection * view);
+    shader.SetUniform4f("u_Color", 0.3f, 0.5f, 0.9f, 1.0f);
+    m_Renderer.Draw(*m_VertexArray, *m_IndexBuffer, shader);
+  }
+
+  void DynamicMesh::OnImGuiRender()
+  {
+    if (ImGui::SliderInt("Resolution", &m_Resolution, 16, 400))
+    {
+      CreateIndices();
+      OnUpdate(0.0f);
+    }
+    ImGui::RadioButton("Recreate buffers", &m_UpdateMode, UPDATE_RECREATE);
+    ImGui::RadioButton("SetData", &m_UpdateMode, UPDATE_SET_DATA);
+    ImGui::RadioButton("Orphan + SetSubData", &m_UpdateMode, UPDATE_ORPHAN_SUB_DATA);
+    if (ImGui::Checkbox("16-bit indices when possible", &m_ShortIndices))
+      CreateIndices();
+
+    ImGui::Text("Vertices: %d  Index type: %s", (m_Resolution + 1) * (m_Resolution + 1),
+      m_IndexBuffer->GetType() == GL_UNSIGNED_SHORT ? "16-bit" : "32-bit");
+    ImGui::Text("Index buffer: %.2f MB", m_IndexBuffer->GetLength() * m_IndexBuffer->GetIndexSize() / (1024.0 * 1024.0));
+    ImGui::Text("Vertex update: %.3f ms", m_UpdateMilliseconds);
+  }
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "Test.h"
+
+#include "Renderer.h"
+#include "ResourceRegistry.h"
+#include "VertexBuffer.h"
+#include "VertexBufferLayout.h"
+
+namespace test
+{
+  // A rippling grid rewritten every frame, comparing recreating its buffers against updating
+  // them in place, and 16-bit against 32-bit indices.
+  class DynamicMesh : public Test
+  {
+  private:
+    std::unique_ptr<VertexArray> m_VertexArray;
+    std::unique_ptr<VertexBuffer> m_VertexBuffer;
+    std::unique_ptr<IndexBuffer> m_IndexBuffer;
+    ShaderHandle m_Shader;
+    std::vector<float> m_Vertices;
+    Renderer m_Renderer;
+    int m_Resolution;
+    int m_UpdateMode;
+    bool m_ShortIndices;
+    float m_Time;
+    float m_UpdateMilliseconds;
+
+  public:
+    DynamicMesh();
+    ~DynamicMesh();
+
+    void OnUpdate(float deltatime);
+    void OnRender();
+    void OnImGuiRender();
+  private:
+    void CreateBuffers();
+    void CreateIndices();
+  };
+}
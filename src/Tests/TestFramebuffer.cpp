@@ -0,0 +1,53 @@
+#include <imgui/imgui.h>
+
+#include "TestFramebuffer.h"
+
+#include "RenderTargetPool.h"
+
+namespace test
+{
+  Framebuffers::Framebuffers() : m_Samples(4), m_PixelSize(1)
+  {
+  }
+
+  Framebuffers::~Framebuffers()
+  {
+  }
+
+  void Framebuffers::OnRender()
+  {
+    RenderTargetPool& pool = RenderTargetPool::Get();
+    int width = (int)WINDOW_WIDTH, height = (int)WINDOW_HEIGHT;
+
+    Framebuffer* scene = pool.Acquire({ width, height, { GL_RGBA8 }, GL_DEPTH24_STENCIL8, m_Samples });
+    scene->Bind();
+    Texture2D::OnRender();
+    scene->Unbind();
+
+    Framebuffer* output = scene;
+    if (m_Samples > 0)
+    {
+      output = pool.Acquire({ width, height, { GL_RGBA8 }, 0, 0 });
+      scene->BlitTo(output);
+      pool.Release(scene);
+    }
+
+    if (m_PixelSize > 1)
+    {
+      Framebuffer* small = pool.Acquire({ width / m_PixelSize, height / m_PixelSize, { GL_RGBA8 }, 0, 0 });
+      output->BlitTo(small, GL_LINEAR);
+      pool.Release(output);
+      output = small;
+    }
+
+    output->BlitTo(nullptr);
+    pool.Release(output);
+  }
+
+  void Framebuffers::OnImGuiRender()
+  {
+    Texture2D::OnImGuiRender();
+    ImGui::SliderInt("MSAA samples", &m_Samples, 0, 8);
+    ImGui::SliderInt("Pixel size", &m_PixelSize, 1, 16);
+  }
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "TestTexture2D.h"
+
+namespace test
+{
+  // Renders the 2D texture scene offscreen through pooled render targets: a multisampled
+  // target, a resolve target and an optional low resolution target for a pixelation effect.
+  class Framebuffers : public Texture2D
+  {
+  private:
+    int m_Samples;
+    int m_PixelSize;
+
+  public:
+    Framebuffers();
+    ~Framebuffers();
+
+    void OnRender();
+    void OnImGuiRender();
+  };
+}
@@ -0,0 +1,100 @@
+#include <imgui/imgui.h>
+
+#include <chrono>
+#include <random>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "TestFrustumCulling.h"
+
+#include "Renderer.h"
+
+namespace test
+{
+  FrustumCullingBenchmark::FrustumCullingBenchmark() : m_Iterations(10)
+  {
+  }
+
+  FrustumCullingBenchmark::~FrustumCullingBenchmark()
+  {
+  }
+
+  void FrustumCullingBenchmark::Run()
+  {
+    m_Results.clear();
+
+    glm::mat4 projection = glm::perspective(glm::radians(60.0f), WINDOW_WIDTH / WINDOW_HEIGHT, 0.1f, 1000.0f);
+    glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 50.0f, 200.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    Frustum frustum(projection * view);
+
+    const size_t counts[] = { 100000, 1000000 };
+    const SimdKernel kernels[] = { SimdKernel::Scalar, SimdKernel::Sse, SimdKernel::Avx2 };
+
+    for (size_t count : counts)
+    {
+      // Scattered around the camera so roughly a quarter of them end up visible.
+      std::mt19937 random(42);
+      std::uniform_real_distribution<float> unit(-1.0f, 1.0f), size(0.5f, 5.0f);
+      FrustumCuller culler;
+      for (size_t i = 0; i < count; i++)
+      {
+        glm::vec3 center(unit(random) * 400.0f, unit(random) * 400.0f, unit(random) * 400.0f);
+        culler.AddSphere(BoundingSphere{ center, size(random) });
+        glm::vec3 extents(size(random), size(random), size(random));
+        culler.AddBox(BoundingBox{ center - extents, center + extents });
+      }
+
+      for (int boxes = 0; boxes < 2; boxes++)
+      {
+        std::vector<unsigned int> reference, visible;
+        if (boxes)
+          culler.CullBoxes(frustum, reference, SimdKernel::Scalar);
+        else
+          culler.CullSpheres(frustum, reference, SimdKernel::Scalar);
+
+        for (SimdKernel kernel : kernels)
+        {
+          if (!IsSimdKernelSupported(kernel))
+            continue;
+
+          auto start = std::chrono::high_resolution_clock::now();
+          for (int i = 0; i < m_Iterations; i++)
+          {
+            if (boxes)
+              culler.CullBoxes(frustum, visible, kernel);
+            else
+              culler.CullSpheres(frustum, visible, kernel);
+          }
+          auto end = std::chrono::high_resolution_clock::now();
+
+          double seconds = std::chrono::duration<double>(end - start).count();
+          Result result;
+          result.Count = count;
+          result.Boxes = boxes != 0;
+          result.Kernel = kernel;
+          result.MillisecondsPerCull = seconds * 1000.0 / m_Iterations;
+          result.MillionObjectsPerSecond = count * (double)m_Iterations / seconds / 1000000.0;
+          result.Visible = visible.size();
+          result.MatchesScalar = visible == reference;
+          m_Results.push_back(result);
+        }
+      }
+    }
+  }
+
+  void FrustumCullingBenchmark::OnImGuiRender()
+  {
+    ImGui::SliderInt("Iterations", &m_Iterations, 1, 100);
+    if (ImGui::Button("Run"))
+      Run();
+
+    ImGui::Text("Best kernel: %s", GetSimdKernelName(GetBestSimdKernel()));
+    ImGui::Separator();
+    for (const Result& result : m_Results)
+    {
+      ImGui::Text("%7zu %-7s  %-6s  %8.3f ms  %7.1f M objects/s  %7zu visible  %s", result.Count,
+        result.Boxes ? "boxes" : "spheres", GetSimdKernelName(result.Kernel), result.MillisecondsPerCull,
+        result.MillionObjectsPerSecond, result.Visible, result.MatchesScalar ? "" : "MISMATCH");
+    }
+  }
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <vector>
+
+#include "Test.h"
+
+#include "FrustumCuller.h"
+
+namespace test
+{
+  // Culls 100k and 1M random bounding spheres and boxes with every FrustumCuller kernel, reporting
+  // objects per second, how many were visible and whether the result matches the scalar kernel.
+  class FrustumCullingBenchmark : public Test
+  {
+  private:
+    struct Result
+    {
+      size_t Count;
+      bool Boxes;
+      SimdKernel Kernel;
+      double MillisecondsPerCull;
+      double MillionObjectsPerSecond;
+      size_t Visible;
+      bool MatchesScalar;
+    };
+
+    int m_Iterations;
+    std::vector<Result> m_Results;
+
+  public:
+    FrustumCullingBenchmark();
+    ~FrustumCullingBenchmark();
+
+    void OnImGuiRender();
+  private:
+    void Run();
+  };
+}
@@ -0,0 +1,146 @@
+#include <chrono>
+#include <random>
+#include <utility>
+
+#include <imgui/imgui.h>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "TestGpuCulling.h"
+
+namespace test
+{
+  GpuCullingScene::GpuCullingScene()
+    : m_InstanceCount(100000), m_GpuCulling(true), m_Rotate(true), m_CameraAngle(0.0f), m_CullMilliseconds(0.0f)
+  {
+    // Both meshes share one vertex and index buffer; each mesh indexes from its own base vertex.
+    std::vector<float> vertices;
+    std::vector<unsigned int> indices;
+    unsigned int baseVertex = 0;
+    auto addFace = [&](const glm::vec3* corners, unsigned int count, const glm::vec3& normal)
+    {
+      unsigned int first = (unsigned int)(vertices.size() / 6) - baseVertex;
+      for (unsigned int i = 0; i < count; i++)
+        vertices.insert(vertices.end(), { corners[i].x, corners[i].y, corners[i].z, normal.x, normal.y, normal.z });
+      for (unsigned int i = 1; i + 1 < count; i++)
+        indices.insert(indices.end(), { first, first + i, first + i + 1 });
+    };
+
+    // Mesh 0: unit cube, four vertices per face for flat normals.
+    for (int axis = 0; axis < 3; axis++)
+    {
+      for (int sign = -1; sign <= 1; sign += 2)
+      {
+        glm::vec3 normal(0.0f), u(0.0f), v(0.0f);
+        normal[axis] = (float)sign;
+        u[(axis + 1) % 3] = 0.5f;
+        v[(axis + 2) % 3] = 0.5f * sign;
+        glm::vec3 center = normal * 0.5f;
+        glm::vec3 corners[4] = { center - u - v, center + u - v, center + u + v, center - u + v };
+        addFace(corners, 4, normal);
+      }
+    }
+    unsigned int cubeIndexCount = (unsigned int)indices.size();
+
+    // Mesh 1: octahedron.
+    baseVertex = (unsigned int)(vertices.size() / 6);
+    for (int face = 0; face < 8; face++)
+    {
+      float x = (face & 1) ? 0.6f : -0.6f, y = (face & 2) ? 0.6f : -0.6f, z = (face & 4) ? 0.6f : -0.6f;
+      glm::vec3 corners[3] = { glm::vec3(x, 0.0f, 0.0f), glm::vec3(0.0f, y, 0.0f), glm::vec3(0.0f, 0.0f, z) };
+      // Keep the winding counter-clockwise seen from outside.
+      if (x * y * z < 0.0f)
+        std::swap(corners[1], corners[2]);
+      addFace(corners, 3, glm::normalize(glm::vec3(x, y, z)));
+    }
+    unsigned int octahedronIndexCount = (unsigned int)indices.size() - cubeIndexCount;
+
+    m_IndexBuffer = std::make_unique<IndexBuffer>(indices.data(), (unsigned int)indices.size());
+    m_VertexBuffer = std::make_unique<VertexBuffer>(vertices.data(), (unsigned int)(vertices.size() * sizeof(float)));
+    VertexBufferLayout layout;
+    layout.Push<float>(3);
+    layout.Push<float>(3);
+    m_VertexArray = std::make_unique<VertexArray>();
+    m_VertexArray->AddBuffer(*m_VertexBuffer, layout);
+
+    m_Shader = std::make_unique<Shader>("src/resources/Instanced.vert", "src/resources/Instanced.frag");
+
+    std::vector<GpuCulling::MeshRange> meshes = {
+      { cubeIndexCount, 0, 0 },
+      { octahedronIndexCount, cubeIndexCount, (int)baseVertex }
+    };
+    m_Culling = std::make_unique<GpuCulling>(meshes);
+    m_GpuCulling = m_Culling->IsGpuCullingSupported();
+    GenerateInstances();
+
+    OpenGLCall(glDisable(GL_BLEND));
+  }
+
+  GpuCullingScene::~GpuCullingScene()
+  {
+    m_Renderer.SetDepthMode(DepthMode::Disabled);
+    OpenGLCall(glEnable(GL_BLEND));
+  }
+
+  void GpuCullingScene::GenerateInstances()
+  {
+    std::mt19937 random(42);
+    std::uniform_real_distribution<float> position(-200.0f, 200.0f), size(0.5f, 2.0f), angle(0.0f, 6.2831853f);
+    std::vector<CullingInstance> instances(m_InstanceCount);
+    for (int i = 0; i < m_InstanceCount; i++)
+    {
+      CullingInstance& instance = instances[i];
+      glm::vec3 translation(position(random), position(random) * 0.25f, position(random));
+      float scale = size(random);
+      instance.Transform = glm::translate(glm::mat4(1.0f), translation);
+      instance.Transform = glm::rotate(instance.Transform, angle(random), glm::normalize(glm::vec3(0.3f, 1.0f, 0.2f)));
+      instance.Transform = glm::scale(instance.Transform, glm::vec3(scale));
+      // Both meshes fit in a sphere of radius 0.87 at unit scale.
+      instance.BoundingSphere = glm::vec4(translation, 0.87f * scale);
+      instance.Mesh = i & 1;
+    }
+    m_Culling->SetInstances(instances);
+  }
+
+  void GpuCullingScene::OnUpdate(float deltatime)
+  {
+    if (m_Rotate)
+      m_CameraAngle += deltatime * 10.0f;
+  }
+
+  void GpuCullingScene::OnRender()
+  {
+    m_Renderer.SetDepthMode(DepthMode::ReadWrite);
+    OpenGLCall(glClearColor(0.05f, 0.05f, 0.08f, 1.0f));
+    m_Renderer.Clear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    glm::mat4 projection = glm::perspective(glm::radians(60.0f), WINDOW_WIDTH / WINDOW_HEIGHT, 0.1f, 250.0f);
+    glm::mat4 view = glm::rotate(glm::mat4(1.0f), glm::radians(m_CameraAngle), glm::vec3(0.0f, 1.0f, 0.0f));
+    glm::mat4 viewProjection = projection * view;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    m_Culling->SetGpuCulling(m_GpuCulling);
+    m_Culling->Cull(viewProjection);
+
+    m_Shader->Bind();
+    m_Shader->SetUniformMat4f("u_ViewProjection", viewProjection);
+    m_Shader->SetUniform4f("u_Color", 0.8f, 0.6f, 0.3f, 1.0f);
+    m_Culling->Draw(*m_VertexArray, *m_IndexBuffer, *m_Shader);
+    m_CullMilliseconds = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+  }
+
+  void GpuCullingScene::OnImGuiRender()
+  {
+    if (ImGui::SliderInt("Instances", &m_InstanceCount, 1000, 200000))
+      GenerateInstances();
+
+    if (m_Culling->IsGpuCullingSupported())
+      ImGui::Checkbox("Cull on the GPU", &m_GpuCulling);
+    else
+      ImGui::Text("Compute shaders unavailable, culling on the CPU");
+    ImGui::Checkbox("Rotate camera", &m_Rotate);
+
+    const GpuCulling::Stats& stats = m_Culling->GetStats();
+    ImGui::Text("Visible: %u of %u", stats.Visible, stats.Instances);
+    ImGui::Text("CPU time to cull and submit: %.3f ms", m_CullMilliseconds);
+  }
+}
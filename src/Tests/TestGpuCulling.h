@@ -0,0 +1,40 @@
+#pragma once
+
+#include <memory>
+
+#include "Test.h"
+
+#include "GpuCulling.h"
+#include "VertexBuffer.h"
+#include "VertexBufferLayout.h"
+
+namespace test
+{
+  // 100k cubes and octahedra around a rotating camera, frustum culled either by a compute shader
+  // writing indirect draws or on the CPU.
+  class GpuCullingScene : public Test
+  {
+  private:
+    std::unique_ptr<VertexArray> m_VertexArray;
+    std::unique_ptr<IndexBuffer> m_IndexBuffer;
+    std::unique_ptr<VertexBuffer> m_VertexBuffer;
+    std::unique_ptr<Shader> m_Shader;
+    std::unique_ptr<GpuCulling> m_Culling;
+    Renderer m_Renderer;
+    int m_InstanceCount;
+    bool m_GpuCulling;
+    bool m_Rotate;
+    float m_CameraAngle;
+    float m_CullMilliseconds;
+
+  public:
+    GpuCullingScene();
+    ~GpuCullingScene();
+
+    void OnUpdate(float deltatime);
+    void OnRender();
+    void OnImGuiRender();
+  private:
+    void GenerateInstances();
+  };
+}
@@ -0,0 +1,96 @@
+#include <algorithm>
+#include <cmath>
+
+#include <imgui/imgui.h>
+
+#include "TestGpuHeap.h"
+
+namespace test
+{
+  GpuHeapChurn::GpuHeapChurn()
+    : m_Heap(std::make_unique<GpuHeap>(4 * 1024 * 1024)), m_Random(99), m_TargetAllocations(2000), m_ChurnPerFrame(50),
+      m_Defragment(true), m_DefragmentKilobytes(256), m_Paused(false), m_VerifyFailures(-1)
+  {
+  }
+
+  GpuHeapChurn::~GpuHeapChurn()
+  {
+  }
+
+  void GpuHeapChurn::OnUpdate(float deltatime)
+  {
+    if (!m_Paused)
+    {
+      // Sizes spread log-uniformly from 256 bytes to 128 KB, like vertex and index data of small meshes.
+      std::uniform_real_distribution<float> logSize(8.0f, 17.0f);
+      for (int i = 0; i < m_ChurnPerFrame && !m_Live.empty(); i++)
+      {
+        size_t index = std::uniform_int_distribution<size_t>(0, m_Live.size() - 1)(m_Random);
+        m_Heap->Free(m_Live[index]);
+        m_Live[index] = m_Live.back();
+        m_Live.pop_back();
+      }
+
+      while ((int)m_Live.size() < m_TargetAllocations)
+      {
+        size_t size = (size_t)std::pow(2.0f, logSize(m_Random));
+        GpuHeap::Handle handle = m_Heap->Allocate(size);
+        if (handle == GpuHeap::INVALID_HANDLE)
+          break;
+
+        // Tag the start of each block with its handle so Verify can check moves kept the data.
+        m_Heap->Upload(handle, &handle, sizeof(handle));
+        m_Live.push_back(handle);
+      }
+    }
+
+    if (m_Defragment)
+      m_Heap->Defragment((size_t)m_DefragmentKilobytes * 1024);
+  }
+
+  void GpuHeapChurn::Verify()
+  {
+    m_VerifyFailures = 0;
+    for (GpuHeap::Handle handle : m_Live)
+    {
+      GpuHeap::Handle stored = GpuHeap::INVALID_HANDLE;
+      m_Heap->GetBuffer(handle)->GetSubData(m_Heap->GetOffset(handle), sizeof(stored), &stored);
+      if (stored != handle)
+        m_VerifyFailures++;
+    }
+  }
+
+  void GpuHeapChurn::OnImGuiRender()
+  {
+    ImGui::SliderInt("Live allocations", &m_TargetAllocations, 0, 10000);
+    ImGui::SliderInt("Frees per frame", &m_ChurnPerFrame, 0, 500);
+    ImGui::Checkbox("Pause churn", &m_Paused);
+    ImGui::Checkbox("Defragment", &m_Defragment);
+    ImGui::SliderInt("Budget (KB per frame)", &m_DefragmentKilobytes, 16, 4096);
+    if (ImGui::Button("Verify contents"))
+      Verify();
+    if (m_VerifyFailures >= 0)
+    {
+      ImGui::SameLine();
+      ImGui::Text("%d of %d allocations wrong", m_VerifyFailures, (int)m_Live.size());
+    }
+
+    m_Heap->OnImGuiRender();
+
+    // One bar per page, allocated blocks in orange.
+    ImDrawList* drawList = ImGui::GetWindowDrawList();
+    float width = ImGui::GetContentRegionAvailWidth();
+    for (unsigned int page = 0; page < m_Heap->GetPageCount(); page++)
+    {
+      ImVec2 origin = ImGui::GetCursorScreenPos();
+      drawList->AddRectFilled(origin, ImVec2(origin.x + width, origin.y + 12.0f), IM_COL32(40, 40, 40, 255));
+      for (const std::pair<size_t, size_t>& block : m_Heap->GetAllocatedBlocks(page))
+      {
+        float start = origin.x + width * block.first / m_Heap->GetPageSize();
+        float end = origin.x + width * (block.first + block.second) / m_Heap->GetPageSize();
+        drawList->AddRectFilled(ImVec2(start, origin.y), ImVec2(std::max(end, start + 1.0f), origin.y + 12.0f), IM_COL32(230, 140, 40, 255));
+      }
+      ImGui::Dummy(ImVec2(width, 14.0f));
+    }
+  }
+}
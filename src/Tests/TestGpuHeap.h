@@ -0,0 +1,37 @@
+#pragma once
+
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "Test.h"
+
+#include "GpuHeap.h"
+
+namespace test
+{
+  // Churns a GpuHeap with allocations the size of small meshes, drawing each page's blocks so
+  // fragmentation and the effect of incremental defragmentation are visible.
+  class GpuHeapChurn : public Test
+  {
+  private:
+    std::unique_ptr<GpuHeap> m_Heap;
+    std::vector<GpuHeap::Handle> m_Live;
+    std::mt19937 m_Random;
+    int m_TargetAllocations;
+    int m_ChurnPerFrame;
+    bool m_Defragment;
+    int m_DefragmentKilobytes;
+    bool m_Paused;
+    int m_VerifyFailures;
+
+  public:
+    GpuHeapChurn();
+    ~GpuHeapChurn();
+
+    void OnUpdate(float deltatime);
+    void OnImGuiRender();
+  private:
+    void Verify();
+  };
+}
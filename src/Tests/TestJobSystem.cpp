@@ -0,0 +1,148 @@
+#include <imgui/imgui.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <thread>
+
+#include "TestJobSystem.h"
+
+#include "JobSystem.h"
+
+namespace test
+{
+  namespace
+  {
+    typedef std::chrono::high_resolution_clock Clock;
+
+    double GetMilliseconds(Clock::time_point start)
+    {
+      return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    // Enough arithmetic per item that the work, not the scheduling, dominates.
+    void Simulate(float* values, size_t begin, size_t end)
+    {
+      for (size_t i = begin; i < end; i++)
+      {
+        float value = values[i];
+        for (int step = 0; step < 16; step++)
+          value = std::sqrt(value * value + 1.0f) * 0.5f;
+        values[i] = value;
+      }
+    }
+  }
+
+  JobSystemBenchmark::JobSystemBenchmark()
+    : m_JobCount(100000), m_ItemCount(1 << 22)
+  {
+  }
+
+  JobSystemBenchmark::~JobSystemBenchmark()
+  {
+  }
+
+  void JobSystemBenchmark::Run()
+  {
+    m_Results.clear();
+    JobSystem& jobs = JobSystem::Get();
+
+    {
+      JobCounter counter;
+      auto start = Clock::now();
+      for (int i = 0; i < m_JobCount; i++)
+        jobs.Schedule([]() {}, &counter);
+      jobs.Wait(counter);
+      double milliseconds = GetMilliseconds(start);
+      m_Results.push_back({ "Empty jobs", milliseconds, milliseconds * 1e6 / m_JobCount, 0.0 });
+    }
+
+    {
+      // Each job spawns its own children, so the work starts out on the workers' deques.
+      std::atomic<int> done(0);
+      JobCounter counter;
+      int fanOut = 100;
+      int perJob = m_JobCount / fanOut;
+      auto start = Clock::now();
+      for (int i = 0; i < fanOut; i++)
+      {
+        jobs.Schedule([&jobs, &done, &counter, perJob]()
+        {
+          for (int child = 0; child < perJob; child++)
+            jobs.Schedule([&done]() { done++; }, &counter);
+        }, &counter);
+      }
+      jobs.Wait(counter);
+      double milliseconds = GetMilliseconds(start);
+      m_Results.push_back({ "Nested empty jobs", milliseconds, milliseconds * 1e6 / (fanOut * (perJob + 1)), 0.0 });
+    }
+
+    {
+      // Every job waits for the one before, so this measures the hand-over latency.
+      const int links = 1000;
+      std::unique_ptr<JobCounter[]> counters(new JobCounter[links]);
+      auto start = Clock::now();
+      for (int i = 0; i < links; i++)
+        jobs.Schedule([]() {}, &counters[i], i > 0 ? &counters[i - 1] : nullptr);
+      jobs.Wait(counters[links - 1]);
+      double milliseconds = GetMilliseconds(start);
+      m_Results.push_back({ "Dependency chain", milliseconds, milliseconds * 1e6 / links, 0.0 });
+      for (int i = 0; i < links; i++)
+        jobs.Wait(counters[i]);
+    }
+
+    std::vector<float> values(m_ItemCount, 1.0f);
+    auto start = Clock::now();
+    Simulate(values.data(), 0, values.size());
+    double serial = GetMilliseconds(start);
+    m_Results.push_back({ "Main thread only", serial, serial * 1e6 / m_ItemCount, 1.0 });
+
+    // Restarts the system with each worker count, then goes back to the default.
+    unsigned int threads = std::thread::hardware_concurrency();
+    unsigned int maxWorkers = threads > 1 ? threads - 1 : 1;
+    for (unsigned int workers = 1; ; workers = std::min(workers * 2, maxWorkers))
+    {
+      jobs.Start(workers);
+      start = Clock::now();
+      jobs.ParallelFor(values.size(), 1024, [&values](size_t begin, size_t end) { Simulate(values.data(), begin, end); });
+      double milliseconds = GetMilliseconds(start);
+      m_Results.push_back({ "ParallelFor, " + std::to_string(workers) + " workers", milliseconds, milliseconds * 1e6 / m_ItemCount, serial / milliseconds });
+      if (workers == maxWorkers)
+        break;
+    }
+    jobs.Start();
+
+    // Tiny items, where a small grain pays for the splitting.
+    const size_t grains[] = { 1, 64, 4096 };
+    for (size_t grain : grains)
+    {
+      std::atomic<size_t> sum(0);
+      start = Clock::now();
+      jobs.ParallelFor(values.size(), grain, [&sum](size_t begin, size_t end) { sum += end - begin; });
+      double milliseconds = GetMilliseconds(start);
+      m_Results.push_back({ "ParallelFor grain " + std::to_string(grain) + ", empty items", milliseconds, milliseconds * 1e6 / m_ItemCount, 0.0 });
+    }
+  }
+
+  void JobSystemBenchmark::OnImGuiRender()
+  {
+    ImGui::SliderInt("Jobs", &m_JobCount, 1000, 1000000);
+    ImGui::SliderInt("ParallelFor items", &m_ItemCount, 1 << 16, 1 << 24);
+    if (ImGui::Button("Run"))
+      Run();
+
+    ImGui::Text("Workers: %u", JobSystem::Get().GetWorkerCount());
+    ImGui::Separator();
+    for (const Result& result : m_Results)
+    {
+      ImGui::Text("%-36s %9.3f ms  %8.1f ns/item", result.Name.c_str(), result.Milliseconds, result.NanosecondsPerItem);
+      if (result.Speedup > 0.0)
+      {
+        ImGui::SameLine();
+        ImGui::Text("  %.2fx", result.Speedup);
+      }
+    }
+  }
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Test.h"
+
+namespace test
+{
+  // Microbenchmarks for the JobSystem: the cost of scheduling and running empty jobs, the latency
+  // of a chain of dependent jobs, how ParallelFor scales with the number of workers and what the
+  // grain size costs on small work items.
+  class JobSystemBenchmark : public Test
+  {
+  private:
+    struct Result
+    {
+      std::string Name;
+      double Milliseconds;
+      double NanosecondsPerItem;
+      double Speedup; // Over running on the main thread alone, zero where it doesn't apply.
+    };
+
+    int m_JobCount;
+    int m_ItemCount;
+    std::vector<Result> m_Results;
+
+  public:
+    JobSystemBenchmark();
+    ~JobSystemBenchmark();
+
+    void OnImGuiRender();
+  private:
+    void Run();
+  };
+}
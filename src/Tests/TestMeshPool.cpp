@@ -0,0 +1,139 @@
+#include <chrono>
+#include <cmath>
+#include <random>
+
+#include <imgui/imgui.h>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "TestMeshPool.h"
+
+namespace test
+{
+  MeshPoolScene::MeshPoolScene()
+    : m_MeshCount(4000), m_Mode(1), m_SubmitMilliseconds(0.0f), m_DrawCalls(0)
+  {
+    m_Shader = ResourceRegistry::Get().LoadShader("src/resources/StaticMesh.vert", "src/resources/Instanced.frag");
+    GenerateMeshes();
+    OpenGLCall(glDisable(GL_BLEND));
+  }
+
+  MeshPoolScene::~MeshPoolScene()
+  {
+    ResourceRegistry::Get().Release(m_Shader);
+    m_Renderer.SetDepthMode(DepthMode::Disabled);
+    OpenGLCall(glEnable(GL_BLEND));
+  }
+
+  void MeshPoolScene::GenerateMeshes()
+  {
+    VertexBufferLayout layout;
+    layout.Push<float>(3);
+    layout.Push<float>(3);
+    m_Pool = std::make_unique<MeshPool>(layout);
+    m_SeparateMeshes.clear();
+    m_DrawList.clear();
+    m_Commands.clear();
+
+    // Prisms with 3 to 8 sides, baked into world space so every mesh is different.
+    std::mt19937 random(7);
+    std::uniform_int_distribution<int> sides(3, 8);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::vector<float> vertices;
+    std::vector<unsigned int> indices;
+    int columns = (int)std::ceil(std::sqrt((float)m_MeshCount));
+
+    for (int mesh = 0; mesh < m_MeshCount; mesh++)
+    {
+      vertices.clear();
+      indices.clear();
+      int count = sides(random);
+      float radius = 0.2f + unit(random) * 0.25f, height = 0.2f + unit(random) * 1.2f;
+      glm::vec3 base((mesh % columns) - columns * 0.5f, 0.0f, (float)(mesh / columns) - columns * 0.5f);
+
+      auto addVertex = [&](const glm::vec3& position, const glm::vec3& normal)
+      {
+        vertices.insert(vertices.end(), { position.x, position.y, position.z, normal.x, normal.y, normal.z });
+        return (unsigned int)(vertices.size() / 6 - 1);
+      };
+
+      for (int side = 0; side < count; side++)
+      {
+        float angle0 = side * 6.2831853f / count, angle1 = (side + 1) * 6.2831853f / count;
+        glm::vec3 p0 = base + glm::vec3(std::cos(angle0), 0.0f, std::sin(angle0)) * radius;
+        glm::vec3 p1 = base + glm::vec3(std::cos(angle1), 0.0f, std::sin(angle1)) * radius;
+        glm::vec3 up(0.0f, height, 0.0f);
+        glm::vec3 normal = glm::normalize(glm::vec3(std::cos((angle0 + angle1) * 0.5f), 0.0f, std::sin((angle0 + angle1) * 0.5f)));
+        unsigned int a = addVertex(p0, normal), b = addVertex(p1, normal), c = addVertex(p1 + up, normal), d = addVertex(p0 + up, normal);
+        indices.insert(indices.end(), { a, c, b, a, d, c });
+      }
+
+      // Top cap as a fan.
+      unsigned int center = addVertex(base + glm::vec3(0.0f, height, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+      for (int side = 0; side < count; side++)
+      {
+        float angle = side * 6.2831853f / count;
+        addVertex(base + glm::vec3(std::cos(angle) * radius, height, std::sin(angle) * radius), glm::vec3(0.0f, 1.0f, 0.0f));
+      }
+      for (int side = 0; side < count; side++)
+        indices.insert(indices.end(), { center, center + 1 + (side + 1) % count, center + 1 + side });
+
+      unsigned int vertexCount = (unsigned int)(vertices.size() / 6);
+      unsigned int id = m_Pool->Add(vertices.data(), vertexCount, indices.data(), (unsigned int)indices.size());
+      m_DrawList.push_back(id);
+      m_Commands.push_back(m_Pool->GetCommand(id));
+
+      m_SeparateMeshes.emplace_back(vertices, indices, layout);
+    }
+  }
+
+  void MeshPoolScene::OnRender()
+  {
+    m_Renderer.SetDepthMode(DepthMode::ReadWrite);
+    OpenGLCall(glClearColor(0.05f, 0.05f, 0.08f, 1.0f));
+    m_Renderer.Clear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    float distance = std::sqrt((float)m_MeshCount) * 0.8f;
+    glm::mat4 projection = glm::perspective(glm::radians(60.0f), WINDOW_WIDTH / WINDOW_HEIGHT, 0.1f, distance * 4.0f);
+    glm::mat4 view = glm::lookAt(glm::vec3(0.0f, distance, distance), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    Shader& shader = *ResourceRegistry::Get().Resolve(m_Shader);
+    shader.Bind();
+    shader.SetUniformMat4f("u_ViewProjection", projection * view);
+    shader.SetUniform4f("u_Color", 0.4f, 0.7f, 0.5f, 1.0f);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    if (m_Mode == 0)
+    {
+      for (const SeparateMesh& mesh : m_SeparateMeshes)
+        m_Renderer.Draw(mesh.Vertices, mesh.Indices, shader);
+      m_DrawCalls = (unsigned int)m_SeparateMeshes.size();
+    }
+    else if (m_Mode == 1)
+    {
+      m_Pool->Draw(m_DrawList, shader);
+      m_DrawCalls = 1;
+    }
+    else
+    {
+      m_Pool->DrawIndirect(m_Commands, shader);
+      m_DrawCalls = 1;
+    }
+    m_SubmitMilliseconds = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+  }
+
+  void MeshPoolScene::OnImGuiRender()
+  {
+    if (ImGui::SliderInt("Meshes", &m_MeshCount, 100, 20000))
+      GenerateMeshes();
+
+    ImGui::RadioButton("Vertex array per mesh", &m_Mode, 0);
+    ImGui::RadioButton("MeshPool multi-draw", &m_Mode, 1);
+    if (MeshPool::IsIndirectSupported())
+      ImGui::RadioButton("MeshPool indirect", &m_Mode, 2);
+    else if (m_Mode == 2)
+      m_Mode = 1;
+
+    ImGui::Text("Draw calls: %u", m_DrawCalls);
+    ImGui::Text("CPU submit time: %.3f ms", m_SubmitMilliseconds);
+    ImGui::Text("Pool: %u meshes, %.2f MB", m_Pool->GetMeshCount(), m_Pool->GetMemorySize() / (1024.0 * 1024.0));
+  }
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "Test.h"
+
+#include "MeshPool.h"
+#include "ResourceRegistry.h"
+
+namespace test
+{
+  // Thousands of distinct small meshes drawn either with a vertex array and draw call each, or
+  // from a MeshPool with one multi-draw or one indirect draw.
+  class MeshPoolScene : public Test
+  {
+  private:
+    // Held by value: the GL wrappers are move-only, so the vector can reallocate without
+    // double deleting or leaking anything.
+    struct SeparateMesh
+    {
+      VertexBuffer VertexData;
+      VertexArray Vertices;
+      IndexBuffer Indices;
+
+      SeparateMesh(const std::vector<float>& vertices, const std::vector<unsigned int>& indices, const VertexBufferLayout& layout)
+        : VertexData(vertices.data(), (unsigned int)(vertices.size() * sizeof(float))),
+        Indices(indices.data(), (unsigned int)indices.size())
+      {
+        Vertices.AddBuffer(VertexData, layout);
+      }
+    };
+
+    std::unique_ptr<MeshPool> m_Pool;
+    std::vector<SeparateMesh> m_SeparateMeshes;
+    std::vector<unsigned int> m_DrawList;
+    std::vector<DrawElementsIndirectCommand> m_Commands;
+    ShaderHandle m_Shader;
+    Renderer m_Renderer;
+    int m_MeshCount;
+    int m_Mode;
+    float m_SubmitMilliseconds;
+    unsigned int m_DrawCalls;
+
+  public:
+    MeshPoolScene();
+    ~MeshPoolScene();
+
+    void OnRender();
+    void OnImGuiRender();
+  private:
+    void GenerateMeshes();
+  };
+}
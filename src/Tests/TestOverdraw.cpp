@@ -0,0 +1,104 @@
+#include <random>
+
+#include <imgui/imgui.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "TestOverdraw.h"
+
+namespace test
+{
+  Overdraw::Overdraw()
+    : m_Count(2000), m_CameraAngle(0.0f), m_DepthTest(true), m_SortMode((int)Renderer::SortMode::FrontToBack),
+      m_DepthPrePass(false), m_ShowOverdraw(true), m_FrustumCulling(true)
+  {
+    float positions[] = {
+      -0.5f, -0.5f, 0.0f, 0.0f, 0.0f,
+       0.5f, -0.5f, 0.0f, 1.0f, 0.0f,
+       0.5f,  0.5f, 0.0f, 1.0f, 1.0f,
+      -0.5f,  0.5f, 0.0f, 0.0f, 1.0f
+    };
+    unsigned int indices[] = { 0, 1, 2, 2, 3, 0 };
+    m_IndexBuffer = std::make_unique<IndexBuffer>(indices, 6);
+
+    m_VertexBuffer = std::make_unique<VertexBuffer>(positions, 4 * 5 * sizeof(float));
+    VertexBufferLayout layout;
+    layout.Push<float>(3);
+    layout.Push<float>(2);
+    m_VertexArray = std::make_unique<VertexArray>();
+    m_VertexArray->AddBuffer(*m_VertexBuffer, layout);
+
+    m_Shader = ResourceRegistry::Get().LoadShader("src/resources/Basic.vert", "src/resources/Basic.frag");
+    Shader& shader = *ResourceRegistry::Get().Resolve(m_Shader);
+    shader.Bind();
+    shader.SetUniform1i("u_Texture", 0);
+    m_Texture = TextureCache::Get().Load("src/resources/crazy-love.png");
+
+    // Everything here is opaque.
+    OpenGLCall(glDisable(GL_BLEND));
+    GenerateScene();
+  }
+
+  Overdraw::~Overdraw()
+  {
+    ResourceRegistry::Get().Release(m_Shader);
+    m_Renderer.SetDepthMode(DepthMode::Disabled);
+    OpenGLCall(glEnable(GL_BLEND));
+  }
+
+  void Overdraw::GenerateScene()
+  {
+    // Fixed seed so every configuration is measured against the same scene.
+    std::mt19937 random(1234);
+    std::uniform_real_distribution<float> position(-6.0f, 6.0f), depth(-30.0f, -2.0f), size(0.5f, 3.0f);
+
+    m_Transforms.clear();
+    for (int i = 0; i < m_Count; i++)
+    {
+      glm::vec3 translation(position(random), position(random) * 0.6f, depth(random));
+      float scale = size(random);
+      m_Transforms.push_back(glm::scale(glm::translate(glm::mat4(1.0f), translation), glm::vec3(scale, scale, 1.0f)));
+    }
+  }
+
+  void Overdraw::OnRender()
+  {
+    m_Renderer.SetDepthMode(m_DepthTest ? DepthMode::ReadWrite : DepthMode::Disabled);
+    m_Renderer.SetSortMode((Renderer::SortMode)m_SortMode);
+    m_Renderer.SetDepthPrePass(m_DepthPrePass);
+    m_Renderer.SetOverdrawVisualisation(m_ShowOverdraw, 0.05f);
+    m_Renderer.SetFrustumCulling(m_FrustumCulling);
+
+    OpenGLCall(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
+    m_Renderer.Clear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    glm::mat4 projection = glm::perspective(glm::radians(60.0f), WINDOW_WIDTH / WINDOW_HEIGHT, 0.1f, 100.0f);
+    glm::mat4 view = glm::rotate(glm::mat4(1.0f), glm::radians(m_CameraAngle), glm::vec3(0.0f, 1.0f, 0.0f));
+
+    Shader& shader = *ResourceRegistry::Get().Resolve(m_Shader);
+    m_Texture->Bind();
+    m_Renderer.BeginScene(projection * view);
+    // Encloses the unit quad, corner to corner.
+    BoundingSphere bounds{ glm::vec3(0.0f), 0.71f };
+    for (const glm::mat4& transform : m_Transforms)
+      m_Renderer.Submit(*m_VertexArray, *m_IndexBuffer, shader, transform, bounds);
+    m_Renderer.EndScene();
+  }
+
+  void Overdraw::OnImGuiRender()
+  {
+    if (ImGui::SliderInt("Quads", &m_Count, 100, 10000))
+      GenerateScene();
+    ImGui::SliderFloat("Camera angle", &m_CameraAngle, -45.0f, 45.0f);
+    ImGui::Checkbox("Depth test", &m_DepthTest);
+    ImGui::Combo("Draw order", &m_SortMode, "Submission\0Front to back\0Back to front\0");
+    ImGui::Checkbox("Depth pre-pass", &m_DepthPrePass);
+    ImGui::Checkbox("Visualise overdraw", &m_ShowOverdraw);
+    ImGui::Checkbox("Frustum culling", &m_FrustumCulling);
+
+    const Renderer::Stats& stats = m_Renderer.GetStats();
+    double pixels = (double)WINDOW_WIDTH * WINDOW_HEIGHT;
+    ImGui::Text("Draw calls: %u + %u depth pre-pass (%u culled)", stats.DrawCalls, stats.PrePassDrawCalls, stats.Culled);
+    ImGui::Text("Shaded fragments: %llu (%.2f per pixel)", stats.SamplesPassed, stats.SamplesPassed / pixels);
+  }
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <memory>
+
+#include "Test.h"
+
+#include "Renderer.h"
+#include "ResourceRegistry.h"
+#include "TextureCache.h"
+#include "VertexBuffer.h"
+#include "VertexBufferLayout.h"
+
+namespace test
+{
+  // Thousands of overlapping opaque quads in perspective, to compare depth testing, draw order and
+  // a depth pre-pass by how many fragments get shaded. Overdraw view shows the count per pixel.
+  class Overdraw : public Test
+  {
+  private:
+    std::unique_ptr<VertexArray> m_VertexArray;
+    std::unique_ptr<IndexBuffer> m_IndexBuffer;
+    std::unique_ptr<VertexBuffer> m_VertexBuffer;
+    ShaderHandle m_Shader;
+    std::shared_ptr<::Texture2D> m_Texture;
+    std::vector<glm::mat4> m_Transforms;
+    Renderer m_Renderer;
+    int m_Count;
+    float m_CameraAngle;
+    bool m_DepthTest;
+    int m_SortMode;
+    bool m_DepthPrePass;
+    bool m_ShowOverdraw;
+    bool m_FrustumCulling;
+
+  public:
+    Overdraw();
+    ~Overdraw();
+
+    void OnRender();
+    void OnImGuiRender();
+  private:
+    void GenerateScene();
+  };
+}
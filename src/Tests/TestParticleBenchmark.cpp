@@ -0,0 +1,163 @@
+#include <imgui/imgui.h>
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+
+#include "TestParticleBenchmark.h"
+
+namespace test
+{
+  static const float DELTA_TIME = 1.0f / 60.0f;
+  static const glm::vec3 GRAVITY(0.0f, -9.81f, 0.0f);
+  static const float DRAG = 0.1f;
+
+  // How particles usually start out: one struct each, updated and removed one at a time.
+  struct NaiveParticle
+  {
+    glm::vec3 Position;
+    glm::vec3 Velocity;
+    float Age;
+    float Lifetime;
+  };
+
+  static NaiveParticle ToNaive(const Particle& particle)
+  {
+    return { glm::vec3(particle.PositionAge), glm::vec3(particle.VelocityLifetime), particle.PositionAge.w, particle.VelocityLifetime.w };
+  }
+
+  static double GetMilliseconds(std::chrono::high_resolution_clock::time_point start, std::chrono::high_resolution_clock::time_point end)
+  {
+    return std::chrono::duration<double, std::milli>(end - start).count();
+  }
+
+  ParticleBenchmark::ParticleBenchmark() : m_Iterations(20)
+  {
+  }
+
+  ParticleBenchmark::~ParticleBenchmark()
+  {
+  }
+
+  void ParticleBenchmark::Run()
+  {
+    m_Results.clear();
+
+    const size_t counts[] = { 100000, 1000000 };
+    const SimdKernel kernels[] = { SimdKernel::Scalar, SimdKernel::Sse, SimdKernel::Avx2 };
+
+    for (size_t count : counts)
+    {
+      // Ages spread over the lifetimes, so a steady share dies every update.
+      std::mt19937 random(42);
+      std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+      std::uniform_real_distribution<float> lifetimes(0.5f, 2.0f);
+      std::vector<Particle> initial(count), spawns(count);
+      for (size_t i = 0; i < count; i++)
+      {
+        glm::vec3 velocity(unit(random) * 2.0f, 10.0f + unit(random) * 2.0f, unit(random) * 2.0f);
+        float lifetime = lifetimes(random);
+        spawns[i] = { glm::vec4(0.0f), glm::vec4(velocity, lifetime) };
+        initial[i] = { glm::vec4(glm::vec3(unit(random), unit(random), unit(random)) * 10.0f, lifetime * (unit(random) * 0.5f + 0.5f)),
+          glm::vec4(velocity, lifetime) };
+      }
+
+      m_Results.push_back(MeasureNaive(initial, spawns));
+      for (SimdKernel kernel : kernels)
+      {
+        if (IsSimdKernelSupported(kernel))
+          m_Results.push_back(MeasurePool(initial, spawns, kernel, false));
+      }
+      m_Results.push_back(MeasurePool(initial, spawns, GetBestSimdKernel(), true));
+    }
+  }
+
+  ParticleBenchmark::Result ParticleBenchmark::MeasureNaive(const std::vector<Particle>& initial, const std::vector<Particle>& spawns)
+  {
+    std::vector<NaiveParticle> particles;
+    particles.reserve(initial.size());
+    for (const Particle& particle : initial)
+      particles.push_back(ToNaive(particle));
+    std::vector<Particle> vertices(initial.size());
+
+    Result result = { initial.size(), "AoS", false, 0.0, 0.0, 0.0 };
+    size_t spawned = 0, died = 0;
+    float damping = std::max(1.0f - DRAG * DELTA_TIME, 0.0f);
+    for (int iteration = 0; iteration < m_Iterations; iteration++)
+    {
+      auto start = std::chrono::high_resolution_clock::now();
+      for (NaiveParticle& particle : particles)
+      {
+        particle.Velocity = (particle.Velocity + GRAVITY * DELTA_TIME) * damping;
+        particle.Position += particle.Velocity * DELTA_TIME;
+        particle.Age += DELTA_TIME;
+      }
+      size_t before = particles.size();
+      particles.erase(std::remove_if(particles.begin(), particles.end(),
+        [](const NaiveParticle& particle) { return !(particle.Age < particle.Lifetime); }), particles.end());
+      died += before - particles.size();
+      while (particles.size() < initial.size())
+        particles.push_back(ToNaive(spawns[spawned++ % spawns.size()]));
+
+      auto updated = std::chrono::high_resolution_clock::now();
+      for (size_t i = 0; i < particles.size(); i++)
+        vertices[i] = { glm::vec4(particles[i].Position, particles[i].Age), glm::vec4(particles[i].Velocity, particles[i].Lifetime) };
+      auto end = std::chrono::high_resolution_clock::now();
+
+      result.UpdateMilliseconds += GetMilliseconds(start, updated);
+      result.WriteMilliseconds += GetMilliseconds(updated, end);
+    }
+
+    result.UpdateMilliseconds /= m_Iterations;
+    result.WriteMilliseconds /= m_Iterations;
+    result.DiedPerUpdate = (double)died / m_Iterations;
+    return result;
+  }
+
+  ParticleBenchmark::Result ParticleBenchmark::MeasurePool(const std::vector<Particle>& initial, const std::vector<Particle>& spawns,
+    SimdKernel kernel, bool parallel)
+  {
+    ParticlePool particles(initial.size());
+    for (const Particle& particle : initial)
+      particles.Add(particle);
+    std::vector<Particle> vertices(initial.size());
+
+    Result result = { initial.size(), GetSimdKernelName(kernel), parallel, 0.0, 0.0, 0.0 };
+    size_t spawned = 0, died = 0;
+    for (int iteration = 0; iteration < m_Iterations; iteration++)
+    {
+      auto start = std::chrono::high_resolution_clock::now();
+      particles.Update(DELTA_TIME, GRAVITY, DRAG, kernel, parallel);
+      died += particles.GetStats().DiedLastUpdate;
+      while (particles.GetCount() < initial.size())
+        particles.Add(spawns[spawned++ % spawns.size()]);
+
+      auto updated = std::chrono::high_resolution_clock::now();
+      particles.Write(vertices.data(), parallel);
+      auto end = std::chrono::high_resolution_clock::now();
+
+      result.UpdateMilliseconds += GetMilliseconds(start, updated);
+      result.WriteMilliseconds += GetMilliseconds(updated, end);
+    }
+
+    result.UpdateMilliseconds /= m_Iterations;
+    result.WriteMilliseconds /= m_Iterations;
+    result.DiedPerUpdate = (double)died / m_Iterations;
+    return result;
+  }
+
+  void ParticleBenchmark::OnImGuiRender()
+  {
+    ImGui::SliderInt("Iterations", &m_Iterations, 1, 100);
+    if (ImGui::Button("Run"))
+      Run();
+
+    ImGui::Text("Best kernel: %s", GetSimdKernelName(GetBestSimdKernel()));
+    ImGui::Separator();
+    for (const Result& result : m_Results)
+    {
+      ImGui::Text("%7zu particles  %-6s %-5s  update %8.3f ms  write %8.3f ms  %8.1f died/update", result.Count,
+        result.Name, result.Parallel ? "+jobs" : "", result.UpdateMilliseconds, result.WriteMilliseconds, result.DiedPerUpdate);
+    }
+  }
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <vector>
+
+#include "Test.h"
+
+#include "ParticlePool.h"
+
+namespace test
+{
+  // Simulates 100k and 1M particles at a steady population, topping it up as they die: a naive
+  // array of structs compacted with erase and remove_if, against ParticlePool with every kernel and
+  // with the best one split into jobs. Times the update and the interleaved write a vertex buffer
+  // upload needs.
+  class ParticleBenchmark : public Test
+  {
+  private:
+    struct Result
+    {
+      size_t Count;
+      const char* Name;
+      bool Parallel;
+      double UpdateMilliseconds;
+      double WriteMilliseconds;
+      double DiedPerUpdate; // The same for every implementation, or one of them is wrong.
+    };
+
+    int m_Iterations;
+    std::vector<Result> m_Results;
+
+  public:
+    ParticleBenchmark();
+    ~ParticleBenchmark();
+
+    void OnImGuiRender();
+  private:
+    void Run();
+    Result MeasureNaive(const std::vector<Particle>& initial, const std::vector<Particle>& spawns);
+    Result MeasurePool(const std::vector<Particle>& initial, const std::vector<Particle>& spawns, SimdKernel kernel, bool parallel);
+  };
+}
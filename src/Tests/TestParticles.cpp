@@ -0,0 +1,91 @@
+#include <algorithm>
+
+#include <imgui/imgui.h>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "TestParticles.h"
+
+namespace test
+{
+  Particles::Particles()
+    : m_Capacity(1000000), m_UseGpu(true), m_Paused(false), m_CameraYaw(30.0f), m_CameraPitch(20.0f), m_CameraDistance(30.0f)
+  {
+    m_System = std::make_unique<ParticleSystem>((unsigned int)m_Capacity);
+  }
+
+  Particles::~Particles()
+  {
+    m_Renderer.SetDepthMode(DepthMode::Disabled);
+  }
+
+  void Particles::OnUpdate(float deltatime)
+  {
+    // Long hitches would launch a frame's worth of particles in one clump.
+    if (!m_Paused)
+      m_System->Update(std::min(deltatime, 0.1f));
+  }
+
+  void Particles::OnRender()
+  {
+    m_Renderer.SetDepthMode(DepthMode::ReadWrite);
+    OpenGLCall(glClearColor(0.02f, 0.02f, 0.04f, 1.0f));
+    m_Renderer.Clear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    glm::mat4 projection = glm::perspective(glm::radians(60.0f), WINDOW_WIDTH / WINDOW_HEIGHT, 0.1f, 500.0f);
+    glm::mat4 view = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, -5.0f, -m_CameraDistance));
+    view = glm::rotate(view, glm::radians(m_CameraPitch), glm::vec3(1.0f, 0.0f, 0.0f));
+    view = glm::rotate(view, glm::radians(m_CameraYaw), glm::vec3(0.0f, 1.0f, 0.0f));
+    m_System->Render(view, projection);
+  }
+
+  void Particles::OnImGuiRender()
+  {
+    // Reallocating the buffers on every slider step would stall, so wait for the slider's release.
+    ImGui::SliderInt("Capacity", &m_Capacity, 1000, 1000000);
+    if (!ImGui::IsItemActive() && (unsigned int)m_Capacity != m_System->GetCapacity())
+    {
+      ParticleEmitterSettings settings = m_System->GetSettings();
+      m_System = std::make_unique<ParticleSystem>((unsigned int)m_Capacity, m_System->GetBackend());
+      m_System->GetSettings() = settings;
+    }
+    if (ImGui::Checkbox("Simulate on the GPU (transform feedback)", &m_UseGpu))
+      m_System->SetBackend(m_UseGpu ? ParticleSystem::Backend::Gpu : ParticleSystem::Backend::Cpu);
+    ImGui::Checkbox("Pause", &m_Paused);
+    ImGui::SameLine();
+    if (ImGui::Button("Reset"))
+      m_System->Reset();
+
+    if (ImGui::CollapsingHeader("Emitter", ImGuiTreeNodeFlags_DefaultOpen))
+    {
+      ParticleEmitterSettings& settings = m_System->GetSettings();
+      ImGui::SliderFloat("Rate", &settings.Rate, 0.0f, 1000000.0f, "%.0f/s", 3.0f);
+      ImGui::SliderFloat3("Position", &settings.Position.x, -10.0f, 10.0f);
+      ImGui::SliderFloat("Radius", &settings.Radius, 0.0f, 5.0f);
+      ImGui::SliderFloat3("Direction", &settings.Direction.x, -1.0f, 1.0f);
+      ImGui::SliderFloat("Spread", &settings.Spread, 0.0f, 2.0f);
+      ImGui::DragFloatRange2("Speed", &settings.SpeedMin, &settings.SpeedMax, 0.1f, 0.0f, 50.0f);
+      ImGui::DragFloatRange2("Lifetime", &settings.LifetimeMin, &settings.LifetimeMax, 0.05f, 0.0f, 20.0f);
+      ImGui::SliderFloat3("Gravity", &settings.Gravity.x, -20.0f, 20.0f);
+      ImGui::SliderFloat("Drag", &settings.Drag, 0.0f, 5.0f);
+      ImGui::ColorEdit4("Start colour", &settings.StartColor.r);
+      ImGui::ColorEdit4("End colour", &settings.EndColor.r);
+      ImGui::SliderFloat("Start size", &settings.StartSize, 0.0f, 0.5f);
+      ImGui::SliderFloat("End size", &settings.EndSize, 0.0f, 0.5f);
+    }
+
+    if (ImGui::CollapsingHeader("Camera"))
+    {
+      ImGui::SliderFloat("Yaw", &m_CameraYaw, -180.0f, 180.0f);
+      ImGui::SliderFloat("Pitch", &m_CameraPitch, -89.0f, 89.0f);
+      ImGui::SliderFloat("Distance", &m_CameraDistance, 1.0f, 200.0f);
+    }
+
+    const ParticleSystem::Stats& stats = m_System->GetStats();
+    ImGui::Text("Emitted last frame: %u of %u", stats.EmittedLastFrame, stats.Capacity);
+    if (m_System->GetBackend() == ParticleSystem::Backend::Cpu)
+      ImGui::Text("Alive: %u (%u died), CPU update and upload %.3f ms", stats.Alive, stats.Died, stats.CpuMilliseconds);
+    else
+      ImGui::Text("GPU update %.3f ms, CPU submit %.3f ms", stats.GpuMilliseconds, stats.CpuMilliseconds);
+    ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+  }
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <memory>
+
+#include "Test.h"
+
+#include "ParticleSystem.h"
+#include "Renderer.h"
+
+namespace test
+{
+  // A fountain of up to a million particles around an orbiting camera, simulated by transform
+  // feedback or the CPU fallback, with the emitter settings exposed.
+  class Particles : public Test
+  {
+  private:
+    std::unique_ptr<ParticleSystem> m_System;
+    Renderer m_Renderer;
+    int m_Capacity;
+    bool m_UseGpu;
+    bool m_Paused;
+    float m_CameraYaw, m_CameraPitch, m_CameraDistance;
+
+  public:
+    Particles();
+    ~Particles();
+
+    void OnUpdate(float deltatime);
+    void OnRender();
+    void OnImGuiRender();
+  };
+}
@@ -0,0 +1,64 @@
+#include <algorithm>
+#include <vector>
+
+#include <imgui/imgui.h>
+
+#include "TestPostProcess.h"
+
+#include "RenderTargetPool.h"
+
+namespace test
+{
+  PostProcess::PostProcess()
+  {
+    // Warm, slightly contrasty grade: lift reds, pull blues and push the midtones apart.
+    const int size = 16;
+    std::vector<unsigned char> texels(size * size * size * 4);
+    for (int b = 0; b < size; b++)
+    {
+      for (int g = 0; g < size; g++)
+      {
+        for (int r = 0; r < size; r++)
+        {
+          float color[3] = { r / (size - 1.0f), g / (size - 1.0f), b / (size - 1.0f) };
+          color[0] = color[0] * 1.08f + 0.02f;
+          color[2] = color[2] * 0.88f;
+          unsigned char* texel = &texels[((b * size + g) * size + r) * 4];
+          for (int channel = 0; channel < 3; channel++)
+          {
+            float c = std::min(std::max(color[channel], 0.0f), 1.0f);
+            c = c * c * (3.0f - 2.0f * c) * 0.35f + c * 0.65f;
+            texel[channel] = (unsigned char)(c * 255.0f + 0.5f);
+          }
+          texel[3] = 255;
+        }
+      }
+    }
+
+    std::unique_ptr<Texture3D> lut = std::make_unique<Texture3D>(size, size, size, GL_RGBA8);
+    lut->SetData(texels.data(), GL_RGBA, GL_UNSIGNED_BYTE);
+    m_Stack.SetLut(std::move(lut));
+  }
+
+  PostProcess::~PostProcess()
+  {
+  }
+
+  void PostProcess::OnRender()
+  {
+    RenderTargetPool& pool = RenderTargetPool::Get();
+    Framebuffer* scene = pool.Acquire({ (int)WINDOW_WIDTH, (int)WINDOW_HEIGHT, { GL_RGBA16F }, 0, 0 });
+    scene->Bind();
+    Texture2D::OnRender();
+    scene->Unbind();
+
+    m_Stack.Apply(*scene, nullptr);
+    pool.Release(scene);
+  }
+
+  void PostProcess::OnImGuiRender()
+  {
+    Texture2D::OnImGuiRender();
+    m_Stack.OnImGuiRender();
+  }
+}
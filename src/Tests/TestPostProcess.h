@@ -0,0 +1,23 @@
+#pragma once
+
+#include "TestTexture2D.h"
+
+#include "PostProcessStack.h"
+
+namespace test
+{
+  // Renders the 2D texture scene into an HDR target and runs it through the PostProcessStack,
+  // with a generated warm colour grading LUT.
+  class PostProcess : public Texture2D
+  {
+  private:
+    PostProcessStack m_Stack;
+
+  public:
+    PostProcess();
+    ~PostProcess();
+
+    void OnRender();
+    void OnImGuiRender();
+  };
+}
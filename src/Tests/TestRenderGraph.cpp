@@ -0,0 +1,101 @@
+#include <imgui/imgui.h>
+
+#include "TestRenderGraph.h"
+
+namespace test
+{
+  RenderGraphs::RenderGraphs() : m_Samples(4), m_Downsample(true), m_DebugPass(true)
+  {
+  }
+
+  RenderGraphs::~RenderGraphs()
+  {
+  }
+
+  void RenderGraphs::OnRender()
+  {
+    int width = (int)WINDOW_WIDTH, height = (int)WINDOW_HEIGHT;
+    m_Graph.reset(new RenderGraph());
+    RenderGraph& graph = *m_Graph;
+
+    RenderGraphResource backbuffer = graph.Import("Backbuffer", nullptr);
+    // Every resource the passes capture lives until Execute, not just until its pass is added.
+    RenderGraphResource scene, resolved, half, quarter, upsampled, output;
+
+    graph.AddPass("Scene",
+      [&](RenderGraphBuilder& builder) { scene = builder.Create("Scene", { width, height, GL_RGBA8, GL_DEPTH24_STENCIL8, m_Samples }); },
+      [&](RenderGraphContext&) { Texture2D::OnRender(); });
+
+    graph.AddPass("Resolve",
+      [&](RenderGraphBuilder& builder)
+      {
+        builder.Read(scene, RenderGraphUsage::Attachment);
+        resolved = builder.Create("Resolved", { width, height, GL_RGBA8, 0, 0 });
+      },
+      [&](RenderGraphContext& context) { context.GetFramebuffer(scene)->BlitTo(context.GetFramebuffer(resolved)); });
+
+    output = resolved;
+    if (m_Downsample)
+    {
+      // Half and Upsampled share a description and never overlap, so they end up on one target.
+      graph.AddPass("Downsample Half",
+        [&](RenderGraphBuilder& builder)
+        {
+          builder.Read(resolved, RenderGraphUsage::Attachment);
+          half = builder.Create("Half", { width / 2, height / 2, GL_RGBA8, 0, 0 });
+        },
+        [&](RenderGraphContext& context) { context.GetFramebuffer(resolved)->BlitTo(context.GetFramebuffer(half), GL_LINEAR); });
+
+      graph.AddPass("Downsample Quarter",
+        [&](RenderGraphBuilder& builder)
+        {
+          builder.Read(half, RenderGraphUsage::Attachment);
+          quarter = builder.Create("Quarter", { width / 4, height / 4, GL_RGBA8, 0, 0 });
+        },
+        [&](RenderGraphContext& context) { context.GetFramebuffer(half)->BlitTo(context.GetFramebuffer(quarter), GL_LINEAR); });
+
+      graph.AddPass("Upsample Half",
+        [&](RenderGraphBuilder& builder)
+        {
+          builder.Read(quarter, RenderGraphUsage::Attachment);
+          upsampled = builder.Create("Upsampled", { width / 2, height / 2, GL_RGBA8, 0, 0 });
+        },
+        [&](RenderGraphContext& context) { context.GetFramebuffer(quarter)->BlitTo(context.GetFramebuffer(upsampled), GL_LINEAR); });
+
+      output = upsampled;
+    }
+
+    if (m_DebugPass)
+    {
+      // Nothing reads this target, so the pass is culled and its target never allocated.
+      graph.AddPass("Debug Copy",
+        [&](RenderGraphBuilder& builder)
+        {
+          builder.Read(resolved, RenderGraphUsage::Attachment);
+          builder.Create("Debug", { width, height, GL_RGBA16F, 0, 0 });
+        },
+        [&](RenderGraphContext&) {});
+    }
+
+    graph.AddPass("Present",
+      [&](RenderGraphBuilder& builder)
+      {
+        builder.Read(output, RenderGraphUsage::Attachment);
+        builder.Write(backbuffer);
+      },
+      [&](RenderGraphContext& context) { context.GetFramebuffer(output)->BlitTo(nullptr, GL_LINEAR); });
+
+    graph.Compile();
+    graph.Execute();
+  }
+
+  void RenderGraphs::OnImGuiRender()
+  {
+    Texture2D::OnImGuiRender();
+    ImGui::SliderInt("MSAA samples", &m_Samples, 0, 8);
+    ImGui::Checkbox("Downsample chain", &m_Downsample);
+    ImGui::Checkbox("Unused debug pass", &m_DebugPass);
+    if (m_Graph)
+      m_Graph->OnImGuiRender();
+  }
+}
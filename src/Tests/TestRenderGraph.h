@@ -0,0 +1,29 @@
+#pragma once
+
+#include <memory>
+
+#include "TestTexture2D.h"
+
+#include "RenderGraph.h"
+
+namespace test
+{
+  // Builds a small frame graph around the 2D texture scene each frame: a multisampled scene pass,
+  // a resolve, an optional downsample chain whose intermediates alias each other and an unused
+  // debug pass that the graph culls.
+  class RenderGraphs : public Texture2D
+  {
+  private:
+    std::unique_ptr<RenderGraph> m_Graph;
+    int m_Samples;
+    bool m_Downsample;
+    bool m_DebugPass;
+
+  public:
+    RenderGraphs();
+    ~RenderGraphs();
+
+    void OnRender();
+    void OnImGuiRender();
+  };
+}
@@ -0,0 +1,112 @@
+#include <imgui/imgui.h>
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+
+#include "TestSceneGraph.h"
+
+namespace test
+{
+  SceneGraphBenchmark::SceneGraphBenchmark() : m_NodeCount(100000), m_MovingPercent(1.0f), m_Frames(30)
+  {
+  }
+
+  SceneGraphBenchmark::~SceneGraphBenchmark()
+  {
+  }
+
+  SceneGraphBenchmark::Result SceneGraphBenchmark::Measure(const std::string& name, SceneGraph& graph, const std::vector<SceneNodeId>& nodes)
+  {
+    graph.Update();
+
+    std::mt19937 random(99);
+    std::uniform_int_distribution<size_t> pick(0, nodes.size() - 1);
+    std::uniform_real_distribution<float> offset(-1.0f, 1.0f);
+    size_t moving = std::max((size_t)1, (size_t)(nodes.size() * m_MovingPercent / 100.0f));
+
+    Result result;
+    result.Hierarchy = name;
+    result.Depth = graph.GetStats().Depth;
+
+    // The same moves both ways; the full update just marks everything dirty first.
+    double seconds[2] = {};
+    unsigned long long updated = 0;
+    for (int full = 0; full < 2; full++)
+    {
+      for (int frame = 0; frame < m_Frames; frame++)
+      {
+        for (size_t i = 0; i < moving; i++)
+          graph.SetPosition(nodes[pick(random)], glm::vec3(offset(random), offset(random), offset(random)));
+        if (full)
+          graph.MarkAllDirty();
+
+        auto start = std::chrono::high_resolution_clock::now();
+        graph.Update();
+        auto end = std::chrono::high_resolution_clock::now();
+        seconds[full] += std::chrono::duration<double>(end - start).count();
+        if (!full)
+          updated += graph.GetStats().UpdatedLastFrame;
+      }
+    }
+
+    result.IncrementalMilliseconds = seconds[0] * 1000.0 / m_Frames;
+    result.FullMilliseconds = seconds[1] * 1000.0 / m_Frames;
+    result.NodesUpdatedPerFrame = (double)updated / m_Frames;
+    return result;
+  }
+
+  void SceneGraphBenchmark::Run()
+  {
+    m_Results.clear();
+    std::mt19937 random(5);
+
+    // Deep: chains 64 nodes long, e.g. skeletons or nested UI.
+    {
+      const int chainLength = 64;
+      SceneGraph graph;
+      std::vector<SceneNodeId> nodes;
+      for (int i = 0; i < m_NodeCount; i++)
+      {
+        SceneNodeId parent = i % chainLength == 0 ? SceneGraph::INVALID_NODE : nodes.back();
+        nodes.push_back(graph.CreateNode(parent, glm::vec3(0.0f, 1.0f, 0.0f)));
+      }
+      m_Results.push_back(Measure("Deep", graph, nodes));
+    }
+
+    // Wide: a few levels with many children each, e.g. a level full of props.
+    {
+      SceneGraph graph;
+      std::vector<SceneNodeId> nodes;
+      SceneNodeId root = graph.CreateNode();
+      nodes.push_back(root);
+      std::vector<SceneNodeId> groups;
+      for (int i = 0; i < 100 && (int)nodes.size() < m_NodeCount; i++)
+      {
+        groups.push_back(graph.CreateNode(root, glm::vec3((float)i, 0.0f, 0.0f)));
+        nodes.push_back(groups.back());
+      }
+      std::uniform_int_distribution<size_t> group(0, groups.size() - 1);
+      while ((int)nodes.size() < m_NodeCount)
+        nodes.push_back(graph.CreateNode(groups[group(random)], glm::vec3(0.0f, 0.0f, 1.0f)));
+      m_Results.push_back(Measure("Wide", graph, nodes));
+    }
+  }
+
+  void SceneGraphBenchmark::OnImGuiRender()
+  {
+    ImGui::SliderInt("Nodes", &m_NodeCount, 1000, 1000000);
+    ImGui::SliderFloat("Moving per frame (%)", &m_MovingPercent, 0.01f, 100.0f, "%.2f", 3.0f);
+    ImGui::SliderInt("Frames", &m_Frames, 1, 100);
+    if (ImGui::Button("Run"))
+      Run();
+
+    ImGui::Separator();
+    for (const Result& result : m_Results)
+    {
+      ImGui::Text("%s (depth %u): incremental %.3f ms (%.0f nodes updated), full %.3f ms, %.1fx", result.Hierarchy.c_str(),
+        result.Depth, result.IncrementalMilliseconds, result.NodesUpdatedPerFrame, result.FullMilliseconds,
+        result.FullMilliseconds / std::max(result.IncrementalMilliseconds, 0.0001));
+    }
+  }
+}
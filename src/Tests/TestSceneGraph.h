@@ -0,0 +1,40 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Test.h"
+
+#include "SceneGraph.h"
+
+namespace test
+{
+  // Moves a small fraction of the nodes of a deep and a wide hierarchy every frame, timing
+  // SceneGraph's dirty-flag update against recomputing every world matrix.
+  class SceneGraphBenchmark : public Test
+  {
+  private:
+    struct Result
+    {
+      std::string Hierarchy;
+      unsigned int Depth;
+      double IncrementalMilliseconds;
+      double FullMilliseconds;
+      double NodesUpdatedPerFrame;
+    };
+
+    int m_NodeCount;
+    float m_MovingPercent;
+    int m_Frames;
+    std::vector<Result> m_Results;
+
+  public:
+    SceneGraphBenchmark();
+    ~SceneGraphBenchmark();
+
+    void OnImGuiRender();
+  private:
+    void Run();
+    Result Measure(const std::string& name, SceneGraph& graph, const std::vector<SceneNodeId>& nodes);
+  };
+}
@@ -0,0 +1,117 @@
+#include <imgui/imgui.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "TestSdfText.h"
+
+namespace test
+{
+  // Derives the cache file from the font's name, so every font gets its own.
+  static std::string GetCachePath(const std::string& fontPath)
+  {
+    size_t nameStart = fontPath.find_last_of("/\\") + 1;
+    size_t extension = fontPath.find_last_of('.');
+    if (extension == std::string::npos || extension < nameStart)
+      extension = fontPath.size();
+    return fontPath.substr(nameStart, extension - nameStart) + ".sdf";
+  }
+
+  SdfText::SdfText()
+    : m_FontPath{ "src/resources/DejaVuSans.ttf" }, m_UseCache(true), m_LabelCount(10000), m_LabelSize(12.0f),
+      m_HeadingSize(48.0f), m_Animate(true), m_Time(0.0f), m_ShapeMilliseconds(0.0)
+  {
+    LoadFont();
+    CreateLabels();
+  }
+
+  SdfText::~SdfText()
+  {
+  }
+
+  void SdfText::LoadFont()
+  {
+    std::string fontPath = m_FontPath;
+    std::unique_ptr<SdfFont> font(new SdfFont(fontPath, m_UseCache ? GetCachePath(fontPath) : ""));
+    m_Text = std::make_unique<TextRenderer>(std::move(font));
+  }
+
+  void SdfText::CreateLabels()
+  {
+    const char* kinds[] = { "Pump", "Valve", "Sensor", "Fan", "Motor" };
+    const char* units[] = { " kPa", " %", " \xC2\xB0" "C", " rpm", " A" };
+    m_Labels.resize(m_LabelCount);
+    for (int i = 0; i < m_LabelCount; i++)
+      m_Labels[i] = std::string(kinds[i % 5]) + " " + std::to_string(i) + ": " + std::to_string((i * 7919) % 1000) + units[i % 6];
+  }
+
+  void SdfText::OnUpdate(float deltatime)
+  {
+    if (m_Animate)
+      m_Time += deltatime;
+  }
+
+  void SdfText::OnRender()
+  {
+    OpenGLCall(glClearColor(0.08f, 0.09f, 0.11f, 1.0f));
+    m_Renderer.Clear(GL_COLOR_BUFFER_BIT);
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    const char* heading = "Signed distance field text";
+    m_Text->AddText(heading, glm::vec2(20.0f, 20.0f), m_HeadingSize, glm::vec4(1.0f, 0.85f, 0.4f, 1.0f));
+    float top = 30.0f + m_Text->MeasureText(heading, m_HeadingSize).y;
+
+    // Columns wide enough for the longest labels, wrapping down the window and beyond.
+    float columnWidth = m_LabelSize * 12.0f;
+    int columns = std::max(1, (int)((WINDOW_WIDTH - 40.0f) / columnWidth));
+    float rowHeight = m_LabelSize * 1.25f;
+    for (int i = 0; i < (int)m_Labels.size(); i++)
+    {
+      glm::vec2 position(20.0f + (i % columns) * columnWidth, top + (i / columns) * rowHeight);
+      float phase = m_Time * 2.0f + i * 0.05f;
+      glm::vec4 color(0.6f + 0.4f * std::sin(phase), 0.8f, 0.6f + 0.4f * std::cos(phase), 1.0f);
+      m_Text->AddText(m_Labels[i].c_str(), position, m_LabelSize, color);
+    }
+
+    m_ShapeMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    m_Text->Render(glm::ortho(0.0f, WINDOW_WIDTH, WINDOW_HEIGHT, 0.0f, -1.0f, 1.0f));
+  }
+
+  void SdfText::OnImGuiRender()
+  {
+    ImGui::InputText("Font", m_FontPath, sizeof(m_FontPath));
+    ImGui::Checkbox("Use atlas cache", &m_UseCache);
+    ImGui::SameLine();
+    if (ImGui::Button("Load"))
+      LoadFont();
+
+    if (ImGui::SliderInt("Labels", &m_LabelCount, 0, 50000))
+      CreateLabels();
+    ImGui::SliderFloat("Label size", &m_LabelSize, 4.0f, 64.0f);
+    ImGui::SliderFloat("Heading size", &m_HeadingSize, 4.0f, 400.0f, "%.1f", 2.0f);
+    ImGui::Checkbox("Animate colours", &m_Animate);
+
+    const SdfFont& font = m_Text->GetFont();
+    const SdfFont::Stats& fontStats = font.GetStats();
+    if (!font.IsValid())
+      ImGui::Text("Font failed to load");
+    else
+      ImGui::Text("Atlas: %u page(s) %s in %.1f ms", fontStats.Pages, fontStats.FromCache ? "loaded from cache" : "built", fontStats.LoadMilliseconds);
+
+    const TextRenderer::Stats& stats = m_Text->GetStats();
+    ImGui::Text("Glyphs: %u in %u draw call(s), %.1f KB streamed", stats.Glyphs, stats.DrawCalls, stats.BufferBytes / 1024.0f);
+    ImGui::Text("Shaping %.3f ms", m_ShapeMilliseconds);
+
+    if (font.IsValid() && ImGui::CollapsingHeader("Atlas"))
+    {
+      for (size_t page = 0; page < font.GetPageCount(); page++)
+        ImGui::Image((ImTextureID)(intptr_t)font.GetPage(page).GetRendererId(), ImVec2(256.0f, 256.0f));
+    }
+    ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+  }
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Test.h"
+
+#include "Renderer.h"
+#include "TextRenderer.h"
+
+namespace test
+{
+  // A dashboard of up to 50k labels drawn by the TextRenderer, with a heading that scales from
+  // tiny to huge to show the edges staying sharp. The font can be swapped for any TrueType file,
+  // with or without the atlas cache.
+  class SdfText : public Test
+  {
+  private:
+    std::unique_ptr<TextRenderer> m_Text;
+    Renderer m_Renderer;
+    char m_FontPath[256];
+    bool m_UseCache;
+    std::vector<std::string> m_Labels;
+    int m_LabelCount;
+    float m_LabelSize;
+    float m_HeadingSize;
+    bool m_Animate;
+    float m_Time;
+    double m_ShapeMilliseconds;
+
+  public:
+    SdfText();
+    ~SdfText();
+
+    void OnUpdate(float deltatime);
+    void OnRender();
+    void OnImGuiRender();
+  private:
+    void LoadFont();
+    void CreateLabels();
+  };
+}
@@ -0,0 +1,248 @@
+#include <imgui/imgui.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "TestSpatialIndex.h"
+
+#include "FrustumCuller.h"
+
+namespace test
+{
+  namespace
+  {
+    const float WORLD_SIZE = 20000.0f;
+    const float MIN_ZOOM = 0.25f, MAX_ZOOM = 4.0f;
+
+    const float QUAD_POSITIONS[] = {
+      -0.5f, -0.5f, 0.0f, 0.0f, 0.0f,
+       0.5f, -0.5f, 0.0f, 1.0f, 0.0f,
+       0.5f,  0.5f, 0.0f, 1.0f, 1.0f,
+      -0.5f,  0.5f, 0.0f, 0.0f, 1.0f
+    };
+    const unsigned int QUAD_INDICES[] = { 0, 1, 2, 2, 3, 0 };
+
+    double GetMilliseconds(std::chrono::high_resolution_clock::time_point start)
+    {
+      return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    }
+  }
+
+  SpatialIndexScene::SpatialIndexScene()
+    : m_VertexBuffer(QUAD_POSITIONS, sizeof(QUAD_POSITIONS)), m_IndexBuffer(QUAD_INDICES, 6),
+      m_Quadtree({ glm::vec2(0.0f), glm::vec2(WORLD_SIZE) }), m_Count(100000), m_MovingCount(1000),
+      m_Offset(WORLD_SIZE * 0.5f), m_Zoom(1.0f), m_QueryMilliseconds(0.0), m_LinearMilliseconds(0.0), m_LinearVisible(0),
+      m_CompareLinear(false)
+  {
+    VertexBufferLayout layout;
+    layout.Push<float>(3);
+    layout.Push<float>(2);
+    m_VertexArray.AddBuffer(m_VertexBuffer, layout);
+
+    m_Shader = ResourceRegistry::Get().LoadShader("src/resources/Basic.vert", "src/resources/Basic.frag");
+    Shader& shader = *ResourceRegistry::Get().Resolve(m_Shader);
+    shader.Bind();
+    shader.SetUniform1i("u_Texture", 0);
+    m_Texture = TextureCache::Get().Load("src/resources/crazy-love.png");
+
+    // Already culled by the quadtree.
+    m_Renderer.SetFrustumCulling(false);
+    GenerateScene();
+  }
+
+  SpatialIndexScene::~SpatialIndexScene()
+  {
+    ResourceRegistry::Get().Release(m_Shader);
+  }
+
+  void SpatialIndexScene::GenerateScene()
+  {
+    std::mt19937 random(1234);
+    std::uniform_real_distribution<float> position(0.0f, WORLD_SIZE), size(8.0f, 40.0f), speed(-200.0f, 200.0f);
+
+    m_Quadtree.Clear();
+    m_Moving.clear();
+    for (int i = 0; i < m_Count; i++)
+    {
+      glm::vec2 center(position(random), position(random));
+      glm::vec2 extents(size(random) * 0.5f);
+      unsigned int object = m_Quadtree.Insert({ center - extents, center + extents });
+      if (i < m_MovingCount)
+        m_Moving.push_back({ object, glm::vec2(speed(random), speed(random)) });
+    }
+  }
+
+  glm::mat4 SpatialIndexScene::GetViewProjection() const
+  {
+    glm::vec2 size = glm::vec2(WINDOW_WIDTH, WINDOW_HEIGHT) * m_Zoom;
+    return glm::ortho(m_Offset.x, m_Offset.x + size.x, m_Offset.y, m_Offset.y + size.y, -1.0f, 1.0f);
+  }
+
+  void SpatialIndexScene::OnUpdate(float deltatime)
+  {
+    // Moving quads bounce off the world's edges.
+    for (MovingQuad& moving : m_Moving)
+    {
+      BoundingRect bounds = m_Quadtree.GetBounds(moving.Object);
+      glm::vec2 step = moving.Velocity * deltatime;
+      for (int axis = 0; axis < 2; axis++)
+      {
+        if (bounds.Min[axis] + step[axis] < 0.0f || bounds.Max[axis] + step[axis] > WORLD_SIZE)
+        {
+          moving.Velocity[axis] = -moving.Velocity[axis];
+          step[axis] = -step[axis];
+        }
+      }
+      m_Quadtree.Move(moving.Object, { bounds.Min + step, bounds.Max + step });
+    }
+
+    ImGuiIO& io = ImGui::GetIO();
+    m_Picked.clear();
+    if (io.WantCaptureMouse)
+      return;
+
+    glm::vec2 cursor(io.MousePos.x, WINDOW_HEIGHT - io.MousePos.y);
+    if (io.MouseWheel != 0.0f)
+    {
+      // Zoom around the cursor.
+      glm::vec2 world = m_Offset + cursor * m_Zoom;
+      m_Zoom = std::max(MIN_ZOOM, std::min(m_Zoom * std::pow(0.8f, io.MouseWheel), MAX_ZOOM));
+      m_Offset = world - cursor * m_Zoom;
+    }
+    if (io.MouseDown[0])
+      m_Offset -= glm::vec2(io.MouseDelta.x, -io.MouseDelta.y) * m_Zoom;
+
+    m_Quadtree.QueryPoint(m_Offset + cursor * m_Zoom, m_Picked);
+  }
+
+  void SpatialIndexScene::OnRender()
+  {
+    OpenGLCall(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
+    m_Renderer.Clear();
+
+    glm::mat4 viewProjection = GetViewProjection();
+    Frustum frustum(viewProjection);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    m_Quadtree.Query(frustum, m_Visible);
+    m_QueryMilliseconds = GetMilliseconds(start);
+
+    if (m_CompareLinear)
+    {
+      // What culling cost before: every object against the frustum.
+      start = std::chrono::high_resolution_clock::now();
+      m_LinearVisible = 0;
+      for (unsigned int object = 0; object < (unsigned int)m_Count; object++)
+        m_LinearVisible += frustum.Intersects(m_Quadtree.GetBounds(object).ToBox());
+      m_LinearMilliseconds = GetMilliseconds(start);
+    }
+
+    Shader& shader = *ResourceRegistry::Get().Resolve(m_Shader);
+    m_Texture->Bind();
+    m_Renderer.BeginScene(viewProjection);
+    for (unsigned int object : m_Visible)
+    {
+      const BoundingRect& bounds = m_Quadtree.GetBounds(object);
+      glm::mat4 transform = glm::translate(glm::mat4(1.0f), glm::vec3(bounds.GetCenter(), 0.0f));
+      transform = glm::scale(transform, glm::vec3(bounds.Max - bounds.Min, 1.0f));
+      m_Renderer.Submit(m_VertexArray, m_IndexBuffer, shader, transform);
+    }
+    m_Renderer.EndScene();
+  }
+
+  void SpatialIndexScene::RunBvhBenchmark()
+  {
+    m_Results.clear();
+
+    const size_t count = 1000000;
+    std::mt19937 random(42);
+    std::uniform_real_distribution<float> position(-1000.0f, 1000.0f), size(0.5f, 5.0f);
+    std::vector<BoundingBox> boxes(count);
+    for (BoundingBox& box : boxes)
+    {
+      glm::vec3 center(position(random), position(random), position(random));
+      glm::vec3 extents(size(random), size(random), size(random));
+      box = { center - extents, center + extents };
+    }
+
+    Bvh bvh(0.0f);
+    FrustumCuller culler;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (const BoundingBox& box : boxes)
+      bvh.Insert(box);
+    m_Results.push_back({ "BVH insert", GetMilliseconds(start), count });
+
+    start = std::chrono::high_resolution_clock::now();
+    bvh.Rebuild();
+    m_Results.push_back({ "BVH rebuild", GetMilliseconds(start), count });
+
+    for (const BoundingBox& box : boxes)
+      culler.AddBox(box);
+
+    glm::mat4 projection = glm::perspective(glm::radians(60.0f), WINDOW_WIDTH / WINDOW_HEIGHT, 0.1f, 300.0f);
+    glm::mat4 view = glm::lookAt(glm::vec3(0.0f), glm::vec3(1.0f, 0.2f, 0.3f), glm::vec3(0.0f, 1.0f, 0.0f));
+    Frustum frustum(projection * view);
+    std::vector<unsigned int> visible;
+
+    start = std::chrono::high_resolution_clock::now();
+    culler.CullBoxes(frustum, visible);
+    m_Results.push_back({ std::string("Linear frustum cull (") + GetSimdKernelName(GetBestSimdKernel()) + ")", GetMilliseconds(start), visible.size() });
+
+    start = std::chrono::high_resolution_clock::now();
+    bvh.Query(frustum, visible);
+    m_Results.push_back({ "BVH frustum query", GetMilliseconds(start), visible.size() });
+
+    const int rays = 1000;
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    size_t hits = 0;
+    start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < rays; i++)
+    {
+      glm::vec3 direction = glm::normalize(glm::vec3(unit(random), unit(random), unit(random)) + glm::vec3(0.0f, 0.0f, 1e-4f));
+      hits += bvh.Raycast(glm::vec3(0.0f), direction, 3000.0f) != Bvh::INVALID_OBJECT;
+    }
+    m_Results.push_back({ "BVH 1000 ray picks", GetMilliseconds(start), hits });
+
+    // Small moves mostly stay inside the leaves' margins; large ones reinsert.
+    Bvh dynamic(1.0f);
+    for (size_t i = 0; i < 100000; i++)
+      dynamic.Insert(boxes[i]);
+    start = std::chrono::high_resolution_clock::now();
+    for (unsigned int object = 0; object < 100000; object++)
+    {
+      glm::vec3 step(unit(random), unit(random), unit(random));
+      dynamic.Move(object, { boxes[object].Min + step, boxes[object].Max + step });
+    }
+    m_Results.push_back({ "BVH 100k moves", GetMilliseconds(start), dynamic.GetStats().Reinserts });
+  }
+
+  void SpatialIndexScene::OnImGuiRender()
+  {
+    if (ImGui::SliderInt("Quads", &m_Count, 1000, 1000000))
+      GenerateScene();
+    if (ImGui::SliderInt("Moving", &m_MovingCount, 0, 10000))
+      GenerateScene();
+    ImGui::Checkbox("Compare with linear culling", &m_CompareLinear);
+
+    const LooseQuadtree::Stats& stats = m_Quadtree.GetStats();
+    ImGui::Text("Visible: %zu of %u (%u nodes of %u visited, %u objects tested)", m_Visible.size(), stats.Objects,
+      stats.NodesVisited, stats.Nodes, stats.ObjectsTested);
+    ImGui::Text("Quadtree query: %.3f ms", m_QueryMilliseconds);
+    if (m_CompareLinear)
+      ImGui::Text("Linear culling: %.3f ms (%zu visible)", m_LinearMilliseconds, m_LinearVisible);
+    if (m_Picked.empty())
+      ImGui::Text("Under cursor: nothing");
+    else
+      ImGui::Text("Under cursor: quad %u (%zu overlapping)", m_Picked.front(), m_Picked.size());
+
+    ImGui::Separator();
+    if (ImGui::Button("Run BVH benchmark (1M boxes)"))
+      RunBvhBenchmark();
+    for (const Result& result : m_Results)
+      ImGui::Text("%-36s %9.3f ms  %zu", result.Name.c_str(), result.Milliseconds, result.Found);
+  }
+}
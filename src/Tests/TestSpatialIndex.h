@@ -0,0 +1,75 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "Test.h"
+
+#include "Bvh.h"
+#include "Quadtree.h"
+#include "Renderer.h"
+#include "ResourceRegistry.h"
+#include "TextureCache.h"
+#include "VertexBuffer.h"
+#include "VertexBufferLayout.h"
+
+namespace test
+{
+  // A large 2D world of quads kept in a LooseQuadtree: only the quads the camera's frustum query
+  // returns are drawn, a few move every frame, and the quads under the cursor are picked with a
+  // point query. Drag to pan and scroll to zoom. The BVH benchmark compares frustum queries and
+  // ray picks against a million static boxes with the linear FrustumCuller.
+  class SpatialIndexScene : public Test
+  {
+  private:
+    struct MovingQuad
+    {
+      unsigned int Object;
+      glm::vec2 Velocity;
+    };
+
+    struct Result
+    {
+      std::string Name;
+      double Milliseconds;
+      size_t Found;
+    };
+
+    VertexBuffer m_VertexBuffer;
+    IndexBuffer m_IndexBuffer;
+    VertexArray m_VertexArray;
+    ShaderHandle m_Shader;
+    std::shared_ptr<::Texture2D> m_Texture;
+    Renderer m_Renderer;
+
+    LooseQuadtree m_Quadtree;
+    std::vector<MovingQuad> m_Moving;
+    std::vector<unsigned int> m_Visible;
+    std::vector<unsigned int> m_Picked;
+    int m_Count;
+    int m_MovingCount;
+    glm::vec2 m_Offset; // World position of the bottom left corner of the screen.
+    float m_Zoom; // World units per pixel.
+    double m_QueryMilliseconds;
+    double m_LinearMilliseconds;
+    size_t m_LinearVisible;
+    bool m_CompareLinear;
+
+    std::vector<Result> m_Results;
+
+  public:
+    SpatialIndexScene();
+    ~SpatialIndexScene();
+
+    void OnUpdate(float deltatime);
+    void OnRender();
+    void OnImGuiRender();
+  private:
+    void GenerateScene();
+    glm::mat4 GetViewProjection() const;
+    void RunBvhBenchmark();
+  };
+}
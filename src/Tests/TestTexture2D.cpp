@@ -1,3 +1,5 @@
+#include <random>
+
 #include <imgui/imgui.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
@@ -8,14 +10,10 @@
 
 namespace test
 {
-  Texture2D::Texture2D()
-    : m_TranslationA(glm::vec3(200.0f, 200.0f, 0.0f)), 
-      m_TranslationB(glm::vec3(400.0f, 200.0f, 0.0f)),
-      m_Projection(glm::ortho(0.0f, WINDOW_WIDTH, 0.0f, WINDOW_HEIGHT, -1.0f, 1.0f)),
-      m_View(glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, 0.0f)))
+  namespace
   {
     // Defining square positions to draw later in Modern OpenGL.
-    float positions[] = {
+    const float QUAD_POSITIONS[] = {
       -50.0f, -50.0f, 0.0f, 0.0f,  // 0
        50.0f, -50.0f, 1.0f, 0.0f,  // 1
        50.0f,  50.0f, 1.0f, 1.0f,  // 2
@@ -23,23 +21,47 @@ namespace test
     };
 
     // Using an index buffer to avoid storing data for the same vertex multiple times
-    unsigned int indices[] = {
+    const unsigned int QUAD_INDICES[] = {
       0, 1, 2, // Indices of positions to use for first triangle
       2, 3, 0  // Indices of positions to use for second triangle
     };
-    m_IndexBuffer = std::make_unique<IndexBuffer>(indices, 6);
-    
-    m_VertexBuffer = std::make_unique<VertexBuffer>(positions, 4 * 4 * sizeof(float));
+
+    struct Translation
+    {
+      glm::vec3 Value;
+    };
+
+    struct Velocity
+    {
+      glm::vec3 Value;
+    };
+
+    // Tags the quads the sliders move.
+    struct Editable
+    {
+      bool Unused;
+    };
+  }
+
+  Texture2D::Texture2D()
+    : m_Projection(glm::ortho(0.0f, WINDOW_WIDTH, 0.0f, WINDOW_HEIGHT, -1.0f, 1.0f)),
+      m_View(glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, 0.0f))),
+      m_BouncingCount(0),
+      m_VertexBuffer(QUAD_POSITIONS, sizeof(QUAD_POSITIONS)),
+      m_IndexBuffer(QUAD_INDICES, 6)
+  {
     VertexBufferLayout layout;
     layout.Push<float>(2);
     layout.Push<float>(2);
-    m_VertexArray = std::make_unique<VertexArray>();
-    m_VertexArray->AddBuffer(*m_VertexBuffer, layout);
+    m_VertexArray.AddBuffer(m_VertexBuffer, layout);
+    m_World.CreateEntity(Translation{ glm::vec3(200.0f, 200.0f, 0.0f) }, Editable{});
+    m_World.CreateEntity(Translation{ glm::vec3(400.0f, 200.0f, 0.0f) }, Editable{});
 
-    m_Shader = std::make_unique<Shader>("src/resources/Basic.vert", "src/resources/Basic.frag");
-    m_Shader->Bind();
-    m_Shader->SetUniform1i("u_Texture", 0);
-    m_Texture = std::make_unique<Texture>("src/resources/crazy-love.png");
+    m_Shader = ResourceRegistry::Get().LoadShader("src/resources/Basic.vert", "src/resources/Basic.frag");
+    Shader& shader = *ResourceRegistry::Get().Resolve(m_Shader);
+    shader.Bind();
+    shader.SetUniform1i("u_Texture", 0);
+    m_Texture = TextureCache::Get().Load("src/resources/crazy-love.png");
 
     OpenGLCall(glEnable(GL_BLEND));
     OpenGLCall(glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA));
@@ -47,11 +69,38 @@ namespace test
 
   Texture2D::~Texture2D()
   {
+    ResourceRegistry::Get().Release(m_Shader);
     OpenGLCall(glDisable(GL_BLEND));
   }
 
+  void Texture2D::SetBouncingCount(int count)
+  {
+    std::mt19937 random((unsigned int)m_Bouncing.size());
+    std::uniform_real_distribution<float> x(50.0f, WINDOW_WIDTH - 50.0f), y(50.0f, WINDOW_HEIGHT - 50.0f), speed(-300.0f, 300.0f);
+    while ((int)m_Bouncing.size() < count)
+    {
+      m_Bouncing.push_back(m_World.CreateEntity(Translation{ glm::vec3(x(random), y(random), 0.0f) },
+        Velocity{ glm::vec3(speed(random), speed(random), 0.0f) }));
+    }
+    while ((int)m_Bouncing.size() > count)
+    {
+      m_World.DestroyEntity(m_Bouncing.back());
+      m_Bouncing.pop_back();
+    }
+  }
+
   void Texture2D::OnUpdate(float deltatime)
   {
+    m_World.ParallelForEach<Translation, Velocity>([deltatime](Entity, Translation& translation, Velocity& velocity)
+    {
+      translation.Value += velocity.Value * deltatime;
+      const glm::vec2 max(WINDOW_WIDTH - 50.0f, WINDOW_HEIGHT - 50.0f);
+      for (int axis = 0; axis < 2; axis++)
+      {
+        if ((translation.Value[axis] < 50.0f && velocity.Value[axis] < 0.0f) || (translation.Value[axis] > max[axis] && velocity.Value[axis] > 0.0f))
+          velocity.Value[axis] = -velocity.Value[axis];
+      }
+    });
   }
 
   void Texture2D::OnRender()
@@ -60,29 +109,41 @@ namespace test
     OpenGLCall(glClear(GL_COLOR_BUFFER_BIT));
 
     Renderer renderer;
+    Shader& shader = *ResourceRegistry::Get().Resolve(m_Shader);
     m_Texture->Bind();
 
+    // The translation columns are gathered into the transform system so the matrices are built
+    // by its SIMD kernels rather than one glm::translate per entity.
+    m_Transforms.Clear();
+    m_World.ForEach<Translation>([this](Entity, const Translation& translation)
     {
-      glm::mat4 model = glm::translate(glm::mat4(1.0f), m_TranslationA);
-      glm::mat4 mvp = m_Projection * m_View * model;
-      m_Shader->Bind();
-      m_Shader->SetUniformMat4f("u_ModelViewProjectionMatrix", mvp);
-      renderer.Draw(*m_VertexArray, *m_IndexBuffer, *m_Shader);
-    }
+      m_Transforms.Add(translation.Value);
+    });
+    m_Transforms.Update(m_Projection * m_View, GetBestSimdKernel(), true);
 
+    shader.Bind();
+    for (const glm::mat4& modelViewProjection : m_Transforms.GetModelViewProjections())
     {
-      glm::mat4 model = glm::translate(glm::mat4(1.0f), m_TranslationB);
-      glm::mat4 mvp = m_Projection * m_View * model;
-      m_Shader->Bind();
-      m_Shader->SetUniformMat4f("u_ModelViewProjectionMatrix", mvp);
-      renderer.Draw(*m_VertexArray, *m_IndexBuffer, *m_Shader);
+      shader.SetUniformMat4f("u_ModelViewProjectionMatrix", modelViewProjection);
+      renderer.Draw(m_VertexArray, m_IndexBuffer, shader);
     }
   }
 
   void Texture2D::OnImGuiRender()
   {
-    ImGui::SliderFloat3("Translation A", &m_TranslationA.x, 0.0f, WINDOW_WIDTH);
-    ImGui::SliderFloat3("Translation B", &m_TranslationB.x, 0.0f, WINDOW_WIDTH);
+    m_World.ForEach<Editable, Translation>([](Entity entity, const Editable&, Translation& translation)
+    {
+      ImGui::PushID((int)entity.Index);
+      ImGui::SliderFloat3("Translation", &translation.Value.x, 0.0f, WINDOW_WIDTH);
+      ImGui::PopID();
+    });
+    if (ImGui::Button("Add quad"))
+      m_World.CreateEntity(Translation{ glm::vec3(WINDOW_WIDTH * 0.5f, WINDOW_HEIGHT * 0.5f, 0.0f) }, Editable{});
+    if (ImGui::SliderInt("Bouncing quads", &m_BouncingCount, 0, 2000))
+      SetBouncingCount(m_BouncingCount);
+
+    EntityWorld::Stats stats = m_World.GetStats();
+    ImGui::Text("%u entities, %u archetypes, %u chunks", stats.Entities, stats.Archetypes, stats.Chunks);
     ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
   }
 }
\ No newline at end of file
@@ -1,25 +1,34 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
 #include "Test.h"
 
-#include "Texture.h"
+#include "EntityWorld.h"
+#include "ResourceRegistry.h"
+#include "TextureCache.h"
+#include "TransformSystem.h"
 #include "VertexBuffer.h"
 #include "VertexBufferLayout.h"
 
 namespace test
 {
+  // Textured quads as entities: editable ones with a translation, and bouncing ones that also have
+  // a velocity and are moved by jobs. Their matrices are built each frame by a TransformSystem.
   class Texture2D: public Test
   {
   private:
-    glm::vec3 m_TranslationA, m_TranslationB;
     glm::mat4 m_Projection, m_View;
-    std::unique_ptr<VertexArray> m_VertexArray;
-    std::unique_ptr<IndexBuffer> m_IndexBuffer;
-    std::unique_ptr<VertexBuffer> m_VertexBuffer;
-    std::unique_ptr<Shader> m_Shader;
-    std::unique_ptr<Texture> m_Texture;
+    EntityWorld m_World;
+    std::vector<Entity> m_Bouncing;
+    TransformSystem m_Transforms;
+    int m_BouncingCount;
+    VertexBuffer m_VertexBuffer;
+    IndexBuffer m_IndexBuffer;
+    VertexArray m_VertexArray;
+    ShaderHandle m_Shader;
+    std::shared_ptr<::Texture2D> m_Texture;
 
   public:
     Texture2D();
@@ -28,5 +37,7 @@ namespace test
     void OnUpdate(float deltatime);
     void OnRender();
     void OnImGuiRender();
+  private:
+    void SetBouncingCount(int count);
   };
-}
\ No newline at end of file
+}
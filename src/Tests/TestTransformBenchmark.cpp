@@ -0,0 +1,107 @@
+#include <imgui/imgui.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "TestTransformBenchmark.h"
+
+#include "Renderer.h"
+
+namespace test
+{
+  static float GetMaxDifference(const std::vector<glm::mat4>& a, const std::vector<glm::mat4>& b)
+  {
+    float difference = 0.0f;
+    for (size_t i = 0; i < a.size(); i++)
+    {
+      for (int column = 0; column < 4; column++)
+      {
+        glm::vec4 delta = glm::abs(a[i][column] - b[i][column]);
+        difference = std::max(difference, std::max(std::max(delta.x, delta.y), std::max(delta.z, delta.w)));
+      }
+    }
+    return difference;
+  }
+
+  TransformBenchmark::TransformBenchmark() : m_Iterations(10)
+  {
+  }
+
+  TransformBenchmark::~TransformBenchmark()
+  {
+  }
+
+  void TransformBenchmark::Run()
+  {
+    m_Results.clear();
+
+    glm::mat4 projection = glm::perspective(glm::radians(60.0f), WINDOW_WIDTH / WINDOW_HEIGHT, 0.1f, 1000.0f);
+    glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 50.0f, 200.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    glm::mat4 viewProjection = projection * view;
+
+    const size_t counts[] = { 10000, 100000, 1000000 };
+    const SimdKernel kernels[] = { SimdKernel::Scalar, SimdKernel::Sse, SimdKernel::Avx2 };
+
+    for (size_t count : counts)
+    {
+      std::mt19937 random(42);
+      std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+      TransformSystem transforms;
+      for (size_t i = 0; i < count; i++)
+      {
+        glm::vec3 position(unit(random) * 100.0f, unit(random) * 100.0f, unit(random) * 100.0f);
+        glm::quat rotation = glm::normalize(glm::quat(unit(random), unit(random), unit(random), unit(random)));
+        transforms.Add(position, rotation, glm::vec3(1.0f + unit(random) * 0.5f));
+      }
+
+      transforms.Update(viewProjection, SimdKernel::Scalar);
+      std::vector<glm::mat4> reference = transforms.GetModelViewProjections();
+
+      for (SimdKernel kernel : kernels)
+      {
+        if (IsSimdKernelSupported(kernel))
+          m_Results.push_back(Measure(transforms, viewProjection, reference, kernel, false));
+      }
+      m_Results.push_back(Measure(transforms, viewProjection, reference, GetBestSimdKernel(), true));
+    }
+  }
+
+  TransformBenchmark::Result TransformBenchmark::Measure(TransformSystem& transforms, const glm::mat4& viewProjection,
+    const std::vector<glm::mat4>& reference, SimdKernel kernel, bool parallel)
+  {
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < m_Iterations; i++)
+      transforms.Update(viewProjection, kernel, parallel);
+    auto end = std::chrono::high_resolution_clock::now();
+
+    double seconds = std::chrono::duration<double>(end - start).count();
+    Result result;
+    result.Count = transforms.GetCount();
+    result.Kernel = kernel;
+    result.Parallel = parallel;
+    result.MillisecondsPerUpdate = seconds * 1000.0 / m_Iterations;
+    result.MillionMatricesPerSecond = result.Count * (double)m_Iterations / seconds / 1000000.0;
+    result.MaxError = GetMaxDifference(reference, transforms.GetModelViewProjections());
+    return result;
+  }
+
+  void TransformBenchmark::OnImGuiRender()
+  {
+    ImGui::SliderInt("Iterations", &m_Iterations, 1, 100);
+    if (ImGui::Button("Run"))
+      Run();
+
+    ImGui::Text("Best kernel: %s", GetSimdKernelName(GetBestSimdKernel()));
+    ImGui::Separator();
+    for (const Result& result : m_Results)
+    {
+      ImGui::Text("%7zu objects  %-6s %-5s  %8.3f ms  %7.1f M matrices/s  max error %.2g", result.Count,
+        GetSimdKernelName(result.Kernel), result.Parallel ? "+jobs" : "", result.MillisecondsPerUpdate,
+        result.MillionMatricesPerSecond, result.MaxError);
+    }
+  }
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <vector>
+
+#include "Test.h"
+
+#include "TransformSystem.h"
+
+namespace test
+{
+  // Builds world and model view projection matrices for 10k, 100k and 1M objects with every
+  // TransformSystem kernel, and the best one split into jobs, reporting matrices per second and
+  // the largest difference from the scalar reference.
+  class TransformBenchmark : public Test
+  {
+  private:
+    struct Result
+    {
+      size_t Count;
+      SimdKernel Kernel;
+      bool Parallel;
+      double MillisecondsPerUpdate;
+      double MillionMatricesPerSecond;
+      float MaxError;
+    };
+
+    int m_Iterations;
+    std::vector<Result> m_Results;
+
+  public:
+    TransformBenchmark();
+    ~TransformBenchmark();
+
+    void OnImGuiRender();
+  private:
+    void Run();
+    Result Measure(TransformSystem& transforms, const glm::mat4& viewProjection, const std::vector<glm::mat4>& reference,
+      SimdKernel kernel, bool parallel);
+  };
+}
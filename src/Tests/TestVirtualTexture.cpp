@@ -0,0 +1,180 @@
+#include <imgui/imgui.h>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+#include "TestVirtualTexture.h"
+
+#include "Renderer.h"
+#include "VertexBufferLayout.h"
+
+namespace test
+{
+  // Deterministic terrain-like pattern evaluated per page, so the map needs no disk space.
+  class ProceduralMapSource : public VirtualTextureSource
+  {
+  private:
+    static constexpr int PAGE_TABLE_SIZE = 2048;
+
+    static float Hash(int x, int y)
+    {
+      unsigned int h = (unsigned int)x * 374761393u + (unsigned int)y * 668265263u;
+      h = (h ^ (h >> 13)) * 1274126177u;
+      return (h ^ (h >> 16)) / 4294967295.0f;
+    }
+
+    static float ValueNoise(float x, float y)
+    {
+      int x0 = (int)std::floor(x), y0 = (int)std::floor(y);
+      float fx = x - x0, fy = y - y0;
+      fx = fx * fx * (3.0f - 2.0f * fx);
+      fy = fy * fy * (3.0f - 2.0f * fy);
+      float a = Hash(x0, y0), b = Hash(x0 + 1, y0), c = Hash(x0, y0 + 1), d = Hash(x0 + 1, y0 + 1);
+      return (a + (b - a) * fx) + ((c + (d - c) * fx) - (a + (b - a) * fx)) * fy;
+    }
+
+  public:
+    int GetPageTableSize() const override { return PAGE_TABLE_SIZE; }
+    int GetWidth() const override { return PAGE_TABLE_SIZE * VT_PAGE_CONTENT; }
+    int GetHeight() const override { return PAGE_TABLE_SIZE * VT_PAGE_CONTENT; }
+
+    bool ReadPage(int level, int x, int y, unsigned char* destination) const override
+    {
+      float texelSize = (float)(1 << level);
+      for (int row = 0; row < VT_PAGE_SIZE; row++)
+      {
+        for (int column = 0; column < VT_PAGE_SIZE; column++)
+        {
+          // Level 0 texel coordinates of this texel's centre.
+          float worldX = ((x * VT_PAGE_CONTENT + column - VT_PAGE_BORDER) + 0.5f) * texelSize;
+          float worldY = ((y * VT_PAGE_CONTENT + row - VT_PAGE_BORDER) + 0.5f) * texelSize;
+
+          // Only add octaves that are coarser than a texel at this level to avoid aliasing.
+          float height = 0.0f, amplitude = 0.5f, total = 0.0f;
+          for (float cell = 262144.0f; cell >= 2.0f * texelSize && cell >= 16.0f; cell /= 4.0f)
+          {
+            height += ValueNoise(worldX / cell, worldY / cell) * amplitude;
+            total += amplitude;
+            amplitude *= 0.6f;
+          }
+          height /= total;
+
+          unsigned char* texel = destination + ((size_t)row * VT_PAGE_SIZE + column) * 4;
+          if (height < 0.45f)
+          {
+            texel[0] = 20; texel[1] = (unsigned char)(60 + height * 160); texel[2] = (unsigned char)(120 + height * 200);
+          }
+          else
+          {
+            float land = (height - 0.45f) / 0.55f;
+            texel[0] = (unsigned char)(60 + land * 150); texel[1] = (unsigned char)(140 - land * 40); texel[2] = (unsigned char)(40 + land * 60);
+          }
+          texel[3] = 255;
+
+          // Grid lines every 64 level 0 pages, one texel wide at any level.
+          const float gridSpacing = 64.0f * VT_PAGE_CONTENT;
+          if (std::fmod(worldX, gridSpacing) < texelSize || std::fmod(worldY, gridSpacing) < texelSize)
+          {
+            texel[0] = texel[1] = texel[2] = 230;
+          }
+        }
+      }
+      return true;
+    }
+  };
+
+  VirtualTextureMap::VirtualTextureMap()
+    : m_Projection(glm::ortho(0.0f, WINDOW_WIDTH, 0.0f, WINDOW_HEIGHT, -1.0f, 1.0f)),
+      m_Offset((WINDOW_WIDTH - WINDOW_HEIGHT) / 2.0f, 0.0f), m_MapSize(WINDOW_HEIGHT)
+  {
+    std::unique_ptr<VirtualTextureSource> source(new VirtualTextureFile("src/resources/map.vtex"));
+    if (!static_cast<VirtualTextureFile&>(*source).IsValid())
+      source.reset(new ProceduralMapSource());
+    m_VirtualTexture = std::make_unique<VirtualTexture>(std::move(source), 32, (int)WINDOW_WIDTH, (int)WINDOW_HEIGHT);
+
+    // Unit quad scaled to the map size, covering the whole virtual texture.
+    float positions[] = {
+      0.0f, 0.0f, 0.0f, 0.0f,
+      1.0f, 0.0f, 1.0f, 0.0f,
+      1.0f, 1.0f, 1.0f, 1.0f,
+      0.0f, 1.0f, 0.0f, 1.0f
+    };
+    unsigned int indices[] = { 0, 1, 2, 2, 3, 0 };
+    m_IndexBuffer = std::make_unique<IndexBuffer>(indices, 6);
+    m_VertexBuffer = std::make_unique<VertexBuffer>(positions, 4 * 4 * sizeof(float));
+    VertexBufferLayout layout;
+    layout.Push<float>(2);
+    layout.Push<float>(2);
+    m_VertexArray = std::make_unique<VertexArray>();
+    m_VertexArray->AddBuffer(*m_VertexBuffer, layout);
+
+    m_Shader = std::make_unique<Shader>("src/resources/Basic.vert", "src/resources/VirtualTexture.frag");
+    m_FeedbackShader = std::make_unique<Shader>("src/resources/Basic.vert", "src/resources/VirtualTextureFeedback.frag");
+  }
+
+  VirtualTextureMap::~VirtualTextureMap()
+  {
+  }
+
+  void VirtualTextureMap::ZoomAround(const glm::vec2& point, float factor)
+  {
+    float size = std::max(64.0f, std::min(m_MapSize * factor, 1.0e7f));
+    m_Offset = point - (point - m_Offset) * (size / m_MapSize);
+    m_MapSize = size;
+  }
+
+  void VirtualTextureMap::OnUpdate(float deltatime)
+  {
+    ImGuiIO& io = ImGui::GetIO();
+    if (io.WantCaptureMouse)
+      return;
+
+    // Scroll to zoom around the cursor, drag to pan.
+    glm::vec2 cursor(io.MousePos.x, WINDOW_HEIGHT - io.MousePos.y);
+    if (io.MouseWheel != 0.0f)
+      ZoomAround(cursor, std::pow(1.25f, io.MouseWheel));
+    if (io.MouseDown[0])
+      m_Offset += glm::vec2(io.MouseDelta.x, -io.MouseDelta.y);
+  }
+
+  void VirtualTextureMap::OnRender()
+  {
+    OpenGLCall(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
+    OpenGLCall(glClear(GL_COLOR_BUFFER_BIT));
+
+    Renderer renderer;
+    glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(m_Offset, 0.0f));
+    model = glm::scale(model, glm::vec3(m_MapSize, m_MapSize, 1.0f));
+    glm::mat4 mvp = m_Projection * model;
+
+    m_VirtualTexture->BeginFeedback();
+    m_VirtualTexture->BindFeedback(*m_FeedbackShader);
+    m_FeedbackShader->SetUniformMat4f("u_ModelViewProjectionMatrix", mvp);
+    renderer.Draw(*m_VertexArray, *m_IndexBuffer, *m_FeedbackShader);
+    m_VirtualTexture->EndFeedback();
+
+    m_VirtualTexture->Update();
+
+    m_VirtualTexture->Bind(*m_Shader);
+    m_Shader->SetUniformMat4f("u_ModelViewProjectionMatrix", mvp);
+    renderer.Draw(*m_VertexArray, *m_IndexBuffer, *m_Shader);
+  }
+
+  void VirtualTextureMap::OnImGuiRender()
+  {
+    const VirtualTextureSource& source = m_VirtualTexture->GetSource();
+    const VirtualTexture::Stats& stats = m_VirtualTexture->GetStats();
+
+    ImGui::Text("Virtual size: %d x %d (%d levels)", source.GetWidth(), source.GetHeight(), source.GetLevelCount());
+    ImGui::Text("Zoom: %.1fx  (scroll to zoom, drag to pan)", m_MapSize / WINDOW_HEIGHT);
+    if (ImGui::Button("Reset view"))
+    {
+      m_Offset = glm::vec2((WINDOW_WIDTH - WINDOW_HEIGHT) / 2.0f, 0.0f);
+      m_MapSize = WINDOW_HEIGHT;
+    }
+    ImGui::Text("Resident pages: %u  Pending: %u", stats.ResidentPages, stats.PendingPages);
+    ImGui::Text("Uploads: %u this frame, %u total  Evictions: %u", stats.UploadsLastFrame, stats.TotalUploads, stats.Evictions);
+    ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+  }
+}
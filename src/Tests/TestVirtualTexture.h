@@ -0,0 +1,41 @@
+#pragma once
+
+#include <memory>
+
+#include <glm/glm.hpp>
+
+#include "Test.h"
+
+#include "IndexBuffer.h"
+#include "Shader.h"
+#include "VertexArray.h"
+#include "VirtualTexture.h"
+
+namespace test
+{
+  // Zoomable map backed by a VirtualTexture. Uses src/resources/map.vtex when present
+  // (see --build-vtex) and otherwise a procedurally generated 60 gigapixel map.
+  class VirtualTextureMap : public Test
+  {
+  private:
+    glm::mat4 m_Projection;
+    glm::vec2 m_Offset;
+    float m_MapSize;
+    std::unique_ptr<VirtualTexture> m_VirtualTexture;
+    std::unique_ptr<VertexArray> m_VertexArray;
+    std::unique_ptr<IndexBuffer> m_IndexBuffer;
+    std::unique_ptr<VertexBuffer> m_VertexBuffer;
+    std::unique_ptr<Shader> m_Shader;
+    std::unique_ptr<Shader> m_FeedbackShader;
+
+  public:
+    VirtualTextureMap();
+    ~VirtualTextureMap();
+
+    void OnUpdate(float deltatime);
+    void OnRender();
+    void OnImGuiRender();
+  private:
+    void ZoomAround(const glm::vec2& point, float factor);
+  };
+}
@@ -0,0 +1,490 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#include <imgui/stb_truetype.h>
+
+#include "JobSystem.h"
+#include "MappedFile.h"
+#include "Renderer.h"
+#include "TextRenderer.h"
+#include "VirtualFileSystem.h"
+
+constexpr uint32_t SdfFont::FIRST_CODEPOINT;
+constexpr uint32_t SdfFont::CODEPOINT_COUNT;
+constexpr int SdfFont::GLYPH_SIZE;
+constexpr int SdfFont::PADDING;
+constexpr int SdfFont::PAGE_SIZE;
+
+namespace
+{
+  constexpr uint32_t SDF_CACHE_MAGIC = 0x46445353; // "SSDF"
+  constexpr uint32_t SDF_CACHE_VERSION = 1;
+
+  // Field value on the outline; it falls to zero PADDING texels outside.
+  constexpr unsigned char ON_EDGE = 128;
+
+  struct CacheHeader
+  {
+    uint32_t Magic;
+    uint32_t Version;
+    uint64_t FontHash;
+    uint32_t GlyphSize, Padding, PageSize;
+    uint32_t FirstCodepoint, CodepointCount;
+    uint32_t PageCount;
+    float Ascent, Descent, LineGap;
+    uint32_t Reserved;
+  };
+
+  const float QUAD_CORNERS[] = {
+    0.0f, 0.0f,
+    1.0f, 0.0f,
+    0.0f, 1.0f,
+    1.0f, 1.0f
+  };
+
+  // FNV-1a, enough to notice the font file changing under the cache.
+  uint64_t HashBytes(const unsigned char* data, size_t size)
+  {
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (size_t i = 0; i < size; i++)
+      hash = (hash ^ data[i]) * 0x100000001b3ull;
+    return hash;
+  }
+
+  // Returns the codepoint text starts with and moves text past it. A malformed sequence gives
+  // U+FFFD and is skipped up to the first byte that doesn't belong to it.
+  uint32_t DecodeUtf8(const char*& text)
+  {
+    const unsigned char* bytes = (const unsigned char*)text;
+    uint32_t first = bytes[0];
+    int length = first < 0x80 ? 1 : (first >> 5) == 0x6 ? 2 : (first >> 4) == 0xE ? 3 : (first >> 3) == 0x1E ? 4 : 0;
+    if (length == 0)
+    {
+      text++;
+      return 0xFFFD;
+    }
+
+    uint32_t codepoint = length == 1 ? first : first & (0x7F >> length);
+    for (int i = 1; i < length; i++)
+    {
+      // Also stops at the terminator.
+      if ((bytes[i] & 0xC0) != 0x80)
+      {
+        text += i;
+        return 0xFFFD;
+      }
+      codepoint = (codepoint << 6) | (bytes[i] & 0x3F);
+    }
+    text += length;
+    return codepoint;
+  }
+
+  // Lays text out from the top left of its first line, calling place(glyph, x, baseline, scale)
+  // for every glyph with an outline. Returns the size of the text's box.
+  template<typename Place>
+  glm::vec2 LayOut(const SdfFont& font, const char* text, float size, const Place& place)
+  {
+    float scale = size / SdfFont::GLYPH_SIZE;
+    float lineHeight = font.GetLineHeight() * scale;
+    float x = 0.0f, width = 0.0f, baseline = font.GetAscent() * scale;
+    unsigned int lines = 1;
+    uint32_t previous = 0;
+    while (*text)
+    {
+      uint32_t codepoint = DecodeUtf8(text);
+      if (codepoint == '\n')
+      {
+        width = std::max(width, x);
+        x = 0.0f;
+        baseline += lineHeight;
+        lines++;
+        previous = 0;
+        continue;
+      }
+
+      if (previous)
+        x += font.GetKerning(previous, codepoint) * scale;
+      const SdfFont::Glyph& glyph = font.GetGlyph(codepoint);
+      if (glyph.Width > 0.0f)
+        place(glyph, x, baseline, scale);
+      x += glyph.Advance * scale;
+      previous = codepoint;
+    }
+    return glm::vec2(std::max(width, x), lines * lineHeight);
+  }
+
+  uint32_t PackColor(const glm::vec4& color)
+  {
+    glm::vec4 bytes = glm::clamp(color, 0.0f, 1.0f) * 255.0f + 0.5f;
+    return (uint32_t)bytes.r | ((uint32_t)bytes.g << 8) | ((uint32_t)bytes.b << 16) | ((uint32_t)bytes.a << 24);
+  }
+}
+
+SdfFont::SdfFont(const std::string& fontPath, const std::string& cachePath)
+  : m_Ascent(0.0f), m_Descent(0.0f), m_LineGap(0.0f), m_Stats{}
+{
+  auto start = std::chrono::high_resolution_clock::now();
+
+  FileView font = VirtualFileSystem::Get().Open(fontPath);
+  if (!font.IsValid())
+  {
+    std::cout << "[ERROR] [TEXT]: Can't open font '" << fontPath << "'" << std::endl;
+    return;
+  }
+
+  uint64_t fontHash = HashBytes(font.Data, font.Size);
+  std::vector<unsigned char> pixels;
+  m_Stats.FromCache = !cachePath.empty() && LoadCache(cachePath, fontHash, pixels);
+  if (!m_Stats.FromCache)
+  {
+    if (!Build(font.Data, pixels))
+    {
+      std::cout << "[ERROR] [TEXT]: '" << fontPath << "' is not a TrueType font" << std::endl;
+      return;
+    }
+    if (!cachePath.empty())
+      SaveCache(cachePath, fontHash, pixels);
+  }
+
+  CreatePages(pixels);
+  m_Stats.Pages = (unsigned int)m_Pages.size();
+  m_Stats.LoadMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+bool SdfFont::Build(const unsigned char* font, std::vector<unsigned char>& pixels)
+{
+  stbtt_fontinfo info;
+  int offset = stbtt_GetFontOffsetForIndex(font, 0);
+  if (offset < 0 || !stbtt_InitFont(&info, font, offset))
+    return false;
+
+  float scale = stbtt_ScaleForPixelHeight(&info, (float)GLYPH_SIZE);
+  int ascent = 0, descent = 0, lineGap = 0;
+  stbtt_GetFontVMetrics(&info, &ascent, &descent, &lineGap);
+  m_Ascent = ascent * scale;
+  m_Descent = -descent * scale;
+  m_LineGap = lineGap * scale;
+
+  // Same boxes stbtt_GetGlyphSDF will produce, so the atlas can be packed before rasterising.
+  // Codepoints the font lacks (like the C1 controls) share the glyph of '?' instead of each
+  // taking space for a copy of the missing glyph box.
+  const uint32_t fallback = '?' - FIRST_CODEPOINT;
+  std::vector<int> glyphIndices(CODEPOINT_COUNT);
+  std::vector<uint32_t> outlined, missing;
+  m_Glyphs.assign(CODEPOINT_COUNT, Glyph{});
+  for (uint32_t i = 0; i < CODEPOINT_COUNT; i++)
+  {
+    int glyphIndex = stbtt_FindGlyphIndex(&info, (int)(FIRST_CODEPOINT + i));
+    glyphIndices[i] = glyphIndex;
+    if (glyphIndex == 0 && i != fallback)
+    {
+      missing.push_back(i);
+      continue;
+    }
+
+    int advance = 0, bearing = 0, x0 = 0, y0 = 0, x1 = 0, y1 = 0;
+    stbtt_GetGlyphHMetrics(&info, glyphIndex, &advance, &bearing);
+    stbtt_GetGlyphBitmapBox(&info, glyphIndex, scale, scale, &x0, &y0, &x1, &y1);
+
+    Glyph& glyph = m_Glyphs[i];
+    glyph.Advance = advance * scale;
+    if (x0 == x1 || y0 == y1)
+      continue;
+    glyph.OffsetX = (float)(x0 - PADDING);
+    glyph.OffsetY = (float)(y0 - PADDING);
+    glyph.Width = (float)(x1 - x0 + 2 * PADDING);
+    glyph.Height = (float)(y1 - y0 + 2 * PADDING);
+    outlined.push_back(i);
+  }
+
+  // Shelf packing, tallest first, with a texel between glyphs so filtering never mixes two.
+  std::stable_sort(outlined.begin(), outlined.end(), [this](uint32_t a, uint32_t b) { return m_Glyphs[a].Height > m_Glyphs[b].Height; });
+  std::vector<int> atlasX(CODEPOINT_COUNT), atlasY(CODEPOINT_COUNT);
+  uint32_t page = 0;
+  int shelfX = 0, shelfY = 0, shelfHeight = 0;
+  for (uint32_t i : outlined)
+  {
+    Glyph& glyph = m_Glyphs[i];
+    int width = (int)glyph.Width, height = (int)glyph.Height;
+    if (shelfX + width > PAGE_SIZE)
+    {
+      shelfX = 0;
+      shelfY += shelfHeight + 1;
+      shelfHeight = 0;
+    }
+    if (shelfY + height > PAGE_SIZE)
+    {
+      page++;
+      shelfX = shelfY = shelfHeight = 0;
+    }
+
+    atlasX[i] = shelfX;
+    atlasY[i] = shelfY;
+    glyph.Page = page;
+    glyph.U0 = (float)shelfX / PAGE_SIZE;
+    glyph.V0 = (float)shelfY / PAGE_SIZE;
+    glyph.U1 = (float)(shelfX + width) / PAGE_SIZE;
+    glyph.V1 = (float)(shelfY + height) / PAGE_SIZE;
+    shelfX += width + 1;
+    shelfHeight = std::max(shelfHeight, height);
+  }
+
+  // Each glyph writes only its own rectangle, so they can all be rasterised at once.
+  pixels.assign((size_t)(page + 1) * PAGE_SIZE * PAGE_SIZE, 0);
+  JobSystem::Get().ParallelFor(outlined.size(), 4, [&](size_t begin, size_t end)
+  {
+    for (size_t k = begin; k < end; k++)
+    {
+      uint32_t i = outlined[k];
+      const Glyph& glyph = m_Glyphs[i];
+      int width = 0, height = 0, xOffset = 0, yOffset = 0;
+      unsigned char* sdf = stbtt_GetGlyphSDF(&info, scale, glyphIndices[i], PADDING, ON_EDGE, (float)ON_EDGE / PADDING,
+        &width, &height, &xOffset, &yOffset);
+      if (!sdf)
+        continue;
+
+      unsigned char* destination = &pixels[((size_t)glyph.Page * PAGE_SIZE + atlasY[i]) * PAGE_SIZE + atlasX[i]];
+      int rowLength = std::min(width, (int)glyph.Width);
+      for (int y = 0; y < std::min(height, (int)glyph.Height); y++)
+        memcpy(destination + (size_t)y * PAGE_SIZE, sdf + (size_t)y * width, rowLength);
+      stbtt_FreeSDF(sdf, nullptr);
+    }
+  });
+
+  for (uint32_t i : missing)
+  {
+    m_Glyphs[i] = m_Glyphs[fallback];
+    glyphIndices[i] = glyphIndices[fallback];
+  }
+
+  // A full table makes the lookup per character pair a single load while shaping. This version
+  // of stb_truetype adds up the kern and GPOS tables when a font has both, where later ones use
+  // GPOS alone, so the kern table is hidden from it in that case.
+  m_Kerning.assign(CODEPOINT_COUNT * CODEPOINT_COUNT, 0.0f);
+  if (info.gpos)
+    info.kern = 0;
+  if (info.kern || info.gpos)
+  {
+    JobSystem::Get().ParallelFor(CODEPOINT_COUNT, 8, [&](size_t begin, size_t end)
+    {
+      for (size_t left = begin; left < end; left++)
+      {
+        for (size_t right = 0; right < CODEPOINT_COUNT; right++)
+          m_Kerning[left * CODEPOINT_COUNT + right] = stbtt_GetGlyphKernAdvance(&info, glyphIndices[left], glyphIndices[right]) * scale;
+      }
+    });
+  }
+  return true;
+}
+
+bool SdfFont::LoadCache(const std::string& cachePath, uint64_t fontHash, std::vector<unsigned char>& pixels)
+{
+  MappedFile file(cachePath);
+  if (!file.IsValid() || file.GetSize() < sizeof(CacheHeader))
+    return false;
+
+  const CacheHeader* header = (const CacheHeader*)file.GetData();
+  size_t glyphBytes = CODEPOINT_COUNT * sizeof(Glyph);
+  size_t kerningBytes = CODEPOINT_COUNT * CODEPOINT_COUNT * sizeof(float);
+  size_t pixelBytes = (size_t)header->PageCount * PAGE_SIZE * PAGE_SIZE;
+  if (header->Magic != SDF_CACHE_MAGIC || header->Version != SDF_CACHE_VERSION || header->FontHash != fontHash ||
+    header->GlyphSize != GLYPH_SIZE || header->Padding != PADDING || header->PageSize != PAGE_SIZE ||
+    header->FirstCodepoint != FIRST_CODEPOINT || header->CodepointCount != CODEPOINT_COUNT || header->PageCount == 0 ||
+    file.GetSize() != sizeof(CacheHeader) + glyphBytes + kerningBytes + pixelBytes)
+    return false;
+
+  const unsigned char* data = file.GetData() + sizeof(CacheHeader);
+  m_Glyphs.resize(CODEPOINT_COUNT);
+  memcpy(m_Glyphs.data(), data, glyphBytes);
+  // Drawing indexes the pages by glyph, so one bad page number would read past them.
+  for (const Glyph& glyph : m_Glyphs)
+  {
+    if (glyph.Page >= header->PageCount)
+    {
+      std::cout << "[ERROR] [TEXT]: Font cache '" << cachePath << "' has a glyph on page " << glyph.Page << " of " << header->PageCount << ", rebuilding it" << std::endl;
+      m_Glyphs.clear();
+      return false;
+    }
+  }
+  m_Kerning.resize(CODEPOINT_COUNT * CODEPOINT_COUNT);
+  memcpy(m_Kerning.data(), data + glyphBytes, kerningBytes);
+  pixels.assign(data + glyphBytes + kerningBytes, data + glyphBytes + kerningBytes + pixelBytes);
+  m_Ascent = header->Ascent;
+  m_Descent = header->Descent;
+  m_LineGap = header->LineGap;
+  return true;
+}
+
+void SdfFont::SaveCache(const std::string& cachePath, uint64_t fontHash, const std::vector<unsigned char>& pixels) const
+{
+  std::ofstream stream(cachePath, std::ios::binary | std::ios::trunc);
+  CacheHeader header = { SDF_CACHE_MAGIC, SDF_CACHE_VERSION, fontHash, GLYPH_SIZE, PADDING, PAGE_SIZE,
+    FIRST_CODEPOINT, CODEPOINT_COUNT, (uint32_t)(pixels.size() / ((size_t)PAGE_SIZE * PAGE_SIZE)), m_Ascent, m_Descent, m_LineGap, 0 };
+  stream.write((const char*)&header, sizeof(header));
+  stream.write((const char*)m_Glyphs.data(), m_Glyphs.size() * sizeof(Glyph));
+  stream.write((const char*)m_Kerning.data(), m_Kerning.size() * sizeof(float));
+  stream.write((const char*)pixels.data(), pixels.size());
+  if (!stream)
+    std::cout << "[ERROR] [TEXT]: Can't write font cache '" << cachePath << "'" << std::endl;
+}
+
+void SdfFont::CreatePages(const std::vector<unsigned char>& pixels)
+{
+  // Mipmapped: averaging a distance field still gives a usable one, and small text shimmers less.
+  size_t pageBytes = (size_t)PAGE_SIZE * PAGE_SIZE;
+  for (size_t offset = 0; offset + pageBytes <= pixels.size(); offset += pageBytes)
+  {
+    std::unique_ptr<RenderTexture> page(new RenderTexture(PAGE_SIZE, PAGE_SIZE, GL_R8, Texture::GetMipLevelCount(PAGE_SIZE, PAGE_SIZE)));
+    page->Bind();
+    OpenGLCall(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+    OpenGLCall(glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, PAGE_SIZE, PAGE_SIZE, GL_RED, GL_UNSIGNED_BYTE, &pixels[offset]));
+    OpenGLCall(glPixelStorei(GL_UNPACK_ALIGNMENT, 4));
+    page->GenerateMipmaps();
+    m_Pages.push_back(std::move(page));
+  }
+}
+
+TextRenderer::TextRenderer(std::unique_ptr<SdfFont> font)
+  : m_Font(std::move(font)), m_Stats{}
+{
+  m_Batches.resize(m_Font->GetPageCount());
+  m_Quad = std::make_unique<VertexBuffer>(QUAD_CORNERS, (unsigned int)sizeof(QUAD_CORNERS));
+  m_Instances = std::make_unique<VertexBuffer>(nullptr, 4096 * (unsigned int)sizeof(GlyphInstance), BufferUsage::Stream);
+
+  unsigned int id = 0;
+  OpenGLCall(glGenVertexArrays(1, &id));
+  m_VertexArray.Reset(id);
+  OpenGLCall(glBindVertexArray(id));
+  m_Quad->Bind();
+  OpenGLCall(glEnableVertexAttribArray(0));
+  OpenGLCall(glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (const void*)(size_t)m_Quad->GetOffset()));
+  for (unsigned int location = 1; location <= 3; location++)
+  {
+    OpenGLCall(glEnableVertexAttribArray(location));
+    OpenGLCall(glVertexAttribDivisor(location, 1));
+  }
+  SetInstanceOffset(0);
+  OpenGLCall(glBindVertexArray(0));
+
+  m_Shader = std::make_unique<Shader>("src/resources/Text.vert", "src/resources/Text.frag");
+}
+
+float TextRenderer::AddText(const char* text, const glm::vec2& position, float size, const glm::vec4& color)
+{
+  if (!m_Font->IsValid())
+    return 0.0f;
+
+  uint32_t packedColor = PackColor(color);
+  glm::vec2 extent = LayOut(*m_Font, text, size, [&](const SdfFont::Glyph& glyph, float x, float baseline, float scale)
+  {
+    float left = position.x + x + glyph.OffsetX * scale;
+    float top = position.y + baseline + glyph.OffsetY * scale;
+    m_Batches[glyph.Page].push_back({ glm::vec4(left, top, left + glyph.Width * scale, top + glyph.Height * scale),
+      glm::vec4(glyph.U0, glyph.V0, glyph.U1, glyph.V1), packedColor });
+  });
+  return extent.x;
+}
+
+glm::vec2 TextRenderer::MeasureText(const char* text, float size) const
+{
+  if (!m_Font->IsValid())
+    return glm::vec2(0.0f);
+  return LayOut(*m_Font, text, size, [](const SdfFont::Glyph&, float, float, float) {});
+}
+
+void TextRenderer::Render(const glm::mat4& projection)
+{
+  size_t count = 0;
+  for (const std::vector<GlyphInstance>& batch : m_Batches)
+    count += batch.size();
+
+  m_Stats = {};
+  m_Stats.Glyphs = (unsigned int)count;
+  if (count == 0)
+    return;
+
+  unsigned int size = (unsigned int)(count * sizeof(GlyphInstance));
+  if (size > m_Instances->GetSize())
+    m_Instances->SetData(nullptr, std::max(size, m_Instances->GetSize() * 2));
+
+  // Losing the contents while mapped is rare enough that skipping a frame of text is fine.
+  GlyphInstance* destination = (GlyphInstance*)m_Instances->Map(size);
+  if (!destination)
+  {
+    Clear();
+    return;
+  }
+  for (const std::vector<GlyphInstance>& batch : m_Batches)
+  {
+    if (!batch.empty())
+      memcpy(destination, batch.data(), batch.size() * sizeof(GlyphInstance));
+    destination += batch.size();
+  }
+  if (!m_Instances->Unmap())
+  {
+    Clear();
+    return;
+  }
+  m_Stats.BufferBytes = size;
+
+  OpenGLCall(GLboolean blendEnabled = glIsEnabled(GL_BLEND));
+  OpenGLCall(GLboolean depthTestEnabled = glIsEnabled(GL_DEPTH_TEST));
+  GLint blendSource = GL_ONE, blendDestination = GL_ZERO;
+  OpenGLCall(glGetIntegerv(GL_BLEND_SRC_RGB, &blendSource));
+  OpenGLCall(glGetIntegerv(GL_BLEND_DST_RGB, &blendDestination));
+  OpenGLCall(glEnable(GL_BLEND));
+  OpenGLCall(glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA));
+  OpenGLCall(glDisable(GL_DEPTH_TEST));
+
+  Shader& shader = *m_Shader;
+  shader.Bind();
+  shader.SetUniformMat4f("u_Projection", projection);
+  shader.SetUniform1i("u_Atlas", 0);
+
+  // Pages were written back to back, so each draw just moves the instance attributes along.
+  OpenGLCall(glBindVertexArray(m_VertexArray.Get()));
+  size_t first = 0;
+  for (size_t page = 0; page < m_Batches.size(); page++)
+  {
+    size_t pageCount = m_Batches[page].size();
+    if (pageCount == 0)
+      continue;
+
+    m_Font->GetPage(page).Bind(0);
+    SetInstanceOffset(first);
+    OpenGLCall(glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, (GLsizei)pageCount));
+    m_Stats.DrawCalls++;
+    first += pageCount;
+  }
+  OpenGLCall(glBindVertexArray(0));
+
+  OpenGLCall(glBlendFunc(blendSource, blendDestination));
+  if (!blendEnabled)
+  {
+    OpenGLCall(glDisable(GL_BLEND));
+  }
+  if (depthTestEnabled)
+  {
+    OpenGLCall(glEnable(GL_DEPTH_TEST));
+  }
+  Clear();
+}
+
+void TextRenderer::Clear()
+{
+  for (std::vector<GlyphInstance>& batch : m_Batches)
+    batch.clear();
+}
+
+void TextRenderer::SetInstanceOffset(size_t firstInstance) const
+{
+  size_t base = firstInstance * sizeof(GlyphInstance);
+  m_Instances->Bind();
+  OpenGLCall(glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(GlyphInstance), (const void*)(base + offsetof(GlyphInstance, Rect))));
+  OpenGLCall(glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(GlyphInstance), (const void*)(base + offsetof(GlyphInstance, TexCoords))));
+  OpenGLCall(glVertexAttribPointer(3, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(GlyphInstance), (const void*)(base + offsetof(GlyphInstance, Color))));
+}
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "GLHandle.h"
+#include "RenderTexture.h"
+#include "Shader.h"
+#include "VertexBuffer.h"
+
+// Signed distance field atlas of a TrueType font's Latin-1 glyphs, rasterised once at GLYPH_SIZE
+// pixels with stb_truetype. The field reaches PADDING texels either side of each outline, which
+// is what lets bilinear samples rebuild sharp edges at any scale. Glyphs are rasterised as jobs on
+// the JobSystem workers, and the finished atlas is written to a cache file that later runs load
+// instead, as long as the font file hasn't changed.
+class SdfFont
+{
+public:
+  static constexpr uint32_t FIRST_CODEPOINT = 32;
+  static constexpr uint32_t CODEPOINT_COUNT = 224; // Up to U+00FF.
+  static constexpr int GLYPH_SIZE = 48;
+  static constexpr int PADDING = 6;
+  static constexpr int PAGE_SIZE = 1024;
+
+  // Metrics in pixels at GLYPH_SIZE, y down.
+  struct Glyph
+  {
+    float Advance;
+    float OffsetX, OffsetY; // Top left of the quad from the pen on the baseline.
+    float Width, Height;    // Zero for glyphs without an outline, like the space.
+    float U0, V0, U1, V1;
+    uint32_t Page;
+  };
+
+  struct Stats
+  {
+    unsigned int Pages;
+    bool FromCache;
+    double LoadMilliseconds;
+  };
+
+private:
+  std::vector<Glyph> m_Glyphs; // By codepoint minus FIRST_CODEPOINT.
+  std::vector<float> m_Kerning; // CODEPOINT_COUNT squared, indexed by the left glyph first.
+  std::vector<std::unique_ptr<RenderTexture>> m_Pages;
+  float m_Ascent, m_Descent, m_LineGap; // Ascent and descent both positive.
+  Stats m_Stats;
+
+public:
+  // Loads the atlas from cachePath if it was built from this font file, otherwise builds it and
+  // writes it there. An empty cachePath skips the cache.
+  SdfFont(const std::string& fontPath, const std::string& cachePath = "");
+
+  SdfFont(const SdfFont&) = delete;
+  SdfFont& operator=(const SdfFont&) = delete;
+
+  inline bool IsValid() const { return !m_Pages.empty(); }
+  // Codepoints outside the atlas get the glyph of '?'.
+  inline const Glyph& GetGlyph(uint32_t codepoint) const { return m_Glyphs[GetIndex(codepoint)]; }
+  inline float GetKerning(uint32_t left, uint32_t right) const { return m_Kerning[GetIndex(left) * CODEPOINT_COUNT + GetIndex(right)]; }
+  inline float GetAscent() const { return m_Ascent; }
+  inline float GetDescent() const { return m_Descent; }
+  inline float GetLineHeight() const { return m_Ascent + m_Descent + m_LineGap; }
+  inline size_t GetPageCount() const { return m_Pages.size(); }
+  inline const RenderTexture& GetPage(size_t page) const { return *m_Pages[page]; }
+
+  inline const Stats& GetStats() const { return m_Stats; }
+private:
+  static inline uint32_t GetIndex(uint32_t codepoint)
+  {
+    return codepoint - FIRST_CODEPOINT < CODEPOINT_COUNT ? codepoint - FIRST_CODEPOINT : '?' - FIRST_CODEPOINT;
+  }
+
+  bool Build(const unsigned char* font, std::vector<unsigned char>& pixels);
+  bool LoadCache(const std::string& cachePath, uint64_t fontHash, std::vector<unsigned char>& pixels);
+  void SaveCache(const std::string& cachePath, uint64_t fontHash, const std::vector<unsigned char>& pixels) const;
+  void CreatePages(const std::vector<unsigned char>& pixels);
+};
+
+// Draws strings from an SdfFont. AddText shapes a UTF-8 string into one instance per glyph, kerned,
+// and files it under the glyph's atlas page; Render streams every instance queued that frame into
+// one mapped vertex buffer and draws each page with a single instanced call. Positions and sizes are
+// in the projection's units with y down, so glm::ortho(0, width, height, 0) draws in pixels.
+// Edges are antialiased over one screen pixel whatever the scale.
+class TextRenderer
+{
+public:
+  struct Stats
+  {
+    unsigned int Glyphs;
+    unsigned int DrawCalls;
+    unsigned int BufferBytes;
+  };
+
+private:
+  struct GlyphInstance
+  {
+    glm::vec4 Rect;      // Top left and bottom right corners.
+    glm::vec4 TexCoords; // Matching corners in the atlas page.
+    uint32_t Color;      // RGBA8.
+  };
+
+  std::unique_ptr<SdfFont> m_Font;
+  std::vector<std::vector<GlyphInstance>> m_Batches; // One per atlas page, kept to reuse their memory.
+  std::unique_ptr<VertexBuffer> m_Quad;
+  std::unique_ptr<VertexBuffer> m_Instances;
+  VertexArrayHandle m_VertexArray;
+  std::unique_ptr<Shader> m_Shader;
+  Stats m_Stats;
+
+public:
+  explicit TextRenderer(std::unique_ptr<SdfFont> font);
+
+  inline const SdfFont& GetFont() const { return *m_Font; }
+
+  // Queues text with the top left of its first line at position, size being the font's pixel
+  // height. Lines break at '\n'. Returns the width of the widest line.
+  float AddText(const char* text, const glm::vec2& position, float size, const glm::vec4& color = glm::vec4(1.0f));
+  glm::vec2 MeasureText(const char* text, float size) const;
+
+  // Draws and clears everything queued, alpha blended without depth testing. Restores the blend
+  // and depth state afterwards.
+  void Render(const glm::mat4& projection);
+  void Clear();
+
+  inline const Stats& GetStats() const { return m_Stats; }
+private:
+  void SetInstanceOffset(size_t firstInstance) const;
+};
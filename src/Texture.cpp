@@ -1,48 +1,171 @@
-#include "stb_image/stb_image.h"
+#include <algorithm>
 
 #include "Texture.h"
 
-Texture::Texture(const std::string& filepath)
-  : m_RendererId(0), m_FilePath(filepath), m_LocalBuffer(nullptr), 
-    m_Width(0), m_Height(0), m_BytesPerPixel(0)
+Texture::Texture(unsigned int target)
+  : m_Target(target), m_InternalFormat(0), m_Width(0), m_Height(0), m_Depth(0), m_Levels(0), m_Samples(0)
 {
-  stbi_set_flip_vertically_on_load(1);
-  m_LocalBuffer = stbi_load(m_FilePath.c_str(), &m_Width, &m_Height, &m_BytesPerPixel, 4);
+}
 
-  OpenGLCall(glGenTextures(1, &m_RendererId));
-  OpenGLCall(glBindTexture(GL_TEXTURE_2D, m_RendererId));
+void Texture::Create(unsigned int internalFormat, int width, int height, int depth, int levels, int samples)
+{
+  m_InternalFormat = internalFormat;
+  m_Width = width;
+  m_Height = height;
+  m_Depth = depth;
+  m_Levels = levels;
+  m_Samples = samples;
 
-  OpenGLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
-  OpenGLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
-  OpenGLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
-  OpenGLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+  unsigned int id = 0;
+  OpenGLCall(glGenTextures(1, &id));
+  m_RendererId.Reset(id);
+  OpenGLCall(glBindTexture(m_Target, id));
 
-  OpenGLCall(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, m_Width, m_Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, m_LocalBuffer));
+  if (m_Target == GL_TEXTURE_2D_MULTISAMPLE)
+  {
+    if (GLEW_ARB_texture_storage_multisample)
+    {
+      OpenGLCall(glTexStorage2DMultisample(m_Target, samples, internalFormat, width, height, GL_TRUE));
+    }
+    else
+    {
+      OpenGLCall(glTexImage2DMultisample(m_Target, samples, internalFormat, width, height, GL_TRUE));
+    }
+    return;
+  }
 
-  if (m_LocalBuffer)
+  if (GLEW_ARB_texture_storage)
   {
-    stbi_image_free(m_LocalBuffer);
+    switch (m_Target)
+    {
+      case GL_TEXTURE_3D:
+      case GL_TEXTURE_2D_ARRAY:
+        OpenGLCall(glTexStorage3D(m_Target, levels, internalFormat, width, height, depth));
+        break;
+      default:
+        OpenGLCall(glTexStorage2D(m_Target, levels, internalFormat, width, height));
+        break;
+    }
+    return;
   }
-  else
+
+  // Mutable fallback: define every level up front and clamp the level range so the texture is complete.
+  unsigned int format = GetFormatForInternalFormat(internalFormat);
+  unsigned int type = GetTypeForInternalFormat(internalFormat);
+  for (int level = 0; level < levels; level++)
   {
-    std::cout << "\nError: Failed to load texture" << std::endl;
-    std::cout << stbi_failure_reason() << std::endl;
-    __debugbreak();
+    int levelWidth = std::max(1, width >> level), levelHeight = std::max(1, height >> level);
+    switch (m_Target)
+    {
+      case GL_TEXTURE_3D:
+        OpenGLCall(glTexImage3D(m_Target, level, internalFormat, levelWidth, levelHeight, std::max(1, depth >> level), 0, format, type, nullptr));
+        break;
+      case GL_TEXTURE_2D_ARRAY:
+        OpenGLCall(glTexImage3D(m_Target, level, internalFormat, levelWidth, levelHeight, depth, 0, format, type, nullptr));
+        break;
+      case GL_TEXTURE_CUBE_MAP:
+        for (int face = 0; face < 6; face++)
+        {
+          OpenGLCall(glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, level, internalFormat, levelWidth, levelHeight, 0, format, type, nullptr));
+        }
+        break;
+      default:
+        OpenGLCall(glTexImage2D(m_Target, level, internalFormat, levelWidth, levelHeight, 0, format, type, nullptr));
+        break;
+    }
   }
+  OpenGLCall(glTexParameteri(m_Target, GL_TEXTURE_BASE_LEVEL, 0));
+  OpenGLCall(glTexParameteri(m_Target, GL_TEXTURE_MAX_LEVEL, levels - 1));
 }
 
-Texture::~Texture()
+void Texture::SetFilter(unsigned int minFilter, unsigned int magFilter) const
 {
-  OpenGLCall(glDeleteTextures(1, &m_RendererId));
+  OpenGLCall(glTexParameteri(m_Target, GL_TEXTURE_MIN_FILTER, minFilter));
+  OpenGLCall(glTexParameteri(m_Target, GL_TEXTURE_MAG_FILTER, magFilter));
+}
+
+void Texture::SetWrap(unsigned int wrap) const
+{
+  OpenGLCall(glTexParameteri(m_Target, GL_TEXTURE_WRAP_S, wrap));
+  OpenGLCall(glTexParameteri(m_Target, GL_TEXTURE_WRAP_T, wrap));
+  if (m_Target == GL_TEXTURE_3D || m_Target == GL_TEXTURE_CUBE_MAP)
+  {
+    OpenGLCall(glTexParameteri(m_Target, GL_TEXTURE_WRAP_R, wrap));
+  }
 }
 
 void Texture::Bind(unsigned int slot) const
 {
   OpenGLCall(glActiveTexture(GL_TEXTURE0 + slot));
-  OpenGLCall(glBindTexture(GL_TEXTURE_2D, m_RendererId));
+  OpenGLCall(glBindTexture(m_Target, m_RendererId.Get()));
 }
 
 void Texture::Unbind() const
 {
-  OpenGLCall(glBindTexture(GL_TEXTURE_2D, 0));
+  OpenGLCall(glBindTexture(m_Target, 0));
+}
+
+size_t Texture::GetMemorySize() const
+{
+  size_t size = 0;
+  int layers = m_Target == GL_TEXTURE_2D_ARRAY ? m_Depth : 1;
+  for (int level = 0; level < m_Levels; level++)
+  {
+    size_t width = std::max(1, m_Width >> level), height = std::max(1, m_Height >> level);
+    size_t depth = m_Target == GL_TEXTURE_3D ? std::max(1, m_Depth >> level) : layers;
+    size += width * height * depth * GetBytesPerTexel(m_InternalFormat);
+  }
+  if (m_Target == GL_TEXTURE_CUBE_MAP)
+    size *= 6;
+  return m_Samples > 1 ? size * m_Samples : size;
+}
+
+int Texture::GetMipLevelCount(int width, int height, int depth)
+{
+  int levels = 1;
+  for (int size = std::max(width, std::max(height, depth)); size > 1; size /= 2)
+    levels++;
+  return levels;
+}
+
+int Texture::GetBytesPerTexel(unsigned int internalFormat)
+{
+  switch (internalFormat)
+  {
+    case GL_R8: return 1;
+    case GL_RG8: case GL_R16F: return 2;
+    // Drivers pad three channel formats to four bytes per texel.
+    case GL_RGB8: case GL_RGBA8: case GL_SRGB8: case GL_SRGB8_ALPHA8: case GL_R32F: case GL_RG16F:
+    case GL_R11F_G11F_B10F: case GL_RGB10_A2: case GL_DEPTH24_STENCIL8: case GL_DEPTH_COMPONENT24:
+    case GL_DEPTH_COMPONENT32F: return 4;
+    case GL_RGBA16F: case GL_RGB16F: case GL_RG32F: case GL_DEPTH32F_STENCIL8: return 8;
+    case GL_RGBA32F: case GL_RGB32F: return 16;
+    default: return 4;
+  }
+}
+
+unsigned int Texture::GetFormatForInternalFormat(unsigned int internalFormat)
+{
+  switch (internalFormat)
+  {
+    case GL_R8: case GL_R16F: case GL_R32F: return GL_RED;
+    case GL_RG8: case GL_RG16F: case GL_RG32F: return GL_RG;
+    case GL_RGB8: case GL_SRGB8: case GL_RGB16F: case GL_RGB32F: case GL_R11F_G11F_B10F: return GL_RGB;
+    case GL_DEPTH_COMPONENT24: case GL_DEPTH_COMPONENT32F: return GL_DEPTH_COMPONENT;
+    case GL_DEPTH24_STENCIL8: case GL_DEPTH32F_STENCIL8: return GL_DEPTH_STENCIL;
+    default: return GL_RGBA;
+  }
+}
+
+unsigned int Texture::GetTypeForInternalFormat(unsigned int internalFormat)
+{
+  switch (internalFormat)
+  {
+    case GL_R16F: case GL_RG16F: case GL_RGB16F: case GL_RGBA16F: case GL_R11F_G11F_B10F: return GL_HALF_FLOAT;
+    case GL_R32F: case GL_RG32F: case GL_RGB32F: case GL_RGBA32F: case GL_DEPTH_COMPONENT32F: return GL_FLOAT;
+    case GL_DEPTH_COMPONENT24: return GL_UNSIGNED_INT;
+    case GL_DEPTH24_STENCIL8: return GL_UNSIGNED_INT_24_8;
+    case GL_DEPTH32F_STENCIL8: return GL_FLOAT_32_UNSIGNED_INT_24_8_REV;
+    default: return GL_UNSIGNED_BYTE;
+  }
 }
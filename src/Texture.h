@@ -1,22 +1,53 @@
 #pragma once
 
+#include "GLHandle.h"
 #include "Renderer.h"
 
+// Base of every texture type. Owns the GL texture object and allocates immutable storage,
+// so a texture's size and format are fixed once created and never re-specified per frame.
 class Texture
 {
-private:
-  unsigned int m_RendererId;
-  std::string m_FilePath;
-  unsigned char* m_LocalBuffer;
-  int m_Width, m_Height, m_BytesPerPixel;
+protected:
+  TextureHandle m_RendererId;
+  unsigned int m_Target;
+  unsigned int m_InternalFormat;
+  int m_Width, m_Height, m_Depth;
+  int m_Levels;
+  int m_Samples;
 
 public:
-  Texture(const std::string& filepath);
-  ~Texture();
+  virtual ~Texture() = default;
 
   void Bind(unsigned int slot = 0) const;
   void Unbind() const;
 
+  // Estimated VRAM usage of all levels (and faces) in bytes.
+  size_t GetMemorySize() const;
+
+  inline unsigned int GetRendererId() const { return m_RendererId.Get(); }
+  inline unsigned int GetTarget() const { return m_Target; }
+  inline unsigned int GetInternalFormat() const { return m_InternalFormat; }
   inline int GetWidth() const { return m_Width; }
   inline int GetHeight() const { return m_Height; }
-};
\ No newline at end of file
+  inline int GetDepth() const { return m_Depth; }
+  inline int GetLevels() const { return m_Levels; }
+  inline int GetSamples() const { return m_Samples; }
+
+  // Number of levels in a full mip chain down to 1x1(x1).
+  static int GetMipLevelCount(int width, int height, int depth = 1);
+  static int GetBytesPerTexel(unsigned int internalFormat);
+  // Client format and type matching an internal format, as used for uploads and read backs.
+  static unsigned int GetFormatForInternalFormat(unsigned int internalFormat);
+  static unsigned int GetTypeForInternalFormat(unsigned int internalFormat);
+protected:
+  Texture(unsigned int target);
+  // Protected so textures only move as their concrete type and never slice.
+  Texture(Texture&&) = default;
+  Texture& operator=(Texture&&) = default;
+
+  // Generates a fresh texture object (deleting any previous one) and allocates immutable storage
+  // for it. Falls back to specifying every level with glTexImage when ARB_texture_storage is missing.
+  void Create(unsigned int internalFormat, int width, int height, int depth, int levels, int samples = 0);
+  void SetFilter(unsigned int minFilter, unsigned int magFilter) const;
+  void SetWrap(unsigned int wrap) const;
+};
@@ -0,0 +1,113 @@
+#include <vector>
+
+#include "ImageDecoder.h"
+#include "Texture2D.h"
+#include "VirtualFileSystem.h"
+
+static unsigned int GetInternalFormatForChannels(int channels)
+{
+  switch (channels)
+  {
+    case 1: return GL_R8;
+    case 2: return GL_RG8;
+    case 3: return GL_RGB8;
+    default: return GL_RGBA8;
+  }
+}
+
+Texture2D::Texture2D(const std::string& filepath)
+  : Texture(GL_TEXTURE_2D), m_FilePath(filepath), m_BytesPerPixel(0), m_DroppedMipLevels(0)
+{
+  LoadFromFile();
+}
+
+void Texture2D::Allocate(int width, int height)
+{
+  Create(GetInternalFormatForChannels(m_BytesPerPixel), width, height, 1, GetMipLevelCount(width, height));
+  SetFilter(GL_LINEAR_MIPMAP_LINEAR, GL_LINEAR);
+  SetWrap(GL_CLAMP_TO_EDGE);
+
+  // Single and dual channel images are stored compactly and expanded to grey (+ alpha) on sampling.
+  if (m_BytesPerPixel <= 2)
+  {
+    GLint swizzle[4] = { GL_RED, GL_RED, GL_RED, m_BytesPerPixel == 2 ? GL_GREEN : GL_ONE };
+    OpenGLCall(glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, swizzle));
+  }
+}
+
+void Texture2D::LoadFromFile()
+{
+  FileView file = VirtualFileSystem::Get().Open(m_FilePath);
+  const ImageDecoder* decoder = file.IsValid() ? ImageDecoder::Find(file.Data, file.Size) : nullptr;
+
+  ImageInfo info;
+  if (!decoder || !decoder->ReadInfo(file.Data, file.Size, info))
+  {
+    std::cout << "\nError: Failed to load texture" << std::endl;
+    std::cout << "Unsupported or missing image: " << m_FilePath << std::endl;
+    __debugbreak();
+    return;
+  }
+
+  m_BytesPerPixel = info.Channels;
+  size_t size = (size_t)info.Width * info.Height * m_BytesPerPixel;
+  Allocate(info.Width, info.Height);
+
+  // Decode straight into a mapped pixel unpack buffer, the upload then needs no staging copy.
+  unsigned int pixelBuffer;
+  OpenGLCall(glGenBuffers(1, &pixelBuffer));
+  OpenGLCall(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pixelBuffer));
+  OpenGLCall(glBufferData(GL_PIXEL_UNPACK_BUFFER, size, nullptr, GL_STREAM_DRAW));
+  OpenGLCall(unsigned char* pixels = (unsigned char*)glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
+  bool decoded = pixels && decoder->Decode(file.Data, file.Size, pixels, size, m_BytesPerPixel, true);
+  OpenGLCall(glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER));
+
+  OpenGLCall(glBindTexture(GL_TEXTURE_2D, m_RendererId.Get()));
+  OpenGLCall(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+  OpenGLCall(glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, m_Width, m_Height, GetFormatForInternalFormat(m_InternalFormat), GL_UNSIGNED_BYTE, nullptr));
+  OpenGLCall(glPixelStorei(GL_UNPACK_ALIGNMENT, 4));
+  OpenGLCall(glGenerateMipmap(GL_TEXTURE_2D));
+  m_DroppedMipLevels = 0;
+
+  OpenGLCall(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0));
+  OpenGLCall(glDeleteBuffers(1, &pixelBuffer));
+
+  if (!decoded)
+  {
+    std::cout << "\nError: Failed to load texture" << std::endl;
+    std::cout << decoder->GetName() << ": " << decoder->GetFailureReason() << std::endl;
+    __debugbreak();
+  }
+}
+
+bool Texture2D::DropMipLevel(int minimumSize)
+{
+  if (m_Width <= minimumSize || m_Height <= minimumSize)
+    return false;
+
+  int width = m_Width / 2;
+  int height = m_Height / 2;
+  unsigned int format = GetFormatForInternalFormat(m_InternalFormat);
+
+  // Immutable storage can't shrink, so read mip level 1 back and move it into a smaller texture.
+  std::vector<unsigned char> pixels((size_t)width * height * m_BytesPerPixel);
+  OpenGLCall(glBindTexture(GL_TEXTURE_2D, m_RendererId.Get()));
+  OpenGLCall(glPixelStorei(GL_PACK_ALIGNMENT, 1));
+  OpenGLCall(glGetTexImage(GL_TEXTURE_2D, 1, format, GL_UNSIGNED_BYTE, pixels.data()));
+  OpenGLCall(glPixelStorei(GL_PACK_ALIGNMENT, 4));
+
+  Allocate(width, height);
+  OpenGLCall(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+  OpenGLCall(glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, format, GL_UNSIGNED_BYTE, pixels.data()));
+  OpenGLCall(glPixelStorei(GL_UNPACK_ALIGNMENT, 4));
+  OpenGLCall(glGenerateMipmap(GL_TEXTURE_2D));
+
+  m_DroppedMipLevels++;
+  return true;
+}
+
+void Texture2D::Restore()
+{
+  if (m_DroppedMipLevels > 0)
+    LoadFromFile();
+}
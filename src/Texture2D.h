@@ -0,0 +1,30 @@
+#pragma once
+
+#include <string>
+
+#include "Texture.h"
+
+// A mipmapped 2D texture loaded from an image file through the VirtualFileSystem.
+class Texture2D : public Texture
+{
+private:
+  std::string m_FilePath;
+  int m_BytesPerPixel;
+  int m_DroppedMipLevels;
+
+public:
+  Texture2D(const std::string& filepath);
+
+  // Replaces the texture with its next mip level, halving width and height.
+  // Returns false once the texture is already at or below minimumSize.
+  bool DropMipLevel(int minimumSize);
+  // Reloads the full resolution image after mip levels were dropped.
+  void Restore();
+
+  inline const std::string& GetFilePath() const { return m_FilePath; }
+  inline int GetDroppedMipLevels() const { return m_DroppedMipLevels; }
+private:
+  void LoadFromFile();
+  // Allocates immutable storage for the whole mip chain and sets the sampling state.
+  void Allocate(int width, int height);
+};
@@ -0,0 +1,57 @@
+#include <vector>
+
+#include "ImageDecoder.h"
+#include "Texture3D.h"
+#include "VirtualFileSystem.h"
+
+Texture3D::Texture3D(int width, int height, int depth, unsigned int internalFormat, int levels)
+  : Texture(GL_TEXTURE_3D)
+{
+  Create(internalFormat, width, height, depth, levels);
+  SetFilter(levels > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR, GL_LINEAR);
+  SetWrap(GL_CLAMP_TO_EDGE);
+}
+
+void Texture3D::SetData(const void* data, unsigned int format, unsigned int type)
+{
+  OpenGLCall(glBindTexture(GL_TEXTURE_3D, m_RendererId.Get()));
+  OpenGLCall(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+  OpenGLCall(glTexSubImage3D(GL_TEXTURE_3D, 0, 0, 0, 0, m_Width, m_Height, m_Depth, format, type, data));
+  OpenGLCall(glPixelStorei(GL_UNPACK_ALIGNMENT, 4));
+}
+
+std::unique_ptr<Texture3D> Texture3D::LoadLut(const std::string& filepath)
+{
+  FileView file = VirtualFileSystem::Get().Open(filepath);
+  const ImageDecoder* decoder = file.IsValid() ? ImageDecoder::Find(file.Data, file.Size) : nullptr;
+
+  ImageInfo info;
+  if (!decoder || !decoder->ReadInfo(file.Data, file.Size, info) || info.Width != info.Height * info.Height)
+  {
+    std::cout << "[ERROR] [OPENGL]: '" << filepath << "' is not an N*N x N lookup table strip" << std::endl;
+    return nullptr;
+  }
+
+  // Top row first, so green increases with the row index.
+  std::vector<unsigned char> strip((size_t)info.Width * info.Height * 3);
+  if (!decoder->Decode(file.Data, file.Size, strip.data(), strip.size(), 3, false))
+    return nullptr;
+
+  int size = info.Height;
+  std::unique_ptr<Texture3D> lut(new Texture3D(size, size, size, GL_RGB8));
+
+  // Each slice is a size x size window into the strip, so upload it in place using the unpack row length.
+  OpenGLCall(glBindTexture(GL_TEXTURE_3D, lut->m_RendererId.Get()));
+  OpenGLCall(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+  OpenGLCall(glPixelStorei(GL_UNPACK_ROW_LENGTH, info.Width));
+  for (int slice = 0; slice < size; slice++)
+  {
+    OpenGLCall(glPixelStorei(GL_UNPACK_SKIP_PIXELS, slice * size));
+    OpenGLCall(glTexSubImage3D(GL_TEXTURE_3D, 0, 0, 0, slice, size, size, 1, GL_RGB, GL_UNSIGNED_BYTE, strip.data()));
+  }
+  OpenGLCall(glPixelStorei(GL_UNPACK_ROW_LENGTH, 0));
+  OpenGLCall(glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0));
+  OpenGLCall(glPixelStorei(GL_UNPACK_ALIGNMENT, 4));
+
+  return lut;
+}
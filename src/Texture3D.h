@@ -0,0 +1,20 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "Texture.h"
+
+// Volume texture, used for colour grading lookup tables and volume data.
+class Texture3D : public Texture
+{
+public:
+  Texture3D(int width, int height, int depth, unsigned int internalFormat, int levels = 1);
+
+  // Replaces level 0 with tightly packed data in the given client format and type.
+  void SetData(const void* data, unsigned int format, unsigned int type);
+
+  // Loads a colour grading LUT stored as a horizontal strip of N slices of N x N texels
+  // (an N*N x N image, blue increasing per slice, red to the right and green downwards).
+  static std::unique_ptr<Texture3D> LoadLut(const std::string& filepath);
+};
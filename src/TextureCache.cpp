@@ -0,0 +1,133 @@
+#include <imgui/imgui.h>
+
+#include "TextureCache.h"
+
+static constexpr size_t DEFAULT_BUDGET = 256 * 1024 * 1024;
+static constexpr int DEFAULT_MINIMUM_SIZE = 64;
+
+TextureCache::TextureCache()
+  : m_Budget(DEFAULT_BUDGET), m_MinimumSize(DEFAULT_MINIMUM_SIZE), m_Stats{ 0, 0, 0, 0 }
+{
+}
+
+TextureCache& TextureCache::Get()
+{
+  static TextureCache instance;
+  return instance;
+}
+
+std::shared_ptr<Texture2D> TextureCache::Load(const std::string& filepath)
+{
+  auto it = m_Entries.find(filepath);
+  if (it != m_Entries.end())
+  {
+    m_Stats.Hits++;
+    Entry& entry = it->second;
+    Touch(entry);
+
+    // Bring a degraded texture back to full resolution if the budget allows it.
+    if (entry.Resource->GetDroppedMipLevels() > 0)
+    {
+      size_t fullSize = entry.Resource->GetMemorySize() << (2 * entry.Resource->GetDroppedMipLevels());
+      if (GetMemoryUsage() - entry.Resource->GetMemorySize() + fullSize <= m_Budget)
+        entry.Resource->Restore();
+    }
+    return entry.Resource;
+  }
+
+  m_Stats.Misses++;
+  m_LruList.push_front(filepath);
+  Entry& entry = m_Entries[filepath];
+  entry.Resource = std::make_shared<Texture2D>(filepath);
+  entry.LruPosition = m_LruList.begin();
+
+  // Keep a local reference so the new texture can be degraded but never evicted by its own load.
+  std::shared_ptr<Texture2D> texture = entry.Resource;
+  Trim();
+  return texture;
+}
+
+void TextureCache::Touch(Entry& entry)
+{
+  m_LruList.splice(m_LruList.begin(), m_LruList, entry.LruPosition);
+}
+
+void TextureCache::Trim()
+{
+  size_t usage = GetMemoryUsage();
+
+  while (usage > m_Budget)
+  {
+    // Prefer lowering the resolution of the least recently used texture that still can be.
+    bool reduced = false;
+    for (auto it = m_LruList.rbegin(); it != m_LruList.rend() && !reduced; ++it)
+    {
+      Texture2D& texture = *m_Entries[*it].Resource;
+      size_t before = texture.GetMemorySize();
+      if (texture.DropMipLevel(m_MinimumSize))
+      {
+        usage -= before - texture.GetMemorySize();
+        m_Stats.MipDrops++;
+        reduced = true;
+      }
+    }
+
+    // Everything is at its minimum size, so evict the least recently used texture nobody else holds.
+    for (auto it = m_LruList.rbegin(); it != m_LruList.rend() && !reduced; ++it)
+    {
+      auto entry = m_Entries.find(*it);
+      if (entry->second.Resource.use_count() == 1)
+      {
+        usage -= entry->second.Resource->GetMemorySize();
+        m_LruList.erase(entry->second.LruPosition);
+        m_Entries.erase(entry);
+        m_Stats.Evictions++;
+        reduced = true;
+      }
+    }
+
+    // Every remaining texture is both minimal and in use, the budget can't be met.
+    if (!reduced)
+      break;
+  }
+}
+
+void TextureCache::Clear()
+{
+  m_Entries.clear();
+  m_LruList.clear();
+}
+
+void TextureCache::SetBudget(size_t bytes)
+{
+  m_Budget = bytes;
+  Trim();
+}
+
+size_t TextureCache::GetMemoryUsage() const
+{
+  size_t usage = 0;
+  for (const auto& entry : m_Entries)
+    usage += entry.second.Resource->GetMemorySize();
+  return usage;
+}
+
+void TextureCache::OnImGuiRender()
+{
+  const float megabyte = 1024.0f * 1024.0f;
+
+  float budget = m_Budget / megabyte;
+  if (ImGui::SliderFloat("Budget (MB)", &budget, 1.0f, 1024.0f))
+    SetBudget((size_t)(budget * megabyte));
+
+  ImGui::Text("Usage: %.2f / %.2f MB", GetMemoryUsage() / megabyte, m_Budget / megabyte);
+  ImGui::Text("Hits: %u  Misses: %u  Evictions: %u  Mip drops: %u",
+    m_Stats.Hits, m_Stats.Misses, m_Stats.Evictions, m_Stats.MipDrops);
+
+  for (const std::string& path : m_LruList)
+  {
+    const Entry& entry = m_Entries[path];
+    ImGui::BulletText("%s  %dx%d  %.2f MB  (refs %ld)", path.c_str(), entry.Resource->GetWidth(), 
+      entry.Resource->GetHeight(), entry.Resource->GetMemorySize() / megabyte, entry.Resource.use_count() - 1);
+  }
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "Texture2D.h"
+
+// Shares textures loaded from the same path and keeps their combined VRAM usage within a budget.
+// When over budget, the least recently used textures are first dropped to lower mip levels and
+// then evicted entirely once nothing outside the cache holds a reference to them.
+class TextureCache
+{
+public:
+  struct Stats
+  {
+    unsigned int Hits;
+    unsigned int Misses;
+    unsigned int Evictions;
+    unsigned int MipDrops;
+  };
+
+private:
+  struct Entry
+  {
+    std::shared_ptr<Texture2D> Resource;
+    std::list<std::string>::iterator LruPosition;
+  };
+
+  std::unordered_map<std::string, Entry> m_Entries;
+  std::list<std::string> m_LruList; // Most recently used at the front.
+  size_t m_Budget;
+  int m_MinimumSize;
+  Stats m_Stats;
+
+public:
+  static TextureCache& Get();
+
+  std::shared_ptr<Texture2D> Load(const std::string& filepath);
+
+  // Enforces the memory budget. Called after every load and whenever the budget changes.
+  void Trim();
+  // Releases every texture. Must be called while the OpenGL context is still alive.
+  void Clear();
+
+  void SetBudget(size_t bytes);
+  inline size_t GetBudget() const { return m_Budget; }
+  size_t GetMemoryUsage() const;
+  inline const Stats& GetStats() const { return m_Stats; }
+
+  void OnImGuiRender();
+private:
+  TextureCache();
+  TextureCache(const TextureCache&) = delete;
+  TextureCache& operator=(const TextureCache&) = delete;
+
+  void Touch(Entry& entry);
+};
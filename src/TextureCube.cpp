@@ -0,0 +1,84 @@
+#include "ImageDecoder.h"
+#include "JobSystem.h"
+#include "TextureCube.h"
+#include "VirtualFileSystem.h"
+
+TextureCube::TextureCube(const std::array<std::string, 6>& faceFilePaths)
+  : Texture(GL_TEXTURE_CUBE_MAP)
+{
+  FileView files[6];
+  const ImageDecoder* decoders[6];
+  ImageInfo info[6];
+  for (int face = 0; face < 6; face++)
+  {
+    files[face] = VirtualFileSystem::Get().Open(faceFilePaths[face]);
+    decoders[face] = files[face].IsValid() ? ImageDecoder::Find(files[face].Data, files[face].Size) : nullptr;
+    if (!decoders[face] || !decoders[face]->ReadInfo(files[face].Data, files[face].Size, info[face]) ||
+      info[face].Width != info[0].Width || info[face].Height != info[0].Width)
+    {
+      std::cout << "\nError: Failed to load cube map face" << std::endl;
+      std::cout << "Missing, unsupported or mismatched image: " << faceFilePaths[face] << std::endl;
+      __debugbreak();
+      return;
+    }
+  }
+
+  int size = info[0].Width;
+  int channels = (info[0].Channels == 2 || info[0].Channels == 4) ? 4 : 3;
+  Create(channels == 4 ? GL_RGBA8 : GL_RGB8, size, size, 1, GetMipLevelCount(size, size));
+  SetFilter(GL_LINEAR_MIPMAP_LINEAR, GL_LINEAR);
+  SetWrap(GL_CLAMP_TO_EDGE);
+  OpenGLCall(glEnable(GL_TEXTURE_CUBE_MAP_SEAMLESS));
+
+  // The mapped pointer is plain memory, so each face can be decoded into it by its own job.
+  size_t faceSize = (size_t)size * size * channels;
+  unsigned int pixelBuffer;
+  OpenGLCall(glGenBuffers(1, &pixelBuffer));
+  OpenGLCall(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pixelBuffer));
+  OpenGLCall(glBufferData(GL_PIXEL_UNPACK_BUFFER, faceSize * 6, nullptr, GL_STREAM_DRAW));
+  OpenGLCall(unsigned char* pixels = (unsigned char*)glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, faceSize * 6, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
+
+  bool decoded = pixels != nullptr;
+  if (pixels)
+  {
+    bool faces[6];
+    JobCounter counter;
+    for (int face = 0; face < 6; face++)
+    {
+      JobSystem::Get().Schedule([&, face]() {
+        faces[face] = decoders[face]->Decode(files[face].Data, files[face].Size, pixels + face * faceSize, faceSize, channels, false);
+      }, &counter);
+    }
+    JobSystem::Get().Wait(counter);
+    for (int face = 0; face < 6; face++)
+      decoded = faces[face] && decoded;
+  }
+  OpenGLCall(glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER));
+
+  OpenGLCall(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+  for (int face = 0; face < 6; face++)
+  {
+    OpenGLCall(glTexSubImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, 0, 0, 0, size, size,
+      channels == 4 ? GL_RGBA : GL_RGB, GL_UNSIGNED_BYTE, (const void*)(face * faceSize)));
+  }
+  OpenGLCall(glPixelStorei(GL_UNPACK_ALIGNMENT, 4));
+  OpenGLCall(glGenerateMipmap(GL_TEXTURE_CUBE_MAP));
+
+  OpenGLCall(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0));
+  OpenGLCall(glDeleteBuffers(1, &pixelBuffer));
+
+  if (!decoded)
+  {
+    std::cout << "\nError: Failed to decode cube map" << std::endl;
+    __debugbreak();
+  }
+}
+
+TextureCube::TextureCube(int size, unsigned int internalFormat, int levels)
+  : Texture(GL_TEXTURE_CUBE_MAP)
+{
+  Create(internalFormat, size, size, 1, levels);
+  SetFilter(levels > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR, GL_LINEAR);
+  SetWrap(GL_CLAMP_TO_EDGE);
+  OpenGLCall(glEnable(GL_TEXTURE_CUBE_MAP_SEAMLESS));
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <array>
+#include <string>
+
+#include "Texture.h"
+
+// Cube map with faces in GL order: +X, -X, +Y, -Y, +Z, -Z.
+class TextureCube : public Texture
+{
+public:
+  // Loads six square face images; the faces are decoded in parallel into one pixel unpack buffer.
+  TextureCube(const std::array<std::string, 6>& faceFilePaths);
+  // Empty cube map to render into, e.g. for environment captures.
+  TextureCube(int size, unsigned int internalFormat, int levels = 1);
+};
@@ -0,0 +1,4 @@
+// imgui_draw.cpp compiles its own copy with STBTT_STATIC, so this one has external linkage
+// without clashing with it.
+#define STB_TRUETYPE_IMPLEMENTATION
+#include "stb_truetype.h"
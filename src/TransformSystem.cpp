@@ -0,0 +1,267 @@
+#include <algorithm>
+#include <immintrin.h>
+
+#include "CpuFeatures.h"
+#include "JobSystem.h"
+#include "TransformSystem.h"
+
+size_t TransformSystem::Add(const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale)
+{
+  m_PositionX.push_back(position.x);
+  m_PositionY.push_back(position.y);
+  m_PositionZ.push_back(position.z);
+  m_RotationX.push_back(rotation.x);
+  m_RotationY.push_back(rotation.y);
+  m_RotationZ.push_back(rotation.z);
+  m_RotationW.push_back(rotation.w);
+  m_ScaleX.push_back(scale.x);
+  m_ScaleY.push_back(scale.y);
+  m_ScaleZ.push_back(scale.z);
+  return m_PositionX.size() - 1;
+}
+
+void TransformSystem::Clear()
+{
+  for (std::vector<float>* component : { &m_PositionX, &m_PositionY, &m_PositionZ, &m_RotationX, &m_RotationY,
+    &m_RotationZ, &m_RotationW, &m_ScaleX, &m_ScaleY, &m_ScaleZ })
+  {
+    component->clear();
+  }
+  m_World.clear();
+  m_ModelViewProjection.clear();
+}
+
+void TransformSystem::SetPosition(size_t index, const glm::vec3& position)
+{
+  m_PositionX[index] = position.x;
+  m_PositionY[index] = position.y;
+  m_PositionZ[index] = position.z;
+}
+
+void TransformSystem::SetRotation(size_t index, const glm::quat& rotation)
+{
+  m_RotationX[index] = rotation.x;
+  m_RotationY[index] = rotation.y;
+  m_RotationZ[index] = rotation.z;
+  m_RotationW[index] = rotation.w;
+}
+
+void TransformSystem::SetScale(size_t index, const glm::vec3& scale)
+{
+  m_ScaleX[index] = scale.x;
+  m_ScaleY[index] = scale.y;
+  m_ScaleZ[index] = scale.z;
+}
+
+void TransformSystem::Update(const glm::mat4& viewProjection, SimdKernel kernel, bool parallel)
+{
+  size_t count = GetCount();
+  m_World.resize(count);
+  m_ModelViewProjection.resize(count);
+
+  if (!IsSimdKernelSupported(kernel))
+    kernel = SimdKernel::Scalar;
+
+  if (!parallel)
+  {
+    UpdateRange(viewProjection, kernel, 0, count);
+    return;
+  }
+
+  // Jobs take whole blocks, so only the last one leaves a tail for the scalar kernel.
+  const size_t BLOCK_SIZE = 256;
+  size_t blocks = (count + BLOCK_SIZE - 1) / BLOCK_SIZE;
+  JobSystem::Get().ParallelFor(blocks, 4, [&](size_t begin, size_t end)
+  {
+    UpdateRange(viewProjection, kernel, begin * BLOCK_SIZE, std::min(count, end * BLOCK_SIZE));
+  });
+}
+
+void TransformSystem::UpdateRange(const glm::mat4& viewProjection, SimdKernel kernel, size_t begin, size_t end)
+{
+  // The SIMD kernels only take whole groups of lanes, the scalar kernel finishes the rest.
+  size_t done = begin;
+  switch (kernel)
+  {
+    case SimdKernel::Sse:
+      done = begin + ((end - begin) & ~(size_t)3);
+      UpdateSse(viewProjection, begin, done);
+      break;
+    case SimdKernel::Avx2:
+      done = begin + ((end - begin) & ~(size_t)7);
+      UpdateAvx2(viewProjection, begin, done);
+      break;
+    default:
+      break;
+  }
+  UpdateScalar(viewProjection, done, end);
+}
+
+void TransformSystem::UpdateScalar(const glm::mat4& viewProjection, size_t begin, size_t end)
+{
+  for (size_t i = begin; i < end; i++)
+  {
+    // Same as translate * rotate * scale, without multiplying out the zeros.
+    glm::mat4 world = glm::mat4_cast(GetRotation(i));
+    world[0] *= m_ScaleX[i];
+    world[1] *= m_ScaleY[i];
+    world[2] *= m_ScaleZ[i];
+    world[3] = glm::vec4(GetPosition(i), 1.0f);
+
+    m_World[i] = world;
+    m_ModelViewProjection[i] = viewProjection * world;
+  }
+}
+
+// Each register holds one row of a column for four objects; transposing turns them into that
+// column of each object's matrix.
+static inline void StoreColumnSse(glm::mat4* matrices, int column, __m128 x, __m128 y, __m128 z, __m128 w)
+{
+  _MM_TRANSPOSE4_PS(x, y, z, w);
+  _mm_storeu_ps(&matrices[0][column].x, x);
+  _mm_storeu_ps(&matrices[1][column].x, y);
+  _mm_storeu_ps(&matrices[2][column].x, z);
+  _mm_storeu_ps(&matrices[3][column].x, w);
+}
+
+void TransformSystem::UpdateSse(const glm::mat4& viewProjection, size_t begin, size_t end)
+{
+  __m128 vp[4][4];
+  for (int column = 0; column < 4; column++)
+  {
+    for (int row = 0; row < 4; row++)
+      vp[column][row] = _mm_set1_ps(viewProjection[column][row]);
+  }
+
+  const __m128 zero = _mm_setzero_ps();
+  const __m128 one = _mm_set1_ps(1.0f);
+  const __m128 two = _mm_set1_ps(2.0f);
+
+  for (size_t i = begin; i < end; i += 4)
+  {
+    __m128 qx = _mm_loadu_ps(&m_RotationX[i]), qy = _mm_loadu_ps(&m_RotationY[i]);
+    __m128 qz = _mm_loadu_ps(&m_RotationZ[i]), qw = _mm_loadu_ps(&m_RotationW[i]);
+    __m128 sx = _mm_loadu_ps(&m_ScaleX[i]), sy = _mm_loadu_ps(&m_ScaleY[i]), sz = _mm_loadu_ps(&m_ScaleZ[i]);
+    __m128 px = _mm_loadu_ps(&m_PositionX[i]), py = _mm_loadu_ps(&m_PositionY[i]), pz = _mm_loadu_ps(&m_PositionZ[i]);
+
+    __m128 xx = _mm_mul_ps(qx, qx), yy = _mm_mul_ps(qy, qy), zz = _mm_mul_ps(qz, qz);
+    __m128 xy = _mm_mul_ps(qx, qy), xz = _mm_mul_ps(qx, qz), yz = _mm_mul_ps(qy, qz);
+    __m128 wx = _mm_mul_ps(qw, qx), wy = _mm_mul_ps(qw, qy), wz = _mm_mul_ps(qw, qz);
+
+    // Rotation matrix of the quaternion, each column scaled.
+    __m128 w[3][3];
+    w[0][0] = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))), sx);
+    w[0][1] = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xy, wz)), sx);
+    w[0][2] = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xz, wy)), sx);
+    w[1][0] = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xy, wz)), sy);
+    w[1][1] = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz))), sy);
+    w[1][2] = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(yz, wx)), sy);
+    w[2][0] = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xz, wy)), sz);
+    w[2][1] = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(yz, wx)), sz);
+    w[2][2] = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy))), sz);
+
+    glm::mat4* world = &m_World[i];
+    glm::mat4* mvp = &m_ModelViewProjection[i];
+    for (int column = 0; column < 3; column++)
+    {
+      StoreColumnSse(world, column, w[column][0], w[column][1], w[column][2], zero);
+
+      __m128 rows[4];
+      for (int row = 0; row < 4; row++)
+      {
+        rows[row] = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vp[0][row], w[column][0]), _mm_mul_ps(vp[1][row], w[column][1])),
+          _mm_mul_ps(vp[2][row], w[column][2]));
+      }
+      StoreColumnSse(mvp, column, rows[0], rows[1], rows[2], rows[3]);
+    }
+
+    StoreColumnSse(world, 3, px, py, pz, one);
+    __m128 rows[4];
+    for (int row = 0; row < 4; row++)
+    {
+      rows[row] = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vp[0][row], px), _mm_mul_ps(vp[1][row], py)),
+        _mm_add_ps(_mm_mul_ps(vp[2][row], pz), vp[3][row]));
+    }
+    StoreColumnSse(mvp, 3, rows[0], rows[1], rows[2], rows[3]);
+  }
+}
+
+// Eight object version of StoreColumnSse. The in-lane transpose leaves objects 0-3 in the low
+// halves and 4-7 in the high halves.
+SIMD_TARGET_AVX2 static inline void StoreColumnAvx(glm::mat4* matrices, int column, __m256 x, __m256 y, __m256 z, __m256 w)
+{
+  __m256 t0 = _mm256_unpacklo_ps(x, y), t1 = _mm256_unpackhi_ps(x, y);
+  __m256 t2 = _mm256_unpacklo_ps(z, w), t3 = _mm256_unpackhi_ps(z, w);
+  __m256 c0 = _mm256_shuffle_ps(t0, t2, 0x44), c1 = _mm256_shuffle_ps(t0, t2, 0xEE);
+  __m256 c2 = _mm256_shuffle_ps(t1, t3, 0x44), c3 = _mm256_shuffle_ps(t1, t3, 0xEE);
+
+  _mm_storeu_ps(&matrices[0][column].x, _mm256_castps256_ps128(c0));
+  _mm_storeu_ps(&matrices[1][column].x, _mm256_castps256_ps128(c1));
+  _mm_storeu_ps(&matrices[2][column].x, _mm256_castps256_ps128(c2));
+  _mm_storeu_ps(&matrices[3][column].x, _mm256_castps256_ps128(c3));
+  _mm_storeu_ps(&matrices[4][column].x, _mm256_extractf128_ps(c0, 1));
+  _mm_storeu_ps(&matrices[5][column].x, _mm256_extractf128_ps(c1, 1));
+  _mm_storeu_ps(&matrices[6][column].x, _mm256_extractf128_ps(c2, 1));
+  _mm_storeu_ps(&matrices[7][column].x, _mm256_extractf128_ps(c3, 1));
+}
+
+SIMD_TARGET_AVX2 void TransformSystem::UpdateAvx2(const glm::mat4& viewProjection, size_t begin, size_t end)
+{
+  __m256 vp[4][4];
+  for (int column = 0; column < 4; column++)
+  {
+    for (int row = 0; row < 4; row++)
+      vp[column][row] = _mm256_set1_ps(viewProjection[column][row]);
+  }
+
+  const __m256 zero = _mm256_setzero_ps();
+  const __m256 one = _mm256_set1_ps(1.0f);
+  const __m256 two = _mm256_set1_ps(2.0f);
+
+  for (size_t i = begin; i < end; i += 8)
+  {
+    __m256 qx = _mm256_loadu_ps(&m_RotationX[i]), qy = _mm256_loadu_ps(&m_RotationY[i]);
+    __m256 qz = _mm256_loadu_ps(&m_RotationZ[i]), qw = _mm256_loadu_ps(&m_RotationW[i]);
+    __m256 sx = _mm256_loadu_ps(&m_ScaleX[i]), sy = _mm256_loadu_ps(&m_ScaleY[i]), sz = _mm256_loadu_ps(&m_ScaleZ[i]);
+    __m256 px = _mm256_loadu_ps(&m_PositionX[i]), py = _mm256_loadu_ps(&m_PositionY[i]), pz = _mm256_loadu_ps(&m_PositionZ[i]);
+
+    __m256 xx = _mm256_mul_ps(qx, qx), yy = _mm256_mul_ps(qy, qy), zz = _mm256_mul_ps(qz, qz);
+    __m256 xy = _mm256_mul_ps(qx, qy), xz = _mm256_mul_ps(qx, qz), yz = _mm256_mul_ps(qy, qz);
+    __m256 wx = _mm256_mul_ps(qw, qx), wy = _mm256_mul_ps(qw, qy), wz = _mm256_mul_ps(qw, qz);
+
+    __m256 w[3][3];
+    w[0][0] = _mm256_mul_ps(_mm256_fnmadd_ps(two, _mm256_add_ps(yy, zz), one), sx);
+    w[0][1] = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(xy, wz)), sx);
+    w[0][2] = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(xz, wy)), sx);
+    w[1][0] = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(xy, wz)), sy);
+    w[1][1] = _mm256_mul_ps(_mm256_fnmadd_ps(two, _mm256_add_ps(xx, zz), one), sy);
+    w[1][2] = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(yz, wx)), sy);
+    w[2][0] = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(xz, wy)), sz);
+    w[2][1] = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(yz, wx)), sz);
+    w[2][2] = _mm256_mul_ps(_mm256_fnmadd_ps(two, _mm256_add_ps(xx, yy), one), sz);
+
+    glm::mat4* world = &m_World[i];
+    glm::mat4* mvp = &m_ModelViewProjection[i];
+    for (int column = 0; column < 3; column++)
+    {
+      StoreColumnAvx(world, column, w[column][0], w[column][1], w[column][2], zero);
+
+      __m256 rows[4];
+      for (int row = 0; row < 4; row++)
+      {
+        rows[row] = _mm256_fmadd_ps(vp[2][row], w[column][2],
+          _mm256_fmadd_ps(vp[1][row], w[column][1], _mm256_mul_ps(vp[0][row], w[column][0])));
+      }
+      StoreColumnAvx(mvp, column, rows[0], rows[1], rows[2], rows[3]);
+    }
+
+    StoreColumnAvx(world, 3, px, py, pz, one);
+    __m256 rows[4];
+    for (int row = 0; row < 4; row++)
+    {
+      rows[row] = _mm256_fmadd_ps(vp[2][row], pz,
+        _mm256_fmadd_ps(vp[1][row], py, _mm256_fmadd_ps(vp[0][row], px, vp[3][row])));
+    }
+    StoreColumnAvx(mvp, 3, rows[0], rows[1], rows[2], rows[3]);
+  }
+}
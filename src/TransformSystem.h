@@ -0,0 +1,47 @@
+#pragma once
+
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include "CpuFeatures.h"
+
+// Translation, rotation and scale of many objects in structure of arrays form, turned into world
+// and model view projection matrices in one batch. The SIMD kernels build four (SSE) or eight (AVX2)
+// objects' matrices at once, one object per lane; the scalar kernel does the same with glm and is
+// the reference the others are checked against.
+class TransformSystem
+{
+private:
+  std::vector<float> m_PositionX, m_PositionY, m_PositionZ;
+  std::vector<float> m_RotationX, m_RotationY, m_RotationZ, m_RotationW; // Unit quaternions.
+  std::vector<float> m_ScaleX, m_ScaleY, m_ScaleZ;
+  std::vector<glm::mat4> m_World;
+  std::vector<glm::mat4> m_ModelViewProjection;
+
+public:
+  // Returns the new object's index.
+  size_t Add(const glm::vec3& position, const glm::quat& rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f), const glm::vec3& scale = glm::vec3(1.0f));
+  void Clear();
+  inline size_t GetCount() const { return m_PositionX.size(); }
+
+  void SetPosition(size_t index, const glm::vec3& position);
+  void SetRotation(size_t index, const glm::quat& rotation);
+  void SetScale(size_t index, const glm::vec3& scale);
+  inline glm::vec3 GetPosition(size_t index) const { return glm::vec3(m_PositionX[index], m_PositionY[index], m_PositionZ[index]); }
+  inline glm::quat GetRotation(size_t index) const { return glm::quat(m_RotationW[index], m_RotationX[index], m_RotationY[index], m_RotationZ[index]); }
+  inline glm::vec3 GetScale(size_t index) const { return glm::vec3(m_ScaleX[index], m_ScaleY[index], m_ScaleZ[index]); }
+
+  // Recomputes every world and model view projection matrix, split into jobs if parallel. Falls
+  // back to the scalar kernel when the CPU lacks the requested one.
+  void Update(const glm::mat4& viewProjection, SimdKernel kernel = GetBestSimdKernel(), bool parallel = false);
+
+  inline const std::vector<glm::mat4>& GetWorldMatrices() const { return m_World; }
+  inline const std::vector<glm::mat4>& GetModelViewProjections() const { return m_ModelViewProjection; }
+private:
+  void UpdateRange(const glm::mat4& viewProjection, SimdKernel kernel, size_t begin, size_t end);
+  void UpdateScalar(const glm::mat4& viewProjection, size_t begin, size_t end);
+  void UpdateSse(const glm::mat4& viewProjection, size_t begin, size_t end);
+  void UpdateAvx2(const glm::mat4& viewProjection, size_t begin, size_t end);
+};
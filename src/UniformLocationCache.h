@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Uniform locations of one program, looked up by C string so setting a uniform from a literal
+// doesn't build a std::string every call. Programs have a handful of uniforms, so a linear scan
+// is quicker than hashing the name.
+class UniformLocationCache
+{
+private:
+  struct Entry
+  {
+    std::string Name;
+    int Location;
+  };
+
+  std::vector<Entry> m_Entries;
+
+public:
+  // Null if the name hasn't been added yet.
+  const int* Find(const char* name) const
+  {
+    for (const Entry& entry : m_Entries)
+    {
+      if (std::strcmp(entry.Name.c_str(), name) == 0)
+        return &entry.Location;
+    }
+    return nullptr;
+  }
+
+  void Add(const char* name, int location) { m_Entries.push_back({ name, location }); }
+};
@@ -1,15 +1,12 @@
 #include "VertexArray.h"
 #include "Renderer.h"
 
-VertexArray::VertexArray(): m_RendererId(0)
+VertexArray::VertexArray()
 {
-  OpenGLCall(glGenVertexArrays(1, &m_RendererId));
-  OpenGLCall(glBindVertexArray(m_RendererId));
-}
-
-VertexArray::~VertexArray()
-{
-  OpenGLCall(glDeleteVertexArrays(1, &m_RendererId));
+  unsigned int id = 0;
+  OpenGLCall(glGenVertexArrays(1, &id));
+  m_RendererId.Reset(id);
+  OpenGLCall(glBindVertexArray(id));
 }
 
 void VertexArray::AddBuffer(const VertexBuffer& buffer, const VertexBufferLayout& layout)
@@ -17,7 +14,8 @@ void VertexArray::AddBuffer(const VertexBuffer& buffer, const VertexBufferLayout
   Bind();
   buffer.Bind();
   const auto& elements = layout.GetElements();
-  unsigned int offset = 0;
+  // Static buffers can start part way into a shared GpuHeap buffer.
+  size_t offset = buffer.GetOffset();
 
   for (unsigned int i = 0; i < elements.size(); i++) {
     const auto& element = elements[i];
@@ -31,7 +29,7 @@ void VertexArray::AddBuffer(const VertexBuffer& buffer, const VertexBufferLayout
 
 void VertexArray::Bind() const
 {
-  OpenGLCall(glBindVertexArray(m_RendererId));
+  OpenGLCall(glBindVertexArray(m_RendererId.Get()));
 }
 
 void VertexArray::Unbind() const
@@ -1,17 +1,22 @@
 #pragma once
+#include "GLHandle.h"
 #include "VertexBuffer.h"
 #include "VertexBufferLayout.h"
 
 class VertexArray
 {
 private:
-  unsigned int m_RendererId;
+  VertexArrayHandle m_RendererId;
 public:
   VertexArray();
-  ~VertexArray();
+
+  VertexArray(VertexArray&&) = default;
+  VertexArray& operator=(VertexArray&&) = default;
 
   void AddBuffer(const VertexBuffer& buffer, const VertexBufferLayout& layout);
 
   void Bind() const;
   void Unbind() const;
+
+  inline unsigned int GetRendererId() const { return m_RendererId.Get(); }
 };
\ No newline at end of file
@@ -1,24 +1,59 @@
 #include "VertexBuffer.h"
 #include "Renderer.h"
 
-VertexBuffer::VertexBuffer(const void* data, unsigned int size)
+VertexBuffer::VertexBuffer(const void* data, unsigned int size, BufferUsage usage)
+  : m_Storage(data, size, usage)
 {
-  OpenGLCall(glGenBuffers(1, &m_RendererId));
-  OpenGLCall(glBindBuffer(GL_ARRAY_BUFFER, m_RendererId));
-  OpenGLCall(glBufferData(GL_ARRAY_BUFFER, size, data, GL_STATIC_DRAW));
-}
-
-VertexBuffer::~VertexBuffer()
-{
-  OpenGLCall(glDeleteBuffers(1, &m_RendererId));
 }
 
 void VertexBuffer::Bind() const
 {
-  OpenGLCall(glBindBuffer(GL_ARRAY_BUFFER, m_RendererId));
+  m_Storage.Bind(GL_ARRAY_BUFFER);
 }
 
 void VertexBuffer::Unbind() const
 {
   OpenGLCall(glBindBuffer(GL_ARRAY_BUFFER, 0));
 }
+
+void VertexBuffer::SetData(const void* data, unsigned int size)
+{
+  m_Storage.SetData(data, size);
+}
+
+void VertexBuffer::SetSubData(unsigned int offset, const void* data, unsigned int size)
+{
+  if (offset + size > GetSize())
+  {
+    std::cout << "[ERROR] [OPENGL]: Vertex buffer update of " << size << " bytes at " << offset << " overflows " << GetSize() << " bytes" << std::endl;
+    return;
+  }
+
+  m_Storage.SetSubData(offset, data, size);
+}
+
+void VertexBuffer::Orphan()
+{
+  m_Storage.Orphan();
+}
+
+void VertexBuffer::Resize(unsigned int size)
+{
+  m_Storage.Resize(size);
+}
+
+void* VertexBuffer::Map(unsigned int size)
+{
+  if (size > GetSize())
+  {
+    std::cout << "[ERROR] [OPENGL]: Vertex buffer map of " << size << " bytes overflows " << GetSize() << " bytes" << std::endl;
+    return nullptr;
+  }
+
+  return m_Storage.Map(size);
+}
+
+bool VertexBuffer::Unmap()
+{
+  return m_Storage.Unmap();
+}
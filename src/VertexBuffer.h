@@ -1,13 +1,39 @@
 #pragma once
 
+#include "BufferStorage.h"
+
 class VertexBuffer 
 {
 private:
-  unsigned int m_RendererId;
+  BufferStorage m_Storage;
 public:
-  VertexBuffer(const void* data, unsigned int size);
-  ~VertexBuffer();
+  VertexBuffer(const void* data, unsigned int size, BufferUsage usage = BufferUsage::Static);
+
+  VertexBuffer(VertexBuffer&&) = default;
+  VertexBuffer& operator=(VertexBuffer&&) = default;
 
   void Bind() const;
   void Unbind() const;
-};
\ No newline at end of file
+
+  // Replaces the whole contents, reallocating storage at the new size.
+  void SetData(const void* data, unsigned int size);
+  void SetSubData(unsigned int offset, const void* data, unsigned int size);
+  // Detaches the current storage so new writes don't wait for draws still reading the old data.
+  // The contents are undefined afterwards.
+  void Orphan();
+  // Changes the size keeping the existing contents (up to the new size). The buffer object stays
+  // the same, so vertex arrays using it remain valid, unless the buffer was still in the shared
+  // GpuHeap: then it moves to its own object and must be added to its vertex arrays again.
+  void Resize(unsigned int size);
+  // Maps the first size bytes for writing, orphaning the old storage so the map never waits for
+  // draws still reading it. Whatever isn't written before Unmap is undefined. Null on failure.
+  void* Map(unsigned int size);
+  // Returns false if the contents were lost while mapped and have to be written again.
+  bool Unmap();
+
+  // Static buffers may be a range of a shared GpuHeap buffer starting at GetOffset bytes.
+  inline unsigned int GetRendererId() const { return m_Storage.GetRendererId(); }
+  inline unsigned int GetOffset() const { return m_Storage.GetOffset(); }
+  inline unsigned int GetSize() const { return m_Storage.GetSize(); }
+  inline BufferUsage GetUsage() const { return m_Storage.GetUsage(); }
+};
@@ -0,0 +1,81 @@
+#include <iostream>
+
+#ifdef OPENGL_USE_LZ4
+#include <lz4.h>
+#endif
+
+#include "VirtualFileSystem.h"
+
+VirtualFileSystem::VirtualFileSystem()
+#ifdef _DEBUG
+  : m_LooseFilesEnabled(true)
+#else
+  : m_LooseFilesEnabled(false)
+#endif
+{
+}
+
+VirtualFileSystem& VirtualFileSystem::Get()
+{
+  static VirtualFileSystem instance;
+  return instance;
+}
+
+bool VirtualFileSystem::Mount(const std::string& packPath)
+{
+  std::shared_ptr<AssetPack> pack = std::make_shared<AssetPack>(packPath);
+  if (!pack->IsValid())
+    return false;
+
+  std::cout << "Mounted asset pack - " << packPath << " (" << pack->GetEntryCount() << " files)" << std::endl;
+  m_Packs.push_back(std::move(pack));
+  return true;
+}
+
+void VirtualFileSystem::UnmountAll()
+{
+  m_Packs.clear();
+}
+
+FileView VirtualFileSystem::Open(const std::string& path) const
+{
+  // Without any pack mounted there is nothing to fall back on, so always look on disk.
+  if (m_LooseFilesEnabled || m_Packs.empty())
+  {
+    std::shared_ptr<MappedFile> file = std::make_shared<MappedFile>(path);
+    if (file->IsValid())
+      return { file->GetData(), file->GetSize(), file };
+  }
+
+  for (auto pack = m_Packs.rbegin(); pack != m_Packs.rend(); ++pack)
+  {
+    const PackEntry* entry = (*pack)->Find(path);
+    if (!entry)
+      continue;
+
+    if (!(entry->Flags & PACK_ENTRY_LZ4))
+      return { (*pack)->GetData(*entry), (size_t)entry->StoredSize, *pack };
+
+#ifdef OPENGL_USE_LZ4
+    std::shared_ptr<std::vector<unsigned char>> buffer = std::make_shared<std::vector<unsigned char>>(entry->OriginalSize);
+    int size = LZ4_decompress_safe((const char*)(*pack)->GetData(*entry), (char*)buffer->data(),
+      (int)entry->StoredSize, (int)entry->OriginalSize);
+    if (size == (int)entry->OriginalSize)
+      return { buffer->data(), buffer->size(), buffer };
+    std::cout << "[ERROR] [VFS]: Corrupt LZ4 data for '" << path << "'" << std::endl;
+#else
+    std::cout << "[ERROR] [VFS]: '" << path << "' is LZ4 compressed but LZ4 support isn't built in" << std::endl;
+#endif
+    return { nullptr, 0, nullptr };
+  }
+
+  // Not packed, so fall back to the loose file if it wasn't already tried.
+  if (!m_LooseFilesEnabled && !m_Packs.empty())
+  {
+    std::shared_ptr<MappedFile> file = std::make_shared<MappedFile>(path);
+    if (file->IsValid())
+      return { file->GetData(), file->GetSize(), file };
+  }
+
+  return { nullptr, 0, nullptr };
+}
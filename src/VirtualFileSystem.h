@@ -0,0 +1,46 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "AssetPack.h"
+
+// A read-only view of a file's bytes. Views into an uncompressed pack entry point straight into
+// the mapped archive; Owner keeps the backing storage (loose file mapping, pack, decompressed
+// buffer) alive, so a view stays valid after its pack is unmounted.
+struct FileView
+{
+  const unsigned char* Data;
+  size_t Size;
+  std::shared_ptr<void> Owner;
+
+  inline bool IsValid() const { return Data != nullptr; }
+  inline std::string ToString() const { return std::string((const char*)Data, Size); }
+};
+
+// Resolves asset paths against mounted packs. With loose files enabled (the default in debug
+// builds) a file on disk overrides the packed copy so assets can be edited without repacking.
+class VirtualFileSystem
+{
+private:
+  std::vector<std::shared_ptr<AssetPack>> m_Packs;
+  bool m_LooseFilesEnabled;
+
+public:
+  static VirtualFileSystem& Get();
+
+  // Later mounts take priority over earlier ones.
+  bool Mount(const std::string& packPath);
+  // Views already opened from a pack keep it mapped until they are released.
+  void UnmountAll();
+
+  FileView Open(const std::string& path) const;
+
+  inline void SetLooseFilesEnabled(bool enabled) { m_LooseFilesEnabled = enabled; }
+  inline bool GetLooseFilesEnabled() const { return m_LooseFilesEnabled; }
+private:
+  VirtualFileSystem();
+  VirtualFileSystem(const VirtualFileSystem&) = delete;
+  VirtualFileSystem& operator=(const VirtualFileSystem&) = delete;
+};
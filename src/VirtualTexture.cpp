@@ -0,0 +1,450 @@
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+#include "Renderer.h"
+#include "VirtualTexture.h"
+
+static constexpr int FEEDBACK_SCALE = 4;
+static constexpr int MAX_LOADERS = 4;
+
+static inline uint32_t PackEntry(int slot, int pagesPerSide, int level)
+{
+  uint32_t x = slot % pagesPerSide, y = slot / pagesPerSide;
+  return x | (y << 8) | ((uint32_t)level << 16) | (0xFFu << 24);
+}
+
+VirtualTexture::VirtualTexture(std::unique_ptr<VirtualTextureSource> source, int physicalPagesPerSide, int viewportWidth, int viewportHeight)
+  : m_Source(std::move(source)), m_PhysicalPagesPerSide(physicalPagesPerSide), m_Frame(0), m_MaxUploadsPerFrame(16),
+    m_FeedbackScale(FEEDBACK_SCALE), m_FeedbackWriteIndex(0), m_ActiveLoaders(0), m_Running(true), m_Stats{ 0, 0, 0, 0, 0 }
+{
+  m_PageTableSize = m_Source->GetPageTableSize();
+  m_LevelCount = m_Source->GetLevelCount();
+
+  // Physical page cache.
+  int physicalSize = m_PhysicalPagesPerSide * VT_PAGE_SIZE;
+  OpenGLCall(glGenTextures(1, &m_PhysicalTexture));
+  OpenGLCall(glBindTexture(GL_TEXTURE_2D, m_PhysicalTexture));
+  OpenGLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
+  OpenGLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+  OpenGLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+  OpenGLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+  OpenGLCall(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, physicalSize, physicalSize, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr));
+
+  // Page table, one mip level per virtual texture level.
+  OpenGLCall(glGenTextures(1, &m_PageTableTexture));
+  OpenGLCall(glBindTexture(GL_TEXTURE_2D, m_PageTableTexture));
+  OpenGLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST));
+  OpenGLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
+  OpenGLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, m_LevelCount - 1));
+  m_PageTable.resize(m_LevelCount);
+  m_DirtyRect.resize(m_LevelCount * 4);
+  for (int level = 0; level < m_LevelCount; level++)
+  {
+    int size = m_PageTableSize >> level;
+    m_PageTable[level].assign((size_t)size * size, 0);
+    OpenGLCall(glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA8, size, size, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr));
+    m_DirtyRect[level * 4 + 0] = m_DirtyRect[level * 4 + 1] = size;
+    m_DirtyRect[level * 4 + 2] = m_DirtyRect[level * 4 + 3] = -1;
+  }
+
+  // Every slot starts free. The coarsest page is loaded up front and pinned, so each
+  // virtual page always has something to fall back on.
+  m_Slots.resize((size_t)m_PhysicalPagesPerSide * m_PhysicalPagesPerSide);
+  for (int i = 0; i < (int)m_Slots.size(); i++)
+  {
+    m_Slots[i].Occupied = false;
+    m_Slots[i].Pinned = false;
+    m_Slots[i].LastUsedFrame = 0;
+    m_Slots[i].LruPosition = m_LruSlots.insert(m_LruSlots.end(), i);
+  }
+
+  LoadedPage root = { { m_LevelCount - 1, 0, 0 }, std::vector<unsigned char>(VT_PAGE_BYTES) };
+  m_Source->ReadPage(root.Page.Level, 0, 0, root.Pixels.data());
+  UploadPage(root);
+  int rootSlot = m_ResidentPages[PageKey(root.Page.Level, 0, 0)];
+  m_Slots[rootSlot].Pinned = true;
+  m_LruSlots.erase(m_Slots[rootSlot].LruPosition);
+  UploadPageTable();
+
+  // Feedback target: page x, page y, level and a validity flag per pixel.
+  m_FeedbackWidth = std::max(1, viewportWidth / m_FeedbackScale);
+  m_FeedbackHeight = std::max(1, viewportHeight / m_FeedbackScale);
+  OpenGLCall(glGenTextures(1, &m_FeedbackTexture));
+  OpenGLCall(glBindTexture(GL_TEXTURE_2D, m_FeedbackTexture));
+  OpenGLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
+  OpenGLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
+  OpenGLCall(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16UI, m_FeedbackWidth, m_FeedbackHeight, 0, GL_RGBA_INTEGER, GL_UNSIGNED_SHORT, nullptr));
+  OpenGLCall(glBindTexture(GL_TEXTURE_2D, 0));
+
+  OpenGLCall(glGenFramebuffers(1, &m_FeedbackFramebuffer));
+  OpenGLCall(glBindFramebuffer(GL_FRAMEBUFFER, m_FeedbackFramebuffer));
+  OpenGLCall(glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_FeedbackTexture, 0));
+  OpenGLCall(glBindFramebuffer(GL_FRAMEBUFFER, 0));
+
+  size_t feedbackSize = (size_t)m_FeedbackWidth * m_FeedbackHeight * 4 * sizeof(unsigned short);
+  OpenGLCall(glGenBuffers(FEEDBACK_BUFFER_COUNT, m_FeedbackBuffers));
+  for (int i = 0; i < FEEDBACK_BUFFER_COUNT; i++)
+  {
+    OpenGLCall(glBindBuffer(GL_PIXEL_PACK_BUFFER, m_FeedbackBuffers[i]));
+    OpenGLCall(glBufferData(GL_PIXEL_PACK_BUFFER, feedbackSize, nullptr, GL_STREAM_READ));
+    m_FeedbackFences[i] = nullptr;
+  }
+  OpenGLCall(glBindBuffer(GL_PIXEL_PACK_BUFFER, 0));
+}
+
+VirtualTexture::~VirtualTexture()
+{
+  // Loaders finish the page they're reading and stop; this runs other jobs until they have.
+  m_Running = false;
+  JobSystem::Get().Wait(m_LoaderJobs);
+
+  for (int i = 0; i < FEEDBACK_BUFFER_COUNT; i++)
+  {
+    if (m_FeedbackFences[i])
+    {
+      OpenGLCall(glDeleteSync((GLsync)m_FeedbackFences[i]));
+    }
+  }
+  OpenGLCall(glDeleteBuffers(FEEDBACK_BUFFER_COUNT, m_FeedbackBuffers));
+  OpenGLCall(glDeleteFramebuffers(1, &m_FeedbackFramebuffer));
+  OpenGLCall(glDeleteTextures(1, &m_FeedbackTexture));
+  OpenGLCall(glDeleteTextures(1, &m_PageTableTexture));
+  OpenGLCall(glDeleteTextures(1, &m_PhysicalTexture));
+}
+
+void VirtualTexture::BeginFeedback()
+{
+  OpenGLCall(glGetIntegerv(GL_VIEWPORT, m_PreviousViewport));
+  OpenGLCall(glBindFramebuffer(GL_FRAMEBUFFER, m_FeedbackFramebuffer));
+  OpenGLCall(glViewport(0, 0, m_FeedbackWidth, m_FeedbackHeight));
+
+  const GLuint clear[4] = { 0, 0, 0, 0 };
+  OpenGLCall(glClearBufferuiv(GL_COLOR, 0, clear));
+}
+
+void VirtualTexture::EndFeedback()
+{
+  // If the GPU hasn't finished with the oldest buffer yet, skip this frame's feedback rather than stall.
+  if (!m_FeedbackFences[m_FeedbackWriteIndex])
+  {
+    OpenGLCall(glBindBuffer(GL_PIXEL_PACK_BUFFER, m_FeedbackBuffers[m_FeedbackWriteIndex]));
+    OpenGLCall(glReadPixels(0, 0, m_FeedbackWidth, m_FeedbackHeight, GL_RGBA_INTEGER, GL_UNSIGNED_SHORT, nullptr));
+    OpenGLCall(m_FeedbackFences[m_FeedbackWriteIndex] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+    OpenGLCall(glBindBuffer(GL_PIXEL_PACK_BUFFER, 0));
+    m_FeedbackWriteIndex = (m_FeedbackWriteIndex + 1) % FEEDBACK_BUFFER_COUNT;
+  }
+
+  OpenGLCall(glBindFramebuffer(GL_FRAMEBUFFER, 0));
+  OpenGLCall(glViewport(m_PreviousViewport[0], m_PreviousViewport[1], m_PreviousViewport[2], m_PreviousViewport[3]));
+}
+
+void VirtualTexture::Update()
+{
+  m_Frame++;
+
+  // Oldest read back first.
+  for (int i = 0; i < FEEDBACK_BUFFER_COUNT; i++)
+  {
+    int index = (m_FeedbackWriteIndex + i) % FEEDBACK_BUFFER_COUNT;
+    GLsync fence = (GLsync)m_FeedbackFences[index];
+    if (!fence)
+      continue;
+
+    OpenGLCall(GLenum status = glClientWaitSync(fence, 0, 0));
+    if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+      break;
+
+    OpenGLCall(glDeleteSync(fence));
+    m_FeedbackFences[index] = nullptr;
+
+    OpenGLCall(glBindBuffer(GL_PIXEL_PACK_BUFFER, m_FeedbackBuffers[index]));
+    OpenGLCall(const unsigned short* pixels = (const unsigned short*)glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY));
+    if (pixels)
+      ProcessFeedback(pixels);
+    OpenGLCall(glUnmapBuffer(GL_PIXEL_PACK_BUFFER));
+    OpenGLCall(glBindBuffer(GL_PIXEL_PACK_BUFFER, 0));
+  }
+
+  std::vector<LoadedPage> loaded;
+  {
+    std::lock_guard<std::mutex> lock(m_ResultMutex);
+    size_t count = std::min(m_Results.size(), (size_t)m_MaxUploadsPerFrame);
+    std::move(m_Results.begin(), m_Results.begin() + count, std::back_inserter(loaded));
+    m_Results.erase(m_Results.begin(), m_Results.begin() + count);
+  }
+
+  m_Stats.UploadsLastFrame = 0;
+  for (const LoadedPage& page : loaded)
+  {
+    m_PendingPages.erase(PageKey(page.Page.Level, page.Page.X, page.Page.Y));
+    if (!page.Pixels.empty())
+      UploadPage(page);
+  }
+
+  UploadPageTable();
+  m_Stats.ResidentPages = (unsigned int)m_ResidentPages.size();
+  m_Stats.PendingPages = (unsigned int)m_PendingPages.size();
+}
+
+void VirtualTexture::ProcessFeedback(const unsigned short* pixels)
+{
+  // Collect unique requests; neighbouring pixels almost always ask for the same page.
+  m_Requests.clear();
+  uint64_t previous = ~0ull;
+  size_t pixelCount = (size_t)m_FeedbackWidth * m_FeedbackHeight;
+  for (size_t i = 0; i < pixelCount; i++)
+  {
+    const unsigned short* pixel = pixels + i * 4;
+    if (pixel[3] == 0)
+      continue;
+
+    int level = std::min((int)pixel[2], m_LevelCount - 1);
+    uint64_t key = PageKey(level, pixel[0] >> level, pixel[1] >> level);
+    if (key != previous)
+      m_Requests.push_back(key);
+    previous = key;
+  }
+  std::sort(m_Requests.begin(), m_Requests.end());
+  m_Requests.erase(std::unique(m_Requests.begin(), m_Requests.end()), m_Requests.end());
+
+  // Touch resident pages, and request missing ones together with any missing ancestors
+  // so the fallback improves one level at a time.
+  std::vector<PageRequest> wanted;
+  std::unordered_set<uint64_t> seen;
+  for (uint64_t request : m_Requests)
+  {
+    int level = (int)(request >> 48);
+    int y = (int)((request >> 24) & 0xFFFFFF);
+    int x = (int)(request & 0xFFFFFF);
+    for (; level < m_LevelCount; level++, x /= 2, y /= 2)
+    {
+      uint64_t key = PageKey(level, x, y);
+      auto resident = m_ResidentPages.find(key);
+      if (resident != m_ResidentPages.end())
+      {
+        Slot& slot = m_Slots[resident->second];
+        slot.LastUsedFrame = m_Frame;
+        if (!slot.Pinned)
+          m_LruSlots.splice(m_LruSlots.end(), m_LruSlots, slot.LruPosition);
+        break;
+      }
+      if (seen.insert(key).second)
+        wanted.push_back({ level, x, y });
+    }
+  }
+
+  // Coarse pages first: they cover the most screen area and unblock finer pages.
+  std::stable_sort(wanted.begin(), wanted.end(),
+    [](const PageRequest& a, const PageRequest& b) { return a.Level > b.Level; });
+
+  int newLoaders = 0;
+  {
+    // Replace the queue so requests nothing asks for any more are dropped before loading.
+    std::lock_guard<std::mutex> lock(m_RequestMutex);
+    for (const PageRequest& queued : m_RequestQueue)
+      m_PendingPages.erase(PageKey(queued.Level, queued.X, queued.Y));
+    m_RequestQueue.clear();
+
+    for (const PageRequest& request : wanted)
+    {
+      if (m_PendingPages.insert(PageKey(request.Level, request.X, request.Y)).second)
+        m_RequestQueue.push_back(request);
+    }
+
+    // Loads block on the disk, so only a few jobs at a time, leaving the other workers free.
+    newLoaders = std::max(0, std::min((int)m_RequestQueue.size(), MAX_LOADERS) - m_ActiveLoaders);
+    m_ActiveLoaders += newLoaders;
+  }
+
+  for (int i = 0; i < newLoaders; i++)
+    JobSystem::Get().Schedule([this]() { LoadPages(); }, &m_LoaderJobs);
+}
+
+void VirtualTexture::UploadPage(const LoadedPage& page)
+{
+  uint64_t key = PageKey(page.Page.Level, page.Page.X, page.Page.Y);
+  if (m_ResidentPages.count(key))
+    return;
+
+  int slot = AcquireSlot();
+  if (slot < 0)
+    return;
+
+  int x = (slot % m_PhysicalPagesPerSide) * VT_PAGE_SIZE;
+  int y = (slot / m_PhysicalPagesPerSide) * VT_PAGE_SIZE;
+  OpenGLCall(glBindTexture(GL_TEXTURE_2D, m_PhysicalTexture));
+  OpenGLCall(glPixelStorei(GL_UNPACK_ALIGNMENT, 4));
+  OpenGLCall(glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, VT_PAGE_SIZE, VT_PAGE_SIZE, GL_RGBA, GL_UNSIGNED_BYTE, page.Pixels.data()));
+
+  m_Slots[slot].PageKey = key;
+  m_Slots[slot].Occupied = true;
+  m_Slots[slot].LastUsedFrame = m_Frame;
+  m_ResidentPages[key] = slot;
+  MapPage(page.Page.Level, page.Page.X, page.Page.Y, slot);
+
+  m_Stats.UploadsLastFrame++;
+  m_Stats.TotalUploads++;
+}
+
+int VirtualTexture::AcquireSlot()
+{
+  if (m_LruSlots.empty())
+    return -1;
+
+  // The front is the least recently used slot; if even that was needed this frame the cache is full.
+  int index = m_LruSlots.front();
+  Slot& slot = m_Slots[index];
+  if (slot.Occupied && slot.LastUsedFrame == m_Frame)
+    return -1;
+
+  if (slot.Occupied)
+  {
+    int level = (int)(slot.PageKey >> 48);
+    int y = (int)((slot.PageKey >> 24) & 0xFFFFFF);
+    int x = (int)(slot.PageKey & 0xFFFFFF);
+    UnmapPage(level, x, y, index);
+    m_ResidentPages.erase(slot.PageKey);
+    slot.Occupied = false;
+    m_Stats.Evictions++;
+  }
+
+  m_LruSlots.splice(m_LruSlots.end(), m_LruSlots, slot.LruPosition);
+  return index;
+}
+
+void VirtualTexture::MapPage(int level, int x, int y, int slot)
+{
+  // Point every finer entry below this page at it, unless it already has a finer page of its own.
+  uint32_t entry = PackEntry(slot, m_PhysicalPagesPerSide, level);
+  for (int target = level; target >= 0; target--)
+  {
+    int span = 1 << (level - target);
+    int size = m_PageTableSize >> target;
+    std::vector<uint32_t>& table = m_PageTable[target];
+    for (int row = y * span; row < (y + 1) * span; row++)
+    {
+      for (int column = x * span; column < (x + 1) * span; column++)
+      {
+        uint32_t& current = table[(size_t)row * size + column];
+        if (current == 0 || (int)((current >> 16) & 0xFF) >= level)
+          current = entry;
+      }
+    }
+    MarkDirty(target, x * span, y * span, (x + 1) * span - 1, (y + 1) * span - 1);
+  }
+}
+
+void VirtualTexture::UnmapPage(int level, int x, int y, int slot)
+{
+  // Entries that pointed at this page fall back to whatever covers its parent.
+  uint32_t entry = PackEntry(slot, m_PhysicalPagesPerSide, level);
+  uint32_t fallback = 0;
+  if (level + 1 < m_LevelCount)
+    fallback = m_PageTable[level + 1][(size_t)(y / 2) * (m_PageTableSize >> (level + 1)) + x / 2];
+
+  for (int target = level; target >= 0; target--)
+  {
+    int span = 1 << (level - target);
+    int size = m_PageTableSize >> target;
+    std::vector<uint32_t>& table = m_PageTable[target];
+    for (int row = y * span; row < (y + 1) * span; row++)
+    {
+      for (int column = x * span; column < (x + 1) * span; column++)
+      {
+        uint32_t& current = table[(size_t)row * size + column];
+        if (current == entry)
+          current = fallback;
+      }
+    }
+    MarkDirty(target, x * span, y * span, (x + 1) * span - 1, (y + 1) * span - 1);
+  }
+}
+
+void VirtualTexture::MarkDirty(int level, int minX, int minY, int maxX, int maxY)
+{
+  int* rect = &m_DirtyRect[level * 4];
+  rect[0] = std::min(rect[0], minX);
+  rect[1] = std::min(rect[1], minY);
+  rect[2] = std::max(rect[2], maxX);
+  rect[3] = std::max(rect[3], maxY);
+}
+
+void VirtualTexture::UploadPageTable()
+{
+  OpenGLCall(glBindTexture(GL_TEXTURE_2D, m_PageTableTexture));
+  OpenGLCall(glPixelStorei(GL_UNPACK_ALIGNMENT, 4));
+  for (int level = 0; level < m_LevelCount; level++)
+  {
+    int* rect = &m_DirtyRect[level * 4];
+    if (rect[2] < rect[0])
+      continue;
+
+    int size = m_PageTableSize >> level;
+    OpenGLCall(glPixelStorei(GL_UNPACK_ROW_LENGTH, size));
+    OpenGLCall(glPixelStorei(GL_UNPACK_SKIP_PIXELS, rect[0]));
+    OpenGLCall(glPixelStorei(GL_UNPACK_SKIP_ROWS, rect[1]));
+    OpenGLCall(glTexSubImage2D(GL_TEXTURE_2D, level, rect[0], rect[1], rect[2] - rect[0] + 1, rect[3] - rect[1] + 1,
+      GL_RGBA, GL_UNSIGNED_BYTE, m_PageTable[level].data()));
+
+    rect[0] = rect[1] = size;
+    rect[2] = rect[3] = -1;
+  }
+  OpenGLCall(glPixelStorei(GL_UNPACK_ROW_LENGTH, 0));
+  OpenGLCall(glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0));
+  OpenGLCall(glPixelStorei(GL_UNPACK_SKIP_ROWS, 0));
+}
+
+void VirtualTexture::SetCommonUniforms(Shader& shader) const
+{
+  shader.SetUniform1f("u_PageTableSize", (float)m_PageTableSize);
+  shader.SetUniform1f("u_VirtualSize", (float)m_PageTableSize * VT_PAGE_CONTENT);
+  shader.SetUniform1f("u_MaxLevel", (float)(m_LevelCount - 1));
+}
+
+void VirtualTexture::Bind(Shader& shader, unsigned int pageTableSlot, unsigned int physicalSlot) const
+{
+  OpenGLCall(glActiveTexture(GL_TEXTURE0 + pageTableSlot));
+  OpenGLCall(glBindTexture(GL_TEXTURE_2D, m_PageTableTexture));
+  OpenGLCall(glActiveTexture(GL_TEXTURE0 + physicalSlot));
+  OpenGLCall(glBindTexture(GL_TEXTURE_2D, m_PhysicalTexture));
+
+  shader.Bind();
+  SetCommonUniforms(shader);
+  shader.SetUniform1i("u_PageTable", pageTableSlot);
+  shader.SetUniform1i("u_PhysicalPages", physicalSlot);
+  shader.SetUniform1f("u_PhysicalPagesPerSide", (float)m_PhysicalPagesPerSide);
+}
+
+void VirtualTexture::BindFeedback(Shader& shader) const
+{
+  shader.Bind();
+  SetCommonUniforms(shader);
+  // The feedback buffer is smaller than the screen, so its derivatives overestimate the level.
+  shader.SetUniform1f("u_LevelBias", -std::log2((float)m_FeedbackScale));
+}
+
+void VirtualTexture::LoadPages()
+{
+  while (true)
+  {
+    PageRequest request;
+    {
+      std::lock_guard<std::mutex> lock(m_RequestMutex);
+      if (!m_Running || m_RequestQueue.empty())
+      {
+        m_ActiveLoaders--;
+        return;
+      }
+      request = m_RequestQueue.front();
+      m_RequestQueue.pop_front();
+    }
+
+    LoadedPage page = { request, std::vector<unsigned char>(VT_PAGE_BYTES) };
+    if (!m_Source->ReadPage(request.Level, request.X, request.Y, page.Pixels.data()))
+      page.Pixels.clear();
+
+    std::lock_guard<std::mutex> lock(m_ResultMutex);
+    m_Results.push_back(std::move(page));
+  }
+}
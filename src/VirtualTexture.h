@@ -0,0 +1,126 @@
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "JobSystem.h"
+#include "Shader.h"
+#include "VirtualTextureSource.h"
+
+// Streams pages of an arbitrarily large texture into a fixed size physical page cache.
+//
+// Each frame the scene is drawn once into a small feedback buffer with VirtualTextureFeedback.frag,
+// which writes the page and mip level every pixel wants. The buffer is read back asynchronously
+// through pixel pack buffers, missing pages are loaded by JobSystem jobs, uploaded into free or
+// least recently used cache slots, and the page table (indirection texture) is updated so every
+// virtual page points at the finest resident page covering it.
+class VirtualTexture
+{
+public:
+  struct Stats
+  {
+    unsigned int ResidentPages;
+    unsigned int PendingPages;
+    unsigned int UploadsLastFrame;
+    unsigned int TotalUploads;
+    unsigned int Evictions;
+  };
+
+private:
+  struct PageRequest
+  {
+    int Level, X, Y;
+  };
+
+  struct LoadedPage
+  {
+    PageRequest Page;
+    std::vector<unsigned char> Pixels;
+  };
+
+  struct Slot
+  {
+    uint64_t PageKey;
+    unsigned int LastUsedFrame;
+    bool Occupied;
+    bool Pinned;
+    std::list<int>::iterator LruPosition;
+  };
+
+  static constexpr int FEEDBACK_BUFFER_COUNT = 3;
+
+  std::unique_ptr<VirtualTextureSource> m_Source;
+  int m_PageTableSize, m_LevelCount, m_PhysicalPagesPerSide;
+  unsigned int m_PhysicalTexture, m_PageTableTexture;
+
+  // CPU copy of every page table level, packed as RGBA8 (physical x, physical y, level, 255).
+  std::vector<std::vector<uint32_t>> m_PageTable;
+  std::vector<int> m_DirtyRect; // minX, minY, maxX, maxY per level
+
+  std::vector<Slot> m_Slots;
+  std::list<int> m_LruSlots; // Least recently used at the front.
+  std::unordered_map<uint64_t, int> m_ResidentPages;
+  std::unordered_set<uint64_t> m_PendingPages;
+  unsigned int m_Frame;
+  int m_MaxUploadsPerFrame;
+
+  int m_FeedbackWidth, m_FeedbackHeight, m_FeedbackScale;
+  unsigned int m_FeedbackFramebuffer, m_FeedbackTexture;
+  unsigned int m_FeedbackBuffers[FEEDBACK_BUFFER_COUNT];
+  void* m_FeedbackFences[FEEDBACK_BUFFER_COUNT];
+  int m_FeedbackWriteIndex;
+  int m_PreviousViewport[4];
+  std::vector<uint64_t> m_Requests;
+
+  std::mutex m_RequestMutex, m_ResultMutex;
+  std::deque<PageRequest> m_RequestQueue;
+  int m_ActiveLoaders; // Loader jobs draining m_RequestQueue, guarded by m_RequestMutex.
+  JobCounter m_LoaderJobs;
+  std::vector<LoadedPage> m_Results;
+  std::atomic<bool> m_Running;
+
+  Stats m_Stats;
+
+public:
+  VirtualTexture(std::unique_ptr<VirtualTextureSource> source, int physicalPagesPerSide, int viewportWidth, int viewportHeight);
+  ~VirtualTexture();
+
+  VirtualTexture(const VirtualTexture&) = delete;
+  VirtualTexture& operator=(const VirtualTexture&) = delete;
+
+  // Redirects rendering into the feedback buffer. Draw the virtual textured geometry with the
+  // feedback shader in between, then call EndFeedback to queue the asynchronous read back.
+  void BeginFeedback();
+  void EndFeedback();
+
+  // Processes finished read backs and uploads pages streamed in since the last frame.
+  void Update();
+
+  // Binds the page table and physical cache for VirtualTexture.frag.
+  void Bind(Shader& shader, unsigned int pageTableSlot = 0, unsigned int physicalSlot = 1) const;
+  // Sets the uniforms VirtualTextureFeedback.frag needs.
+  void BindFeedback(Shader& shader) const;
+
+  inline const Stats& GetStats() const { return m_Stats; }
+  inline const VirtualTextureSource& GetSource() const { return *m_Source; }
+  inline void SetMaxUploadsPerFrame(int uploads) { m_MaxUploadsPerFrame = uploads; }
+private:
+  static inline uint64_t PageKey(int level, int x, int y) { return ((uint64_t)level << 48) | ((uint64_t)y << 24) | (uint64_t)x; }
+
+  void SetCommonUniforms(Shader& shader) const;
+  void ProcessFeedback(const unsigned short* pixels);
+  void UploadPage(const LoadedPage& page);
+  int AcquireSlot();
+  void MapPage(int level, int x, int y, int slot);
+  void UnmapPage(int level, int x, int y, int slot);
+  void MarkDirty(int level, int minX, int minY, int maxX, int maxY);
+  void UploadPageTable();
+  // Job body: loads queued pages until the queue is empty or the texture is being destroyed.
+  void LoadPages();
+};
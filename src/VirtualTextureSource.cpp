@@ -0,0 +1,135 @@
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+#include "ImageDecoder.h"
+#include "VirtualTextureSource.h"
+
+static constexpr uint32_t VT_FILE_MAGIC = 0x58545456; // "VTTX"
+static constexpr uint32_t VT_FILE_VERSION = 1;
+
+int VirtualTextureSource::GetLevelCount() const
+{
+  int levels = 1;
+  for (int size = GetPageTableSize(); size > 1; size /= 2)
+    levels++;
+  return levels;
+}
+
+VirtualTextureFile::VirtualTextureFile(const std::string& filepath)
+  : m_File(filepath), m_Header(nullptr)
+{
+  if (!m_File.IsValid() || m_File.GetSize() < sizeof(Header))
+    return;
+
+  const Header* header = (const Header*)m_File.GetData();
+  if (header->Magic != VT_FILE_MAGIC || header->Version != VT_FILE_VERSION ||
+    header->PageSize != VT_PAGE_SIZE || header->PageBorder != VT_PAGE_BORDER)
+  {
+    std::cout << "[ERROR] [VT]: '" << filepath << "' is not a compatible virtual texture" << std::endl;
+    return;
+  }
+
+  m_Header = header;
+}
+
+bool VirtualTextureFile::ReadPage(int level, int x, int y, unsigned char* destination) const
+{
+  size_t pageIndex = 0;
+  for (int i = 0; i < level; i++)
+  {
+    size_t size = m_Header->PageTableSize >> i;
+    pageIndex += size * size;
+  }
+  pageIndex += (size_t)y * (m_Header->PageTableSize >> level) + x;
+
+  size_t offset = sizeof(Header) + pageIndex * VT_PAGE_BYTES;
+  if (offset + VT_PAGE_BYTES > m_File.GetSize())
+    return false;
+
+  memcpy(destination, m_File.GetData() + offset, VT_PAGE_BYTES);
+  return true;
+}
+
+bool VirtualTextureFile::Build(const std::string& sourcePath, const std::string& outputPath)
+{
+  MappedFile source(sourcePath);
+  const ImageDecoder* decoder = source.IsValid() ? ImageDecoder::Find(source.GetData(), source.GetSize()) : nullptr;
+  ImageInfo info;
+  if (!decoder || !decoder->ReadInfo(source.GetData(), source.GetSize(), info))
+  {
+    std::cout << "[ERROR] [VT]: Can't read '" << sourcePath << "'" << std::endl;
+    return false;
+  }
+
+  // Bottom-up rows, so page (0, 0) is at the texture coordinate origin like any other texture.
+  std::vector<unsigned char> image((size_t)info.Width * info.Height * 4);
+  if (!decoder->Decode(source.GetData(), source.GetSize(), image.data(), image.size(), 4, true))
+    return false;
+
+  int pageTableSize = 1;
+  while (pageTableSize * VT_PAGE_CONTENT < std::max(info.Width, info.Height))
+    pageTableSize *= 2;
+
+  std::ofstream stream(outputPath, std::ios::binary | std::ios::trunc);
+  Header header = { VT_FILE_MAGIC, VT_FILE_VERSION, (uint32_t)info.Width, (uint32_t)info.Height,
+    (uint32_t)pageTableSize, VT_PAGE_SIZE, VT_PAGE_BORDER, 0 };
+  stream.write((const char*)&header, sizeof(header));
+
+  int width = info.Width, height = info.Height;
+  std::vector<unsigned char> page(VT_PAGE_BYTES);
+  for (int pages = pageTableSize; pages >= 1; pages /= 2)
+  {
+    for (int pageY = 0; pageY < pages; pageY++)
+    {
+      for (int pageX = 0; pageX < pages; pageX++)
+      {
+        // Copy the page's content plus border, clamping to the image edge and leaving
+        // pages beyond the image transparent.
+        for (int y = 0; y < VT_PAGE_SIZE; y++)
+        {
+          for (int x = 0; x < VT_PAGE_SIZE; x++)
+          {
+            int imageX = pageX * VT_PAGE_CONTENT + x - VT_PAGE_BORDER;
+            int imageY = pageY * VT_PAGE_CONTENT + y - VT_PAGE_BORDER;
+            unsigned char* texel = &page[((size_t)y * VT_PAGE_SIZE + x) * 4];
+            if (imageX >= width + VT_PAGE_BORDER || imageY >= height + VT_PAGE_BORDER)
+            {
+              memset(texel, 0, 4);
+              continue;
+            }
+            imageX = std::min(std::max(imageX, 0), width - 1);
+            imageY = std::min(std::max(imageY, 0), height - 1);
+            memcpy(texel, &image[((size_t)imageY * width + imageX) * 4], 4);
+          }
+        }
+        stream.write((const char*)page.data(), page.size());
+      }
+    }
+
+    // 2x2 box filter down to the next level.
+    int nextWidth = std::max(1, width / 2), nextHeight = std::max(1, height / 2);
+    std::vector<unsigned char> next((size_t)nextWidth * nextHeight * 4);
+    for (int y = 0; y < nextHeight; y++)
+    {
+      for (int x = 0; x < nextWidth; x++)
+      {
+        int x0 = std::min(x * 2, width - 1), x1 = std::min(x * 2 + 1, width - 1);
+        int y0 = std::min(y * 2, height - 1), y1 = std::min(y * 2 + 1, height - 1);
+        for (int c = 0; c < 4; c++)
+        {
+          int sum = image[((size_t)y0 * width + x0) * 4 + c] + image[((size_t)y0 * width + x1) * 4 + c] +
+            image[((size_t)y1 * width + x0) * 4 + c] + image[((size_t)y1 * width + x1) * 4 + c];
+          next[((size_t)y * nextWidth + x) * 4 + c] = (unsigned char)((sum + 2) / 4);
+        }
+      }
+    }
+    image.swap(next);
+    width = nextWidth;
+    height = nextHeight;
+  }
+
+  return (bool)stream;
+}
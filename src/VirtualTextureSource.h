@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "MappedFile.h"
+
+// Pages are stored with a border of neighbouring texels so bilinear filtering
+// never reads from an unrelated page in the physical cache.
+constexpr int VT_PAGE_SIZE = 128;
+constexpr int VT_PAGE_BORDER = 4;
+constexpr int VT_PAGE_CONTENT = VT_PAGE_SIZE - 2 * VT_PAGE_BORDER;
+constexpr size_t VT_PAGE_BYTES = VT_PAGE_SIZE * VT_PAGE_SIZE * 4;
+
+// Supplies RGBA8 pages of a virtual texture. The virtual texture is a square grid of
+// GetPageTableSize() pages at level 0, halving at each level until a single page remains.
+// ReadPage is called from JobSystem jobs, several at once, and must be thread-safe.
+class VirtualTextureSource
+{
+public:
+  virtual ~VirtualTextureSource() {}
+
+  virtual int GetPageTableSize() const = 0;
+  // Size of the actual image inside the virtual texture, the rest of the page grid is empty.
+  virtual int GetWidth() const = 0;
+  virtual int GetHeight() const = 0;
+
+  virtual bool ReadPage(int level, int x, int y, unsigned char* destination) const = 0;
+
+  int GetLevelCount() const;
+};
+
+// Pages pre-tiled on disk, read through a memory mapping so worker threads fault
+// pages in directly without any file handle contention.
+//
+// Layout: Header, then every page of level 0 row by row, then level 1 and so on.
+class VirtualTextureFile : public VirtualTextureSource
+{
+private:
+  struct Header
+  {
+    uint32_t Magic;
+    uint32_t Version;
+    uint32_t Width;
+    uint32_t Height;
+    uint32_t PageTableSize;
+    uint32_t PageSize;
+    uint32_t PageBorder;
+    uint32_t Reserved;
+  };
+
+  MappedFile m_File;
+  const Header* m_Header;
+
+public:
+  VirtualTextureFile(const std::string& filepath);
+
+  inline bool IsValid() const { return m_Header != nullptr; }
+
+  int GetPageTableSize() const override { return (int)m_Header->PageTableSize; }
+  int GetWidth() const override { return (int)m_Header->Width; }
+  int GetHeight() const override { return (int)m_Header->Height; }
+
+  bool ReadPage(int level, int x, int y, unsigned char* destination) const override;
+
+  // Tiles an image into a page file, generating the mip levels with a box filter. This is
+  // the offline step; the whole source image has to fit in memory while tiling.
+  static bool Build(const std::string& sourcePath, const std::string& outputPath);
+};
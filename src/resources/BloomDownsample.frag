@@ -0,0 +1,44 @@
+#version 330 core
+
+layout(location = 0) out vec4 color;
+uniform sampler2D u_Texture;
+uniform vec2 u_TexelSize;
+uniform float u_Threshold;
+uniform float u_Knee;
+
+in vec2 v_TextureCoords;
+
+// Keeps only what is brighter than the threshold, with a soft knee to avoid hard edges.
+vec3 Prefilter(vec3 c)
+{
+  float brightness = max(c.r, max(c.g, c.b));
+  float soft = clamp(brightness - u_Threshold + u_Knee, 0.0, 2.0 * u_Knee);
+  soft = soft * soft / (4.0 * u_Knee + 0.0001);
+  return c * max(soft, brightness - u_Threshold) / max(brightness, 0.0001);
+}
+
+void main()
+{
+  // 13 bilinear taps arranged as overlapping 2x2 boxes, which avoids the shimmering of a single box filter.
+  vec2 uv = v_TextureCoords;
+  vec2 t = u_TexelSize;
+  vec3 a = texture(u_Texture, uv + t * vec2(-2.0,  2.0)).rgb;
+  vec3 b = texture(u_Texture, uv + t * vec2( 0.0,  2.0)).rgb;
+  vec3 c = texture(u_Texture, uv + t * vec2( 2.0,  2.0)).rgb;
+  vec3 d = texture(u_Texture, uv + t * vec2(-2.0,  0.0)).rgb;
+  vec3 e = texture(u_Texture, uv).rgb;
+  vec3 f = texture(u_Texture, uv + t * vec2( 2.0,  0.0)).rgb;
+  vec3 g = texture(u_Texture, uv + t * vec2(-2.0, -2.0)).rgb;
+  vec3 h = texture(u_Texture, uv + t * vec2( 0.0, -2.0)).rgb;
+  vec3 i = texture(u_Texture, uv + t * vec2( 2.0, -2.0)).rgb;
+  vec3 j = texture(u_Texture, uv + t * vec2(-1.0,  1.0)).rgb;
+  vec3 k = texture(u_Texture, uv + t * vec2( 1.0,  1.0)).rgb;
+  vec3 l = texture(u_Texture, uv + t * vec2(-1.0, -1.0)).rgb;
+  vec3 m = texture(u_Texture, uv + t * vec2( 1.0, -1.0)).rgb;
+
+  vec3 result = e * 0.125 + (a + c + g + i) * 0.03125 + (b + d + f + h) * 0.0625 + (j + k + l + m) * 0.125;
+#ifdef PREFILTER
+  result = Prefilter(result);
+#endif
+  color = vec4(result, 1.0);
+};
@@ -0,0 +1,21 @@
+#version 330 core
+
+layout(location = 0) out vec4 color;
+uniform sampler2D u_Texture;
+uniform vec2 u_TexelSize;
+uniform float u_Radius;
+
+in vec2 v_TextureCoords;
+
+void main()
+{
+  // 3x3 tent filter; the result is added onto the larger level with additive blending.
+  vec2 uv = v_TextureCoords;
+  vec2 t = u_TexelSize * u_Radius;
+  vec3 result = texture(u_Texture, uv).rgb * 4.0;
+  result += (texture(u_Texture, uv + vec2(-t.x, 0.0)).rgb + texture(u_Texture, uv + vec2(t.x, 0.0)).rgb +
+             texture(u_Texture, uv + vec2(0.0, -t.y)).rgb + texture(u_Texture, uv + vec2(0.0, t.y)).rgb) * 2.0;
+  result += texture(u_Texture, uv + vec2(-t.x, -t.y)).rgb + texture(u_Texture, uv + vec2(t.x, -t.y)).rgb +
+            texture(u_Texture, uv + vec2(-t.x, t.y)).rgb + texture(u_Texture, uv + vec2(t.x, t.y)).rgb;
+  color = vec4(result / 16.0, 1.0);
+};
@@ -0,0 +1,37 @@
+#version 330 core
+
+layout(location = 0) out vec4 color;
+uniform sampler2D u_Texture;
+uniform vec2 u_TexelSize;
+
+in vec2 v_TextureCoords;
+
+#define FXAA_REDUCE_MIN (1.0 / 128.0)
+#define FXAA_REDUCE_MUL (1.0 / 8.0)
+#define FXAA_SPAN_MAX 8.0
+
+void main()
+{
+  // Luma was written to alpha by the composite pass.
+  vec2 uv = v_TextureCoords;
+  float lumaNW = textureOffset(u_Texture, uv, ivec2(-1,  1)).a;
+  float lumaNE = textureOffset(u_Texture, uv, ivec2( 1,  1)).a;
+  float lumaSW = textureOffset(u_Texture, uv, ivec2(-1, -1)).a;
+  float lumaSE = textureOffset(u_Texture, uv, ivec2( 1, -1)).a;
+  vec4 center = texture(u_Texture, uv);
+  float lumaMin = min(center.a, min(min(lumaNW, lumaNE), min(lumaSW, lumaSE)));
+  float lumaMax = max(center.a, max(max(lumaNW, lumaNE), max(lumaSW, lumaSE)));
+
+  // Blur along the edge, perpendicular to the luma gradient.
+  vec2 direction = vec2((lumaSW + lumaSE) - (lumaNW + lumaNE), (lumaNW + lumaSW) - (lumaNE + lumaSE));
+  float directionReduce = max((lumaNW + lumaNE + lumaSW + lumaSE) * 0.25 * FXAA_REDUCE_MUL, FXAA_REDUCE_MIN);
+  float inverseDirectionMin = 1.0 / (min(abs(direction.x), abs(direction.y)) + directionReduce);
+  direction = clamp(direction * inverseDirectionMin, vec2(-FXAA_SPAN_MAX), vec2(FXAA_SPAN_MAX)) * u_TexelSize;
+
+  vec3 resultA = 0.5 * (texture(u_Texture, uv + direction * (1.0 / 3.0 - 0.5)).rgb +
+                        texture(u_Texture, uv + direction * (2.0 / 3.0 - 0.5)).rgb);
+  vec3 resultB = resultA * 0.5 + 0.25 * (texture(u_Texture, uv - direction * 0.5).rgb +
+                                         texture(u_Texture, uv + direction * 0.5).rgb);
+  float lumaB = dot(resultB, vec3(0.299, 0.587, 0.114));
+  color = vec4((lumaB < lumaMin || lumaB > lumaMax) ? resultA : resultB, 1.0);
+};
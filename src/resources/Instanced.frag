@@ -0,0 +1,12 @@
+#version 330 core
+
+layout(location = 0) out vec4 color;
+uniform vec4 u_Color;
+
+in vec3 v_Normal;
+
+void main()
+{
+  float light = max(dot(normalize(v_Normal), normalize(vec3(0.4, 0.8, 0.6))), 0.0) * 0.8 + 0.2;
+  color = vec4(u_Color.rgb * light, u_Color.a);
+};
@@ -0,0 +1,15 @@
+#version 330 core
+
+layout(location = 0) in vec4 position;
+layout(location = 1) in vec3 normal;
+layout(location = 2) in mat4 a_Transform;
+
+out vec3 v_Normal;
+
+uniform mat4 u_ViewProjection;
+
+void main()
+{
+  gl_Position = u_ViewProjection * a_Transform * position;
+  v_Normal = mat3(a_Transform) * normal;
+};
@@ -0,0 +1,10 @@
+#version 330 core
+
+layout(location = 0) out vec4 color;
+uniform vec4 u_Color;
+
+void main()
+{
+  // Added onto the target with additive blending, one increment per shaded fragment.
+  color = u_Color;
+};
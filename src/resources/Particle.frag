@@ -0,0 +1,12 @@
+#version 330 core
+
+layout(location = 0) out vec4 color;
+
+in vec2 v_Corner;
+in vec4 v_Color;
+
+void main()
+{
+  float falloff = 1.0 - smoothstep(0.5, 1.0, length(v_Corner));
+  color = vec4(v_Color.rgb, v_Color.a * falloff);
+}
@@ -0,0 +1,35 @@
+#version 330 core
+
+// Camera facing quad per particle, sized and coloured by how far through its life it is.
+
+layout(location = 0) in vec2 a_Corner;
+layout(location = 1) in vec4 a_PositionAge;       // Per instance.
+layout(location = 2) in vec4 a_VelocityLifetime;  // Per instance.
+
+out vec2 v_Corner;
+out vec4 v_Color;
+
+uniform mat4 u_ViewProjection;
+uniform vec3 u_CameraRight;
+uniform vec3 u_CameraUp;
+uniform vec4 u_StartColor;
+uniform vec4 u_EndColor;
+uniform vec2 u_Size; // Start, end.
+
+void main()
+{
+  v_Corner = a_Corner;
+  float life = a_PositionAge.w / max(a_VelocityLifetime.w, 0.0001);
+  if (life >= 1.0)
+  {
+    // Dead: outside the clip volume, so the quad is dropped before rasterisation.
+    gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
+    v_Color = vec4(0.0);
+    return;
+  }
+
+  float size = mix(u_Size.x, u_Size.y, life);
+  vec3 position = a_PositionAge.xyz + (u_CameraRight * a_Corner.x + u_CameraUp * a_Corner.y) * size;
+  gl_Position = u_ViewProjection * vec4(position, 1.0);
+  v_Color = mix(u_StartColor, u_EndColor, life);
+}
@@ -0,0 +1,71 @@
+#version 330 core
+
+// One particle per vertex, written back through transform feedback. Slots in the emission window
+// are respawned; the rest integrate if they're alive. Must match ParticleSystem::UpdateCpu.
+
+layout(location = 0) in vec4 a_PositionAge;
+layout(location = 1) in vec4 a_VelocityLifetime;
+
+out vec4 v_PositionAge;
+out vec4 v_VelocityLifetime;
+
+uniform float u_DeltaTime;
+uniform vec3 u_Gravity;
+uniform float u_Drag;
+uniform uint u_Capacity;
+uniform uint u_EmitStart;
+uniform uint u_EmitCount;
+uniform uint u_Seed;
+
+uniform vec3 u_EmitterPosition;
+uniform float u_EmitterRadius;
+uniform vec3 u_Direction;
+uniform float u_Spread;
+uniform vec2 u_Speed;    // Min, max.
+uniform vec2 u_Lifetime; // Min, max.
+
+uint Hash(uint x)
+{
+  x ^= x >> 16;
+  x *= 0x7feb352du;
+  x ^= x >> 15;
+  x *= 0x846ca68bu;
+  x ^= x >> 16;
+  return x;
+}
+
+float Random(uint slot, uint stream)
+{
+  return float(Hash(slot * 8u + stream + Hash(u_Seed)) >> 8) / 16777216.0;
+}
+
+vec3 RandomDirection(uint slot, uint stream)
+{
+  float z = Random(slot, stream) * 2.0 - 1.0;
+  float angle = Random(slot, stream + 1u) * 6.2831853;
+  float r = sqrt(max(1.0 - z * z, 0.0));
+  return vec3(r * cos(angle), r * sin(angle), z);
+}
+
+void main()
+{
+  uint slot = uint(gl_VertexID);
+  vec4 positionAge = a_PositionAge;
+  vec4 velocityLifetime = a_VelocityLifetime;
+
+  if ((slot + u_Capacity - u_EmitStart) % u_Capacity < u_EmitCount)
+  {
+    vec3 offset = RandomDirection(slot, 0u) * u_EmitterRadius * Random(slot, 2u);
+    vec3 direction = u_Direction + RandomDirection(slot, 3u) * u_Spread;
+    positionAge = vec4(u_EmitterPosition + offset, 0.0);
+    velocityLifetime = vec4(direction * mix(u_Speed.x, u_Speed.y, Random(slot, 5u)), mix(u_Lifetime.x, u_Lifetime.y, Random(slot, 6u)));
+  }
+  else if (positionAge.w < velocityLifetime.w)
+  {
+    velocityLifetime.xyz = (velocityLifetime.xyz + u_Gravity * u_DeltaTime) * max(1.0 - u_Drag * u_DeltaTime, 0.0);
+    positionAge += vec4(velocityLifetime.xyz * u_DeltaTime, u_DeltaTime);
+  }
+
+  v_PositionAge = positionAge;
+  v_VelocityLifetime = velocityLifetime;
+}
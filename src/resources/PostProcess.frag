@@ -0,0 +1,69 @@
+#version 330 core
+
+// Every per-pixel effect of the post-processing stack in one pass. PostProcessStack compiles a
+// variant per combination of enabled effects by defining BLOOM, TONEMAP_REINHARD, TONEMAP_ACES,
+// COLOR_GRADING, VIGNETTE and OUTPUT_LUMA, so disabled effects cost nothing.
+
+layout(location = 0) out vec4 color;
+uniform sampler2D u_Scene;
+uniform float u_Exposure;
+
+#ifdef BLOOM
+uniform sampler2D u_Bloom;
+uniform float u_BloomIntensity;
+#endif
+
+#ifdef COLOR_GRADING
+uniform sampler3D u_Lut;
+uniform float u_LutSize;
+uniform float u_LutContribution;
+#endif
+
+#ifdef VIGNETTE
+uniform float u_VignetteIntensity;
+uniform float u_VignetteRadius;
+uniform float u_VignetteSmoothness;
+#endif
+
+in vec2 v_TextureCoords;
+
+// Narkowicz's fit of the ACES filmic curve.
+vec3 TonemapAces(vec3 x)
+{
+  return clamp((x * (2.51 * x + 0.03)) / (x * (2.43 * x + 0.59) + 0.14), 0.0, 1.0);
+}
+
+void main()
+{
+  vec3 result = texture(u_Scene, v_TextureCoords).rgb;
+#ifdef BLOOM
+  result += texture(u_Bloom, v_TextureCoords).rgb * u_BloomIntensity;
+#endif
+  result *= u_Exposure;
+
+#if defined(TONEMAP_ACES)
+  result = TonemapAces(result);
+#elif defined(TONEMAP_REINHARD)
+  result = result / (1.0 + result);
+#endif
+  result = clamp(result, 0.0, 1.0);
+
+#ifdef COLOR_GRADING
+  // Sample texel centres so the ends of the range map to the first and last entries.
+  vec3 lutCoords = result * ((u_LutSize - 1.0) / u_LutSize) + 0.5 / u_LutSize;
+  result = mix(result, texture(u_Lut, lutCoords).rgb, u_LutContribution);
+#endif
+
+#ifdef VIGNETTE
+  float centerDistance = length(v_TextureCoords - 0.5);
+  float vignette = smoothstep(u_VignetteRadius, u_VignetteRadius - u_VignetteSmoothness, centerDistance);
+  result *= mix(1.0, vignette, u_VignetteIntensity);
+#endif
+
+#ifdef OUTPUT_LUMA
+  // FXAA runs next and reads luma from alpha.
+  color = vec4(result, dot(result, vec3(0.299, 0.587, 0.114)));
+#else
+  color = vec4(result, 1.0);
+#endif
+};
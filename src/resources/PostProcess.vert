@@ -0,0 +1,11 @@
+#version 330 core
+
+out vec2 v_TextureCoords;
+
+void main()
+{
+  // One triangle covering the screen, generated from the vertex id so no vertex buffer is needed.
+  vec2 position = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+  v_TextureCoords = position;
+  gl_Position = vec4(position * 2.0 - 1.0, 0.0, 1.0);
+};
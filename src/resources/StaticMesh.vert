@@ -0,0 +1,14 @@
+#version 330 core
+
+layout(location = 0) in vec4 position;
+layout(location = 1) in vec3 normal;
+
+out vec3 v_Normal;
+
+uniform mat4 u_ViewProjection;
+
+void main()
+{
+  gl_Position = u_ViewProjection * position;
+  v_Normal = normal;
+};
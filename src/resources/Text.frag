@@ -0,0 +1,18 @@
+#version 330 core
+
+layout(location = 0) out vec4 color;
+
+in vec2 v_TexCoord;
+in vec4 v_Color;
+
+uniform sampler2D u_Atlas; // Signed distance field, 0.5 on the outline.
+
+void main()
+{
+  // Blending over however much the field changes across one screen pixel keeps the edge a pixel
+  // wide at any scale.
+  float distance = texture(u_Atlas, v_TexCoord).r;
+  float width = max(fwidth(distance), 0.0001) * 0.5;
+  float coverage = smoothstep(0.5 - width, 0.5 + width, distance);
+  color = vec4(v_Color.rgb, v_Color.a * coverage);
+}
@@ -0,0 +1,20 @@
+#version 330 core
+
+// One quad per glyph, stretched over the glyph's rectangle on screen and in the atlas.
+
+layout(location = 0) in vec2 a_Corner;     // 0 to 1.
+layout(location = 1) in vec4 a_Rect;       // Per instance: top left, bottom right.
+layout(location = 2) in vec4 a_TexCoords;  // Per instance.
+layout(location = 3) in vec4 a_Color;      // Per instance.
+
+out vec2 v_TexCoord;
+out vec4 v_Color;
+
+uniform mat4 u_Projection;
+
+void main()
+{
+  v_TexCoord = mix(a_TexCoords.xy, a_TexCoords.zw, a_Corner);
+  v_Color = a_Color;
+  gl_Position = u_Projection * vec4(mix(a_Rect.xy, a_Rect.zw, a_Corner), 0.0, 1.0);
+}
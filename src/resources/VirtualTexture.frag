@@ -0,0 +1,33 @@
+#version 330 core
+
+layout(location = 0) out vec4 color;
+
+uniform sampler2D u_PageTable;
+uniform sampler2D u_PhysicalPages;
+uniform float u_PageTableSize;
+uniform float u_VirtualSize;
+uniform float u_MaxLevel;
+uniform float u_PhysicalPagesPerSide;
+
+in vec2 v_TextureCoords;
+
+const float PAGE_SIZE = 128.0;
+const float PAGE_BORDER = 4.0;
+const float PAGE_CONTENT = PAGE_SIZE - 2.0 * PAGE_BORDER;
+
+void main()
+{
+  vec2 uv = clamp(v_TextureCoords, 0.0, 0.99999);
+
+  vec2 dx = dFdx(uv * u_VirtualSize);
+  vec2 dy = dFdy(uv * u_VirtualSize);
+  float level = clamp(floor(0.5 * log2(max(dot(dx, dx), dot(dy, dy)))), 0.0, u_MaxLevel);
+
+  // The page table entry holds the finest resident page covering this one, which may be coarser.
+  ivec2 page = ivec2(uv * (u_PageTableSize / exp2(level)));
+  vec3 entry = texelFetch(u_PageTable, page, int(level)).xyz * 255.0;
+
+  vec2 withinPage = fract(uv * (u_PageTableSize / exp2(entry.z)));
+  vec2 physical = (entry.xy * PAGE_SIZE + PAGE_BORDER + withinPage * PAGE_CONTENT) / (u_PhysicalPagesPerSide * PAGE_SIZE);
+  color = texture(u_PhysicalPages, physical);
+};
@@ -0,0 +1,23 @@
+#version 330 core
+
+layout(location = 0) out uvec4 feedback;
+
+uniform float u_PageTableSize;
+uniform float u_VirtualSize;
+uniform float u_MaxLevel;
+uniform float u_LevelBias;
+
+in vec2 v_TextureCoords;
+
+// Writes the level 0 page and the mip level this pixel samples, for VirtualTexture to stream in.
+void main()
+{
+  vec2 uv = clamp(v_TextureCoords, 0.0, 0.99999);
+
+  vec2 dx = dFdx(uv * u_VirtualSize);
+  vec2 dy = dFdy(uv * u_VirtualSize);
+  float level = clamp(floor(0.5 * log2(max(dot(dx, dx), dot(dy, dy))) + u_LevelBias), 0.0, u_MaxLevel);
+
+  uvec2 page = uvec2(uv * u_PageTableSize);
+  feedback = uvec4(page, uint(level), 1u);
+};